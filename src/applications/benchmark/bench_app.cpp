@@ -0,0 +1,285 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   bench_app.cpp
+ *
+ * @brief  Scaling benchmark for the core GridPACK phases: network
+ * generation, partitioning, mapping, solution and export.
+ *
+ *
+ */
+// -------------------------------------------------------------
+
+#include <cstdio>
+#include <iostream>
+#include "bench_app.hpp"
+#include "bench_network_generator.hpp"
+
+/**
+ * Basic constructor
+ */
+gridpack::benchmark::BenchApp::BenchApp(void)
+  : p_dataBytes(0), p_cloneBytes(0), p_writeBytes(0)
+{
+}
+
+/**
+ * Basic destructor
+ */
+gridpack::benchmark::BenchApp::~BenchApp(void)
+{
+}
+
+/**
+ * Synchronize all processes and return current time. Used to mark
+ * the start of a phase
+ * @return current wall clock time
+ */
+double gridpack::benchmark::BenchApp::p_start(void)
+{
+  p_comm.barrier();
+  return gridpack::utility::CoarseTimer::instance()->currentTime();
+}
+
+/**
+ * Record elapsed time for a phase
+ * @param name name of phase
+ * @param start time returned by p_start at beginning of phase
+ * @param calls number of times the operation was performed
+ */
+void gridpack::benchmark::BenchApp::p_record(const char *name, double start,
+    int calls)
+{
+  double elapsed =
+    gridpack::utility::CoarseTimer::instance()->currentTime() - start;
+  Phase phase;
+  phase.name = name;
+  phase.calls = calls;
+  phase.min = elapsed;
+  phase.max = elapsed;
+  phase.avg = elapsed;
+  p_comm.min(&phase.min,1);
+  p_comm.max(&phase.max,1);
+  p_comm.sum(&phase.avg,1);
+  phase.avg /= static_cast<double>(p_comm.size());
+  p_phases.push_back(phase);
+}
+
+/**
+ * Write results as a JSON record and a short summary to standard
+ * out. Only process 0 writes anything
+ * @param filename file that JSON record is appended to
+ * @param topology name of network topology
+ * @param scaling "strong" or "weak"
+ * @param nbus total number of buses
+ * @param nbranch total number of branches
+ * @param reps number of repetitions of repeated phases
+ */
+void gridpack::benchmark::BenchApp::p_report(const std::string &filename,
+    const std::string &topology, const std::string &scaling, int nbus,
+    int nbranch, int reps)
+{
+  if (p_comm.rank() != 0) return;
+  int nprocs = p_comm.size();
+  int i;
+
+  printf("\nBenchmark: %s network, %d buses, %d branches, %d processes"
+      " (%s scaling)\n\n",topology.c_str(),nbus,nbranch,nprocs,
+      scaling.c_str());
+  printf("  %-24s %8s %14s %14s %14s\n","Phase","Calls","Max (s)",
+      "Avg (s)","Max/call (s)");
+  for (i=0; i<p_phases.size(); i++) {
+    const Phase &phase = p_phases[i];
+    printf("  %-24s %8d %14.6f %14.6f %14.6f\n",phase.name.c_str(),
+        phase.calls,phase.max,phase.avg,
+        phase.max/static_cast<double>(phase.calls));
+  }
+  if (p_dataBytes > 0) {
+    printf("\n  Network data:                 %14ld bytes\n",p_dataBytes);
+    printf("  Network data after clone:     %14ld bytes\n",p_cloneBytes);
+    printf("  Network data after writes:    %14ld bytes\n",p_writeBytes);
+    printf("  Network data with full copy:  %14ld bytes\n",2*p_dataBytes);
+  }
+
+  // Append one record per run (JSON lines) so that runs with
+  // different process counts accumulate in the same file
+  FILE *fp = fopen(filename.c_str(),"a");
+  if (fp == NULL) {
+    printf("\nUnable to open benchmark output file %s\n",filename.c_str());
+    return;
+  }
+  fprintf(fp,"{\"benchmark\": \"gridpack_bench\", \"topology\": \"%s\","
+      " \"scaling\": \"%s\", \"ranks\": %d, \"buses\": %d,"
+      " \"branches\": %d, \"buses_per_rank\": %d, \"repetitions\": %d,"
+      " \"phases\": [",topology.c_str(),scaling.c_str(),nprocs,nbus,
+      nbranch,nbus/nprocs,reps);
+  for (i=0; i<p_phases.size(); i++) {
+    const Phase &phase = p_phases[i];
+    fprintf(fp,"%s{\"name\": \"%s\", \"calls\": %d, \"min\": %.9e,"
+        " \"max\": %.9e, \"avg\": %.9e}",(i>0 ? ", " : ""),
+        phase.name.c_str(),phase.calls,phase.min,phase.max,phase.avg);
+  }
+  fprintf(fp,"], \"data_bytes\": %ld, \"clone_data_bytes\": %ld,"
+      " \"clone_write_data_bytes\": %ld}\n",
+      p_dataBytes,p_cloneBytes,p_writeBytes);
+  fclose(fp);
+  printf("\nTiming record appended to %s\n",filename.c_str());
+}
+
+/**
+ * Execute benchmark
+ * @param argc number of arguments
+ * @param argv list of character strings
+ */
+void gridpack::benchmark::BenchApp::execute(int argc, char** argv)
+{
+  // read configuration file
+  gridpack::utility::Configuration *config =
+    gridpack::utility::Configuration::configuration();
+  if (argc >= 2 && argv[1] != NULL) {
+    char inputfile[256];
+    sprintf(inputfile,"%s",argv[1]);
+    config->open(inputfile,p_comm);
+  } else {
+    config->open("input.xml",p_comm);
+  }
+  gridpack::utility::Configuration::CursorPtr cursor;
+  cursor = config->getCursor("Configuration.Benchmark");
+
+  // Network size. If busesPerRank is set, the problem size grows with
+  // the number of processes (weak scaling), otherwise it is fixed
+  // (strong scaling)
+  std::string topology = cursor->get("topology",std::string("grid"));
+  int nbus = cursor->get("buses",10000);
+  int nbus_per_rank = cursor->get("busesPerRank",0);
+  std::string scaling("strong");
+  if (nbus_per_rank > 0) {
+    nbus = nbus_per_rank*p_comm.size();
+    scaling = "weak";
+  }
+  int reps = cursor->get("repetitions",5);
+  if (reps < 1) reps = 1;
+  std::string outfile = cursor->get("outputFile",std::string("bench.json"));
+  bool writeBuses = cursor->get("writeBuses",true);
+  std::string busfile =
+    cursor->get("busOutputFile",std::string("bench_buses.out"));
+
+  int i;
+  double t;
+  p_phases.clear();
+
+  // generate network
+  boost::shared_ptr<BenchNetwork> network(new BenchNetwork(p_comm));
+  SyntheticNetworkGenerator<BenchNetwork> generator(network);
+  generator.setTopology(topology);
+  generator.setTreeBranching(cursor->get("treeBranching",3));
+  generator.setMeshStride(cursor->get("meshStride",10));
+  t = p_start();
+  generator.generate(nbus);
+  p_record("generate",t,1);
+
+  // partition network
+  t = p_start();
+  network->partition();
+  p_record("partition",t,1);
+
+  // create factory and set up components
+  gridpack::factory::BaseFactory<BenchNetwork> factory(network);
+  t = p_start();
+  factory.load();
+  factory.setComponents();
+  factory.setExchange();
+  p_record("factory_setup",t,1);
+
+  // clone network. The copy shares data collections with the original,
+  // so the data footprint of both networks together should be close to
+  // that of the original network. The copy then overwrites the same
+  // fields that the real time path rating application writes into its
+  // dynamic simulation clones (bus voltages, generator and load powers).
+  // Only the overwritten values should add to the footprint
+  p_dataBytes = network->dataMemoryUsage();
+  {
+    boost::shared_ptr<BenchNetwork> copy(new BenchNetwork(p_comm));
+    t = p_start();
+    network->clone<BenchBus,BenchBranch>(copy);
+    p_record("network_clone",t,1);
+    p_cloneBytes = network->dataMemoryUsage() + copy->dataMemoryUsage();
+    t = p_start();
+    int nbus = copy->numBuses();
+    for (i=0; i<nbus; i++) {
+      gridpack::component::DataCollection *data = copy->getBusData(i).get();
+      data->setValue(BUS_VOLTAGE_MAG,1.01);
+      data->setValue(BUS_VOLTAGE_ANG,0.1);
+      data->setValue(GENERATOR_PG,1.1,0);
+      data->setValue(GENERATOR_QG,0.1,0);
+      data->setValue(LOAD_PL,1.1,0);
+      data->setValue(LOAD_QL,0.6,0);
+    }
+    p_record("clone_data_write",t,1);
+    p_writeBytes = network->dataMemoryUsage() + copy->dataMemoryUsage();
+  }
+
+  // bus exchange
+  t = p_start();
+  network->initBusUpdate();
+  p_record("init_bus_update",t,1);
+
+  t = p_start();
+  for (i=0; i<reps; i++) network->updateBuses();
+  p_record("update_buses",t,reps);
+
+  // matrix mapper
+  t = p_start();
+  gridpack::mapper::FullMatrixMap<BenchNetwork> vMap(network);
+  boost::shared_ptr<gridpack::math::Matrix> V = vMap.mapToMatrix();
+  p_record("matrix_map_build",t,1);
+
+  t = p_start();
+  for (i=0; i<reps; i++) vMap.mapToMatrix(*V);
+  p_record("matrix_map_refill",t,reps);
+
+  // vector mapper
+  t = p_start();
+  gridpack::mapper::BusVectorMap<BenchNetwork> rMap(network);
+  boost::shared_ptr<gridpack::math::Vector> R = rMap.mapToVector();
+  p_record("vector_map_build",t,1);
+
+  t = p_start();
+  for (i=0; i<reps; i++) rMap.mapToVector(*R);
+  p_record("vector_map_refill",t,reps);
+
+  // linear solve. The first solve includes preconditioner setup
+  boost::shared_ptr<gridpack::math::Vector> X(R->clone());
+  gridpack::math::LinearSolver solver(*V);
+  solver.configure(cursor);
+  t = p_start();
+  solver.solve(*R, *X);
+  p_record("linear_solve_first",t,1);
+
+  t = p_start();
+  for (i=0; i<reps; i++) solver.solve(*R, *X);
+  p_record("linear_solve",t,reps);
+
+  // push solution back on to buses
+  t = p_start();
+  for (i=0; i<reps; i++) rMap.mapToBus(*X);
+  p_record("vector_map_scatter",t,reps);
+  network->updateBuses();
+
+  // serial output
+  if (writeBuses) {
+    gridpack::serial_io::SerialBusIO<BenchNetwork> busIO(128,network);
+    busIO.open(busfile.c_str());
+    t = p_start();
+    busIO.header("Bus voltages\n");
+    busIO.write();
+    p_record("serial_bus_write",t,1);
+    busIO.close();
+  }
+
+  p_report(outfile,topology,scaling,nbus,generator.numBranches(),reps);
+}
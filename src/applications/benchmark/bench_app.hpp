@@ -0,0 +1,104 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   bench_app.hpp
+ *
+ * @brief
+ * Scaling benchmark for the core GridPACK phases. Results for each
+ * run are appended as a single JSON record to an output file so that
+ * runs at different process counts can be combined into weak- and
+ * strong-scaling plots.
+ *
+ */
+// -------------------------------------------------------------
+
+#ifndef _bench_app_h_
+#define _bench_app_h_
+
+#include <string>
+#include <vector>
+#include "bench_components.hpp"
+
+namespace gridpack {
+namespace benchmark {
+
+// Calling program for scaling benchmark
+
+class BenchApp
+{
+  public:
+    /**
+     * Basic constructor
+     */
+    BenchApp(void);
+
+    /**
+     * Basic destructor
+     */
+    ~BenchApp(void);
+
+    /**
+     * Execute benchmark
+     * @param argc number of arguments
+     * @param argv list of character strings
+     */
+    void execute(int argc, char** argv);
+
+  private:
+
+    /**
+     * Synchronize all processes and return current time. Used to mark
+     * the start of a phase
+     * @return current wall clock time
+     */
+    double p_start(void);
+
+    /**
+     * Record elapsed time for a phase
+     * @param name name of phase
+     * @param start time returned by p_start at beginning of phase
+     * @param calls number of times the operation was performed
+     */
+    void p_record(const char *name, double start, int calls);
+
+    /**
+     * Write results as a JSON record and a short summary to standard
+     * out. Only process 0 writes anything
+     * @param filename file that JSON record is appended to
+     * @param topology name of network topology
+     * @param scaling "strong" or "weak"
+     * @param nbus total number of buses
+     * @param nbranch total number of branches
+     * @param reps number of repetitions of repeated phases
+     */
+    void p_report(const std::string &filename, const std::string &topology,
+        const std::string &scaling, int nbus, int nbranch, int reps);
+
+    /// Timing data for one phase
+    struct Phase {
+      std::string name;
+      int calls;
+      double min;
+      double max;
+      double avg;
+    };
+
+    std::vector<Phase> p_phases;
+
+    /// Memory used by network data collections before and after the
+    /// network is cloned, and after the bus voltages, generator and
+    /// load powers of the clone have been overwritten
+    long p_dataBytes;
+    long p_cloneBytes;
+    long p_writeBytes;
+
+    gridpack::parallel::Communicator p_comm;
+};
+
+} // benchmark
+} // gridpack
+#endif
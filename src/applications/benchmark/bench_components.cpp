@@ -0,0 +1,301 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   bench_components.cpp
+ *
+ * @brief  Bus and branch components used by the scaling benchmark.
+ *
+ *
+ */
+// -------------------------------------------------------------
+
+#include <vector>
+#include <iostream>
+
+#include "bench_components.hpp"
+
+/**
+ *  Simple constructor
+ */
+gridpack::benchmark::BenchBus::BenchBus(void)
+{
+  p_lead = false;
+  p_v = 0.0;
+  p_voltage = &p_v;
+}
+
+/**
+ *  Simple destructor
+ */
+gridpack::benchmark::BenchBus::~BenchBus(void)
+{
+}
+
+/**
+ * Load values stored in DataCollection object into BenchBus object
+ * @param data: DataCollection object contain parameters relevant to this
+ *       bus that were assigned when network was generated
+ */
+void gridpack::benchmark::BenchBus::load(const
+         boost::shared_ptr<gridpack::component::DataCollection> &data)
+{
+  int type;
+  data->getValue(BUS_TYPE,&type);
+  if (type == 2) {
+    p_lead = true;
+    data->getValue(BUS_BASEKV,&p_v);
+  }
+}
+
+/**
+ * Is bus attached to external voltage
+ * @return true if voltage is fixed
+ */
+bool gridpack::benchmark::BenchBus::isLead() const
+{
+  return p_lead;
+}
+
+/**
+ * Return value of voltage at bus
+ * @return voltage
+ */
+double gridpack::benchmark::BenchBus::voltage() const
+{
+  return *p_voltage;
+}
+
+/**
+ * Return size of matrix block on the diagonal contributed by component
+ * @param isize, jsize: number of rows and columns of matrix block
+ * @return: false if network component does not contribute matrix
+ *        element
+ */
+bool gridpack::benchmark::BenchBus::matrixDiagSize(int *isize, int *jsize) const
+{
+  if (!p_lead) {
+    *isize = 1;
+    *jsize = 1;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+/**
+ * Return the values of for a diagonal matrix block. The values are
+ * returned in row-major order
+ * @param values: pointer to matrix block values
+ * @return: false if network component does not contribute
+ *        matrix element
+ */
+bool gridpack::benchmark::BenchBus::matrixDiagValues(ComplexType *values)
+{
+  if (!p_lead) {
+    gridpack::ComplexType ret(0.0,0.0);
+    std::vector<boost::shared_ptr<BaseComponent> > branches;
+    getNeighborBranches(branches);
+    int size = branches.size();
+    int i;
+    for (i=0; i<size; i++) {
+      gridpack::benchmark::BenchBranch *branch
+        = dynamic_cast<gridpack::benchmark::BenchBranch*>(branches[i].get());
+      ret += 1.0/branch->resistance();
+    }
+    values[0] = ret;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+/**
+ * Return size of vector block contributed by component
+ * @param isize: number of vector elements
+ * @return: false if network component does not contribute
+ *        vector element
+ */
+bool gridpack::benchmark::BenchBus::vectorSize(int *isize) const
+{
+  if (!p_lead) {
+    *isize = 1;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+/**
+ * Return the values of the vector block
+ * @param values: pointer to vector values
+ * @return: false if network component does not contribute
+ *        vector element
+ */
+bool gridpack::benchmark::BenchBus::vectorValues(ComplexType *values)
+{
+  if (!p_lead) {
+    std::vector<boost::shared_ptr<BaseComponent> > branches;
+    getNeighborBranches(branches);
+    int size = branches.size();
+    int i;
+    gridpack::ComplexType ret(0.0,0.0);
+    for (i=0; i<size; i++) {
+      gridpack::benchmark::BenchBranch *branch
+        = dynamic_cast<gridpack::benchmark::BenchBranch*>(branches[i].get());
+      gridpack::benchmark::BenchBus *bus1
+        = dynamic_cast<gridpack::benchmark::BenchBus*>(branch->getBus1().get());
+      gridpack::benchmark::BenchBus *bus2
+        = dynamic_cast<gridpack::benchmark::BenchBus*>(branch->getBus2().get());
+      if (bus1 != this && bus1->isLead()) {
+        ret += bus1->voltage()/branch->resistance();
+      } else if (bus2 != this && bus2->isLead()) {
+        ret += bus2->voltage()/branch->resistance();
+      }
+    }
+    values[0] = ret;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+/**
+ * Set the internal value of the voltage. Need this function to push
+ * values from vectors back onto buses
+ * @param values array containing voltage
+ */
+void gridpack::benchmark::BenchBus::setValues(gridpack::ComplexType *values)
+{
+  if (!p_lead) {
+    *p_voltage = real(values[0]);
+  }
+}
+
+/**
+ * Write output from buses to standard out
+ * @param string (output) string with information to be printed out
+ * @param bufsize size of string buffer in bytes
+ * @param signal an optional character string to signal to this
+ * routine what about kind of information to write
+ * @return true if bus is contributing string to output, false otherwise
+ */
+bool gridpack::benchmark::BenchBus::serialWrite(char *string,
+    const int bufsize, const char *signal)
+{
+  sprintf(string,"%8d %12.6f\n",getOriginalIndex(),*p_voltage);
+  return true;
+}
+
+/**
+ * Return size of pointer needed for exchange buffer on buses
+ */
+int gridpack::benchmark::BenchBus::getXCBufSize()
+{
+  return sizeof(double);
+}
+
+/**
+ * Assign buffer to internal pointer in bus
+ */
+void gridpack::benchmark::BenchBus::setXCBuf(void *buf)
+{
+  p_voltage = static_cast<double*>(buf);
+  *p_voltage = p_v;
+}
+
+/**
+ *  Simple constructor
+ */
+gridpack::benchmark::BenchBranch::BenchBranch(void)
+{
+  p_resistance = 0.0;
+}
+
+/**
+ *  Simple destructor
+ */
+gridpack::benchmark::BenchBranch::~BenchBranch(void)
+{
+}
+
+/**
+ * Load values stored in DataCollection object into BenchBranch object
+ * @param data: DataCollection object contain parameters relevant to this
+ *       branch that were assigned when network was generated
+ */
+void gridpack::benchmark::BenchBranch::load(
+    const boost::shared_ptr<gridpack::component::DataCollection> &data)
+{
+  data->getValue(BRANCH_R,&p_resistance,0);
+}
+
+/**
+ * Return resistance of this branch
+ * @return resistance
+ */
+double gridpack::benchmark::BenchBranch::resistance(void) const
+{
+  return p_resistance;
+}
+
+/**
+ * Are both ends of the branch free (not attached to a lead)?
+ * @return true if branch contributes to the matrix
+ */
+bool gridpack::benchmark::BenchBranch::interior(void) const
+{
+  gridpack::benchmark::BenchBus *bus1
+    = dynamic_cast<gridpack::benchmark::BenchBus*>(getBus1().get());
+  gridpack::benchmark::BenchBus *bus2
+    = dynamic_cast<gridpack::benchmark::BenchBus*>(getBus2().get());
+  return (!bus1->isLead() && !bus2->isLead());
+}
+
+/**
+ * Return size of off-diagonal matrix block contributed by the component
+ * for the forward/reverse directions
+ * @param isize, jsize: number of rows and columns of matrix block
+ * @return: false if network component does not contribute matrix element
+ */
+bool gridpack::benchmark::BenchBranch::matrixForwardSize(int *isize,
+    int *jsize) const
+{
+  if (interior()) {
+    *isize = 1;
+    *jsize = 1;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+bool gridpack::benchmark::BenchBranch::matrixReverseSize(int *isize,
+    int *jsize) const
+{
+  return matrixForwardSize(isize, jsize);
+}
+
+/**
+ * Return the values of the forward/reverse matrix block. The values are
+ * returned in row-major order
+ * @param values: pointer to matrix block values
+ * @return: false if network component does not contribute matrix element
+ */
+bool gridpack::benchmark::BenchBranch::matrixForwardValues(ComplexType *values)
+{
+  if (interior()) {
+    values[0] = -1.0/p_resistance;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+bool gridpack::benchmark::BenchBranch::matrixReverseValues(ComplexType *values)
+{
+  return matrixForwardValues(values);
+}
@@ -0,0 +1,212 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   bench_components.hpp
+ *
+ * @brief
+ * Bus and branch components used by the scaling benchmark. These
+ * describe a resistor network (as in the resistor_grid example) so
+ * that every core phase (mapping, exchange, solve, output) has some
+ * work to do.
+ *
+ */
+// -------------------------------------------------------------
+
+#ifndef _bench_components_h_
+#define _bench_components_h_
+
+#include "boost/smart_ptr/shared_ptr.hpp"
+#include "gridpack/include/gridpack.hpp"
+
+namespace gridpack {
+namespace benchmark {
+
+class BenchBus
+  : public gridpack::component::BaseBusComponent {
+  public:
+    /**
+     *  Simple constructor
+     */
+    BenchBus(void);
+
+    /**
+     *  Simple destructor
+     */
+    ~BenchBus(void);
+
+    /**
+     * Load values stored in DataCollection object into BenchBus object
+     * @param data: DataCollection object contain parameters relevant to this
+     *       bus that were assigned when network was generated
+     */
+    void load(const boost::shared_ptr<gridpack::component::DataCollection> &data);
+
+    /**
+     * Is bus attached to external voltage
+     * @return true if voltage is fixed
+     */
+    bool isLead() const;
+
+    /**
+     * Return value of voltage at bus
+     * @return voltage
+     */
+    double voltage() const;
+
+    /**
+     * Return size of matrix block on the diagonal contributed by component
+     * @param isize, jsize: number of rows and columns of matrix block
+     * @return: false if network component does not contribute matrix
+     *        element
+     */
+    bool matrixDiagSize(int *isize, int *jsize) const;
+
+    /**
+     * Return the values of for a diagonal matrix block. The values are
+     * returned in row-major order
+     * @param values: pointer to matrix block values
+     * @return: false if network component does not contribute
+     *        matrix element
+     */
+    bool matrixDiagValues(ComplexType *values);
+
+    /**
+     * Return size of vector block contributed by component
+     * @param isize: number of vector elements
+     * @return: false if network component does not contribute
+     *        vector element
+     */
+    bool vectorSize(int *isize) const;
+
+    /**
+     * Return the values of the vector block
+     * @param values: pointer to vector values
+     * @return: false if network component does not contribute
+     *        vector element
+     */
+    bool vectorValues(ComplexType *values);
+
+    /**
+     * Set the internal value of the voltage. Need this function to push
+     * values from vectors back onto buses
+     * @param values array containing voltage
+     */
+    void setValues(gridpack::ComplexType *values);
+
+    /**
+     * Write output from buses to standard out
+     * @param string (output) string with information to be printed out
+     * @param bufsize size of string buffer in bytes
+     * @param signal an optional character string to signal to this
+     * routine what about kind of information to write
+     * @return true if bus is contributing string to output, false otherwise
+     */
+    bool serialWrite(char *string, const int bufsize, const char *signal = NULL);
+
+    /**
+     * Return size of pointer needed for exchange buffer on buses
+     */
+    int getXCBufSize();
+
+    /**
+     * Assign buffer to internal pointer in bus
+     */
+    void setXCBuf(void *buf);
+
+  private:
+    bool p_lead;
+    double *p_voltage;
+    double p_v;
+
+  friend class boost::serialization::access;
+
+  template<class Archive>
+  void serialize(Archive & ar, const unsigned int version)
+  {
+    ar & boost::serialization::base_object<gridpack::component::BaseBusComponent>(*this)
+      & p_lead & p_v;
+  }
+
+};
+
+class BenchBranch
+  : public gridpack::component::BaseBranchComponent {
+  public:
+    /**
+     *  Simple constructor
+     */
+    BenchBranch(void);
+
+    /**
+     *  Simple destructor
+     */
+    ~BenchBranch(void);
+
+    /**
+     * Load values stored in DataCollection object into BenchBranch object
+     * @param data: DataCollection object contain parameters relevant to this
+     *       branch that were assigned when network was generated
+     */
+    void load(const boost::shared_ptr<gridpack::component::DataCollection> &data);
+
+    /**
+     * Return resistance of this branch
+     * @return resistance
+     */
+    double resistance(void) const;
+
+    /**
+     * Return size of off-diagonal matrix block contributed by the component
+     * for the forward/reverse directions
+     * @param isize, jsize: number of rows and columns of matrix block
+     * @return: false if network component does not contribute matrix element
+     */
+    bool matrixForwardSize(int *isize, int *jsize) const;
+    bool matrixReverseSize(int *isize, int *jsize) const;
+
+    /**
+     * Return the values of the forward/reverse matrix block. The values are
+     * returned in row-major order
+     * @param values: pointer to matrix block values
+     * @return: false if network component does not contribute matrix element
+     */
+    bool matrixForwardValues(ComplexType *values);
+    bool matrixReverseValues(ComplexType *values);
+
+  private:
+    /**
+     * Are both ends of the branch free (not attached to a lead)?
+     * @return true if branch contributes to the matrix
+     */
+    bool interior(void) const;
+
+    double p_resistance;
+
+  friend class boost::serialization::access;
+
+  template<class Archive>
+  void serialize(Archive & ar, const unsigned int version)
+  {
+    ar & boost::serialization::base_object<gridpack::component::BaseBranchComponent>(*this)
+      & p_resistance;
+  }
+
+};
+
+
+/// The type of network used in the benchmark
+typedef network::BaseNetwork<BenchBus, BenchBranch > BenchNetwork;
+
+
+}     // benchmark
+}     // gridpack
+
+BOOST_CLASS_EXPORT_KEY(gridpack::benchmark::BenchBus)
+BOOST_CLASS_EXPORT_KEY(gridpack::benchmark::BenchBranch)
+
+
+#endif
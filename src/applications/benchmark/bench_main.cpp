@@ -0,0 +1,32 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   bench_main.cpp
+ *
+ * @brief  Driver for the GridPACK scaling benchmark.
+ *
+ *
+ */
+// -------------------------------------------------------------
+
+#include "gridpack/include/gridpack.hpp"
+#include "bench_app.hpp"
+
+const char* help = "GridPACK scaling benchmark";
+
+// Calling program for the scaling benchmark
+
+int
+main(int argc, char **argv)
+{
+  gridpack::Environment env(argc, argv, help);
+
+  gridpack::benchmark::BenchApp app;
+  app.execute(argc, argv);
+
+  return 0;
+}
@@ -0,0 +1,255 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   bench_network_generator.hpp
+ *
+ * @brief
+ * Generate synthetic networks of arbitrary size directly into a
+ * BaseNetwork. Each process generates a contiguous block of buses and
+ * the branches that originate at those buses, so no process ever holds
+ * the complete network and no input file is read. The result can be
+ * partitioned with BaseNetwork::partition() like a parsed network.
+ *
+ */
+// -------------------------------------------------------------
+
+#ifndef _bench_network_generator_h_
+#define _bench_network_generator_h_
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "boost/smart_ptr/shared_ptr.hpp"
+#include "gridpack/parser/dictionary.hpp"
+#include "gridpack/utilities/exception.hpp"
+
+namespace gridpack {
+namespace benchmark {
+
+template <class _network>
+class SyntheticNetworkGenerator
+{
+  public:
+
+    /// Supported network topologies
+    enum Topology {
+      /// Square two-dimensional grid
+      GRID,
+      /// Tree with a fixed branching factor
+      TREE,
+      /// Square grid with additional long-range branches
+      MESHED
+    };
+
+    /**
+     * Constructor
+     * @param network network that will receive the generated buses and
+     *        branches
+     */
+    SyntheticNetworkGenerator(boost::shared_ptr<_network> network)
+      : p_network(network), p_topology(GRID), p_treeBranching(3),
+        p_meshStride(10), p_numBranches(0)
+    {
+    }
+
+    /**
+     * Destructor
+     */
+    ~SyntheticNetworkGenerator()
+    {
+    }
+
+    /**
+     * Set topology of generated network from a string
+     * @param name one of "grid", "tree", "meshed"
+     */
+    void setTopology(const std::string &name)
+    {
+      if (name == "grid") {
+        p_topology = GRID;
+      } else if (name == "tree") {
+        p_topology = TREE;
+      } else if (name == "meshed") {
+        p_topology = MESHED;
+      } else {
+        char buf[256];
+        sprintf(buf,"SyntheticNetworkGenerator::setTopology: unknown"
+            " topology: %s\n",name.c_str());
+        throw gridpack::Exception(buf);
+      }
+    }
+
+    /**
+     * Set number of children of each bus in a tree network
+     * @param nchild branching factor
+     */
+    void setTreeBranching(int nchild)
+    {
+      if (nchild > 0) p_treeBranching = nchild;
+    }
+
+    /**
+     * Set how often a long-range branch is added in a meshed network
+     * @param stride every stride-th bus gets an extra branch
+     */
+    void setMeshStride(int stride)
+    {
+      if (stride > 0) p_meshStride = stride;
+    }
+
+    /**
+     * Generate a network with the requested number of buses. This
+     * must be called on all processes. The first and last buses are
+     * leads held at fixed voltages of 1 and 0, respectively.
+     * @param nbus total number of buses in the network
+     */
+    void generate(int nbus)
+    {
+      if (nbus < 2) nbus = 2;
+      p_nbus = nbus;
+      p_nx = static_cast<int>(ceil(sqrt(static_cast<double>(nbus))));
+      int me = p_network->communicator().rank();
+      int nprocs = p_network->communicator().size();
+      int lo = static_cast<int>((static_cast<long>(nbus)*me)/nprocs);
+      int hi = static_cast<int>((static_cast<long>(nbus)*(me+1))/nprocs);
+
+      // Find global branch offset for this process
+      int i, j;
+      std::vector<int> targets;
+      int nbranch = 0;
+      for (i=lo; i<hi; i++) {
+        branchTargets(i,targets);
+        nbranch += targets.size();
+      }
+      std::vector<int> counts(nprocs,0);
+      counts[me] = nbranch;
+      p_network->communicator().sum(&counts[0],nprocs);
+      int offset = 0;
+      p_numBranches = 0;
+      for (i=0; i<nprocs; i++) {
+        if (i < me) offset += counts[i];
+        p_numBranches += counts[i];
+      }
+
+      // Add buses. Original indices start at 1, as in most input files
+      int lbus = 0;
+      for (i=lo; i<hi; i++) {
+        p_network->addBus(i+1);
+        p_network->setGlobalBusIndex(lbus,i);
+        boost::shared_ptr<gridpack::component::DataCollection>
+          data = p_network->getBusData(lbus);
+        data->addValue(BUS_NUMBER,i+1);
+        if (i == 0) {
+          data->addValue(BUS_TYPE,2);
+          data->addValue(BUS_BASEKV,1.0);
+        } else if (i == nbus-1) {
+          data->addValue(BUS_TYPE,2);
+          data->addValue(BUS_BASEKV,0.0);
+        } else {
+          data->addValue(BUS_TYPE,1);
+          data->addValue(BUS_BASEKV,0.0);
+        }
+        // Generator, load and bus fields of a typical parsed bus, so that
+        // the data footprint resembles that of a network read from a
+        // file
+        char name[32];
+        sprintf(name,"BUS%d",i+1);
+        data->addValue(BUS_NAME,name);
+        data->addValue(BUS_AREA,1);
+        data->addValue(BUS_ZONE,1);
+        data->addValue(BUS_VOLTAGE_MAG,1.0);
+        data->addValue(BUS_VOLTAGE_ANG,0.0);
+        data->addValue(GENERATOR_NUMBER,1);
+        data->addValue(GENERATOR_ID,"1",0);
+        data->addValue(GENERATOR_STAT,1,0);
+        data->addValue(GENERATOR_PG,1.0,0);
+        data->addValue(GENERATOR_QG,0.0,0);
+        data->addValue(GENERATOR_QMAX,1.0,0);
+        data->addValue(GENERATOR_QMIN,-1.0,0);
+        data->addValue(GENERATOR_PMAX,2.0,0);
+        data->addValue(GENERATOR_VS,1.0,0);
+        data->addValue(GENERATOR_MBASE,100.0,0);
+        data->addValue(LOAD_NUMBER,1);
+        data->addValue(LOAD_ID,"1",0);
+        data->addValue(LOAD_STATUS,1,0);
+        data->addValue(LOAD_PL,1.0,0);
+        data->addValue(LOAD_QL,0.5,0);
+        lbus++;
+      }
+
+      // Add branches
+      int lbranch = 0;
+      for (i=lo; i<hi; i++) {
+        branchTargets(i,targets);
+        for (j=0; j<targets.size(); j++) {
+          int to = targets[j];
+          p_network->addBranch(i+1,to+1);
+          p_network->setGlobalBranchIndex(lbranch,offset+lbranch);
+          boost::shared_ptr<gridpack::component::DataCollection>
+            data = p_network->getBranchData(lbranch);
+          data->addValue(BRANCH_FROMBUS,i+1);
+          data->addValue(BRANCH_TOBUS,to+1);
+          data->addValue(BRANCH_NUM_ELEMENTS,1);
+          data->addValue(BRANCH_R,1.0+0.1*static_cast<double>((i+to)%7),0);
+          lbranch++;
+        }
+      }
+    }
+
+    /**
+     * Total number of branches in the last generated network
+     * @return number of branches
+     */
+    int numBranches(void) const
+    {
+      return p_numBranches;
+    }
+
+  private:
+
+    /**
+     * Find the buses that are connected to bus idx by branches that
+     * originate at idx. Every branch is generated exactly once.
+     * @param idx global index of bus
+     * @param targets global indices of buses at the other end
+     */
+    void branchTargets(int idx, std::vector<int> &targets) const
+    {
+      targets.clear();
+      if (p_topology == TREE) {
+        // Connect each bus to its parent
+        if (idx > 0) targets.push_back((idx-1)/p_treeBranching);
+        return;
+      }
+      int ix = idx%p_nx;
+      if (ix+1 < p_nx && idx+1 < p_nbus) targets.push_back(idx+1);
+      if (idx+p_nx < p_nbus) targets.push_back(idx+p_nx);
+      if (p_topology == MESHED && idx%p_meshStride == 0) {
+        // Add a long-range branch to a pseudo-random bus roughly half
+        // way across the network. Only connect to higher indices so
+        // the same pair is never generated twice.
+        unsigned long hash = static_cast<unsigned long>(idx)*2654435761UL;
+        int to = static_cast<int>((static_cast<unsigned long>(idx)
+              + p_nbus/2 + hash%p_nx)%p_nbus);
+        if (to > idx+1 && to != idx+p_nx) targets.push_back(to);
+      }
+    }
+
+    boost::shared_ptr<_network> p_network;
+    Topology p_topology;
+    int p_treeBranching;
+    int p_meshStride;
+    int p_nbus;
+    int p_nx;
+    int p_numBranches;
+};
+
+}     // benchmark
+}     // gridpack
+
+#endif
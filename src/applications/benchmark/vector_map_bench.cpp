@@ -0,0 +1,252 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   vector_map_bench.cpp
+ *
+ * @brief
+ * Microbenchmark for moving bus values into and out of a vector with
+ * BusVectorMap. Each bus contributes several values with trivial
+ * cost so that the timing is dominated by the mapper itself. The
+ * mapper is compared with the index list path (pack a buffer, then
+ * addElements/getElements) that it used previously.
+ *
+ */
+// -------------------------------------------------------------
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "gridpack/include/gridpack.hpp"
+#include "bench_network_generator.hpp"
+
+const char* help = "GridPACK bus vector mapper microbenchmark";
+
+namespace gridpack {
+namespace benchmark {
+
+// Bus with a fixed number of state values, similar to a bus in a
+// dynamic simulation
+class MapBus
+  : public gridpack::component::BaseBusComponent {
+  public:
+    MapBus(void) : p_nvals(1) {}
+
+    ~MapBus(void) {}
+
+    void setNumValues(int nvals)
+    {
+      p_nvals = nvals;
+      p_state.assign(nvals, gridpack::ComplexType(0.0,0.0));
+      int i;
+      for (i=0; i<nvals; i++) {
+        p_state[i] = gridpack::ComplexType(static_cast<double>(i+1),0.0);
+      }
+    }
+
+    bool vectorSize(int *isize) const
+    {
+      *isize = p_nvals;
+      return true;
+    }
+
+    bool vectorValues(gridpack::ComplexType *values)
+    {
+      int i;
+      for (i=0; i<p_nvals; i++) values[i] = p_state[i];
+      return true;
+    }
+
+    void setValues(gridpack::ComplexType *values)
+    {
+      int i;
+      for (i=0; i<p_nvals; i++) p_state[i] = values[i];
+    }
+
+    double checksum(void) const
+    {
+      double ret = 0.0;
+      int i;
+      for (i=0; i<p_nvals; i++) ret += real(p_state[i]);
+      return ret;
+    }
+
+  private:
+    int p_nvals;
+    std::vector<gridpack::ComplexType> p_state;
+
+    friend class boost::serialization::access;
+
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int version)
+    {
+      ar & boost::serialization::base_object<BaseBusComponent>(*this);
+    }
+};
+
+class MapBranch
+  : public gridpack::component::BaseBranchComponent {
+  public:
+    MapBranch(void) {}
+    ~MapBranch(void) {}
+
+  private:
+    friend class boost::serialization::access;
+
+    template<class Archive>
+    void serialize(Archive & ar, const unsigned int version)
+    {
+      ar & boost::serialization::base_object<BaseBranchComponent>(*this);
+    }
+};
+
+typedef gridpack::network::BaseNetwork<MapBus, MapBranch> MapNetwork;
+
+}   // benchmark
+}   // gridpack
+
+BOOST_CLASS_EXPORT(gridpack::benchmark::MapBus)
+BOOST_CLASS_EXPORT(gridpack::benchmark::MapBranch)
+
+/**
+ * Synchronize all processes and return current time
+ * @param comm communicator for benchmark
+ * @return current wall clock time
+ */
+static double startTime(const gridpack::parallel::Communicator &comm)
+{
+  comm.barrier();
+  return gridpack::utility::CoarseTimer::instance()->currentTime();
+}
+
+/**
+ * Print maximum time per call over all processes
+ * @param comm communicator for benchmark
+ * @param name name of operation
+ * @param start time returned by startTime
+ * @param calls number of calls
+ */
+static double report(const gridpack::parallel::Communicator &comm,
+    const char *name, double start, int calls)
+{
+  double elapsed =
+    gridpack::utility::CoarseTimer::instance()->currentTime() - start;
+  comm.max(&elapsed,1);
+  elapsed /= static_cast<double>(calls);
+  if (comm.rank() == 0) {
+    printf("  %-32s %14.6e\n",name,elapsed);
+  }
+  return elapsed;
+}
+
+int
+main(int argc, char **argv)
+{
+  gridpack::Environment env(argc, argv, help);
+  gridpack::parallel::Communicator world;
+  {
+    gridpack::utility::Configuration *config =
+      gridpack::utility::Configuration::configuration();
+    if (argc >= 2 && argv[1] != NULL) {
+      config->open(argv[1],world);
+    } else {
+      config->open("input.xml",world);
+    }
+    gridpack::utility::Configuration::CursorPtr cursor;
+    cursor = config->getCursor("Configuration.VectorMapBenchmark");
+    int nbus = cursor->get("buses",100000);
+    int nvals = cursor->get("valuesPerBus",4);
+    int reps = cursor->get("repetitions",20);
+    if (reps < 1) reps = 1;
+
+    typedef gridpack::benchmark::MapNetwork MapNetwork;
+    boost::shared_ptr<MapNetwork> network(new MapNetwork(world));
+    gridpack::benchmark::SyntheticNetworkGenerator<MapNetwork>
+      generator(network);
+    generator.generate(nbus);
+    network->partition();
+    int i, j;
+    for (i=0; i<network->numBuses(); i++) {
+      network->getBus(i)->setNumValues(nvals);
+    }
+
+    if (world.rank() == 0) {
+      printf("\nBus vector mapper: %d buses, %d values per bus,"
+          " %d processes\n\n",nbus,nvals,world.size());
+      printf("  %-32s %14s\n","Operation","Max/call (s)");
+    }
+
+    double t;
+    gridpack::mapper::BusVectorMap<MapNetwork> vMap(network);
+    boost::shared_ptr<gridpack::math::Vector> X = vMap.mapToVector();
+
+    // Reference: pack values into a new buffer and add them to the
+    // vector using an explicit index list
+    int nloc = 0;
+    std::vector<gridpack::benchmark::MapBus*> buses;
+    for (i=0; i<network->numBuses(); i++) {
+      if (network->getActiveBus(i)) {
+        buses.push_back(network->getBus(i).get());
+        nloc += nvals;
+      }
+    }
+    int lo, hi;
+    X->localIndexRange(lo, hi);
+    t = startTime(world);
+    for (j=0; j<reps; j++) {
+      gridpack::ComplexType *vbuf = new gridpack::ComplexType[nloc];
+      int *ibuf = new int[nloc];
+      for (i=0; i<buses.size(); i++) buses[i]->vectorValues(vbuf+i*nvals);
+      for (i=0; i<nloc; i++) ibuf[i] = lo+i;
+      X->zero();
+      X->addElements(nloc,ibuf,vbuf);
+      X->ready();
+      delete [] vbuf;
+      delete [] ibuf;
+    }
+    double tref = report(world,"index list fill",t,reps);
+
+    t = startTime(world);
+    for (j=0; j<reps; j++) vMap.mapToVector(*X);
+    double tfill = report(world,"mapToVector (existing vector)",t,reps);
+
+    t = startTime(world);
+    for (j=0; j<reps; j++) {
+      gridpack::ComplexType *vbuf = new gridpack::ComplexType[nloc];
+      int *ibuf = new int[nloc];
+      for (i=0; i<nloc; i++) ibuf[i] = lo+i;
+      X->getElements(nloc,ibuf,vbuf);
+      for (i=0; i<buses.size(); i++) buses[i]->setValues(vbuf+i*nvals);
+      delete [] vbuf;
+      delete [] ibuf;
+    }
+    double tgref = report(world,"index list scatter",t,reps);
+
+    t = startTime(world);
+    for (j=0; j<reps; j++) vMap.mapToBus(*X);
+    double tscat = report(world,"mapToBus",t,reps);
+
+    // Values should survive the round trip unchanged
+    double sum = 0.0;
+    for (i=0; i<buses.size(); i++) sum += buses[i]->checksum();
+    world.sum(&sum,1);
+    double expected = 0.5*static_cast<double>(nvals*(nvals+1))
+      *static_cast<double>(nbus);
+    if (world.rank() == 0) {
+      if (tfill > 0.0 && tscat > 0.0) {
+        printf("\n  Fill speedup:    %8.2f\n",tref/tfill);
+        printf("  Scatter speedup: %8.2f\n",tgref/tscat);
+      }
+      if (fabs(sum-expected) > 1.0e-8*expected) {
+        printf("\nRound trip check failed: %f expected: %f\n",sum,expected);
+      } else {
+        printf("\nRound trip check passed\n");
+      }
+    }
+  }
+
+  return 0;
+}
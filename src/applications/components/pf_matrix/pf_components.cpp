@@ -41,6 +41,8 @@ gridpack::powerflow::PFBus::PFBus(void)
   p_theta = 0.0;
   p_angle = 0.0;
   p_voltage = 0.0;
+  p_save_v = 0.0;
+  p_save_a = 0.0;
   /*p_pl = 0.0;
   p_ql = 0.0;
   p_ip = 0.0;
@@ -96,6 +98,15 @@ bool gridpack::powerflow::PFBus::matrixDiagSize(int *isize, int *jsize) const
     }
   } else if (p_mode == YBus) {
     return YMBus::matrixDiagSize(isize,jsize);
+  } else if (p_mode == BPrime || p_mode == BDoublePrime) {
+    int size;
+    if (vectorSize(&size)) {
+      *isize = 1;
+      *jsize = 1;
+      return true;
+    } else {
+      return false;
+    }
   }
   return true;
 }
@@ -119,6 +130,11 @@ bool gridpack::powerflow::PFBus::matrixDiagValues(ComplexType *values)
     } else  {
       return true;
     }
+  } else if (p_mode == BPrime || p_mode == BDoublePrime) {
+    double rval;
+    if (diagonalFDValues(&rval) == 0) return false;
+    values[0] = rval;
+    return true;
   }
   return false;
 }
@@ -132,6 +148,9 @@ bool gridpack::powerflow::PFBus::matrixDiagValues(RealType *values)
     } else  {
       return true;
     }
+  } else if (p_mode == BPrime || p_mode == BDoublePrime) {
+    if (diagonalFDValues(values) == 0) return false;
+    return true;
   }
   return false;
 }
@@ -164,6 +183,12 @@ bool gridpack::powerflow::PFBus::vectorSize(int *size) const
     }
   } else if (p_mode == S_Cal){
     *size = 1;
+  } else if (p_mode == BPrime || p_mode == BPrimeIndex) {
+    if (isIsolated() || getReferenceBus()) return false;
+    *size = 1;
+  } else if (p_mode == BDoublePrime || p_mode == BDoublePrimeIndex) {
+    if (isIsolated() || getReferenceBus() || p_isPV) return false;
+    *size = 1;
   } else {
     *size = 2;
   }
@@ -197,6 +222,14 @@ bool gridpack::powerflow::PFBus::vectorValues(ComplexType *values)
     } else {
       return true;
     }
+  } else if (p_mode == BPrime || p_mode == BDoublePrime) {
+    double rval;
+    if (fdRHSValues(&rval) == 0) return false;
+    values[0] = rval;
+    return true;
+  } else if (p_mode == BPrimeIndex || p_mode == BDoublePrimeIndex) {
+    values[0] = static_cast<double>(getOriginalIndex());
+    return true;
   }
   return false;
 }
@@ -216,6 +249,14 @@ bool gridpack::powerflow::PFBus::vectorValues(RealType *values)
       return true;
     }
   }
+  if (p_mode == BPrime || p_mode == BDoublePrime) {
+    if (fdRHSValues(values) == 0) return false;
+    return true;
+  }
+  if (p_mode == BPrimeIndex || p_mode == BDoublePrimeIndex) {
+    values[0] = static_cast<double>(getOriginalIndex());
+    return true;
+  }
   return false;
 }
 
@@ -278,6 +319,7 @@ bool gridpack::powerflow::PFBus::chkQlim(void)
         }
       }
       if (p_PV_ptr) *p_PV_ptr = p_isPV;
+      markDirty();
       return true;
     } else if (qval < qmin) {
       printf("\nWarning: Gen(s) at bus %d exceeds the QMIN %8.3f vs %8.3f, converted to PQ bus\n", getOriginalIndex(),qval, qmin);  
@@ -299,6 +341,7 @@ bool gridpack::powerflow::PFBus::chkQlim(void)
       }
 
       if (p_PV_ptr) *p_PV_ptr = p_isPV;
+      markDirty();
       return true;
     } else {
        if (p_PV_ptr) *p_PV_ptr = p_isPV;
@@ -326,6 +369,7 @@ void gridpack::powerflow::PFBus::clearQlim()
   }
   p_isPV = p_save2isPV;
   if (p_PV_ptr) *p_PV_ptr = p_isPV;
+  markDirty();
 }
 
 
@@ -338,14 +382,20 @@ void gridpack::powerflow::PFBus::setValues(gridpack::ComplexType *values)
 {
   double vt = p_v;
   double at = p_a;
-  p_a -= real(values[0]);
+  if (p_mode == BPrime) {
+    p_a -= real(values[0]);
+  } else if (p_mode == BDoublePrime) {
+    p_v -= real(values[0]);
+  } else {
+    p_a -= real(values[0]);
 #ifdef LARGE_MATRIX
-  p_v -= real(values[1]);
-#else
-  if (!p_isPV) {
     p_v -= real(values[1]);
-  }
+#else
+    if (!p_isPV) {
+      p_v -= real(values[1]);
+    }
 #endif
+  }
   *p_vMag_ptr = p_v;
   double pi = 4.0*atan(1.0);
   if (p_a >= 0.0) {
@@ -359,14 +409,20 @@ void gridpack::powerflow::PFBus::setValues(gridpack::RealType *values)
 {
   double vt = p_v;
   double at = p_a;
-  p_a -= values[0];
+  if (p_mode == BPrime) {
+    p_a -= values[0];
+  } else if (p_mode == BDoublePrime) {
+    p_v -= values[0];
+  } else {
+    p_a -= values[0];
 #ifdef LARGE_MATRIX
-  p_v -= real(values[1]);
+    p_v -= real(values[1]);
 #else
-  if (!p_isPV) {
-    p_v -= values[1];
-  }
+    if (!p_isPV) {
+      p_v -= values[1];
+    }
 #endif
+  }
   *p_vMag_ptr = p_v;
   double pi = 4.0*atan(1.0);
   if (p_a >= 0.0) {
@@ -622,6 +678,40 @@ void gridpack::powerflow::PFBus::resetVoltage(void)
   }
 }
 
+/**
+ * Save current voltage and phase angle so that they can be used as
+ * the starting point of later calculations
+ */
+void gridpack::powerflow::PFBus::saveVoltage(void)
+{
+  p_save_v = p_v;
+  p_save_a = p_a;
+}
+
+/**
+ * Reset voltage and phase angle to values stored by saveVoltage. PV buses
+ * start from the same magnitude as in resetVoltage
+ */
+void gridpack::powerflow::PFBus::restoreVoltage(void)
+{
+  p_v = p_save_v;
+  p_a = p_save_a;
+  // The magnitude of a PV bus is fixed at its starting value. If the bus
+  // was switched to PQ by a Q limit check when its voltage was saved,
+  // the saved magnitude has drifted from the set point, so start from the
+  // same magnitude as resetVoltage
+  if (p_isPV) p_v = p_voltage;
+  if (p_vMag_ptr) *p_vMag_ptr = p_v;
+  if (p_vAng_ptr) {
+    double pi = 4.0*atan(1.0);
+    if (p_a >= 0.0) {
+      *p_vAng_ptr = fmod(p_a+pi,2.0*pi)-pi;
+    } else {
+      *p_vAng_ptr = fmod(p_a-pi,2.0*pi)+pi;
+    }
+  }
+}
+
 /**
  * Set voltage limits on bus
  * @param vmin lower value of voltage
@@ -728,6 +818,7 @@ void gridpack::powerflow::PFBus::setGenStatus(std::string gen_id, bool status)
         p_qmax[i] = p_qmax_orig[i];
         p_qmin[i] = p_qmin_orig[i];
       }
+      markDirty();
       return;
     }
   }
@@ -743,6 +834,7 @@ void gridpack::powerflow::PFBus::setIsPV(int status)
   p_isPV = status;
   if (p_PV_ptr) *p_PV_ptr = status;
   p_v = p_voltage;
+  markDirty();
 }
 
 /**
@@ -752,6 +844,7 @@ void gridpack::powerflow::PFBus::resetIsPV()
 {
   p_isPV = p_saveisPV;
   if (p_PV_ptr) *p_PV_ptr = p_saveisPV;
+  markDirty();
 }
 
 /**
@@ -1209,6 +1302,7 @@ void gridpack::powerflow::PFBus::setParam(std::string name, int busID,
           } else if (name == GENERATOR_QG) {
             p_qg[i] = value;
           }
+          markDirty();
         }
       }
     }
@@ -1232,6 +1326,7 @@ void gridpack::powerflow::PFBus::setParam(int busID,
        for (int i = 0; i < p_ngen; i++) {
          if (p_gid[i] == genID) {
            p_pg[i] += value;
+           markDirty();
          }
        }
      }
@@ -1470,6 +1565,64 @@ int gridpack::powerflow::PFBus::rhsValues(double *rvals)
   }
 }
 
+/**
+ * Evaluate diagonal element of the B' or B'' matrix of the fast
+ * decoupled solver, depending on the current mode
+ * @param rvals value of diagonal element
+ * @return number of values returned
+ */
+int gridpack::powerflow::PFBus::diagonalFDValues(double *rvals)
+{
+  int size;
+  if (!vectorSize(&size)) return 0;
+  if (p_mode == BPrime) {
+    std::vector<boost::shared_ptr<BaseComponent> > branches;
+    getNeighborBranches(branches);
+    int nbranch = branches.size();
+    int i;
+    double block[4];
+    rvals[0] = 0.0;
+    for (i=0; i<nbranch; i++) {
+      gridpack::powerflow::PFBranch *branch
+        = dynamic_cast<gridpack::powerflow::PFBranch*>(branches[i].get());
+      branch->getFDValues(BPrime, block);
+      if (branch->getBus1().get() == this) {
+        rvals[0] += block[0];
+      } else {
+        rvals[0] += block[3];
+      }
+    }
+    return 1;
+  } else if (p_mode == BDoublePrime) {
+    rvals[0] = -p_ybusi;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Evaluate real (BPrime mode) or reactive (BDoublePrime mode) power
+ * mismatch divided by the voltage magnitude for the fast decoupled
+ * solver
+ * @param rvals value of mismatch
+ * @return number of values returned
+ */
+int gridpack::powerflow::PFBus::fdRHSValues(double *rvals)
+{
+  int size;
+  if (!vectorSize(&size)) return 0;
+  double pq[2];
+  int nvals = rhsValues(pq);
+  if (p_mode == BPrime && nvals > 0) {
+    rvals[0] = pq[0]/p_v;
+    return 1;
+  } else if (p_mode == BDoublePrime && nvals > 1) {
+    rvals[0] = pq[1]/p_v;
+    return 1;
+  }
+  return 0;
+}
+
 /**
  * Get vector containing generator participation
  * @return vector of generator participation factors
@@ -1527,6 +1680,7 @@ void gridpack::powerflow::PFBus::scaleGeneratorRealPower(std::string tag,
         double slack = p_pg[i]-p_pb[i];
         p_pg[i] += value*slack;
       }
+      markDirty();
       break;
     }
   }
@@ -1570,6 +1724,7 @@ void gridpack::powerflow::PFBus::scaleLoadPower(std::string tag, double value)
     if (p_lid[i] == tag && p_lstatus[i] == 1) {
       p_pl[i] = value*p_pl[i];
       p_ql[i] = value*p_ql[i];
+      markDirty();
       break;
     }
   }
@@ -1589,6 +1744,7 @@ void gridpack::powerflow::PFBus::resetPower()
     p_pl[i] = p_savePl[i];
     p_ql[i] = p_saveQl[i];
   }
+  markDirty();
 }
 
 /**
@@ -1690,6 +1846,10 @@ gridpack::powerflow::PFBranch::PFBranch(void)
   p_theta = 0.0;
   p_sbase = 0.0;
   p_mode = YBus;
+  for (int i=0; i<4; i++) {
+    p_fd_bp[i] = 0.0;
+    p_fd_bpp[i] = 0.0;
+  }
 }
 
 /**
@@ -1748,6 +1908,14 @@ bool gridpack::powerflow::PFBranch::matrixForwardSize(int *isize, int *jsize) co
     }
   } else if (p_mode == YBus) {
     return YMBranch::matrixForwardSize(isize,jsize);
+  } else if (p_mode == BPrime || p_mode == BDoublePrime) {
+    if (fdContributes()) {
+      *isize = 1;
+      *jsize = 1;
+      return true;
+    } else {
+      return false;
+    }
   }
   return false;
 }
@@ -1794,6 +1962,14 @@ bool gridpack::powerflow::PFBranch::matrixReverseSize(int *isize, int *jsize) co
     }
   } else if (p_mode == YBus) {
     return YMBranch::matrixReverseSize(isize,jsize);
+  } else if (p_mode == BPrime || p_mode == BDoublePrime) {
+    if (fdContributes()) {
+      *isize = 1;
+      *jsize = 1;
+      return true;
+    } else {
+      return false;
+    }
   }
   return false;
 }
@@ -1817,6 +1993,12 @@ bool gridpack::powerflow::PFBranch::matrixForwardValues(ComplexType *values)
     }
   } else if (p_mode == YBus) {
     return YMBranch::matrixForwardValues(values);
+  } else if (p_mode == BPrime || p_mode == BDoublePrime) {
+    if (!fdContributes()) return false;
+    double block[4];
+    getFDValues(p_mode, block);
+    values[0] = block[1];
+    return true;
   }
   return false;
 }
@@ -1830,6 +2012,12 @@ bool gridpack::powerflow::PFBranch::matrixForwardValues(RealType *values)
     } else {
       return true;
     }
+  } else if (p_mode == BPrime || p_mode == BDoublePrime) {
+    if (!fdContributes()) return false;
+    double block[4];
+    getFDValues(p_mode, block);
+    values[0] = block[1];
+    return true;
   }
   return false;
 }
@@ -1847,6 +2035,12 @@ bool gridpack::powerflow::PFBranch::matrixReverseValues(ComplexType *values)
     }
   } else if (p_mode == YBus) {
     return YMBranch::matrixForwardValues(values);
+  } else if (p_mode == BPrime || p_mode == BDoublePrime) {
+    if (!fdContributes()) return false;
+    double block[4];
+    getFDValues(p_mode, block);
+    values[0] = block[2];
+    return true;
   }
   return false;
 }
@@ -1860,6 +2054,12 @@ bool gridpack::powerflow::PFBranch::matrixReverseValues(RealType *values)
     } else {
       return true;
     }
+  } else if (p_mode == BPrime || p_mode == BDoublePrime) {
+    if (!fdContributes()) return false;
+    double block[4];
+    getFDValues(p_mode, block);
+    values[0] = block[2];
+    return true;
   }
   return false;
 }
@@ -2502,3 +2702,105 @@ int gridpack::powerflow::PFBranch::reverseJacobianValues(double *rvals)
     return 0;
   }
 }
+
+/**
+ * Return the contribution of the branch to the B' or B'' matrix of the
+ * fast decoupled solver as a 2x2 block in row-major order. The first
+ * row and column correspond to bus 1. B' only includes the series
+ * reactance of the line elements, B'' is the imaginary part of the
+ * admittance matrix
+ * @param mode BPrime or BDoublePrime
+ * @param values contribution to matrix
+ */
+void gridpack::powerflow::PFBranch::getFDValues(int mode, double *values)
+{
+  int i;
+  for (i=0; i<4; i++) values[i] = 0.0;
+  if (mode == BPrime) {
+    // XB scheme: B' ignores resistance, charging and off-nominal taps
+    double b = 0.0;
+    for (i=0; i<p_elems; i++) {
+      if (p_branch_status[i] && p_reactance[i] != 0.0) {
+        b += 1.0/p_reactance[i];
+      }
+    }
+    values[0] = b;
+    values[1] = -b;
+    values[2] = -b;
+    values[3] = b;
+  } else if (mode == BDoublePrime) {
+    gridpack::powerflow::PFBus *bus1 =
+      dynamic_cast<gridpack::powerflow::PFBus*>(getBus1().get());
+    gridpack::powerflow::PFBus *bus2 =
+      dynamic_cast<gridpack::powerflow::PFBus*>(getBus2().get());
+    gridpack::ComplexType adm = getAdmittance();
+    gridpack::ComplexType y11 = -adm - getTransformer(bus1) + getShunt(bus1);
+    gridpack::ComplexType y22 = -adm - getTransformer(bus2) + getShunt(bus2);
+    values[0] = -imag(y11);
+    values[1] = -p_ybusi_frwd;
+    values[2] = -p_ybusi_rvrs;
+    values[3] = -imag(y22);
+  }
+}
+
+/**
+ * Store the contribution of the branch to the B' or B'' matrix,
+ * depending on the current mode. This should be called when the matrix
+ * is factored
+ */
+void gridpack::powerflow::PFBranch::saveFDMatrix(void)
+{
+  if (p_mode == BPrime) {
+    getFDValues(BPrime, p_fd_bp);
+  } else if (p_mode == BDoublePrime) {
+    getFDValues(BDoublePrime, p_fd_bpp);
+  }
+}
+
+/**
+ * Return the change in the contribution of the branch to the B' or B''
+ * matrix, depending on the current mode, since saveFDMatrix was called
+ * @param values change in contribution as a 2x2 block
+ * @return false if the contribution has not changed
+ */
+bool gridpack::powerflow::PFBranch::getFDMatrixChange(double *values)
+{
+  double *saved;
+  if (p_mode == BPrime) {
+    saved = p_fd_bp;
+  } else if (p_mode == BDoublePrime) {
+    saved = p_fd_bpp;
+  } else {
+    return false;
+  }
+  getFDValues(p_mode, values);
+  bool ret = false;
+  int i;
+  for (i=0; i<4; i++) {
+    values[i] -= saved[i];
+    if (fabs(values[i]) > 1.0e-12) ret = true;
+  }
+  return ret;
+}
+
+/**
+ * Return true if branch contributes off-diagonal elements to the B' or
+ * B'' matrix in the current mode
+ */
+bool gridpack::powerflow::PFBranch::fdContributes(void) const
+{
+  gridpack::powerflow::PFBus *bus1
+    = dynamic_cast<gridpack::powerflow::PFBus*>(getBus1().get());
+  gridpack::powerflow::PFBus *bus2
+    = dynamic_cast<gridpack::powerflow::PFBus*>(getBus2().get());
+  bool ok = !bus1->getReferenceBus();
+  ok = ok && !bus2->getReferenceBus();
+  ok = ok && !bus1->isIsolated();
+  ok = ok && !bus2->isIsolated();
+  ok = ok && (p_active);
+  if (p_mode == BDoublePrime) {
+    ok = ok && !bus1->isPV();
+    ok = ok && !bus2->isPV();
+  }
+  return ok;
+}
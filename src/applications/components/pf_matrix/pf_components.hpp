@@ -27,7 +27,12 @@
 namespace gridpack {
 namespace powerflow {
 
-enum PFMode{YBus, Jacobian, RHS, S_Cal, State};
+// BPrime and BDoublePrime build the B' and B'' matrices and the scaled
+// real and reactive power mismatches used by the fast decoupled solver.
+// BPrimeIndex and BDoublePrimeIndex build vectors with the same layout that
+// contain the original index of the bus contributing each element
+enum PFMode{YBus, Jacobian, RHS, S_Cal, State, BPrime, BDoublePrime,
+  BPrimeIndex, BDoublePrimeIndex};
 
 class PFBus
   : public gridpack::ymatrix::YMBus
@@ -132,6 +137,18 @@ class PFBus
      */
     void resetVoltage(void);
 
+    /**
+     * Save current voltage and phase angle so that they can be used as
+     * the starting point of later calculations
+     */
+    void saveVoltage(void);
+
+    /**
+     * Reset voltage and phase angle to values stored by saveVoltage. PV
+     * buses start from the same magnitude as in resetVoltage
+     */
+    void restoreVoltage(void);
+
     /**
      * Set voltage limits on bus
      * @param vmin lower value of voltage
@@ -330,6 +347,23 @@ class PFBus
      */
     int rhsValues(double *rvals);
 
+    /**
+     * Evaluate diagonal element of the B' or B'' matrix of the fast
+     * decoupled solver, depending on the current mode
+     * @param rvals value of diagonal element
+     * @return number of values returned
+     */
+    int diagonalFDValues(double *rvals);
+
+    /**
+     * Evaluate real (BPrime mode) or reactive (BDoublePrime mode) power
+     * mismatch divided by the voltage magnitude for the fast decoupled
+     * solver
+     * @param rvals value of mismatch
+     * @return number of values returned
+     */
+    int fdRHSValues(double *rvals);
+
     /**
      * Push p_isPV values from exchange buffer to p_isPV variable
      */
@@ -434,6 +468,7 @@ class PFBus
     double p_P0, p_Q0; //double p_sbusr, p_sbusi;
     double p_angle;   // initial bus angle read from parser
     double p_voltage; // initial bus voltage read from parser
+    double p_save_v, p_save_a; // voltage and angle stored by saveVoltage
     // newly added priavate variables:
     std::vector<double> p_pg, p_qg, p_pFac;
     std::vector<double> p_savePg;
@@ -495,6 +530,7 @@ private:
       & p_ybusr & p_ybusi
       & p_P0 & p_Q0
       & p_angle & p_voltage
+      & p_save_v & p_save_a
       & p_pg & p_qg & p_pFac & p_qmin & p_qmax
       & p_qmin_orig & p_qmax_orig & p_pFac_orig
       & p_gstatus
@@ -674,7 +710,40 @@ class PFBranch
     int forwardJacobianValues(double *rvals);
     int reverseJacobianValues(double *rvals);
 
+    /**
+     * Return the contribution of the branch to the B' or B'' matrix of the
+     * fast decoupled solver as a 2x2 block in row-major order. The first
+     * row and column correspond to bus 1. B' only includes the series
+     * reactance of the line elements, B'' is the imaginary part of the
+     * admittance matrix
+     * @param mode BPrime or BDoublePrime
+     * @param values contribution to matrix
+     */
+    void getFDValues(int mode, double *values);
+
+    /**
+     * Store the contribution of the branch to the B' or B'' matrix,
+     * depending on the current mode. This should be called when the matrix
+     * is factored
+     */
+    void saveFDMatrix(void);
+
+    /**
+     * Return the change in the contribution of the branch to the B' or B''
+     * matrix, depending on the current mode, since saveFDMatrix was called
+     * @param values change in contribution as a 2x2 block
+     * @return false if the contribution has not changed
+     */
+    bool getFDMatrixChange(double *values);
+
   private:
+
+    /**
+     * Return true if branch contributes off-diagonal elements to the B' or
+     * B'' matrix in the current mode
+     */
+    bool fdContributes(void) const;
+
     std::vector<bool> p_ignore;
     std::vector<double> p_reactance;
     std::vector<double> p_resistance;
@@ -698,6 +767,9 @@ class PFBranch
     double p_sbase;
     int p_elems;
     bool p_active;
+    // contributions to B' and B'' when the matrices were factored
+    double p_fd_bp[4];
+    double p_fd_bpp[4];
 
 private:
 
@@ -221,6 +221,7 @@ void gridpack::ymatrix::YMBus::setParam(std::string name, double value,
 {
   if (name==BUS_SHUNT_BL) {
     p_shunt_bs = value;
+    markDirty();
   }
 }
 
@@ -745,6 +746,7 @@ bool gridpack::ymatrix::YMBranch::setLineStatus(std::string tag,
       break;
     }
   }
+  if (found) p_markChanged();
   return found;
 }
 
@@ -782,6 +784,17 @@ void gridpack::ymatrix::YMBranch::setParam(std::string name, double value,
   } else if (name==BRANCH_SHIFT) {
     p_phase_shift[idx] = value;
   }
+  p_markChanged();
+}
+
+/**
+ * Mark the branch and the buses at either end of it as changed
+ */
+void gridpack::ymatrix::YMBranch::p_markChanged(void)
+{
+  markDirty();
+  if (getBus1()) getBus1()->markDirty();
+  if (getBus2()) getBus2()->markDirty();
 }
 
 #ifdef USE_ACOPF
@@ -308,6 +308,13 @@ class YMBranch
 #endif
 
   private:
+    /**
+     * Mark the branch and the buses at either end of it as changed. The
+     * admittance of a branch also contributes to the diagonal elements of
+     * both buses
+     */
+    void p_markChanged(void);
+
     std::vector<double> p_reactance;
     std::vector<double> p_resistance;
     std::vector<double> p_tap_ratio;
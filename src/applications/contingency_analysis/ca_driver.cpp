@@ -20,10 +20,15 @@
 
 #include "gridpack/include/gridpack.hpp"
 #include "gridpack/applications/modules/powerflow/pf_app_module.hpp"
+#include "gridpack/network/node_shared_network.hpp"
+#include "gridpack/parallel/result_sink.hpp"
 #include "ca_driver.hpp"
 
 #define USE_SUCCESS
 #define USE_STATBLOCK
+// Kinds of values stored in result records
+#define CA_RESULT_VMAG 0
+#define CA_RESULT_PERF 1
 // Sets up multiple communicators so that individual contingency calculations
 // can be run concurrently
 
@@ -204,6 +209,45 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
   if (!cursor->get("checkQLimit",&check_Qlim)) {
     check_Qlim = false;
   }
+  // Keep a single copy of the base case data on each node. This is only
+  // possible if each task runs on a single process
+  bool shared_base = cursor->get("sharedBaseCase",false);
+  if (shared_base && grp_size != 1) {
+    if (world.rank() == 0) {
+      printf("sharedBaseCase requires groupSize 1. Base case data will not"
+          " be shared\n");
+    }
+    shared_base = false;
+  }
+  // Start contingency calculations from the converged base case instead of
+  // the voltages in the network configuration file. If predictWarmStart is
+  // true, the base case voltages are also corrected for each contingency
+  // using the base case Jacobian
+  bool warm_start = cursor->get("warmStart",false);
+  bool predict = cursor->get("predictWarmStart",false);
+  if (predict) warm_start = true;
+  // If a result file is specified, a record for each contingency is sent to
+  // dedicated writer processes and written to a single indexed file instead
+  // of writing a separate output file for each contingency. The writers are
+  // removed from the world communicator used for the calculation
+  std::string result_file = cursor->get("resultFile",std::string(""));
+  boost::shared_ptr<gridpack::parallel::ResultSink> sink;
+  if (result_file != "") {
+    int nwriters = cursor->get("resultWriters",1);
+    sink.reset(new gridpack::parallel::ResultSink(world,nwriters,
+          result_file));
+    if (sink->isWriter()) {
+      sink->serve();
+      timer->stop(t_total);
+      return;
+    }
+    world = sink->computeCommunicator();
+    print_calcs = false;
+    if (world.rank() == 0) {
+      printf("Writing contingency results to %s on %d writer processes\n",
+          result_file.c_str(),sink->numWriters());
+    }
+  }
   gridpack::parallel::Communicator task_comm = world.divide(grp_size);
 
   // Keep track of failed calculations
@@ -215,14 +259,32 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
   gridpack::parallel::GlobalVector<int> ca_violation(world);
 #endif
 
-  // Create powerflow applications on each task communicator
+  // Create powerflow applications on each task communicator. The shared
+  // copy of the base case must be declared before the network so that it
+  // is released after it
+  boost::shared_ptr<gridpack::network::NodeSharedNetwork<
+    gridpack::powerflow::PFNetwork> > shared_network;
   boost::shared_ptr<gridpack::powerflow::PFNetwork>
     pf_network(new gridpack::powerflow::PFNetwork(task_comm));
   gridpack::powerflow::PFAppModule pf_app;
   // Read in the network from an external file and partition it over the
   // processors in the task communicator. This will read in power flow
   // parameters from the Powerflow block in the input
-  pf_app.readNetwork(pf_network,config);
+  if (shared_base) {
+    // Only one process on each node reads the network. The others build
+    // their networks from the copy in shared memory
+    shared_network.reset(new gridpack::network::NodeSharedNetwork<
+        gridpack::powerflow::PFNetwork>(world));
+    if (shared_network->isNodeLeader()) {
+      pf_app.readNetwork(pf_network,config);
+    }
+    shared_network->share(pf_network);
+    if (!shared_network->isNodeLeader()) {
+      pf_app.setNetwork(pf_network,config);
+    }
+  } else {
+    pf_app.readNetwork(pf_network,config);
+  }
   // Finish initializing the network
   pf_app.initialize();
   //  Set minimum and maximum voltage limits on all buses
@@ -238,6 +300,23 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
   // buses to ignore voltage violations on them.
   pf_app.ignoreVoltageViolations();
 
+  // Report memory used by network data on each node
+  if (shared_base) {
+    long priv = shared_network->nodeSum(pf_network->dataMemoryUsage());
+    long unshared = shared_network->nodeSum(shared_network->unsharedBytes());
+    int nnode = shared_network->nodeSize();
+    if (shared_network->isNodeLeader()) {
+      printf("Node with world rank %d: %d tasks of group size %d\n"
+          "  shared base case data: %ld bytes\n"
+          "  private data:          %ld bytes\n"
+          "  total:                 %ld bytes (%ld bytes without sharing)\n",
+          world.rank(),nnode,grp_size,
+          static_cast<long>(shared_network->sharedBytes()),priv,
+          static_cast<long>(shared_network->sharedBytes())+priv,
+          unshared*static_cast<long>(nnode));
+    }
+  }
+
   // Read in contingency file name
   std::string contingencyfile;
   if (!cursor->get("contingencyList",&contingencyfile)) {
@@ -449,11 +528,19 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
   timer->stop(t_store);
 #endif
   if (check_Qlim) pf_app.clearQlimViolations();
+  if (warm_start) pf_app.saveBaseCase(predict);
 
 
   // Evaluate contingencies using the task manager
   int task_id;
   char sbuf[128];
+  // Keep track of Newton-Raphson iterations and solution time for
+  // contingencies on this task communicator
+  int ca_iters = 0;
+  int ca_count = 0;
+  int ca_predicted = 0;
+  double ca_time = 0.0;
+  gridpack::parallel::ResultRecord record;
   // nextTask returns the same task_id on all processors in task_comm. When the
   // calculation runs out of task, nextTask will return false.
   while (taskmgr.nextTask(task_comm, &task_id)) {
@@ -490,21 +577,51 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
       }
     }
     if (print_calcs) pf_app.writeHeader(sbuf);
-    // Reset all voltages back to their original values
-    pf_app.resetVoltages();
-    // Set contingency
-    pf_app.setContingency(events[task_id]);
+    double t_start = timer->currentTime();
+    bool predicted = false;
+    if (warm_start) {
+      // Set contingency and start from the base case solution
+      pf_app.setContingency(events[task_id]);
+      predicted = pf_app.warmStart();
+    } else {
+      // Reset all voltages back to their original values
+      pf_app.resetVoltages();
+      // Set contingency
+      pf_app.setContingency(events[task_id]);
+    }
     // Solve power flow equations for this system
 #ifdef USE_SUCCESS
     contingency_idx.push_back(task_id);
 #endif
-    if (pf_app.solve()) {
+    // Skip the solve if island screening left no buses with a reference
+    bool solvable = pf_app.contingencySolvable();
+    bool converged = false;
+    int iters = 0;
+    if (solvable) {
+      converged = pf_app.solve();
+      iters = pf_app.getIterations();
+    }
+    if (converged && check_Qlim && !pf_app.checkQlimViolations()) {
+      pf_app.solve();
+      iters += pf_app.getIterations();
+    }
+    double t_solve = timer->currentTime() - t_start;
+    ca_iters += iters;
+    ca_time += t_solve;
+    ca_count++;
+    if (predicted) ca_predicted++;
+    // Result record uses the same violation codes as success.txt
+    record.reset(task_id,converged ? 1 : 0,0);
+    if (task_comm.rank() == 0) {
+      printf("Contingency %s: %d iterations %12.6f seconds%s%s\n",
+          events[task_id].p_name.c_str(),iters,t_solve,
+          predicted ? " (predicted start)" : "",
+          solvable ? (converged ? "" : " (divergent)") : " (no generation)");
+    }
+    if (converged) {
 #ifdef USE_SUCCESS
       contingency_success.push_back(true);
 #endif
-      if (check_Qlim && !pf_app.checkQlimViolations()) {
-        pf_app.solve();
-      }
       // If power flow solution is successful, write out voltages and currents
       if (print_calcs) pf_app.write();
       // Check for violations
@@ -512,6 +629,15 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
       bool ok2 = pf_app.checkLineOverloadViolations();
       bool ok = ok1 && ok2;
       // Include results of violation checks in output
+      if (!ok1 && !ok2) {
+        record.reset(task_id,1,4);
+      } else if (!ok1) {
+        record.reset(task_id,1,2);
+      } else if (!ok2) {
+        record.reset(task_id,1,3);
+      } else {
+        record.reset(task_id,1,1);
+      }
       if (ok) {
         sprintf(sbuf,"\nNo violation for contingency %s\n",
             events[task_id].p_name.c_str());
@@ -564,6 +690,11 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
           } else {
             mag_mask.push_back(1);
           }
+          // Save voltage magnitudes outside limits in result record
+          if (vmag.back() < Vmin || vmag.back() > Vmax) {
+            record.addValue(CA_RESULT_VMAG,atoi(tokens[0].c_str()),0,"",
+                vmag.back());
+          }
         }
         vang.push_back(atof(tokens[1].c_str()));
         mask.push_back(1);
@@ -625,6 +756,9 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
             mask.push_back(1);
           } else {
             mask.push_back(2);
+            // Save loading of overloaded lines in result record
+            record.addValue(CA_RESULT_PERF,atoi(tokens[j*8].c_str()),
+                atoi(tokens[j*8+1].c_str()),tokens[j*8+2],perf.back());
           }
         }
       }
@@ -737,11 +871,36 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
     pf_app.unSetContingency(events[task_id]);
     // Close output file for this contingency
     if (print_calcs) pf_app.close();
+    if (sink && task_comm.rank() == 0) sink->post(record);
   }
+  // Complete sends of result records
+  if (sink) sink->finish();
   // Print statistics from task manager describing the number of tasks performed
   // per processor
   taskmgr.printStats();
 
+  // Summarize iterations over all contingencies. Only count values from
+  // one process on each task communicator
+  if (task_comm.rank() != 0) {
+    ca_iters = 0;
+    ca_count = 0;
+    ca_predicted = 0;
+    ca_time = 0.0;
+  }
+  world.sum(&ca_iters,1);
+  world.sum(&ca_count,1);
+  world.sum(&ca_predicted,1);
+  world.sum(&ca_time,1);
+  if (world.rank() == 0 && ca_count > 0) {
+    printf("\nContingency solves: %d (%s start, %d predicted)\n",
+        ca_count,warm_start ? "warm" : "cold",ca_predicted);
+    printf("  Total Newton-Raphson iterations: %d\n",ca_iters);
+    printf("  Average iterations per contingency: %f\n",
+        static_cast<double>(ca_iters)/static_cast<double>(ca_count));
+    printf("  Average time per contingency: %f seconds\n",
+        ca_time/static_cast<double>(ca_count));
+  }
+
   // Gather stats on successful contingency calculations
 #ifdef USE_SUCCESS
   if (task_comm.rank() == 0) {
@@ -806,8 +965,8 @@ void gridpack::contingency_analysis::CADriver::execute(int argc, char** argv)
   timer->stop(t_total);
   // If all processors executed at least one task, then print out timing
   // statistics (this printout does not work if some processors do not define
-  // all timing variables)
-  if (contingencies.size()*grp_size >= world.size()) {
+  // all timing variables, which is always the case for result writers)
+  if (contingencies.size()*grp_size >= world.size() && !sink) {
     timer->dump();
   }
 }
@@ -47,19 +47,12 @@ public:
     p_MatMapper(MatMapper),
     p_localsize(localsize)
   {
-    J = p_MatMapper.mapToMatrix();
   }
 
   // Destructor
   ~DSProblem(void)
   {}
 
-  // A place to build/store the Jacobian
-  // We should be able to reuse the Jacobian created for DAESolve.
-  // Need to somehow eliminate the need for creating this second Jacobian.
-  // The nonlinear solver interface needs to be changed.
-  boost::shared_ptr<gridpack::math::Matrix> J;
-
   // Build the Jacobian for the nonlinear solver at tfaulton or tfaultoff
   void
   operator() (const gridpack::math::Vector& X,gridpack::math::Matrix& J)
@@ -306,8 +299,10 @@ void gridpack::dsimplicit::DSApp::execute(int argc, char** argv)
   math::NonlinearSolver::JacobianBuilder jbuildf = boost::ref(dsprob);
   math::NonlinearSolver::FunctionBuilder fbuildf = boost::ref(dsprob);
 
+  // The nonlinear solver shares the DAE solver's Jacobian; the DAE
+  // solver has to be told whenever the nonlinear solver overwrites it
   boost::scoped_ptr<gridpack::math::NonlinearSolver> nlsolver;
-  nlsolver.reset(new gridpack::math::NonlinearSolver(*(dsprob.J),jbuildf,fbuildf));
+  nlsolver.reset(new gridpack::math::NonlinearSolver(daesolver.jacobian(),jbuildf,fbuildf));
   nlsolver->configure(cursor);
 	      
   // Pre-fault time-stepping
@@ -320,6 +315,7 @@ void gridpack::dsimplicit::DSApp::execute(int argc, char** argv)
   factory.setfault(faultbus,-Gfault,-Bfault);
   // Solve algebraic fault-on equations
   nlsolver->solve(*X);
+  daesolver.invalidateJacobian();
 
   // Fault-on time-stepping
   maxsteps = 10000;
@@ -331,6 +327,7 @@ void gridpack::dsimplicit::DSApp::execute(int argc, char** argv)
   factory.setfault(faultbus,Gfault,Bfault);
   // Solve algebraic fault-on equations
   nlsolver->solve(*X);
+  daesolver.invalidateJacobian();
 
   // Post-fault time-stepping
   maxsteps = 10000;
@@ -143,7 +143,25 @@ main(int argc, char **argv)
     //printf("gen ID:	mac_ang_s0	mac_spd_s0	pmech	pelect\n");
     //printf("Step	time:	bus_id	mac_ang_s1	mac_spd_s1\n");
     //printf("ds_app.solve:\n");
-    ds_app.solve(faults[0]);
+    bool branchFaults = cursor->get("branchFaultsFromCheckpoint",false);
+    if (branchFaults && faults.size() > 1) {
+      // Integrate the pre-fault period once and start every fault from a
+      // checkpoint saved one step before the earliest fault
+      double start = faults[0].start;
+      int i;
+      for (i=1; i<faults.size(); i++) {
+        if (faults[i].start < start) start = faults[i].start;
+      }
+      double step = cursor->get("timeStep",0.0);
+      gridpack::dynamic_simulation::DSFullCheckpoint checkpoint;
+      ds_app.solve(faults[0], start-step, checkpoint);
+      for (i=0; i<faults.size(); i++) {
+        ds_app.restore(checkpoint);
+        ds_app.solve(faults[i]);
+      }
+    } else {
+      ds_app.solve(faults[0]);
+    }
     //ds_app.write();
     timer->stop(t_total);
     timer->dump();
@@ -148,3 +148,27 @@ void gridpack::dynamic_simulation::BaseExciterModel::setVstab(double Vstab)
 void gridpack::dynamic_simulation::BaseExciterModel::setWideAreaFreqforPSS(double freq)
 {
 }	
+
+/**
+ * return a vector containing the current values of the exciter
+ * state variables. These are used to estimate the integration error
+ * of a time step
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::BaseExciterModel::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseExciterModel>
+gridpack::dynamic_simulation::BaseExciterModel::clone()
+{
+  boost::shared_ptr<BaseExciterModel> ret(new BaseExciterModel(*this));
+  return ret;
+}
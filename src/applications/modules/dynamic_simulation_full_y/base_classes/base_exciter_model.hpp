@@ -112,6 +112,21 @@ class BaseExciterModel
 	
 	virtual void setWideAreaFreqforPSS(double freq);	
 
+    /**
+     * return a vector containing the current values of the exciter
+     * state variables. These are used to estimate the integration error
+     * of a time step
+     * @param vals vector of state variables
+     */
+    virtual void getStateValues(std::vector<double> &vals);
+
+    /**
+     * Create a copy of the model that includes its current state. This is
+     * used to checkpoint a simulation
+     * @return copy of model
+     */
+    virtual boost::shared_ptr<BaseExciterModel> clone();
+
   private:
     
     //double Vterminal, w;
@@ -31,6 +31,10 @@ gridpack::dynamic_simulation::BaseGeneratorModel::BaseGeneratorModel(void)
   p_hasPss = false;
   bStatus = true;
   p_wideareafreq = 0.0;
+  p_rate_ratio = 1;
+  p_substep = 0;
+  p_slow_step = true;
+  p_pmech_start = 0.0;
 }
 
 /**
@@ -272,3 +276,118 @@ void gridpack::dynamic_simulation::BaseGeneratorModel::getWatchValues(
 {
   vals.clear();
 }
+
+/**
+ * return a vector containing the current values of the generator
+ * state variables. These are used to estimate the integration error
+ * of a time step
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::BaseGeneratorModel::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+}
+
+/**
+ * Set parameters for multirate integration
+ * @param ratio number of fast steps in each slow step
+ * @param substep index of the fast step within the current slow step.
+ * Slow models are advanced when this is 0
+ */
+void gridpack::dynamic_simulation::BaseGeneratorModel::setMultirateStep(
+    int ratio, int substep)
+{
+  p_rate_ratio = ratio;
+  p_substep = substep;
+  p_slow_step = (substep == 0);
+  // Governor output at the start of the slow step, before the governor
+  // is advanced to the end of it
+  if (p_slow_step && p_hasGovernor && p_governor) {
+    p_pmech_start = p_governor->getMechanicalPower();
+  }
+}
+
+/**
+ * Call the governor predictor. Governors in the slow rate group are
+ * only advanced on slow steps, using the slow time increment, and
+ * otherwise hold their output
+ * @param t_inc time step increment
+ * @param flag initial step if true
+ */
+void gridpack::dynamic_simulation::BaseGeneratorModel::governorPredictor(
+    double t_inc, bool flag)
+{
+  if (p_rate_ratio > 1 && p_governor->getRateGroup() == SLOW_RATE) {
+    if (p_slow_step) p_governor->predictor(t_inc*p_rate_ratio, flag);
+  } else {
+    p_governor->predictor(t_inc, flag);
+  }
+}
+
+/**
+ * Return the mechanical power from the governor. Slow governors are
+ * advanced to the end of the slow step at its start, so their output is
+ * interpolated linearly between the values at the start and end of the
+ * slow step
+ * @param corrector true if called from the corrector, which uses the
+ * power at the end of the fast step
+ * @return mechanical power
+ */
+double gridpack::dynamic_simulation::BaseGeneratorModel::getGovernorPower(
+    bool corrector)
+{
+  double pmech = p_governor->getMechanicalPower();
+  if (p_rate_ratio > 1 && p_governor->getRateGroup() == SLOW_RATE) {
+    int substep = p_substep;
+    if (corrector) substep++;
+    pmech = p_pmech_start + (pmech - p_pmech_start)*
+      static_cast<double>(substep)/static_cast<double>(p_rate_ratio);
+  }
+  return pmech;
+}
+
+/**
+ * Call the governor corrector. Governors in the slow rate group are
+ * only advanced on slow steps
+ * @param t_inc time step increment
+ * @param flag initial step if true
+ */
+void gridpack::dynamic_simulation::BaseGeneratorModel::governorCorrector(
+    double t_inc, bool flag)
+{
+  if (p_rate_ratio > 1 && p_governor->getRateGroup() == SLOW_RATE) {
+    if (p_slow_step) p_governor->corrector(t_inc*p_rate_ratio, flag);
+  } else {
+    p_governor->corrector(t_inc, flag);
+  }
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseGeneratorModel>
+gridpack::dynamic_simulation::BaseGeneratorModel::clone()
+{
+  boost::shared_ptr<BaseGeneratorModel> ret(new BaseGeneratorModel(*this));
+  ret->cloneComponents();
+  return ret;
+}
+
+/**
+ * Replace the governor, exciter, stabilizer and relays of the model
+ * with copies, so that a copy of the generator does not share them with
+ * the original. This is called by clone
+ */
+void gridpack::dynamic_simulation::BaseGeneratorModel::cloneComponents()
+{
+  if (p_governor) p_governor = p_governor->clone();
+  if (p_exciter) p_exciter = p_exciter->clone();
+  if (p_pss) p_pss = p_pss->clone();
+  int i;
+  for (i=0; i<vp_relay.size(); i++) {
+    vp_relay[i] = vp_relay[i]->clone();
+  }
+}
@@ -165,6 +165,64 @@ class BaseGeneratorModel
      */
     virtual void getWatchValues(std::vector<double> &vals);
 
+    /**
+     * return a vector containing the current values of the generator
+     * state variables. These are used to estimate the integration error
+     * of a time step
+     * @param vals vector of state variables
+     */
+    virtual void getStateValues(std::vector<double> &vals);
+
+    /**
+     * Set parameters for multirate integration
+     * @param ratio number of fast steps in each slow step
+     * @param substep index of the fast step within the current slow step.
+     * Slow models are advanced when this is 0
+     */
+    void setMultirateStep(int ratio, int substep);
+
+    /**
+     * Call the governor predictor. Governors in the slow rate group are
+     * only advanced on slow steps, using the slow time increment, and
+     * otherwise hold their output
+     * @param t_inc time step increment
+     * @param flag initial step if true
+     */
+    void governorPredictor(double t_inc, bool flag);
+
+    /**
+     * Return the mechanical power from the governor. Slow governors are
+     * advanced to the end of the slow step at its start, so their output
+     * is interpolated linearly between the values at the start and end of
+     * the slow step
+     * @param corrector true if called from the corrector, which uses the
+     * power at the end of the fast step
+     * @return mechanical power
+     */
+    double getGovernorPower(bool corrector);
+
+    /**
+     * Call the governor corrector. Governors in the slow rate group are
+     * only advanced on slow steps
+     * @param t_inc time step increment
+     * @param flag initial step if true
+     */
+    void governorCorrector(double t_inc, bool flag);
+
+    /**
+     * Create a copy of the model that includes its current state. This is
+     * used to checkpoint a simulation
+     * @return copy of model
+     */
+    virtual boost::shared_ptr<BaseGeneratorModel> clone();
+
+    /**
+     * Replace the governor, exciter, stabilizer and relays of the model
+     * with copies, so that a copy of the generator does not share them with
+     * the original. This is called by clone
+     */
+    void cloneComponents();
+
   //private:
 
     bool p_hasExciter;
@@ -180,6 +238,10 @@ class BaseGeneratorModel
     bool p_watch;
 	bool bStatus;
     std::vector< boost::shared_ptr<BaseRelayModel> > vp_relay;  //renke add, relay vector
+    int p_rate_ratio;
+    int p_substep;
+    bool p_slow_step;
+    double p_pmech_start;
 
 };
 }  // dynamic_simulation
@@ -115,3 +115,38 @@ getRotorSpeedDeviation()
 {
   return 0.0;
 }
+
+/**
+ * Return the rate group of the governor. Governors in the slow group
+ * are only advanced on slow steps if multirate integration is used
+ * @return rate group of model
+ */
+gridpack::dynamic_simulation::RateGroup
+gridpack::dynamic_simulation::BaseGovernorModel::getRateGroup()
+{
+  return FAST_RATE;
+}
+
+/**
+ * return a vector containing the current values of the governor
+ * state variables. These are used to estimate the integration error
+ * of a time step
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::BaseGovernorModel::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseGovernorModel>
+gridpack::dynamic_simulation::BaseGovernorModel::clone()
+{
+  boost::shared_ptr<BaseGovernorModel> ret(new BaseGovernorModel(*this));
+  return ret;
+}
@@ -19,6 +19,7 @@
 
 #include "boost/smart_ptr/shared_ptr.hpp"
 #include "gridpack/component/base_component.hpp"
+#include "rate_group.hpp"
 
 namespace gridpack {
 namespace dynamic_simulation {
@@ -90,6 +91,28 @@ class BaseGovernorModel
      */
     virtual double getRotorSpeedDeviation();
 
+    /**
+     * Return the rate group of the governor. Governors in the slow group
+     * are only advanced on slow steps if multirate integration is used
+     * @return rate group of model
+     */
+    virtual RateGroup getRateGroup();
+
+    /**
+     * return a vector containing the current values of the governor
+     * state variables. These are used to estimate the integration error
+     * of a time step
+     * @param vals vector of state variables
+     */
+    virtual void getStateValues(std::vector<double> &vals);
+
+    /**
+     * Create a copy of the model that includes its current state. This is
+     * used to checkpoint a simulation
+     * @return copy of model
+     */
+    virtual boost::shared_ptr<BaseGovernorModel> clone();
+
   private:
 
 };
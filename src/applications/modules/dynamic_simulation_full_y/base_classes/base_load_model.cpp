@@ -216,3 +216,38 @@ std::string gridpack::dynamic_simulation::BaseLoadModel::getDynLoadID()
 {
 	return dyn_load_id;
 }
+
+/**
+ * Return the rate group of the load. Loads in the slow group are only
+ * advanced on slow steps if multirate integration is used
+ * @return rate group of model
+ */
+gridpack::dynamic_simulation::RateGroup
+gridpack::dynamic_simulation::BaseLoadModel::getRateGroup()
+{
+  return FAST_RATE;
+}
+
+/**
+ * return a vector containing the current values of the load
+ * state variables. These are used to estimate the integration error
+ * of a time step
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::BaseLoadModel::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseLoadModel>
+gridpack::dynamic_simulation::BaseLoadModel::clone()
+{
+  boost::shared_ptr<BaseLoadModel> ret(new BaseLoadModel(*this));
+  return ret;
+}
@@ -100,3 +100,27 @@ double gridpack::dynamic_simulation::BasePssModel::getBusFreq(int busnum)
 void gridpack::dynamic_simulation::BasePssModel::setWideAreaFreqforPSS(double freq)
 {
 }	
+
+/**
+ * return a vector containing the current values of the stabilizer
+ * state variables. These are used to estimate the integration error
+ * of a time step
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::BasePssModel::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BasePssModel>
+gridpack::dynamic_simulation::BasePssModel::clone()
+{
+  boost::shared_ptr<BasePssModel> ret(new BasePssModel(*this));
+  return ret;
+}
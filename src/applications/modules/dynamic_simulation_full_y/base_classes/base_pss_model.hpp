@@ -73,6 +73,21 @@ class BasePssModel
 	virtual void setWideAreaFreqforPSS(double freq);	
 
 
+    /**
+     * return a vector containing the current values of the stabilizer
+     * state variables. These are used to estimate the integration error
+     * of a time step
+     * @param vals vector of state variables
+     */
+    virtual void getStateValues(std::vector<double> &vals);
+
+    /**
+     * Create a copy of the model that includes its current state. This is
+     * used to checkpoint a simulation
+     * @return copy of model
+     */
+    virtual boost::shared_ptr<BasePssModel> clone();
+
   private:
     
     //double Vterminal, w;
@@ -81,6 +81,17 @@ double gridpack::dynamic_simulation::BaseRelayModel::getRelayFracPar(void)
 	return 1.0;
 }
 
+/**
+ * Return true if a pickup or breaker timer of the relay is running.
+ * Relay timers count time steps, so the integration step should not
+ * change while a relay is timing
+ * @return true if relay is timing towards a trip
+ */
+bool gridpack::dynamic_simulation::BaseRelayModel::isTiming(void)
+{
+	return false;
+}
+
 bool  gridpack::dynamic_simulation::BaseRelayModel::getOperationStatus(void)
 {
 	return boperationstatus;
@@ -89,3 +100,15 @@ void  gridpack::dynamic_simulation::BaseRelayModel::setOperationStatus( bool sta
 {
 	boperationstatus = sta;
 }
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseRelayModel>
+gridpack::dynamic_simulation::BaseRelayModel::clone()
+{
+  boost::shared_ptr<BaseRelayModel> ret(new BaseRelayModel(*this));
+  return ret;
+}
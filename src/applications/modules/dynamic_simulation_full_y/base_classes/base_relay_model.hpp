@@ -69,6 +69,21 @@ class BaseRelayModel
 	
 	virtual double getRelayFracPar(void);
 
+    /**
+     * Return true if a pickup or breaker timer of the relay is running.
+     * Relay timers count time steps, so the integration step should not
+     * change while a relay is timing
+     * @return true if relay is timing towards a trip
+     */
+    virtual bool isTiming(void);
+
+    /**
+     * Create a copy of the model that includes its current state. This is
+     * used to checkpoint a simulation
+     * @return copy of model
+     */
+    virtual boost::shared_ptr<BaseRelayModel> clone();
+
   private:
 	 bool boperationstatus;  // true: relay  included in dynamic simulation, 
 							 // false: relay not included in dynamic simulation,
@@ -0,0 +1,24 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   rate_group.hpp
+ * 
+ * @brief  Rate groups used by multirate integration. Models in the slow
+ * group are only advanced every k steps of the fast group.
+ * 
+ * 
+ */
+
+#ifndef _rate_group_h_
+#define _rate_group_h_
+
+namespace gridpack {
+namespace dynamic_simulation {
+enum RateGroup{FAST_RATE, SLOW_RATE};
+}  // dynamic_simulation
+}  // gridpack
+#endif
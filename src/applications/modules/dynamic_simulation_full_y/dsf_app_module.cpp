@@ -23,21 +23,77 @@
 #include "gridpack/mapper/bus_vector_map.hpp"
 #include "gridpack/math/math.hpp"
 #include "gridpack/parallel/global_vector.hpp"
+#include "gridpack/parallel/threads.hpp"
+#include "gridpack/utilities/exception.hpp"
 #include "dsf_app_module.hpp"
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
 using namespace std;
 
-#ifdef USE_HELICS
-//#include "helics/ValueFederates.hpp"
-//#include <helics/shared_api_library/ValueFederate.h>
-#include <helics/helics.hpp>
-#endif
-
 //#define MAP_PROFILE
 
+/**
+ * Basic constructor
+ */
+gridpack::dynamic_simulation::DSFullCheckpoint::DSFullCheckpoint(void)
+{
+  p_valid = false;
+  p_time = 0.0;
+  p_step = 0;
+  p_time_step = 0.0;
+  p_stage = 0;
+  p_insecureAt = -1;
+  p_frequencyOK = true;
+}
+
+/**
+ * Basic destructor
+ */
+gridpack::dynamic_simulation::DSFullCheckpoint::~DSFullCheckpoint(void)
+{
+}
+
+/**
+ * Check if checkpoint holds a simulation state
+ * @return true if checkpoint has been saved
+ */
+bool gridpack::dynamic_simulation::DSFullCheckpoint::isValid(void) const
+{
+  return p_valid;
+}
+
+/**
+ * Simulation time at which checkpoint was saved
+ * @return time of checkpoint
+ */
+double gridpack::dynamic_simulation::DSFullCheckpoint::getTime(void) const
+{
+  return p_time;
+}
+
+/**
+ * Time at the start of a step of the fixed step integrator
+ * @param step index of step
+ * @param t_step number of steps in each stage of the simulation
+ * @param t_width size of steps in each stage of the simulation
+ * @return start time of step
+ */
+static double stepStartTime(int step, const int *t_step,
+    const double *t_width)
+{
+  double ret = 0.0;
+  int i;
+  for (i=0; i<3 && step>0; i++) {
+    int nsteps = step < t_step[i] ? step : t_step[i];
+    ret += static_cast<double>(nsteps)*t_width[i];
+    step -= nsteps;
+  }
+  return ret;
+}
+
 // Calling program for dynamic simulation application
 
 /**
@@ -51,6 +107,13 @@ gridpack::dynamic_simulation::DSFullApp::DSFullApp(void)
   p_generators_read_in = false;
   p_save_time_series = false;
   p_monitorGenerators = false;
+  p_adaptive = false;
+  p_multirate_ratio = 1;
+  p_accepted_steps = 0;
+  p_rejected_steps = 0;
+  p_checkpoint = NULL;
+  p_checkpoint_time = 0.0;
+  p_restarted = false;
 }
 
 /**
@@ -66,6 +129,13 @@ gridpack::dynamic_simulation::DSFullApp::DSFullApp(gridpack::parallel::Communica
   p_generators_read_in = false;
   p_save_time_series = false;
   p_monitorGenerators = false;
+  p_adaptive = false;
+  p_multirate_ratio = 1;
+  p_accepted_steps = 0;
+  p_rejected_steps = 0;
+  p_checkpoint = NULL;
+  p_checkpoint_time = 0.0;
+  p_restarted = false;
 }
 
 /**
@@ -125,6 +195,10 @@ void gridpack::dynamic_simulation::DSFullApp::readNetwork(
   p_monitorGenerators = cursor->get("monitorGenerators",false);
   p_maximumFrequency = cursor->get("frequencyMaximum",61.8);
 
+  // Split loops over buses and branches in factories and mappers across
+  // threads (only has an effect if GridPACK is built with OpenMP)
+  gridpack::parallel::setThreadedLoops(cursor->get("threadedLoops",false));
+
   // load input file
   if (filetype == PTI23) {
     gridpack::parser::PTI23_parser<DSFullNetwork> parser(network);
@@ -195,8 +269,10 @@ void gridpack::dynamic_simulation::DSFullApp::readGenerators(void)
   gridpack::parser::PTI23_parser<DSFullNetwork> parser(p_network);
   cursor = p_config->getCursor("Configuration.Dynamic_simulation");
   std::string filename = cursor->get("generatorParameters","");
+  // Read the file on all processors instead of only on process 0
+  bool parallel = cursor->get("parallelParse",false);
   printf("p[%d] generatorParameters: %s\n",p_comm.rank(),filename.c_str());
-  if (filename.size() > 0) parser.externalParse(filename.c_str());
+  if (filename.size() > 0) parser.externalParse(filename.c_str(), parallel);
   printf("p[%d] finished Generator parameters\n",p_comm.rank());
 }
 
@@ -266,6 +342,29 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
   // Get cursor for setting solver options
   gridpack::utility::Configuration::CursorPtr cursor;
   cursor = p_config->getCursor("Configuration.Dynamic_simulation");
+
+  // Parameters for adaptive time stepping. By default the step is allowed
+  // to grow to ten times the base time step but never drops below it
+  p_adaptive = cursor->get("adaptiveTimeStep",false);
+  p_adaptive_tolerance = cursor->get("adaptiveTolerance",1.0e-4);
+  p_min_time_step = cursor->get("minimumTimeStep",p_time_step);
+  p_max_time_step = cursor->get("maximumTimeStep",10.0*p_time_step);
+  if (p_min_time_step <= 0.0 || p_min_time_step > p_time_step)
+    p_min_time_step = p_time_step;
+  if (p_max_time_step < p_min_time_step) p_max_time_step = p_min_time_step;
+  openCosimulation();
+  // co-simulation exchanges values on the fixed time step grid
+  if (p_cosim) p_adaptive = false;
+  // checkpoints are saved and restored on the fixed time step grid
+  if (p_checkpoint || p_restarted) p_adaptive = false;
+  p_accepted_steps = 0;
+  p_rejected_steps = 0;
+
+  // Number of time steps in each step of the slow rate group (governors
+  // and slow loads) for multirate integration. This is only used with the
+  // fixed time step integrator
+  p_multirate_ratio = cursor->get("multirateRatio",1);
+  if (p_multirate_ratio < 1 || p_adaptive) p_multirate_ratio = 1;
   timer->stop(t_misc);
 
   int t_mode = timer->createCategory("DS Solve: Set Mode");
@@ -328,6 +427,10 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
   
   //exit(0);
  
+  // A restored checkpoint continues with its own Y-matrix, which includes
+  // any changes made by relays before the checkpoint was saved
+  if (p_restarted) ybus.reset(p_restart.p_ybus->clone());
+
   // Get fault information from fautlts Event from input.xml
   int sw2_2 = fault.from_idx - 1;
   int sw3_2 = fault.to_idx - 1;
@@ -399,9 +502,50 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
     simu_k += t_step[i];
   }
   simu_k++;
+
+  // Range of steps to integrate. A restored checkpoint is continued from
+  // its next step. A checkpoint taken in the pre-fault period can start any
+  // fault that has not begun, otherwise the fault must be the same
+  int first_step = 0;
+  int last_step = simu_k - 1;
+  if (p_restarted) {
+    const gridpack::dynamic_simulation::Event &old = p_restart.p_fault;
+    first_step = p_restart.p_step;
+    bool ok = fabs(p_restart.p_time_step - p_time_step)
+      <= 1.0e-9*p_time_step;
+    if (p_restart.p_stage == 0) {
+      ok = ok && first_step <= t_step[0] - 1;
+    } else {
+      ok = ok && old.start == fault.start && old.end == fault.end
+        && old.step == fault.step && old.isGenerator == fault.isGenerator
+        && old.isLine == fault.isLine && old.bus_idx == fault.bus_idx
+        && old.from_idx == fault.from_idx && old.to_idx == fault.to_idx;
+    }
+    if (!ok) {
+      char buf[256];
+      sprintf(buf,"DSFullApp::solve: checkpoint at time %f cannot be used"
+          " for fault starting at time %f\n",p_restart.p_time,fault.start);
+      printf("%s",buf);
+      throw gridpack::Exception(buf);
+    }
+    if (p_restart.p_stage > 0) {
+      ybus_fy.reset(p_restart.p_ybus_fy->clone());
+      ybus_posfy.reset(p_restart.p_ybus_posfy->clone());
+    }
+  }
+  if (p_checkpoint) {
+    // stop at the first step that starts at or after the checkpoint time
+    last_step = first_step;
+    while (last_step < simu_k - 1 && stepStartTime(last_step,t_step,t_width)
+        < p_checkpoint_time - 1.0e-6*p_time_step) {
+      last_step++;
+    }
+  }
   
-  // Initialize vectors for integration 
-  p_factory->initDSVect(p_time_step);
+  // Initialize vectors for integration. Models restored from a checkpoint
+  // already hold their state
+  if (!p_restarted) p_factory->initDSVect(p_time_step);
+  p_factory->setMultirateStep(p_multirate_ratio, 0);
   //exit(0);
 
   gridpack::mapper::BusVectorMap<DSFullNetwork> ngenMap(p_network);
@@ -431,6 +575,7 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
   bool flag = true, flag_corrector = true;
 
   p_insecureAt = -1;
+  if (p_restarted) p_insecureAt = p_restart.p_insecureAt;
 
   p_factory->setMode(make_INorton_full);
   gridpack::mapper::BusVectorMap<DSFullNetwork> nbusMap(p_network);
@@ -443,7 +588,9 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
 #ifdef USE_TIMESTAMP
   if (p_generatorWatch) p_generatorIO->header("t, t_stamp");//bus_id,ckt,x1d_1,x2w_1,x3Eqp_1,x4Psidp_1,x5Psiqpp_1");
 //#  if (p_generatorWatch) p_generatorIO->header("t, t_stamp,bus_id,ckt,x1d_1,x2w_1,x3Eqp_1,x4Psidp_1,x5Psiqpp_1");
-  if (p_generatorWatch) p_generatorIO->write("watch_header");
+  if (p_generatorWatch && p_adaptive)
+    p_generatorIO->write("watch_interpolated_header");
+  else if (p_generatorWatch) p_generatorIO->write("watch_header");
   if (p_generatorWatch) p_generatorIO->header("\n");
 
   if (p_loadWatch) p_loadIO->header("t, t_stamp");
@@ -451,7 +598,9 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
   if (p_loadWatch) p_loadIO->header("\n");
 #else
   if (p_generatorWatch) p_generatorIO->header("t");
-  if (p_generatorWatch) p_generatorIO->write("watch_header");
+  if (p_generatorWatch && p_adaptive)
+    p_generatorIO->write("watch_interpolated_header");
+  else if (p_generatorWatch) p_generatorIO->write("watch_header");
   if (p_generatorWatch) p_generatorIO->header("\n");
 
   if (p_loadWatch) p_loadIO->header("t");
@@ -463,47 +612,25 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
   if (p_loadWatch) p_loadIO->dumpChannel();
 #endif
   p_frequencyOK = true;
+  if (p_restarted) {
+    p_frequencyOK = p_restart.p_frequencyOK;
+    if (p_restart.p_time_series.size() == p_time_series.size()) {
+      p_time_series = p_restart.p_time_series;
+    }
+  }
   // Save initial time step
   //saveTimeStep();
  
 	
  
-#ifdef USE_HELICS
-	//std::cout << "-------------!!!helics test: HELICS Version: " << helics::versionString << std::endl;
-	cout << "-------------!!!helics test: HELICS Version: " << helics::versionString << endl;
-	string configFile = "/home/huan495/gridpack-dev/src/build/applications/dynamic_simulation_full_y/testcase/helics_39bus_3.json";
-    helics::ValueFederate fed(configFile);
-	helics::Publication pub;
-	helics::Input sub;
-	double helics_requestTime = 0.0;
-	
-	//to get publication definitions
-    int pubCount = fed.getPublicationCount();
-	
-	printf("-------------helics test: num of pub: %d \n", pubCount);
-    for(int i = 0; i < pubCount; i++) {
-        pub = fed.getPublication(i);
-        string pubInfo = pub.getInfo();
-        // do stuff to tie pub to GridPACK object property
-    }
-    
-	//to get subscription definitions
-    int subCount = fed.getInputCount();
-	printf("-------------helics test: num of sub: %d \n", subCount);
-	
-    for(int i = 0; i < subCount; i++) {
-        sub = fed.getInput(i);
-        string subInfo = sub.getInfo();
-        // do stuff to tie pub to GridPACK object property
-    }
-         
-	//let helics broker know you are ready to start simulation 
-	fed.enterExecutingMode();	
-
-#endif  //end if of HELICS
 
+  // The adaptive integrator replaces the fixed step loop below
+  if (p_adaptive) {
+    integrateAdaptive(fault, ybusMap, nbusMap, ybus, ybus_fy, ybus_posfy,
+        solver, solver_fy, solver_posfy, INorton_full, volt_full, simu_k-1);
+  }
 
-  for (I_Steps = 0; I_Steps < simu_k - 1; I_Steps++) {
+  for (I_Steps = first_step; !p_adaptive && I_Steps < last_step; I_Steps++) {
   //for (I_Steps = 0; I_Steps < 200; I_Steps++) {
     //char step_str[128];
     //sprintf(step_str,"\nIter %d\n", I_Steps);
@@ -515,6 +642,10 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
     ///sprintf(step_str, "\n===================Step %d\ttime %5.3f sec:================\n", I_Steps+1, (I_Steps+1) * p_time_step);
      ///p_busIO->header(step_str);
     S_Steps = I_Steps;
+    if (p_multirate_ratio > 1) {
+      p_factory->setMultirateStep(p_multirate_ratio,
+          I_Steps%p_multirate_ratio);
+    }
 
     if (I_Steps < steps1) {
       flagP = 0;
@@ -674,48 +805,24 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
 	int tmp = vwideareafreqs.size();
 	double widearea_deltafreq = vwideareafreqs[tmp-1];
 
-#ifdef USE_HELICS
-	 
-	 //pub.publish(widearea_deltafreq);
-	 for(int i = 0; i < pubCount; i++) {
-            pub = fed.getPublication(i);
-            string pubInfo = pub.getInfo();
-			//std::cout << "-------------!!!helics test: HELICS pub info: " << pubInfo << std::endl;
-			pub.publish(vwideareafreqs[i]);
-            // do stuff to tie pub to GridPACK object property
-          }
-
-	 helics_requestTime =       double (I_Steps*h_sol1);
-	 //printf("-------------!!!Helics request time: %12.6f \n", helics_requestTime); 
-	 double helics_grantime;
-	 helics_grantime = fed.requestTime(helics_requestTime);
-	 //printf("-------------!!!Helics grant time: %12.6f \n", helics_grantime); 
-	 
-	 double subvalue = 0.0;
-	 
-	 for(int i = 0; i < subCount; i++) {
-        sub = fed.getInput(i);
-		//printf("-------------!!!helics debug entering  sub loop\n"); 
-		//if(sub.isUpdated()) {
-            //auto value = sub.getValue();
-			subvalue = fed.getDouble(sub);
-			//printf("-------------!!!Helics sub value: %12.6f \n", subvalue);
-                             //update GridPACK object property with value
-        //}
-
-	 }
-	 
-	//printf("-------------!!!Outside Helics def sub value: %12.6f \n", subvalue);
-	 
-	p_factory->setWideAreaFreqforPSS(subvalue);
-
-	//p_factory->setWideAreaFreqforPSS(widearea_deltafreq);
-	 
-#else	 
-	 
-	p_factory->setWideAreaFreqforPSS(widearea_deltafreq);
-	 
-#endif
+    if (p_cosim) {
+      // Publish values for this step and apply the wide area signal
+      // received from the external simulator. In pipelined mode the
+      // inputs belong to the previous step
+      CosimValueSet &outputs = p_cosim->outputs(I_Steps, I_Steps*h_sol1);
+      if (p_comm.rank() == 0) {
+        for (int isig=0; isig<tmp; isig++) {
+          outputs.addSignal(isig, vwideareafreqs[isig]);
+        }
+      }
+      p_factory->getCosimValues(outputs, p_cosimVoltages, p_cosimInjections,
+          p_cosimBreakers);
+      p_cosim->post();
+      if (p_cosim->receive(p_cosimInputs)) {
+        widearea_deltafreq = cosimSignal(widearea_deltafreq);
+      }
+    }
+    p_factory->setWideAreaFreqforPSS(widearea_deltafreq);
 		
     timer->stop(t_volt);
 	
@@ -1113,6 +1220,35 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
   //else sprintf(msg, "\nThe system is insecure from step %d!\n", p_insecureAt);
 
   char secureBuf[128];
+  // Save state at the start of the next step
+  if (p_checkpoint) {
+    int step = I_Steps < simu_k - 1 ? I_Steps : simu_k - 1;
+    p_checkpoint->p_valid = true;
+    p_checkpoint->p_step = step;
+    p_checkpoint->p_time = stepStartTime(step,t_step,t_width);
+    p_checkpoint->p_time_step = p_time_step;
+    if (step <= steps1) {
+      p_checkpoint->p_stage = 0;
+    } else if (step <= steps2) {
+      p_checkpoint->p_stage = 1;
+    } else {
+      p_checkpoint->p_stage = 2;
+    }
+    p_checkpoint->p_fault = fault;
+    p_factory->checkpoint(p_checkpoint->p_buses, p_checkpoint->p_branches);
+    p_checkpoint->p_ybus.reset(ybus->clone());
+    p_checkpoint->p_ybus_fy.reset(ybus_fy->clone());
+    p_checkpoint->p_ybus_posfy.reset(ybus_posfy->clone());
+    p_checkpoint->p_insecureAt = p_insecureAt;
+    p_checkpoint->p_frequencyOK = p_frequencyOK;
+    p_checkpoint->p_time_series = p_time_series;
+    sprintf(secureBuf,"\nCheckpoint saved at time %f\n",
+        p_checkpoint->p_time);
+    p_busIO->header(secureBuf);
+  }
+  p_restarted = false;
+  p_restart = gridpack::dynamic_simulation::DSFullCheckpoint();
+
   if (p_insecureAt == -1) {
     char *ptr;
     sprintf(secureBuf,"\nThe system is secure");
@@ -1139,6 +1275,11 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
     }
   }
   p_busIO->header(secureBuf);
+  if (p_multirate_ratio > 1) {
+    sprintf(secureBuf,"\nMultirate integration: slow models advanced every"
+        " %d time steps\n",p_multirate_ratio);
+    p_busIO->header(secureBuf);
+  }
 
 #ifdef MAP_PROFILE
   timer->configTimer(true);
@@ -1146,13 +1287,509 @@ void gridpack::dynamic_simulation::DSFullApp::solve(
   timer->stop(t_solve);
   //timer->dump();
   
+  closeCosimulation();
+ 
+  
+}
+
+/**
+ * Create the co-simulation exchange if a transport is specified in the
+ * Cosimulation block of the input deck
+ */
+void gridpack::dynamic_simulation::DSFullApp::openCosimulation()
+{
+  p_cosim.reset();
+  gridpack::utility::Configuration::CursorPtr cursor;
+  cursor = p_config->getCursor("Configuration.Dynamic_simulation");
+  std::string transport = cursor->get("Cosimulation.transport",
+      std::string("none"));
+  if (transport == "none") return;
+  bool pipelined = cursor->get("Cosimulation.pipelined",true);
+  gridpack::utility::Configuration::CursorPtr cosim;
+  cosim = cursor->getCursor("Cosimulation");
+  p_cosimVoltages = cosimPublications(cosim,"publishVoltages",false);
+  p_cosimInjections = cosimPublications(cosim,"publishInjections",false);
+  p_cosimBreakers = cosimPublications(cosim,"publishBreakers",true);
+  boost::shared_ptr<CosimTransport> ptr;
+  if (p_comm.rank() == 0) {
+    if (transport == "loopback") {
+      ptr.reset(new LoopbackTransport);
 #ifdef USE_HELICS
+    } else if (transport == "helics") {
+      std::string config = cursor->get("Cosimulation.helicsConfig",
+          std::string(""));
+      ptr.reset(new HelicsTransport(config));
+#endif
+    } else {
+      char buf[256];
+      sprintf(buf,"DSFullApp::openCosimulation: unknown transport %s\n",
+          transport.c_str());
+      printf("%s",buf);
+      throw gridpack::Exception(buf);
+    }
+  }
+  p_cosim.reset(new CosimExchange(p_comm, ptr, pipelined));
+  if (p_comm.rank() == 0) {
+    printf("\nCo-simulation using %s transport (%s exchanges)\n",
+        transport.c_str(), pipelined ? "pipelined" : "synchronous");
+  }
+}
 
-	fed.finalize();
-	
+/**
+ * Find the local indices of the buses or branches listed in a field of the
+ * Cosimulation block. Only buses and branches owned by this process are
+ * returned
+ * @param cursor Cosimulation block of the input deck
+ * @param field name of field containing list of bus IDs or, for branches,
+ * pairs of bus IDs
+ * @param branches true if field contains branches
+ * @return local indices
+ */
+std::vector<int> gridpack::dynamic_simulation::DSFullApp::cosimPublications(
+    gridpack::utility::Configuration::CursorPtr cursor, const char *field,
+    bool branches)
+{
+  std::vector<int> ret;
+  std::string list = cursor->get(field,std::string(""));
+  std::istringstream stream(list);
+  std::vector<int> ids;
+  int id;
+  while (stream >> id) ids.push_back(id);
+  int i, j;
+  std::vector<int> lids;
+  if (branches) {
+    if (ids.size()%2 != 0) {
+      char buf[256];
+      sprintf(buf,"DSFullApp::openCosimulation: %s must contain pairs"
+          " of bus IDs\n",field);
+      printf("%s",buf);
+      throw gridpack::Exception(buf);
+    }
+    for (i=0; i<ids.size(); i+=2) {
+      lids = p_network->getLocalBranchIndices(ids[i],ids[i+1]);
+      for (j=0; j<lids.size(); j++) {
+        if (p_network->getActiveBranch(lids[j])) ret.push_back(lids[j]);
+      }
+    }
+  } else {
+    for (i=0; i<ids.size(); i++) {
+      lids = p_network->getLocalBusIndices(ids[i]);
+      for (j=0; j<lids.size(); j++) {
+        if (p_network->getActiveBus(lids[j])) ret.push_back(lids[j]);
+      }
+    }
+  }
+  return ret;
+}
+
+/**
+ * Complete outstanding co-simulation exchanges and report the time spent
+ * in exchanges
+ */
+void gridpack::dynamic_simulation::DSFullApp::closeCosimulation()
+{
+  if (!p_cosim) return;
+  p_cosim->finalize();
+  double times[2];
+  p_cosim->getTimes(&times[0], &times[1]);
+  p_comm.max(times,2);
+  int nsteps = p_cosim->numSteps();
+  if (p_comm.rank() == 0 && nsteps > 0) {
+    printf("\nCo-simulation exchanges: %d\n",nsteps);
+    printf("  Post time per step:  %12.6e s\n",times[0]/(double)nsteps);
+    printf("  Wait time per step:  %12.6e s\n",times[1]/(double)nsteps);
+    printf("  Total per step:      %12.6e s\n",
+        (times[0]+times[1])/(double)nsteps);
+  }
+  p_cosim.reset();
+}
+
+/**
+ * Find the wide area signal in the values received from the external
+ * simulator. This is the signal with the highest index
+ * @param value value returned if no signal was received
+ * @return wide area signal
+ */
+double gridpack::dynamic_simulation::DSFullApp::cosimSignal(double value)
+{
+  p_cosimInputs.getLastSignal(&value);
+  return value;
+}
+
+/**
+ * Values received from the external simulator in the most recent
+ * co-simulation exchange
+ * @return received value set
+ */
+const gridpack::dynamic_simulation::CosimValueSet&
+gridpack::dynamic_simulation::DSFullApp::getCosimInputs() const
+{
+  return p_cosimInputs;
+}
+
+/**
+ * Execute the time integration up to time end and save the complete
+ * state of the simulation in a checkpoint. Integration starts at t=0,
+ * or at the most recently restored checkpoint. A checkpoint saved
+ * before the last step of the pre-fault period can be used to start any
+ * fault that does not begin before the checkpoint. Later checkpoints
+ * can only be used to continue the same fault. Checkpoints use the
+ * fixed step integrator
+ * @param fault fault event being simulated
+ * @param end time at which integration stops
+ * @param checkpoint state of simulation at the start of the first step
+ * at or after end
+ */
+void gridpack::dynamic_simulation::DSFullApp::solve(
+    gridpack::dynamic_simulation::Event fault, double end,
+    gridpack::dynamic_simulation::DSFullCheckpoint &checkpoint)
+{
+  p_checkpoint = &checkpoint;
+  p_checkpoint_time = end;
+  try {
+    solve(fault);
+  } catch (...) {
+    p_checkpoint = NULL;
+    throw;
+  }
+  p_checkpoint = NULL;
+}
+
+/**
+ * Restore the state of the simulation from a checkpoint. The next call
+ * to solve continues the integration from the checkpoint instead of
+ * initializing the models from the power flow solution. The checkpoint
+ * is not modified, so several faults can be branched from it. This
+ * should be called after initialize or reload
+ * @param checkpoint simulation state saved by solve
+ */
+void gridpack::dynamic_simulation::DSFullApp::restore(
+    const gridpack::dynamic_simulation::DSFullCheckpoint &checkpoint)
+{
+  if (!checkpoint.p_valid) {
+    char buf[128];
+    sprintf(buf,"DSFullApp::restore: checkpoint has not been saved\n");
+    printf("%s",buf);
+    throw gridpack::Exception(buf);
+  }
+  p_factory->restore(checkpoint.p_buses, checkpoint.p_branches);
+  p_restart = checkpoint;
+  p_restarted = true;
+}
+
+/**
+ * Integrate the system using modified Euler steps whose size is
+ * chosen from an estimate of the local error. The estimate is the
+ * difference between the predicted and corrected states of the
+ * generators, exciters, governors, stabilizers and dynamic loads.
+ * Steps that exceed the tolerance are rejected and repeated with a
+ * smaller step. The state of all buses and branches, including relay
+ * timers and bus frequency filters, is copied at the start of each
+ * step and restored when the step is rejected. Steps land exactly on the start and end of the fault,
+ * the fault-on period uses the fault time step and the base time step
+ * is used while any relay is timing towards a trip. Generator watch
+ * output and time series are interpolated onto the fixed output grid.
+ * @param fault fault event being simulated
+ * @param ybusMap mapper used to modify Y-matrices after relay trips
+ * @param nbusMap mapper for Norton currents and bus voltages
+ * @param ybus pre-fault Y-matrix
+ * @param ybus_fy fault-on Y-matrix
+ * @param ybus_posfy post-fault Y-matrix
+ * @param solver linear solver for pre-fault stage
+ * @param solver_fy linear solver for fault-on stage
+ * @param solver_posfy linear solver for post-fault stage
+ * @param INorton_full vector of Norton currents
+ * @param volt_full vector of bus voltages
+ * @param nfixed number of steps taken by the fixed step integrator
+ */
+void gridpack::dynamic_simulation::DSFullApp::integrateAdaptive(
+    gridpack::dynamic_simulation::Event &fault,
+    gridpack::mapper::FullMatrixMap<DSFullNetwork> &ybusMap,
+    gridpack::mapper::BusVectorMap<DSFullNetwork> &nbusMap,
+    boost::shared_ptr<gridpack::math::Matrix> ybus,
+    boost::shared_ptr<gridpack::math::Matrix> ybus_fy,
+    boost::shared_ptr<gridpack::math::Matrix> ybus_posfy,
+    gridpack::math::LinearSolver &solver,
+    gridpack::math::LinearSolver &solver_fy,
+    gridpack::math::LinearSolver &solver_posfy,
+    boost::shared_ptr<gridpack::math::Vector> INorton_full,
+    boost::shared_ptr<gridpack::math::Vector> volt_full,
+    int nfixed)
+{
+  gridpack::utility::CoarseTimer *timer =
+    gridpack::utility::CoarseTimer::instance();
+  int t_control = timer->createCategory("DS Solve: Adaptive Step Control");
+  int t_psolve = timer->createCategory("DS Solve: Modified Euler Predictor: Linear Solver");
+  int t_csolve = timer->createCategory("DS Solve: Modified Euler Corrector: Linear Solver");
+  int t_predictor = timer->createCategory("DS Solve: Modified Euler Predictor");
+  int t_corrector = timer->createCategory("DS Solve: Modified Euler Corrector");
+  int t_secure = timer->createCategory("DS Solve: Check Security");
+
+  // Tolerance used to decide if two times are the same
+  const double teps = 1.0e-6*p_min_time_step;
+  // Limits on change in step size from one step to the next
+  const double safety = 0.9;
+  const double minFactor = 0.2;
+  const double maxFactor = 2.0;
+
+  double fault_start = fault.start;
+  double fault_end = fault.end;
+  if (fault_start > p_sim_time) fault_start = p_sim_time;
+  if (fault_end > p_sim_time) fault_end = p_sim_time;
+
+  double time = 0.0;
+  double h = p_min_time_step;
+  double h_min_used = p_max_time_step;
+  double h_max_used = 0.0;
+  bool first = true;
+  bool retry = false;
+  int i;
+  std::vector<boost::shared_ptr<DSFullBus> > step_buses;
+  std::vector<boost::shared_ptr<DSFullBranch> > step_branches;
+
+  // Output grids for generator watch, load watch and time series
+  double genInterval = p_time_step;
+  if (p_generatorWatch) genInterval *= p_generatorWatchFrequency;
+  double loadInterval = p_time_step;
+  if (p_loadWatch) loadInterval *= p_loadWatchFrequency;
+  int genOut = 1;
+  int loadOut = 1;
+  int seriesOut = 1;
+
+  while (time < p_sim_time - teps) {
+    timer->start(t_control);
+    // Find stage of simulation and the next event time
+    int flagP;
+    double t_event;
+    if (time < fault_start - teps) {
+      flagP = 0;
+      t_event = fault_start;
+    } else if (time < fault_end - teps) {
+      flagP = 1;
+      t_event = fault_end;
+    } else {
+      flagP = 2;
+      t_event = p_sim_time;
+    }
+
+    // Choose step size. Relay timers count steps so the base time step
+    // is used while any relay is timing
+    double h_step = h;
+    bool timing = p_factory->relayTiming();
+    if (flagP == 1) {
+      h_step = fault.step;
+    } else if (timing && h_step > p_time_step) {
+      h_step = p_time_step;
+    }
+    bool landing = false;
+    if (time + h_step >= t_event - teps) {
+      h_step = t_event - time;
+      landing = true;
+    } else if (t_event - time - h_step < p_min_time_step) {
+      // avoid leaving a very small step in front of the event
+      h_step = 0.5*(t_event - time);
+    }
+    timer->stop(t_control);
+
+    // Save the state at the start of a new step. A rejected step is
+    // repeated from this copy so that relays, dynamic loads and bus
+    // frequencies are not advanced twice
+    if (!retry) p_factory->checkpoint(step_buses, step_branches);
+    bool flag = first;
+
+    p_factory->predictor_currentInjection(flag);
+    p_factory->setMode(make_INorton_full);
+    nbusMap.mapToVector(INorton_full);
+    timer->start(t_psolve);
+    volt_full->zero();
+    if (flagP == 0) {
+      solver.solve(*INorton_full, *volt_full);
+    } else if (flagP == 1) {
+      solver_fy.solve(*INorton_full, *volt_full);
+    } else {
+      solver_posfy.solve(*INorton_full, *volt_full);
+    }
+    timer->stop(t_psolve);
+    nbusMap.mapToBus(volt_full);
+    if (first) p_factory->updateoldbusvoltage();
+    p_factory->setVolt(false);
+    p_factory->updateBusFreq(h_step);
+
+    std::vector <double> vwideareafreqs;
+    vwideareafreqs = p_factory->grabWideAreaFreq();
+    p_factory->setWideAreaFreqforPSS(vwideareafreqs[vwideareafreqs.size()-1]);
+
+    bool flagBus = p_factory->updateBusRelay(false, h_step);
+    bool flagBranch = p_factory->updateBranchRelay(false, h_step);
+    p_factory->dynamicload_post_process(h_step, false);
+
+    // Modify Y-matrices for the current and any later stages if a relay
+    // has tripped
+    if (flagBus || flagBranch) {
+      std::vector<boost::shared_ptr<gridpack::math::Matrix> > ymats;
+      ymats.push_back(ybus);
+      if (flagP == 1) ymats.push_back(ybus_fy);
+      if (flagP >= 1) ymats.push_back(ybus_posfy);
+      for (i=0; i<ymats.size(); i++) {
+        if (flagBus) {
+          p_factory->setMode(bus_relay);
+          ybusMap.overwriteMatrix(ymats[i]);
+        }
+        if (flagBranch) {
+          p_factory->setMode(branch_relay);
+          ybusMap.incrementMatrix(ymats[i]);
+        }
+      }
+    }
+    p_factory->updateoldbusvoltage();
+
+    timer->start(t_predictor);
+    p_factory->predictor(h_step, flag);
+    timer->stop(t_predictor);
+    p_factory->saveStateValues();
+
+    p_factory->corrector_currentInjection(flag);
+    p_factory->setMode(make_INorton_full);
+    nbusMap.mapToVector(INorton_full);
+    timer->start(t_csolve);
+    volt_full->zero();
+    if (flagP == 0) {
+      solver.solve(*INorton_full, *volt_full);
+    } else if (flagP == 1) {
+      solver_fy.solve(*INorton_full, *volt_full);
+    } else {
+      solver_posfy.solve(*INorton_full, *volt_full);
+    }
+    timer->stop(t_csolve);
+    nbusMap.mapToBus(volt_full);
+    p_factory->setVolt(false);
+    p_factory->updateBusFreq(h_step);
+
+    timer->start(t_corrector);
+    p_factory->corrector(h_step, false);
+    timer->stop(t_corrector);
+
+    // Estimate error from difference between predicted and corrected
+    // states. Steps during the fault, at the minimum step size, while
+    // relays are timing or in which a relay tripped are always accepted
+    timer->start(t_control);
+    double err = p_factory->getStateError();
+    double ratio = err/p_adaptive_tolerance;
+    bool forced = (flagP == 1 || timing || flagBus || flagBranch ||
+        h_step <= p_min_time_step + teps);
+    if (!forced && ratio > 1.0) {
+      double factor = safety*sqrt(1.0/ratio);
+      if (factor < minFactor) factor = minFactor;
+      h = h_step*factor;
+      if (h < p_min_time_step) h = p_min_time_step;
+      p_rejected_steps++;
+      p_factory->restore(step_buses, step_branches);
+      retry = true;
+      timer->stop(t_control);
+      continue;
+    }
+    p_accepted_steps++;
+    first = false;
+    retry = false;
+    if (h_step < h_min_used) h_min_used = h_step;
+    if (h_step > h_max_used) h_max_used = h_step;
+    double t_old = time;
+    time = landing ? t_event : time + h_step;
+
+    // Size of next step
+    double factor = maxFactor;
+    if (ratio > 0.0) factor = safety*sqrt(1.0/ratio);
+    if (factor < minFactor) factor = minFactor;
+    if (factor > maxFactor) factor = maxFactor;
+    h = h_step*factor;
+    if (h < p_min_time_step) h = p_min_time_step;
+    if (h > p_max_time_step) h = p_max_time_step;
+    timer->stop(t_control);
+
+    // Switch network at the start and end of the fault and restart the
+    // step size controller
+    if (landing && flagP == 0 && time < p_sim_time - teps) {
+      solver_fy.solve(*INorton_full, *volt_full);
+      nbusMap.mapToBus(volt_full);
+      p_factory->setVolt(false);
+      p_factory->updateBusFreq(h_step);
+      h = p_min_time_step;
+    } else if (landing && flagP == 1 && time < p_sim_time - teps) {
+      solver_posfy.solve(*INorton_full, *volt_full);
+      nbusMap.mapToBus(volt_full);
+      p_factory->setVolt(true);
+      p_factory->updateBusFreq(h_step);
+      h = p_min_time_step;
+    }
+
+    // Write out results on the fixed output grids
+    timer->start(t_secure);
+    if (p_generatorWatch) {
+      while (genOut*genInterval <= time + teps) {
+        double frac = (genOut*genInterval - t_old)/(time - t_old);
+        if (frac < 0.0) frac = 0.0;
+        if (frac > 1.0) frac = 1.0;
+        p_factory->setWatchInterpolation(frac);
+        char tbuf[64];
+#ifdef USE_TIMESTAMP
+        sprintf(tbuf,"%8.4f, %20.4f",genOut*genInterval,
+            timer->currentTime());
+#else
+        sprintf(tbuf,"%8.4f",genOut*genInterval);
 #endif
- 
-  
+        p_generatorIO->header(tbuf);
+        p_generatorIO->write("watch_interpolated");
+        p_generatorIO->header("\n");
+#ifdef USEX_GOSS
+        p_generatorIO->dumpChannel();
+#endif
+        genOut++;
+      }
+    }
+    if (p_loadWatch && loadOut*loadInterval <= time + teps) {
+      char tbuf[64];
+#ifdef USE_TIMESTAMP
+      sprintf(tbuf,"%8.4f, %20.4f",time,timer->currentTime());
+#else
+      sprintf(tbuf,"%8.4f",time);
+#endif
+      p_loadIO->header(tbuf);
+      p_loadIO->write("load_watch");
+      p_loadIO->header("\n");
+#ifdef USEX_GOSS
+      p_loadIO->dumpChannel();
+#endif
+      while (loadOut*loadInterval <= time + teps) loadOut++;
+    }
+    while (seriesOut*p_time_step <= time + teps) {
+      double frac = (seriesOut*p_time_step - t_old)/(time - t_old);
+      if (frac < 0.0) frac = 0.0;
+      saveTimeStep(frac);
+      seriesOut++;
+    }
+    p_factory->saveWatchedValues();
+    if ((!p_factory->securityCheck()) && p_insecureAt == -1)
+      p_insecureAt = static_cast<int>(time/p_time_step + 0.5);
+    timer->stop(t_secure);
+    if (p_monitorGenerators) {
+      p_frequencyOK = p_frequencyOK && checkFrequency(p_maximumFrequency);
+      if (!p_frequencyOK) break;
+    }
+  }
+
+  char buf[256];
+  sprintf(buf,"\nAdaptive time stepping: %d accepted steps, %d rejected steps\n",
+      p_accepted_steps,p_rejected_steps);
+  p_busIO->header(buf);
+  sprintf(buf,"  Step size range: %12.6f to %12.6f (base time step %12.6f)\n",
+      h_min_used,h_max_used,p_time_step);
+  p_busIO->header(buf);
+  int nsteps = p_accepted_steps+p_rejected_steps;
+  if (nsteps > 0) {
+    sprintf(buf,"  Fixed time step integration: %d steps, reduction: %8.2f\n",
+        nfixed,static_cast<double>(nfixed)/static_cast<double>(nsteps));
+    p_busIO->header(buf);
+  }
 }
 
 /**
@@ -1527,8 +2164,10 @@ void gridpack::dynamic_simulation::DSFullApp::saveTimeSeries(bool flag)
 
 /**
  * Save time series data for watched generators
+ * @param frac if less than 1, save values interpolated by this fraction
+ * between the start and end of the current time step
  */
-void gridpack::dynamic_simulation::DSFullApp::saveTimeStep()
+void gridpack::dynamic_simulation::DSFullApp::saveTimeStep(double frac)
 {
   if (!p_save_time_series) return;
   int nbus = p_gen_buses.size();
@@ -1539,7 +2178,12 @@ void gridpack::dynamic_simulation::DSFullApp::saveTimeStep()
     if (p_network->getActiveBus(p_gen_buses[i])) {
       bus = dynamic_cast<gridpack::dynamic_simulation::DSFullBus*>
         (p_network->getBus(p_gen_buses[i]).get());
-      std::vector<double> vals = bus->getWatchedValues();
+      std::vector<double> vals;
+      if (frac < 1.0) {
+        vals = bus->getInterpolatedWatchedValues(frac);
+      } else {
+        vals = bus->getWatchedValues();
+      }
       for (j=0; j<vals.size(); j++) {
         p_time_series[icnt].push_back(vals[j]);
         icnt++;
@@ -21,12 +21,77 @@
 #include "boost/smart_ptr/shared_ptr.hpp"
 #include "gridpack/configuration/configuration.hpp"
 #include "gridpack/serial_io/serial_io.hpp"
+#include "gridpack/mapper/full_map.hpp"
+#include "gridpack/mapper/bus_vector_map.hpp"
+#include "gridpack/math/math.hpp"
 #include "dsf_factory.hpp"
+#include "dsf_cosim.hpp"
 
 
 namespace gridpack {
 namespace dynamic_simulation {
 
+    // Complete state of a dynamic simulation at the start of a time step.
+    // Checkpoints are created by DSFullApp::solve and restored by
+    // DSFullApp::restore
+
+class DSFullCheckpoint
+{
+  public:
+
+    /**
+     * Basic constructor
+     */
+    DSFullCheckpoint(void);
+
+    /**
+     * Basic destructor
+     */
+    ~DSFullCheckpoint(void);
+
+    /**
+     * Check if checkpoint holds a simulation state
+     * @return true if checkpoint has been saved
+     */
+    bool isValid(void) const;
+
+    /**
+     * Simulation time at which checkpoint was saved
+     * @return time of checkpoint
+     */
+    double getTime(void) const;
+
+  private:
+
+    friend class DSFullApp;
+
+    bool p_valid;
+
+    // simulation time and index of next step of fixed step integrator
+    double p_time;
+    int p_step;
+    double p_time_step;
+
+    // stage of simulation (0: pre-fault, 1: fault-on, 2: post-fault) and
+    // the fault being simulated when checkpoint was saved
+    int p_stage;
+    gridpack::dynamic_simulation::Event p_fault;
+
+    // copies of buses and branches, including all model states
+    std::vector<boost::shared_ptr<DSFullBus> > p_buses;
+    std::vector<boost::shared_ptr<DSFullBranch> > p_branches;
+
+    // Y-matrices for each stage, including changes made by relays
+    boost::shared_ptr<gridpack::math::Matrix> p_ybus;
+    boost::shared_ptr<gridpack::math::Matrix> p_ybus_fy;
+    boost::shared_ptr<gridpack::math::Matrix> p_ybus_posfy;
+
+    // security status and time series up to checkpoint
+    int p_insecureAt;
+    bool p_frequencyOK;
+    std::vector<std::vector<double> > p_time_series;
+};
+
     // Calling program for dynamic simulation application
 
 class DSFullApp
@@ -95,6 +160,32 @@ class DSFullApp
      */
     void solve(gridpack::dynamic_simulation::Event fault);
 
+    /**
+     * Execute the time integration up to time end and save the complete
+     * state of the simulation in a checkpoint. Integration starts at t=0,
+     * or at the most recently restored checkpoint. A checkpoint saved
+     * before the last step of the pre-fault period can be used to start any
+     * fault that does not begin before the checkpoint. Later checkpoints
+     * can only be used to continue the same fault. Checkpoints use the
+     * fixed step integrator
+     * @param fault fault event being simulated
+     * @param end time at which integration stops
+     * @param checkpoint state of simulation at the start of the first step
+     * at or after end
+     */
+    void solve(gridpack::dynamic_simulation::Event fault, double end,
+        DSFullCheckpoint &checkpoint);
+
+    /**
+     * Restore the state of the simulation from a checkpoint. The next call
+     * to solve continues the integration from the checkpoint instead of
+     * initializing the models from the power flow solution. The checkpoint
+     * is not modified, so several faults can be branched from it. This
+     * should be called after initialize or reload
+     * @param checkpoint simulation state saved by solve
+     */
+    void restore(const DSFullCheckpoint &checkpoint);
+
     /**
      * Write out final results of dynamic simulation calculation to standard output
      */
@@ -248,6 +339,13 @@ class DSFullApp
      */
     void setFrequencyMonitoring(bool flag, double maxFreq);
 
+    /**
+     * Values received from the external simulator in the most recent
+     * co-simulation exchange
+     * @return received value set
+     */
+    const CosimValueSet& getCosimInputs() const;
+
   private:
     /**
      * Utility function to convert faults that are in event list into
@@ -281,8 +379,45 @@ class DSFullApp
 
     /**
      * Save time series data for watched generators
-     */
-    void saveTimeStep();
+     * @param frac if less than 1, save values interpolated by this fraction
+     * between the start and end of the current time step
+     */
+    void saveTimeStep(double frac = 1.0);
+
+    /**
+     * Integrate the system using modified Euler steps whose size is
+     * chosen from an estimate of the local error. The estimate is the
+     * difference between the predicted and corrected generator states.
+     * Steps that exceed the tolerance are rejected and repeated with a
+     * smaller step. Steps land exactly on the start and end of the fault,
+     * the fault-on period uses the fault time step and the base time step
+     * is used while any relay is timing towards a trip. Generator watch
+     * output and time series are interpolated onto the fixed output grid.
+     * @param fault fault event being simulated
+     * @param ybusMap mapper used to modify Y-matrices after relay trips
+     * @param nbusMap mapper for Norton currents and bus voltages
+     * @param ybus pre-fault Y-matrix
+     * @param ybus_fy fault-on Y-matrix
+     * @param ybus_posfy post-fault Y-matrix
+     * @param solver linear solver for pre-fault stage
+     * @param solver_fy linear solver for fault-on stage
+     * @param solver_posfy linear solver for post-fault stage
+     * @param INorton_full vector of Norton currents
+     * @param volt_full vector of bus voltages
+     * @param nfixed number of steps taken by the fixed step integrator
+     */
+    void integrateAdaptive(gridpack::dynamic_simulation::Event &fault,
+        gridpack::mapper::FullMatrixMap<DSFullNetwork> &ybusMap,
+        gridpack::mapper::BusVectorMap<DSFullNetwork> &nbusMap,
+        boost::shared_ptr<gridpack::math::Matrix> ybus,
+        boost::shared_ptr<gridpack::math::Matrix> ybus_fy,
+        boost::shared_ptr<gridpack::math::Matrix> ybus_posfy,
+        gridpack::math::LinearSolver &solver,
+        gridpack::math::LinearSolver &solver_fy,
+        gridpack::math::LinearSolver &solver_posfy,
+        boost::shared_ptr<gridpack::math::Vector> INorton_full,
+        boost::shared_ptr<gridpack::math::Vector> volt_full,
+        int nfixed);
 
     /**
      * Check to see if frequency variations on monitored generators are okay
@@ -299,6 +434,40 @@ class DSFullApp
      */
     bool checkFrequency(double limit);
 
+    /**
+     * Create the co-simulation exchange if a transport is specified in the
+     * Cosimulation block of the input deck
+     */
+    void openCosimulation();
+
+    /**
+     * Find the local indices of the buses or branches listed in a field
+     * of the Cosimulation block. Only buses and branches owned by this
+     * process are returned
+     * @param cursor Cosimulation block of the input deck
+     * @param field name of field containing list of bus IDs or, for
+     * branches, pairs of bus IDs
+     * @param branches true if field contains branches
+     * @return local indices
+     */
+    std::vector<int> cosimPublications(
+        gridpack::utility::Configuration::CursorPtr cursor,
+        const char *field, bool branches);
+
+    /**
+     * Complete outstanding co-simulation exchanges and report the time
+     * spent in exchanges
+     */
+    void closeCosimulation();
+
+    /**
+     * Find the wide area signal in the values received from the external
+     * simulator. This is the signal with the highest index
+     * @param value value returned if no signal was received
+     * @return wide area signal
+     */
+    double cosimSignal(double value);
+
     std::vector<gridpack::dynamic_simulation::Event> p_faults;
 
     // pointer to network
@@ -316,6 +485,19 @@ class DSFullApp
     // Time step
     double p_time_step;
 
+    // Parameters for adaptive time stepping
+    bool p_adaptive;
+    double p_adaptive_tolerance;
+    double p_min_time_step;
+    double p_max_time_step;
+
+    // Number of fast time steps in each step of the slow rate group
+    int p_multirate_ratio;
+
+    // Number of accepted and rejected steps in the last call to solve
+    int p_accepted_steps;
+    int p_rejected_steps;
+
     // Current step count?
     int p_S_Steps;
 
@@ -397,6 +579,22 @@ class DSFullApp
 
    // Record bus ID where frequency violation occured
    std::vector<int> p_violations;
+
+   // Checkpoint that is saved when integration reaches p_checkpoint_time
+   DSFullCheckpoint *p_checkpoint;
+   double p_checkpoint_time;
+
+   // Checkpoint that the next call to solve starts from
+   DSFullCheckpoint p_restart;
+   bool p_restarted;
+
+   // Exchange of values with an external simulator and the values that
+   // are published each step
+   boost::shared_ptr<CosimExchange> p_cosim;
+   std::vector<int> p_cosimVoltages;
+   std::vector<int> p_cosimInjections;
+   std::vector<int> p_cosimBreakers;
+   CosimValueSet p_cosimInputs;
 };
 
 } // dynamic simulation
@@ -59,6 +59,9 @@ gridpack::dynamic_simulation::DSFullBus::DSFullBus(void)
   p_CmplFeederBus = NULL; 
   p_CmplXfmr_xxf = 0.01;
   p_CmplXfmr_tap = 0.0; 
+  p_watch_frac = 1.0;
+  p_rate_ratio = 1;
+  p_slow_step = true;
   p_pl = 0.0;
   p_ql = 0.0;
   p_relaytrippedbranch = NULL;
@@ -502,7 +505,11 @@ void gridpack::dynamic_simulation::DSFullBus::predictor(double t_inc, bool flag)
 	//if (!p_generators[i]->getGenStatus()) {
 	//	continue;
 	//}
-    p_loadmodels[i]->predictor(t_inc,flag);
+    if (p_rate_ratio > 1 && p_loadmodels[i]->getRateGroup() == SLOW_RATE) {
+      if (p_slow_step) p_loadmodels[i]->predictor(t_inc*p_rate_ratio,flag);
+    } else {
+      p_loadmodels[i]->predictor(t_inc,flag);
+    }
   }
   
 #endif
@@ -604,12 +611,34 @@ void gridpack::dynamic_simulation::DSFullBus::corrector(double t_inc, bool flag)
 	//if (!p_generators[i]->getGenStatus()) {
 	//	continue;
 	//}
-    p_loadmodels[i]->corrector(t_inc,flag);
+    if (p_rate_ratio > 1 && p_loadmodels[i]->getRateGroup() == SLOW_RATE) {
+      if (p_slow_step) p_loadmodels[i]->corrector(t_inc*p_rate_ratio,flag);
+    } else {
+      p_loadmodels[i]->corrector(t_inc,flag);
+    }
   }
   
 #endif
 }
 
+/**
+ * Set parameters for multirate integration. Models in the slow rate group
+ * are only advanced on slow steps
+ * @param ratio number of fast steps in each slow step
+ * @param substep index of the fast step within the current slow step.
+ * Slow models are advanced when this is 0
+ */
+void gridpack::dynamic_simulation::DSFullBus::setMultirateStep(int ratio,
+    int substep)
+{
+  p_rate_ratio = ratio;
+  p_slow_step = (substep == 0);
+  int i;
+  for (i = 0; i < p_ngen; i++) {
+    p_generators[i]->setMultirateStep(ratio, substep);
+  }
+}
+
 void gridpack::dynamic_simulation::DSFullBus::setWideAreaFreqforPSS(double freq){
 	
   int i;
@@ -1730,6 +1759,24 @@ double gridpack::dynamic_simulation::DSFullBus::getBusVolFrequency(void) //renke
 	return p_busvolfreq;
 }
 
+/**
+ * Return the current injected at this bus by generators that have not
+ * been tripped and by dynamic loads
+ * @return: complex current injection
+ */
+gridpack::ComplexType gridpack::dynamic_simulation::DSFullBus::getCurrentInjection(void)
+{
+  gridpack::ComplexType ret(0.0,0.0);
+  int i;
+  for (i=0; i<p_ngen; i++) {
+    if (p_generators[i]->getGenStatus()) ret += p_generators[i]->INorton();
+  }
+  for (i=0; i<p_ndyn_load; i++) {
+    ret += p_loadmodels[i]->INorton();
+  }
+  return ret;
+}
+
 /**
  * set the value for the bcomputefreq
  * @return: void
@@ -1849,6 +1896,7 @@ bool gridpack::dynamic_simulation::DSFullBus::updateRelay(bool flag, double delt
 	}
 	
 	p_busrelaytripflag = bbusflag;
+	if (bbusflag) markDirty();
 	return bbusflag;
 }
 
@@ -1979,6 +2027,45 @@ bool gridpack::dynamic_simulation::DSFullBus::serialWrite(char *string,
       }
     }
     if (len > 0) return true;
+  } else if (!strcmp(signal,"watch_interpolated_header") ||
+      !strcmp(signal,"watch_interpolated")) {
+    // Rotor angle and speed of watched generators. Values are interpolated
+    // within the current time step by the fraction set in
+    // setWatchInterpolation
+    if (p_ngen == 0) return false;
+    int i, j;
+    char buf[128];
+    char *ptr = string;
+    int len = 0;
+    std::vector<double> vals;
+    if (!strcmp(signal,"watch_interpolated")) {
+      vals = getInterpolatedWatchedValues(p_watch_frac);
+    }
+    j = 0;
+    for (i=0; i<p_ngen; i++) {
+      if (p_generators[i]->getWatch()) {
+        if (!strcmp(signal,"watch_interpolated_header")) {
+          std::string tag = p_genid[i];
+          sprintf(buf,", %d_%s_angle, %d_%s_speed",idx,tag.c_str(),
+              idx,tag.c_str());
+        } else {
+          std::vector<double> gvals;
+          p_generators[i]->getWatchValues(gvals);
+          int nvals = gvals.size();
+          if (nvals < 2 || j+1 >= vals.size()) {
+            j += nvals;
+            continue;
+          }
+          sprintf(buf,", %f, %f",vals[j],vals[j+1]);
+          j += nvals;
+        }
+        int slen = strlen(buf);
+        if (len+slen < bufsize) sprintf(ptr,"%s",buf);
+        len += slen;
+        ptr += slen;
+      }
+    }
+    if (len > 0) return true;
   } else if (!strcmp(signal,"load_watch_header") ||
       !strcmp(signal,"load_watch")) {
     if (p_ndyn_load == 0) return false;
@@ -2231,6 +2318,148 @@ std::vector<double> gridpack::dynamic_simulation::DSFullBus::getWatchedValues()
   return ret;
 }
 
+/**
+ * Return the current values of the state variables of the generators,
+ * exciters, governors, stabilizers and dynamic loads on the bus
+ * @return state variables of all dynamic models on bus
+ */
+std::vector<double> gridpack::dynamic_simulation::DSFullBus::getStateValues()
+{
+  std::vector<double> ret;
+  p_getStateValues(ret);
+  return ret;
+}
+
+/**
+ * Collect the state variables of all dynamic models on the bus
+ * @param vals state variables
+ */
+void gridpack::dynamic_simulation::DSFullBus::p_getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+  std::vector<double> mvals;
+  int i;
+  for (i=0; i<p_ngen; i++) {
+    p_generators[i]->getStateValues(mvals);
+    vals.insert(vals.end(), mvals.begin(), mvals.end());
+    boost::shared_ptr<BaseExciterModel> exciter =
+      p_generators[i]->getExciter();
+    if (exciter) {
+      exciter->getStateValues(mvals);
+      vals.insert(vals.end(), mvals.begin(), mvals.end());
+    }
+    boost::shared_ptr<BaseGovernorModel> governor =
+      p_generators[i]->getGovernor();
+    if (governor) {
+      governor->getStateValues(mvals);
+      vals.insert(vals.end(), mvals.begin(), mvals.end());
+    }
+    boost::shared_ptr<BasePssModel> pss = p_generators[i]->getPss();
+    if (pss) {
+      pss->getStateValues(mvals);
+      vals.insert(vals.end(), mvals.begin(), mvals.end());
+    }
+  }
+  for (i=0; i<p_ndyn_load; i++) {
+    p_loadmodels[i]->getStateValues(mvals);
+    vals.insert(vals.end(), mvals.begin(), mvals.end());
+  }
+}
+
+/**
+ * Save the current values of the state variables of the generators,
+ * exciters, governors, stabilizers and dynamic loads on the bus so
+ * that they can be compared with the values at the end of the
+ * corrector
+ */
+void gridpack::dynamic_simulation::DSFullBus::saveStateValues()
+{
+  p_getStateValues(p_saved_states);
+}
+
+/**
+ * Return the largest difference between the current state variables
+ * and the values saved by saveStateValues. Differences are scaled by
+ * the magnitude of the state variable if it exceeds 1
+ * @return maximum scaled difference
+ */
+double gridpack::dynamic_simulation::DSFullBus::getStateError()
+{
+  double ret = 0.0;
+  std::vector<double> vals;
+  p_getStateValues(vals);
+  int i;
+  for (i=0; i<vals.size() && i<p_saved_states.size(); i++) {
+    double scale = fabs(vals[i]);
+    if (scale < 1.0) scale = 1.0;
+    double err = fabs(vals[i]-p_saved_states[i])/scale;
+    if (err > ret) ret = err;
+  }
+  return ret;
+}
+
+/**
+ * Save the current watched values so that they can be used as the
+ * starting point for interpolating watched values within a time step
+ */
+void gridpack::dynamic_simulation::DSFullBus::saveWatchedValues()
+{
+  p_saved_watch = getWatchedValues();
+}
+
+/**
+ * Set the fraction of the time step that is used to interpolate
+ * watched values for the "watch_interpolated" output signal
+ * @param frac fraction of time step (0 gives the saved values, 1 gives
+ * the current values)
+ */
+void gridpack::dynamic_simulation::DSFullBus::setWatchInterpolation(double frac)
+{
+  p_watch_frac = frac;
+}
+
+/**
+ * Return watched values interpolated between the values saved by
+ * saveWatchedValues and the current values
+ * @param frac fraction of time step
+ * @return rotor angle and speed for all watched generators on bus
+ */
+std::vector<double>
+gridpack::dynamic_simulation::DSFullBus::getInterpolatedWatchedValues(double frac)
+{
+  std::vector<double> ret = getWatchedValues();
+  if (p_saved_watch.size() != ret.size()) return ret;
+  int i;
+  for (i=0; i<ret.size(); i++) {
+    ret[i] = p_saved_watch[i] + frac*(ret[i]-p_saved_watch[i]);
+  }
+  return ret;
+}
+
+/**
+ * Check to see if any relay on this bus is timing towards a trip
+ * @return true if a relay timer is running
+ */
+bool gridpack::dynamic_simulation::DSFullBus::relayTiming()
+{
+  int i, j;
+  for (i=0; i<p_loadrelays.size(); i++) {
+    if (p_loadrelays[i]->getOperationStatus() &&
+        p_loadrelays[i]->isTiming()) return true;
+  }
+  for (i=0; i<p_ngen; i++) {
+    int nrelay;
+    p_generators[i]->getRelayNumber(nrelay);
+    for (j=0; j<nrelay; j++) {
+      boost::shared_ptr<gridpack::dynamic_simulation::BaseRelayModel> relay
+        = p_generators[i]->getRelay(j);
+      if (relay->getOperationStatus() && relay->isTiming()) return true;
+    }
+  }
+  return false;
+}
+
 /**
  * Check generators for frequency violations
  * @param start time at which monitoring begins
@@ -2490,6 +2719,64 @@ int gridpack::dynamic_simulation::DSFullBus::getZone()
   return p_zone;
 }
 
+/**
+ * Create a copy of the bus that holds its current dynamic state,
+ * including copies of its generator, load and relay models
+ * @return copy of bus
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::DSFullBus>
+gridpack::dynamic_simulation::DSFullBus::checkpoint()
+{
+  boost::shared_ptr<DSFullBus> ret(new DSFullBus(*this));
+  int i;
+  for (i=0; i<p_generators.size(); i++) {
+    ret->p_generators[i] = p_generators[i]->clone();
+  }
+  for (i=0; i<p_loadrelays.size(); i++) {
+    ret->p_loadrelays[i] = p_loadrelays[i]->clone();
+  }
+  for (i=0; i<p_loadmodels.size(); i++) {
+    ret->p_loadmodels[i] = p_loadmodels[i]->clone();
+  }
+  return ret;
+}
+
+/**
+ * Restore the dynamic state of the bus from a copy created by
+ * checkpoint. The copy is not modified, so it can be restored more than
+ * once. Watch settings of the generators and loads on the bus are not
+ * changed
+ * @param state copy of bus
+ */
+void gridpack::dynamic_simulation::DSFullBus::restore(const DSFullBus &state)
+{
+  int i;
+  std::vector<bool> gen_watch, load_watch;
+  for (i=0; i<p_generators.size(); i++) {
+    gen_watch.push_back(p_generators[i]->getWatch());
+  }
+  for (i=0; i<p_loadmodels.size(); i++) {
+    load_watch.push_back(p_loadmodels[i]->getWatch());
+  }
+  // The revision count must keep increasing so that mappers pick up the
+  // restored values
+  unsigned int revision = p_revision;
+  *this = state;
+  p_revision = revision;
+  markDirty();
+  for (i=0; i<p_generators.size(); i++) {
+    p_generators[i] = state.p_generators[i]->clone();
+    if (i < gen_watch.size()) p_generators[i]->setWatch(gen_watch[i]);
+  }
+  for (i=0; i<p_loadrelays.size(); i++) {
+    p_loadrelays[i] = state.p_loadrelays[i]->clone();
+  }
+  for (i=0; i<p_loadmodels.size(); i++) {
+    p_loadmodels[i] = state.p_loadmodels[i]->clone();
+    if (i < load_watch.size()) p_loadmodels[i]->setWatch(load_watch[i]);
+  }
+}
+
 /**
  *  Simple constructor
  */
@@ -2846,6 +3133,20 @@ void gridpack::dynamic_simulation::DSFullBranch::updateBranchCurrent() //renke a
 /**
 * update the relay status associate with this branch
 */
+/**
+ * Check to see if any relay on this branch is timing towards a trip
+ * @return true if a relay timer is running
+ */
+bool gridpack::dynamic_simulation::DSFullBranch::relayTiming()
+{
+  int i;
+  for (i=0; i<p_linerelays.size(); i++) {
+    if (p_linerelays[i]->getOperationStatus() &&
+        p_linerelays[i]->isTiming()) return true;
+  }
+  return false;
+}
+
 bool gridpack::dynamic_simulation::DSFullBranch::updateRelay(bool flag, double delta_t) //renke add
 {
 	int irelay, nrelay, itrip, itrip_prev, ibranch;
@@ -2912,6 +3213,11 @@ bool gridpack::dynamic_simulation::DSFullBranch::updateRelay(bool flag, double d
 	}
 	
 	p_branchrelaytripflag = bbranchflag;
+	if (bbranchflag) {
+		markDirty();
+		bus1->markDirty();
+		bus2->markDirty();
+	}
 	return bbranchflag;
 }
 
@@ -3173,6 +3479,23 @@ void gridpack::dynamic_simulation::DSFullBranch::printDSFullBranch()
 	}	
 }
 
+/**
+ * Get the circuit IDs and status of the lines in this branch
+ * @param tags circuit IDs of lines
+ * @param status status of each line (1: closed, 0: open)
+ */
+void gridpack::dynamic_simulation::DSFullBranch::getLineStatus(
+    std::vector<std::string> &tags, std::vector<int> &status)
+{
+  tags.clear();
+  status.clear();
+  int i;
+  for (i=0; i<p_elems; i++) {
+    tags.push_back(p_ckt[i]);
+    status.push_back(p_branch_status[i]);
+  }
+}
+
 /**
  * check the type of the extended load branch type variable: p_bextendedloadbranch
  */
@@ -3180,3 +3503,38 @@ int gridpack::dynamic_simulation::DSFullBranch::checkExtendedLoadBranchType(void
 {
 	return p_bextendedloadbranch;
 }
+
+/**
+ * Create a copy of the branch that holds its current dynamic state,
+ * including copies of its relay models
+ * @return copy of branch
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::DSFullBranch>
+gridpack::dynamic_simulation::DSFullBranch::checkpoint()
+{
+  boost::shared_ptr<DSFullBranch> ret(new DSFullBranch(*this));
+  int i;
+  for (i=0; i<p_linerelays.size(); i++) {
+    ret->p_linerelays[i] = p_linerelays[i]->clone();
+  }
+  return ret;
+}
+
+/**
+ * Restore the dynamic state of the branch from a copy created by
+ * checkpoint. The copy is not modified, so it can be restored more than
+ * once
+ * @param state copy of branch
+ */
+void gridpack::dynamic_simulation::DSFullBranch::restore(
+    const DSFullBranch &state)
+{
+  unsigned int revision = p_revision;
+  *this = state;
+  p_revision = revision;
+  markDirty();
+  int i;
+  for (i=0; i<p_linerelays.size(); i++) {
+    p_linerelays[i] = state.p_linerelays[i]->clone();
+  }
+}
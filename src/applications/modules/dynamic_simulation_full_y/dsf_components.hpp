@@ -257,12 +257,28 @@ class DSFullBus
      * @return: voltage frequency
      */
     double getBusVolFrequency(void); //renke add
+
+    /**
+     * Return the current injected at this bus by generators that have not
+     * been tripped and by dynamic loads
+     * @return: complex current injection
+     */
+    gridpack::ComplexType getCurrentInjection(void);
 	
 	void setBusVolFrequencyFlag(bool flag); //renke add
 	
 	void printbusvoltage (void); //renke add
 	
 	void setWideAreaFreqforPSS(double freq); //renke hard coded;
+
+    /**
+     * Set parameters for multirate integration. Models in the slow rate
+     * group are only advanced on slow steps
+     * @param ratio number of fast steps in each slow step
+     * @param substep index of the fast step within the current slow step.
+     * Slow models are advanced when this is 0
+     */
+    void setMultirateStep(int ratio, int substep);
 	
 	
 	/**
@@ -387,6 +403,57 @@ class DSFullBus
      */
     std::vector<double> getWatchedValues();
 
+    /**
+     * Return the current values of the state variables of the generators,
+     * exciters, governors, stabilizers and dynamic loads on the bus
+     * @return state variables of all dynamic models on bus
+     */
+    std::vector<double> getStateValues();
+
+    /**
+     * Save the current values of the state variables of the generators,
+     * exciters, governors, stabilizers and dynamic loads on the bus so
+     * that they can be compared with the values at the end of the
+     * corrector
+     */
+    void saveStateValues();
+
+    /**
+     * Return the largest difference between the current state variables
+     * and the values saved by saveStateValues. Differences are scaled by
+     * the magnitude of the state variable if it exceeds 1
+     * @return maximum scaled difference
+     */
+    double getStateError();
+
+    /**
+     * Save the current watched values so that they can be used as the
+     * starting point for interpolating watched values within a time step
+     */
+    void saveWatchedValues();
+
+    /**
+     * Set the fraction of the time step that is used to interpolate
+     * watched values for the "watch_interpolated" output signal
+     * @param frac fraction of time step (0 gives the saved values, 1 gives
+     * the current values)
+     */
+    void setWatchInterpolation(double frac);
+
+    /**
+     * Return watched values interpolated between the values saved by
+     * saveWatchedValues and the current values
+     * @param frac fraction of time step
+     * @return rotor angle and speed for all watched generators on bus
+     */
+    std::vector<double> getInterpolatedWatchedValues(double frac);
+
+    /**
+     * Check to see if any relay on this bus is timing towards a trip
+     * @return true if a relay timer is running
+     */
+    bool relayTiming();
+
     /**
      * Check generators for frequency violations
      * @param start time at which monitoring begins
@@ -489,6 +556,22 @@ class DSFullBus
      */
     void setScale(double scale);
 
+    /**
+     * Create a copy of the bus that holds its current dynamic state,
+     * including copies of its generator, load and relay models
+     * @return copy of bus
+     */
+    boost::shared_ptr<DSFullBus> checkpoint();
+
+    /**
+     * Restore the dynamic state of the bus from a copy created by
+     * checkpoint. The copy is not modified, so it can be restored more than
+     * once. Watch settings of the generators and loads on the bus are not
+     * changed
+     * @param state copy of bus
+     */
+    void restore(const DSFullBus &state);
+
 #ifdef USE_FNCS
     /**
      * Retrieve an opaque data item from component.
@@ -596,6 +679,22 @@ class DSFullBus
     std::vector<double> p_downIntervalStart;
     std::vector<bool> p_downStartedMonitoring;
 
+    // state variables at the end of the predictor and watched values at
+    // the start of the current time step, used for adaptive time stepping
+    std::vector<double> p_saved_states;
+    std::vector<double> p_saved_watch;
+    double p_watch_frac;
+
+    /**
+     * Collect the state variables of all dynamic models on the bus
+     * @param vals state variables
+     */
+    void p_getStateValues(std::vector<double> &vals);
+
+    // parameters for multirate integration
+    int p_rate_ratio;
+    bool p_slow_step;
+
 
     friend class boost::serialization::access;
 
@@ -740,6 +839,12 @@ class DSFullBranch
      */
 	void updateBranchCurrent(); //RENKE ADD
 	bool updateRelay(bool flag, double delta_t); //renke add
+
+    /**
+     * Check to see if any relay on this branch is timing towards a trip
+     * @return true if a relay timer is running
+     */
+    bool relayTiming();
 	
 	/**
      * Set parameters of the transformer branch due to composite load model
@@ -755,12 +860,35 @@ class DSFullBranch
 	* print the content of the DSFullBranch
 	*/
 	void printDSFullBranch();
+
+    /**
+     * Get the circuit IDs and status of the lines in this branch
+     * @param tags circuit IDs of lines
+     * @param status status of each line (1: closed, 0: open)
+     */
+    void getLineStatus(std::vector<std::string> &tags,
+        std::vector<int> &status);
 	
 	/**
      * check the type of the extended load branch type variable: p_bextendedloadbranch
      */
 	int checkExtendedLoadBranchType(void);
 
+    /**
+     * Create a copy of the branch that holds its current dynamic state,
+     * including copies of its relay models
+     * @return copy of branch
+     */
+    boost::shared_ptr<DSFullBranch> checkpoint();
+
+    /**
+     * Restore the dynamic state of the branch from a copy created by
+     * checkpoint. The copy is not modified, so it can be restored more than
+     * once
+     * @param state copy of branch
+     */
+    void restore(const DSFullBranch &state);
+
   private:
     std::vector<double> p_reactance;
     std::vector<double> p_resistance;
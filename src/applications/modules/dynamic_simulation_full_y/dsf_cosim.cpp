@@ -0,0 +1,510 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   dsf_cosim.cpp
+ *
+ * @brief  Exchange of published and subscribed values between the
+ * dynamic simulation and an external co-simulation transport.
+ *
+ *
+ */
+// -------------------------------------------------------------
+
+#include <cstdio>
+#include <cstring>
+#include <mpi.h>
+#include "gridpack/utilities/exception.hpp"
+#include "dsf_cosim.hpp"
+
+#ifdef USE_HELICS
+#include <helics/helics.hpp>
+#endif
+
+/**
+ * Basic constructor
+ */
+gridpack::dynamic_simulation::CosimValueSet::CosimValueSet(void)
+{
+  p_step = 0;
+  p_time = 0.0;
+}
+
+/**
+ * Basic destructor
+ */
+gridpack::dynamic_simulation::CosimValueSet::~CosimValueSet(void)
+{
+}
+
+/**
+ * Remove all values and set the step and time of the value set
+ * @param step index of time step
+ * @param time simulation time
+ */
+void gridpack::dynamic_simulation::CosimValueSet::reset(int step, double time)
+{
+  p_step = step;
+  p_time = time;
+  p_values.clear();
+}
+
+/**
+ * Add a bus voltage
+ * @param bus original bus index
+ * @param mag voltage magnitude
+ * @param ang voltage angle (radians)
+ */
+void gridpack::dynamic_simulation::CosimValueSet::addVoltage(int bus,
+    double mag, double ang)
+{
+  CosimValue value;
+  memset(&value, 0, sizeof(CosimValue));
+  value.type = COSIM_BUS_VOLTAGE;
+  value.idx1 = bus;
+  value.value[0] = mag;
+  value.value[1] = ang;
+  p_values.push_back(value);
+}
+
+/**
+ * Add a current injection at a bus
+ * @param bus original bus index
+ * @param real real part of current
+ * @param imag imaginary part of current
+ */
+void gridpack::dynamic_simulation::CosimValueSet::addInjection(int bus,
+    double real, double imag)
+{
+  CosimValue value;
+  memset(&value, 0, sizeof(CosimValue));
+  value.type = COSIM_BUS_INJECTION;
+  value.idx1 = bus;
+  value.value[0] = real;
+  value.value[1] = imag;
+  p_values.push_back(value);
+}
+
+/**
+ * Add the state of a breaker
+ * @param from original index of "from" bus
+ * @param to original index of "to" bus
+ * @param tag circuit ID of branch
+ * @param closed true if breaker is closed
+ */
+void gridpack::dynamic_simulation::CosimValueSet::addBreaker(int from, int to,
+    const std::string &tag, bool closed)
+{
+  CosimValue value;
+  memset(&value, 0, sizeof(CosimValue));
+  value.type = COSIM_BREAKER_STATE;
+  value.idx1 = from;
+  value.idx2 = to;
+  strncpy(value.tag, tag.c_str(), sizeof(value.tag)-1);
+  value.value[0] = closed ? 1.0 : 0.0;
+  p_values.push_back(value);
+}
+
+/**
+ * Add a signal
+ * @param idx index of signal
+ * @param value value of signal
+ */
+void gridpack::dynamic_simulation::CosimValueSet::addSignal(int idx,
+    double value)
+{
+  CosimValue val;
+  memset(&val, 0, sizeof(CosimValue));
+  val.type = COSIM_SIGNAL;
+  val.idx1 = idx;
+  val.value[0] = value;
+  p_values.push_back(val);
+}
+
+/**
+ * Find a signal
+ * @param idx index of signal
+ * @param value value of signal
+ * @return false if signal is not in set
+ */
+bool gridpack::dynamic_simulation::CosimValueSet::getSignal(int idx,
+    double *value) const
+{
+  int i;
+  int nsize = p_values.size();
+  for (i=0; i<nsize; i++) {
+    if (p_values[i].type == COSIM_SIGNAL && p_values[i].idx1 == idx) {
+      *value = p_values[i].value[0];
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Find the signal with the highest index
+ * @param value value of signal
+ * @return false if there are no signals in set
+ */
+bool gridpack::dynamic_simulation::CosimValueSet::getLastSignal(
+    double *value) const
+{
+  int i;
+  int idx = -1;
+  int nsize = p_values.size();
+  for (i=0; i<nsize; i++) {
+    if (p_values[i].type == COSIM_SIGNAL && p_values[i].idx1 > idx) {
+      idx = p_values[i].idx1;
+      *value = p_values[i].value[0];
+    }
+  }
+  return idx >= 0;
+}
+
+/**
+ * Number of values in set
+ * @return number of values
+ */
+int gridpack::dynamic_simulation::CosimValueSet::size(void) const
+{
+  return p_values.size();
+}
+
+/**
+ * Return a value
+ * @param idx index of value in set
+ * @return value
+ */
+const gridpack::dynamic_simulation::CosimValue&
+gridpack::dynamic_simulation::CosimValueSet::operator[](int idx) const
+{
+  return p_values[idx];
+}
+
+/**
+ * Index of time step
+ * @return step
+ */
+int gridpack::dynamic_simulation::CosimValueSet::step(void) const
+{
+  return p_step;
+}
+
+/**
+ * Simulation time of value set
+ * @return time
+ */
+double gridpack::dynamic_simulation::CosimValueSet::time(void) const
+{
+  return p_time;
+}
+
+/**
+ * Basic constructor
+ */
+gridpack::dynamic_simulation::LoopbackTransport::LoopbackTransport(void)
+{
+}
+
+/**
+ * Basic destructor
+ */
+gridpack::dynamic_simulation::LoopbackTransport::~LoopbackTransport(void)
+{
+}
+
+/**
+ * Start exchange for a time step
+ * @param outputs values published by the simulation
+ */
+void gridpack::dynamic_simulation::LoopbackTransport::post(
+    const CosimValueSet &outputs)
+{
+  p_queue.push_back(outputs);
+}
+
+/**
+ * Wait for the oldest exchange that has been posted to finish
+ * @param inputs values received from the external simulator
+ */
+void gridpack::dynamic_simulation::LoopbackTransport::complete(
+    CosimValueSet &inputs)
+{
+  if (p_queue.empty()) {
+    char buf[256];
+    sprintf(buf,"LoopbackTransport::complete: no exchange has been posted\n");
+    printf("%s",buf);
+    throw gridpack::Exception(buf);
+  }
+  inputs = p_queue.front();
+  p_queue.pop_front();
+}
+
+#ifdef USE_HELICS
+/**
+ * HELICS federate and the value sets that have been posted. Only one time
+ * request can be outstanding, so the next value set is published when
+ * the current request completes
+ */
+class gridpack::dynamic_simulation::HelicsTransport::Impl
+{
+  public:
+
+    Impl(const std::string &config)
+      : fed(config), pending(false)
+    {
+    }
+
+    void start(void)
+    {
+      const CosimValueSet &outputs = queue.front();
+      int npub = fed.getPublicationCount();
+      int i;
+      for (i=0; i<outputs.size(); i++) {
+        if (outputs[i].type == COSIM_SIGNAL && outputs[i].idx1 >= 0
+            && outputs[i].idx1 < npub) {
+          helics::Publication &pub = fed.getPublication(outputs[i].idx1);
+          pub.publish(outputs[i].value[0]);
+        }
+      }
+      fed.requestTimeAsync(outputs.time());
+      pending = true;
+    }
+
+    helics::ValueFederate fed;
+    std::deque<CosimValueSet> queue;
+    bool pending;
+};
+
+/**
+ * Basic constructor
+ * @param config name of HELICS federate configuration file
+ */
+gridpack::dynamic_simulation::HelicsTransport::HelicsTransport(
+    const std::string &config)
+{
+  p_impl = new Impl(config);
+  printf("HELICS version: %s publications: %d inputs: %d\n",
+      helics::versionString, p_impl->fed.getPublicationCount(),
+      p_impl->fed.getInputCount());
+  p_impl->fed.enterExecutingMode();
+}
+
+/**
+ * Basic destructor
+ */
+gridpack::dynamic_simulation::HelicsTransport::~HelicsTransport(void)
+{
+  delete p_impl;
+}
+
+/**
+ * Start exchange for a time step. Signals are published to the
+ * publication with the same index
+ * @param outputs values published by the simulation
+ */
+void gridpack::dynamic_simulation::HelicsTransport::post(
+    const CosimValueSet &outputs)
+{
+  p_impl->queue.push_back(outputs);
+  if (!p_impl->pending) p_impl->start();
+}
+
+/**
+ * Wait for the oldest exchange that has been posted to finish. Each input
+ * is returned as a signal with the index of the input
+ * @param inputs values received from the external simulator
+ */
+void gridpack::dynamic_simulation::HelicsTransport::complete(
+    CosimValueSet &inputs)
+{
+  if (!p_impl->pending) {
+    char buf[256];
+    sprintf(buf,"HelicsTransport::complete: no exchange has been posted\n");
+    printf("%s",buf);
+    throw gridpack::Exception(buf);
+  }
+  double granted = p_impl->fed.requestTimeComplete();
+  inputs.reset(p_impl->queue.front().step(), granted);
+  p_impl->queue.pop_front();
+  p_impl->pending = false;
+  int nsub = p_impl->fed.getInputCount();
+  int i;
+  for (i=0; i<nsub; i++) {
+    helics::Input &sub = p_impl->fed.getInput(i);
+    inputs.addSignal(i, p_impl->fed.getDouble(sub));
+  }
+  if (!p_impl->queue.empty()) p_impl->start();
+}
+
+/**
+ * Shut down the transport
+ */
+void gridpack::dynamic_simulation::HelicsTransport::finalize(void)
+{
+  CosimValueSet inputs;
+  while (p_impl->pending) complete(inputs);
+  p_impl->fed.finalize();
+}
+#endif
+
+/**
+ * Basic constructor
+ * @param comm communicator of the simulation
+ * @param transport transport used on process 0 (may be empty on
+ * other processes)
+ * @param pipelined if true, the inputs used at step k are the inputs
+ * received for step k-1
+ */
+gridpack::dynamic_simulation::CosimExchange::CosimExchange(
+    const gridpack::parallel::Communicator &comm,
+    boost::shared_ptr<CosimTransport> transport, bool pipelined)
+  : p_comm(comm), p_transport(transport), p_pipelined(pipelined)
+{
+  if (p_comm.rank() == 0 && !p_transport) {
+    char buf[256];
+    sprintf(buf,"CosimExchange: no transport on process 0\n");
+    printf("%s",buf);
+    throw gridpack::Exception(buf);
+  }
+  p_counts.resize(p_comm.size());
+  p_displs.resize(p_comm.size());
+  p_inflight = 0;
+  p_steps = 0;
+  p_post_time = 0.0;
+  p_wait_time = 0.0;
+}
+
+/**
+ * Basic destructor
+ */
+gridpack::dynamic_simulation::CosimExchange::~CosimExchange(void)
+{
+}
+
+/**
+ * Return the output buffer for a new step
+ * @param step index of time step
+ * @param time simulation time
+ * @return empty output value set
+ */
+gridpack::dynamic_simulation::CosimValueSet&
+gridpack::dynamic_simulation::CosimExchange::outputs(int step, double time)
+{
+  p_outputs.reset(step, time);
+  return p_outputs;
+}
+
+/**
+ * Post the output buffer returned by the last call to outputs. The values
+ * from all processes are gathered on process 0 and handed to the
+ * transport, which returns without waiting for the inputs. The gather is
+ * a blocking collective, so this must be called on all processes
+ */
+void gridpack::dynamic_simulation::CosimExchange::post(void)
+{
+  double start = MPI_Wtime();
+  int me = p_comm.rank();
+  int nprocs = p_comm.size();
+  int nbytes = p_outputs.p_values.size()*sizeof(CosimValue);
+  MPI_Gather(&nbytes,1,MPI_INT,&p_counts[0],1,MPI_INT,0,p_comm);
+  char *rbuf = NULL;
+  if (me == 0) {
+    int i;
+    int total = 0;
+    for (i=0; i<nprocs; i++) {
+      p_displs[i] = total;
+      total += p_counts[i];
+    }
+    p_gathered.reset(p_outputs.p_step, p_outputs.p_time);
+    p_gathered.p_values.resize(total/sizeof(CosimValue));
+    if (total > 0) rbuf = reinterpret_cast<char*>(&p_gathered.p_values[0]);
+  }
+  char *sbuf = NULL;
+  if (nbytes > 0) sbuf = reinterpret_cast<char*>(&p_outputs.p_values[0]);
+  MPI_Gatherv(sbuf,nbytes,MPI_BYTE,rbuf,&p_counts[0],&p_displs[0],
+      MPI_BYTE,0,p_comm);
+  if (me == 0) p_transport->post(p_gathered);
+  p_inflight++;
+  p_post_time += MPI_Wtime() - start;
+}
+
+/**
+ * Return the inputs to be used in the current step
+ * @param inputs values received from external simulator
+ * @return false if no inputs are available
+ */
+bool gridpack::dynamic_simulation::CosimExchange::receive(
+    CosimValueSet &inputs)
+{
+  double start = MPI_Wtime();
+  bool ret = false;
+  if (p_inflight > (p_pipelined ? 1 : 0)) {
+    p_complete(inputs);
+    ret = true;
+  }
+  p_wait_time += MPI_Wtime() - start;
+  return ret;
+}
+
+/**
+ * Complete all exchanges that are in flight and shut down the transport
+ */
+void gridpack::dynamic_simulation::CosimExchange::finalize(void)
+{
+  double start = MPI_Wtime();
+  CosimValueSet inputs;
+  while (p_inflight > 0) p_complete(inputs);
+  if (p_comm.rank() == 0) p_transport->finalize();
+  p_wait_time += MPI_Wtime() - start;
+}
+
+/**
+ * Number of exchanges that have been completed
+ * @return number of steps
+ */
+int gridpack::dynamic_simulation::CosimExchange::numSteps(void) const
+{
+  return p_steps;
+}
+
+/**
+ * Time spent posting outputs and waiting for inputs on this process
+ * @param post total time spent in post
+ * @param wait total time spent in receive
+ */
+void gridpack::dynamic_simulation::CosimExchange::getTimes(double *post,
+    double *wait) const
+{
+  *post = p_post_time;
+  *wait = p_wait_time;
+}
+
+/**
+ * Wait for the oldest exchange in the transport and broadcast its inputs
+ * @param inputs values received from external simulator
+ */
+void gridpack::dynamic_simulation::CosimExchange::p_complete(
+    CosimValueSet &inputs)
+{
+  if (p_comm.rank() == 0) p_transport->complete(inputs);
+  int hdr[2];
+  double time = inputs.p_time;
+  hdr[0] = inputs.p_step;
+  hdr[1] = inputs.p_values.size();
+  MPI_Bcast(hdr,2,MPI_INT,0,p_comm);
+  MPI_Bcast(&time,1,MPI_DOUBLE,0,p_comm);
+  if (p_comm.rank() != 0) {
+    inputs.reset(hdr[0], time);
+    inputs.p_values.resize(hdr[1]);
+  }
+  if (hdr[1] > 0) {
+    MPI_Bcast(&inputs.p_values[0],hdr[1]*sizeof(CosimValue),MPI_BYTE,0,
+        p_comm);
+  }
+  p_inflight--;
+  p_steps++;
+}
@@ -0,0 +1,379 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   dsf_cosim.hpp
+ *
+ * @brief
+ * Exchange values between the dynamic simulation and an external
+ * simulator. Each time step the values published by all processes are
+ * collected into a single value set and handed to a transport, which
+ * returns the value set received from the external simulator. Exchanges
+ * are double buffered, so the transport can deliver the values of one
+ * step while the next step is being computed. Collecting and
+ * distributing the values are blocking collective operations; only the
+ * transport works in the background.
+ *
+ */
+// -------------------------------------------------------------
+
+#ifndef _dsf_cosim_h_
+#define _dsf_cosim_h_
+
+#include <deque>
+#include <string>
+#include <vector>
+#include "boost/smart_ptr/shared_ptr.hpp"
+#include "gridpack/parallel/communicator.hpp"
+
+namespace gridpack {
+namespace dynamic_simulation {
+
+    // Types of values exchanged with an external simulator
+
+enum CosimValueType{COSIM_BUS_VOLTAGE, COSIM_BUS_INJECTION,
+  COSIM_BREAKER_STATE, COSIM_SIGNAL};
+
+    // A single value. Bus values use idx1 for the bus index, breaker
+    // states use idx1 and idx2 for the buses at either end of the branch
+    // and tag for the circuit ID. Signals use idx1 as the signal index.
+    // Voltages store magnitude and angle, injections the real and
+    // imaginary parts of the current and breaker states 1 (closed) or
+    // 0 (open) in value[0]
+
+struct CosimValue {
+  int type;
+  int idx1;
+  int idx2;
+  char tag[4];
+  double value[2];
+};
+
+    // All values exchanged in one time step
+
+class CosimValueSet
+{
+  public:
+
+    /**
+     * Basic constructor
+     */
+    CosimValueSet(void);
+
+    /**
+     * Basic destructor
+     */
+    ~CosimValueSet(void);
+
+    /**
+     * Remove all values and set the step and time of the value set
+     * @param step index of time step
+     * @param time simulation time
+     */
+    void reset(int step, double time);
+
+    /**
+     * Add a bus voltage
+     * @param bus original bus index
+     * @param mag voltage magnitude
+     * @param ang voltage angle (radians)
+     */
+    void addVoltage(int bus, double mag, double ang);
+
+    /**
+     * Add a current injection at a bus
+     * @param bus original bus index
+     * @param real real part of current
+     * @param imag imaginary part of current
+     */
+    void addInjection(int bus, double real, double imag);
+
+    /**
+     * Add the state of a breaker
+     * @param from original index of "from" bus
+     * @param to original index of "to" bus
+     * @param tag circuit ID of branch
+     * @param closed true if breaker is closed
+     */
+    void addBreaker(int from, int to, const std::string &tag, bool closed);
+
+    /**
+     * Add a signal
+     * @param idx index of signal
+     * @param value value of signal
+     */
+    void addSignal(int idx, double value);
+
+    /**
+     * Find a signal
+     * @param idx index of signal
+     * @param value value of signal
+     * @return false if signal is not in set
+     */
+    bool getSignal(int idx, double *value) const;
+
+    /**
+     * Find the signal with the highest index
+     * @param value value of signal
+     * @return false if there are no signals in set
+     */
+    bool getLastSignal(double *value) const;
+
+    /**
+     * Number of values in set
+     * @return number of values
+     */
+    int size(void) const;
+
+    /**
+     * Return a value
+     * @param idx index of value in set
+     * @return value
+     */
+    const CosimValue& operator[](int idx) const;
+
+    /**
+     * Index of time step
+     * @return step
+     */
+    int step(void) const;
+
+    /**
+     * Simulation time of value set
+     * @return time
+     */
+    double time(void) const;
+
+  private:
+
+    friend class CosimExchange;
+
+    int p_step;
+    double p_time;
+    std::vector<CosimValue> p_values;
+};
+
+    // Transport that moves value sets to and from an external simulator.
+    // Value sets are posted in order and completed in the same order.
+    // Post should return as soon as the outputs have been handed off so
+    // that the simulation can continue while they are in flight
+
+class CosimTransport
+{
+  public:
+
+    /**
+     * Basic destructor
+     */
+    virtual ~CosimTransport(void) {}
+
+    /**
+     * Start exchange for a time step
+     * @param outputs values published by the simulation
+     */
+    virtual void post(const CosimValueSet &outputs) = 0;
+
+    /**
+     * Wait for the oldest exchange that has been posted to finish
+     * @param inputs values received from the external simulator
+     */
+    virtual void complete(CosimValueSet &inputs) = 0;
+
+    /**
+     * Shut down the transport
+     */
+    virtual void finalize(void) {}
+};
+
+    // In-process transport for testing. The values received for each
+    // step are the values that were published, so the simulation is
+    // coupled to itself
+
+class LoopbackTransport
+  : public CosimTransport
+{
+  public:
+
+    /**
+     * Basic constructor
+     */
+    LoopbackTransport(void);
+
+    /**
+     * Basic destructor
+     */
+    ~LoopbackTransport(void);
+
+    /**
+     * Start exchange for a time step
+     * @param outputs values published by the simulation
+     */
+    void post(const CosimValueSet &outputs);
+
+    /**
+     * Wait for the oldest exchange that has been posted to finish
+     * @param inputs values received from the external simulator
+     */
+    void complete(CosimValueSet &inputs);
+
+  private:
+
+    std::deque<CosimValueSet> p_queue;
+};
+
+#ifdef USE_HELICS
+    // Transport using a HELICS value federate. Values are published in the
+    // order of the publications in the federate configuration and each
+    // input is returned as a signal. The time request is made
+    // asynchronously when the outputs are posted
+
+class HelicsTransport
+  : public CosimTransport
+{
+  public:
+
+    /**
+     * Basic constructor
+     * @param config name of HELICS federate configuration file
+     */
+    HelicsTransport(const std::string &config);
+
+    /**
+     * Basic destructor
+     */
+    ~HelicsTransport(void);
+
+    /**
+     * Start exchange for a time step
+     * @param outputs values published by the simulation
+     */
+    void post(const CosimValueSet &outputs);
+
+    /**
+     * Wait for the oldest exchange that has been posted to finish
+     * @param inputs values received from the external simulator
+     */
+    void complete(CosimValueSet &inputs);
+
+    /**
+     * Shut down the transport
+     */
+    void finalize(void);
+
+  private:
+
+    class Impl;
+    Impl *p_impl;
+};
+#endif
+
+    // Double buffered exchange of value sets between all processes in a
+    // communicator and a transport. Process 0 talks to the transport.
+    // Outputs are gathered from all processes when they are posted and
+    // inputs are broadcast when they are received. Both are blocking
+    // collective calls, so the cost of gathering grows with the number
+    // of values that are published. Only the transport runs
+    // asynchronously with the simulation
+
+class CosimExchange
+{
+  public:
+
+    /**
+     * Basic constructor
+     * @param comm communicator of the simulation
+     * @param transport transport used on process 0 (may be empty on
+     * other processes)
+     * @param pipelined if true, the inputs used at step k are the inputs
+     * received for step k-1 so that the exchange for step k overlaps the
+     * remainder of the step. Otherwise each step waits for its own inputs
+     */
+    CosimExchange(const gridpack::parallel::Communicator &comm,
+        boost::shared_ptr<CosimTransport> transport, bool pipelined);
+
+    /**
+     * Basic destructor
+     */
+    ~CosimExchange(void);
+
+    /**
+     * Return the output buffer for a new step. The buffer can be filled
+     * with the local values of this process
+     * @param step index of time step
+     * @param time simulation time
+     * @return empty output value set
+     */
+    CosimValueSet& outputs(int step, double time);
+
+    /**
+     * Post the output buffer returned by the last call to outputs. This
+     * is a blocking collective call that must be made on all processes.
+     * It returns when the outputs of all processes have been gathered on
+     * process 0 and handed to the transport. The transport may still be
+     * sending them when post returns
+     */
+    void post(void);
+
+    /**
+     * Return the inputs to be used in the current step. In pipelined mode
+     * these belong to the previous step, and there are no inputs for the
+     * first step. This must be called on all processes
+     * @param inputs values received from external simulator
+     * @return false if no inputs are available
+     */
+    bool receive(CosimValueSet &inputs);
+
+    /**
+     * Complete all exchanges that are in flight and shut down the
+     * transport. This must be called on all processes
+     */
+    void finalize(void);
+
+    /**
+     * Number of exchanges that have been completed
+     * @return number of steps
+     */
+    int numSteps(void) const;
+
+    /**
+     * Time spent posting outputs and waiting for inputs on this process
+     * @param post total time spent in post
+     * @param wait total time spent in receive
+     */
+    void getTimes(double *post, double *wait) const;
+
+  private:
+
+    /**
+     * Wait for the oldest exchange in the transport and broadcast its
+     * inputs
+     * @param inputs values received from external simulator
+     */
+    void p_complete(CosimValueSet &inputs);
+
+    gridpack::parallel::Communicator p_comm;
+    boost::shared_ptr<CosimTransport> p_transport;
+    bool p_pipelined;
+
+    // local outputs and outputs gathered from all processes on process 0
+    CosimValueSet p_outputs;
+    CosimValueSet p_gathered;
+    std::vector<int> p_counts;
+    std::vector<int> p_displs;
+
+    // number of exchanges in the transport that have not been completed.
+    // In pipelined mode this is at most two, the step whose inputs are
+    // being used and the step that is being computed
+    int p_inflight;
+
+    int p_steps;
+    double p_post_time;
+    double p_wait_time;
+};
+
+} // dynamic simulation
+} // gridpack
+#endif
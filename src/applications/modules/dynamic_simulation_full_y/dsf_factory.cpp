@@ -16,8 +16,11 @@
  */
 // -------------------------------------------------------------
 
+#include <cstdio>
 #include <vector>
 #include "boost/smart_ptr/shared_ptr.hpp"
+#include "gridpack/parallel/threads.hpp"
+#include "gridpack/utilities/exception.hpp"
 #include "dsf_factory.hpp"
 
 namespace gridpack {
@@ -181,6 +184,8 @@ void gridpack::dynamic_simulation::DSFullFactory::predictor_currentInjection(boo
   int i;
 
   // Invoke method on all bus objects
+  bool threaded = gridpack::parallel::threadedLoops();
+#pragma omp parallel for if(threaded)
   for (i=0; i<p_numBus; i++) {
     p_buses[i]->predictor_currentInjection(flag);
   }
@@ -194,6 +199,8 @@ void gridpack::dynamic_simulation::DSFullFactory::predictor(double t_inc, bool f
   int i;
 
   // Invoke updateDSVect method on all bus objects
+  bool threaded = gridpack::parallel::threadedLoops();
+#pragma omp parallel for if(threaded)
   for (i=0; i<p_numBus; i++) {
     p_buses[i]->predictor(t_inc,flag);
   }
@@ -207,6 +214,8 @@ void gridpack::dynamic_simulation::DSFullFactory::corrector_currentInjection(boo
   int i;
 
   // Invoke method on all bus objects
+  bool threaded = gridpack::parallel::threadedLoops();
+#pragma omp parallel for if(threaded)
   for (i=0; i<p_numBus; i++) {
     p_buses[i]->corrector_currentInjection(flag);
   }
@@ -220,11 +229,100 @@ void gridpack::dynamic_simulation::DSFullFactory::corrector(double t_inc, bool f
   int i;
 
   // Invoke updateDSVect method on all bus objects
+  bool threaded = gridpack::parallel::threadedLoops();
+#pragma omp parallel for if(threaded)
   for (i=0; i<p_numBus; i++) {
     p_buses[i]->corrector(t_inc,flag);
   }
 }
 
+/**
+ * Save generator state variables at the end of the predictor
+ */
+void gridpack::dynamic_simulation::DSFullFactory::saveStateValues()
+{
+  int i;
+  for (i=0; i<p_numBus; i++) {
+    p_buses[i]->saveStateValues();
+  }
+}
+
+/**
+ * Estimate the error of the current time step from the difference
+ * between the predicted and corrected generator state variables
+ * @return maximum scaled difference over all generators in the network
+ */
+double gridpack::dynamic_simulation::DSFullFactory::getStateError()
+{
+  int i;
+  double err = 0.0;
+  for (i=0; i<p_numBus; i++) {
+    if (p_network->getActiveBus(i)) {
+      double berr = p_buses[i]->getStateError();
+      if (berr > err) err = berr;
+    }
+  }
+  p_network->communicator().max(&err,1);
+  return err;
+}
+
+/**
+ * Save watched values at the start of a time step for interpolation
+ */
+void gridpack::dynamic_simulation::DSFullFactory::saveWatchedValues()
+{
+  int i;
+  for (i=0; i<p_numBus; i++) {
+    p_buses[i]->saveWatchedValues();
+  }
+}
+
+/**
+ * Set fraction of the time step used to interpolate watched values
+ * @param frac fraction of time step
+ */
+void gridpack::dynamic_simulation::DSFullFactory::setWatchInterpolation(
+    double frac)
+{
+  int i;
+  for (i=0; i<p_numBus; i++) {
+    p_buses[i]->setWatchInterpolation(frac);
+  }
+}
+
+/**
+ * Check to see if any relay in the network is timing towards a trip
+ * @return true if a relay timer is running anywhere in the network
+ */
+bool gridpack::dynamic_simulation::DSFullFactory::relayTiming()
+{
+  int i;
+  bool timing = false;
+  for (i=0; i<p_numBus && !timing; i++) {
+    timing = p_buses[i]->relayTiming();
+  }
+  for (i=0; i<p_numBranch && !timing; i++) {
+    timing = p_branches[i]->relayTiming();
+  }
+  return checkTrueSomewhere(timing);
+}
+
+/**
+ * Set parameters for multirate integration on all buses. Models in
+ * the slow rate group are only advanced on slow steps
+ * @param ratio number of fast steps in each slow step
+ * @param substep index of the fast step within the current slow step.
+ * Slow models are advanced when this is 0
+ */
+void gridpack::dynamic_simulation::DSFullFactory::setMultirateStep(int ratio,
+    int substep)
+{
+  int i;
+  for (i=0; i<p_numBus; i++) {
+    p_buses[i]->setMultirateStep(ratio, substep);
+  }
+}
+
 /**
  * Update dynamic load internal relays action
  */
@@ -312,6 +410,44 @@ std::vector<double> gridpack::dynamic_simulation::DSFullFactory::grabWideAreaFre
   return vbusfreq;
 }
 
+/**
+ * Add the published values of buses and branches owned by this process to
+ * the outputs of a co-simulation exchange
+ * @param values value set that values are added to
+ * @param voltages local indices of buses whose voltages are published
+ * @param injections local indices of buses whose current injections are
+ * published
+ * @param breakers local indices of branches whose line status is published
+ */
+void gridpack::dynamic_simulation::DSFullFactory::getCosimValues(
+    CosimValueSet &values, const std::vector<int> &voltages,
+    const std::vector<int> &injections, const std::vector<int> &breakers)
+{
+  int i, j, idx;
+  for (i=0; i<voltages.size(); i++) {
+    idx = voltages[i];
+    gridpack::ComplexType v = p_buses[idx]->getComplexVoltage();
+    values.addVoltage(p_buses[idx]->getOriginalIndex(), abs(v), arg(v));
+  }
+  for (i=0; i<injections.size(); i++) {
+    idx = injections[i];
+    gridpack::ComplexType cur = p_buses[idx]->getCurrentInjection();
+    values.addInjection(p_buses[idx]->getOriginalIndex(), real(cur),
+        imag(cur));
+  }
+  std::vector<std::string> tags;
+  std::vector<int> status;
+  for (i=0; i<breakers.size(); i++) {
+    idx = breakers[i];
+    p_branches[idx]->getLineStatus(tags, status);
+    int from = p_branches[idx]->getBus1OriginalIndex();
+    int to = p_branches[idx]->getBus2OriginalIndex();
+    for (j=0; j<tags.size(); j++) {
+      values.addBreaker(from, to, tags[j], status[j] == 1);
+    }
+  }
+}
+
 bool gridpack::dynamic_simulation::DSFullFactory::updateBusRelay(bool flag,double delta_t)
 {
 	int i;
@@ -703,5 +839,53 @@ void gridpack::dynamic_simulation::DSFullFactory::setRTPRParams(
   }
 }
 
+/**
+ * Save copies of the dynamic state of all buses and branches
+ * @param buses copies of buses
+ * @param branches copies of branches
+ */
+void DSFullFactory::checkpoint(
+    std::vector<boost::shared_ptr<DSFullBus> > &buses,
+    std::vector<boost::shared_ptr<DSFullBranch> > &branches)
+{
+  int i;
+  buses.resize(p_numBus);
+  for (i=0; i<p_numBus; i++) {
+    buses[i] = p_buses[i]->checkpoint();
+  }
+  branches.resize(p_numBranch);
+  for (i=0; i<p_numBranch; i++) {
+    branches[i] = p_branches[i]->checkpoint();
+  }
+}
+
+/**
+ * Restore the dynamic state of all buses and branches from copies
+ * created by checkpoint
+ * @param buses copies of buses
+ * @param branches copies of branches
+ */
+void DSFullFactory::restore(
+    const std::vector<boost::shared_ptr<DSFullBus> > &buses,
+    const std::vector<boost::shared_ptr<DSFullBranch> > &branches)
+{
+  if (buses.size() != p_numBus || branches.size() != p_numBranch) {
+    char buf[256];
+    sprintf(buf,"DSFullFactory::restore: checkpoint has %d buses and %d"
+        " branches, network has %d buses and %d branches\n",
+        static_cast<int>(buses.size()),static_cast<int>(branches.size()),
+        p_numBus,p_numBranch);
+    printf("%s",buf);
+    throw gridpack::Exception(buf);
+  }
+  int i;
+  for (i=0; i<p_numBus; i++) {
+    p_buses[i]->restore(*buses[i]);
+  }
+  for (i=0; i<p_numBranch; i++) {
+    p_branches[i]->restore(*branches[i]);
+  }
+}
+
 } // namespace dynamic_simulation
 } // namespace gridpack
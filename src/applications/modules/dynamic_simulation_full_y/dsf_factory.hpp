@@ -22,6 +22,7 @@
 #include "boost/smart_ptr/shared_ptr.hpp"
 #include "gridpack/factory/base_factory.hpp"
 #include "dsf_components.hpp"
+#include "dsf_cosim.hpp"
 #include <vector>
 
 namespace gridpack {
@@ -94,6 +95,44 @@ class DSFullFactory
      * Update vectors in each integration time step (Corrector)
      */
     void corrector(double t_inc, bool flag);
+
+    /**
+     * Save generator state variables at the end of the predictor
+     */
+    void saveStateValues();
+
+    /**
+     * Estimate the error of the current time step from the difference
+     * between the predicted and corrected generator state variables
+     * @return maximum scaled difference over all generators in the network
+     */
+    double getStateError();
+
+    /**
+     * Save watched values at the start of a time step for interpolation
+     */
+    void saveWatchedValues();
+
+    /**
+     * Set fraction of the time step used to interpolate watched values
+     * @param frac fraction of time step
+     */
+    void setWatchInterpolation(double frac);
+
+    /**
+     * Check to see if any relay in the network is timing towards a trip
+     * @return true if a relay timer is running anywhere in the network
+     */
+    bool relayTiming();
+
+    /**
+     * Set parameters for multirate integration on all buses. Models in
+     * the slow rate group are only advanced on slow steps
+     * @param ratio number of fast steps in each slow step
+     * @param substep index of the fast step within the current slow step.
+     * Slow models are advanced when this is 0
+     */
+    void setMultirateStep(int ratio, int substep);
 	
 	/**
      * Update dynamic load internal relays action
@@ -122,6 +161,21 @@ class DSFullFactory
 	
 	std::vector<double> grabWideAreaFreq() ;  //renke hard coded
 	void setWideAreaFreqforPSS(double freq); //renke hard coded
+
+    /**
+     * Add the published values of buses and branches owned by this
+     * process to the outputs of a co-simulation exchange
+     * @param values value set that values are added to
+     * @param voltages local indices of buses whose voltages are published
+     * @param injections local indices of buses whose current injections
+     * are published
+     * @param breakers local indices of branches whose line status is
+     * published
+     */
+    void getCosimValues(CosimValueSet &values,
+        const std::vector<int> &voltages,
+        const std::vector<int> &injections,
+        const std::vector<int> &breakers);
 	
    /**
      * update bus relay status
@@ -206,6 +260,23 @@ class DSFullFactory
     void setRTPRParams(int src_area, int src_zone, int load_area,
         int load_zone, double gen_scale, double load_scale);
 
+    /**
+     * Save copies of the dynamic state of all buses and branches
+     * @param buses copies of buses
+     * @param branches copies of branches
+     */
+    void checkpoint(std::vector<boost::shared_ptr<DSFullBus> > &buses,
+        std::vector<boost::shared_ptr<DSFullBranch> > &branches);
+
+    /**
+     * Restore the dynamic state of all buses and branches from copies
+     * created by checkpoint
+     * @param buses copies of buses
+     * @param branches copies of branches
+     */
+    void restore(const std::vector<boost::shared_ptr<DSFullBus> > &buses,
+        const std::vector<boost::shared_ptr<DSFullBranch> > &branches);
+
 #ifdef USE_FNCS
     /**
      * Scatter load from FNCS framework to buses
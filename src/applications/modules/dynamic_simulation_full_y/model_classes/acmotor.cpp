@@ -862,3 +862,30 @@ bool gridpack::dynamic_simulation::AcmotorLoad::serialWrite(
 		
   return false;
 }
+
+/**
+ * return a vector containing the current values of the load
+ * state variables
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::AcmotorLoad::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+  vals.push_back(volt_measured);
+  vals.push_back(freq_measured);
+  vals.push_back(temperatureA);
+  vals.push_back(temperatureB);
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseLoadModel>
+gridpack::dynamic_simulation::AcmotorLoad::clone()
+{
+  boost::shared_ptr<BaseLoadModel> ret(new AcmotorLoad(*this));
+  return ret;
+}
@@ -410,3 +410,29 @@ void gridpack::dynamic_simulation::ClassicalGenerator::getWatchValues(
     vals.push_back(real(p_mac_spd_s1));
   }
 }
+
+/**
+ * return a vector containing the current values of the generator
+ * state variables
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::ClassicalGenerator::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+  vals.push_back(real(p_mac_ang_s1));
+  vals.push_back(real(p_mac_spd_s1));
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseGeneratorModel>
+gridpack::dynamic_simulation::ClassicalGenerator::clone()
+{
+  boost::shared_ptr<ClassicalGenerator> ret(new ClassicalGenerator(*this));
+  ret->cloneComponents();
+  return ret;
+}
@@ -124,6 +124,20 @@ class ClassicalGenerator : public BaseGeneratorModel
      */
     void getWatchValues(std::vector<double> &vals);
 
+    /**
+     * return a vector containing the current values of the generator
+     * state variables
+     * @param vals vector of state variables
+     */
+    void getStateValues(std::vector<double> &vals);
+
+    /**
+     * Create a copy of the model that includes its current state. This is
+     * used to checkpoint a simulation
+     * @return copy of model
+     */
+    boost::shared_ptr<BaseGeneratorModel> clone();
+
   private:
 
     double p_sbase;
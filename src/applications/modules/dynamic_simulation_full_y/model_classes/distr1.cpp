@@ -224,6 +224,15 @@ void gridpack::dynamic_simulation::Distr1Relay::getTripStatus(int &itrip, int &i
 	itrip_prev = iline_trip_prev;
 }
 
+/**
+ * Return true if a pickup or breaker timer of the relay is running
+ * @return true if relay is timing towards a trip
+ */
+bool gridpack::dynamic_simulation::Distr1Relay::isTiming(void)
+{
+  return (icount_zone1t > 0 || icount_zone2t > 0 || iflag == 1);
+}
+
 /**
  * print bus volt and current
  * 
@@ -232,3 +241,15 @@ void gridpack::dynamic_simulation::Distr1Relay::printRelayVoltCurr( void)
 {
 	printf ("Distr1 Relay bus volt, %8.4f+%8.4fj,  bus current, %8.4f+%8.4fj,\n", real(c_volt), imag(c_volt), real(c_curr),imag(c_curr) );
 }
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseRelayModel>
+gridpack::dynamic_simulation::Distr1Relay::clone()
+{
+  boost::shared_ptr<BaseRelayModel> ret(new Distr1Relay(*this));
+  return ret;
+}
@@ -62,6 +62,12 @@ public:
      * @return current value of threshold
      */
     void getTripStatus(int &itrip, int &itrip_prev);
+
+    /**
+     * Return true if a pickup or breaker timer of the relay is running
+     * @return true if relay is timing towards a trip
+     */
+    bool isTiming(void);
 	
 	/**
      * print bus volt and current
@@ -70,6 +76,13 @@ public:
 	void printRelayVoltCurr (void);
 	
 	
+    /**
+     * Create a copy of the model that includes its current state. This is
+     * used to checkpoint a simulation
+     * @return copy of model
+     */
+    boost::shared_ptr<BaseRelayModel> clone();
+
   private:
 	
 	//parameters
@@ -413,3 +413,30 @@ void gridpack::dynamic_simulation::Esst1aModel::setVstab(double vtmp)
   Vstab = vtmp;
 }
 
+/**
+ * return a vector containing the current values of the exciter
+ * state variables
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::Esst1aModel::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+  vals.push_back(x1Va_1);
+  vals.push_back(x2Vcomp_1);
+  vals.push_back(x3LL1_1);
+  vals.push_back(x4LL2_1);
+  vals.push_back(x5Deriv_1);
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseExciterModel>
+gridpack::dynamic_simulation::Esst1aModel::clone()
+{
+  boost::shared_ptr<BaseExciterModel> ret(new Esst1aModel(*this));
+  return ret;
+}
@@ -387,3 +387,29 @@ void gridpack::dynamic_simulation::Esst4bModel::setOmega(double omega)
   //w = omega;
 }
 
+/**
+ * return a vector containing the current values of the exciter
+ * state variables
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::Esst4bModel::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+  vals.push_back(x1Vm_1);
+  vals.push_back(x2Vcomp_1);
+  vals.push_back(x3Va_1);
+  vals.push_back(x4Vr_1);
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseExciterModel>
+gridpack::dynamic_simulation::Esst4bModel::clone()
+{
+  boost::shared_ptr<BaseExciterModel> ret(new Esst4bModel(*this));
+  return ret;
+}
@@ -122,6 +122,20 @@ class Esst4bModel : public BaseExciterModel
      */
     void setOmega(double omega);
 
+    /**
+     * return a vector containing the current values of the exciter
+     * state variables
+     * @param vals vector of state variables
+     */
+    void getStateValues(std::vector<double> &vals);
+
+    /**
+     * Create a copy of the model that includes its current state. This is
+     * used to checkpoint a simulation
+     * @return copy of model
+     */
+    boost::shared_ptr<BaseExciterModel> clone();
+
   private:
 
     //double S10, S12; 
@@ -309,3 +309,30 @@ void gridpack::dynamic_simulation::Exdc1Model::setOmega(double omega)
   w = omega;
 }
 
+/**
+ * return a vector containing the current values of the exciter
+ * state variables
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::Exdc1Model::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+  vals.push_back(x1_1);
+  vals.push_back(x2_1);
+  vals.push_back(x3_1);
+  vals.push_back(x4_1);
+  vals.push_back(x5_1);
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseExciterModel>
+gridpack::dynamic_simulation::Exdc1Model::clone()
+{
+  boost::shared_ptr<BaseExciterModel> ret(new Exdc1Model(*this));
+  return ret;
+}
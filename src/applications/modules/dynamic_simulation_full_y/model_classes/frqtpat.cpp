@@ -165,3 +165,25 @@ void gridpack::dynamic_simulation::FrqtpatRelay::getTripStatus(int &itrip, int &
 	itrip = igen_trip;
 	itrip_prev = igen_trip_prev;
 }
+
+/**
+ * Return true if a pickup or breaker timer of the relay is running
+ * @return true if relay is timing towards a trip
+ */
+bool gridpack::dynamic_simulation::FrqtpatRelay::isTiming(void)
+{
+  return (icount_pickup_lowfreq > 0 || icount_pickup_upfreq > 0 ||
+      iflag == 1);
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseRelayModel>
+gridpack::dynamic_simulation::FrqtpatRelay::clone()
+{
+  boost::shared_ptr<BaseRelayModel> ret(new FrqtpatRelay(*this));
+  return ret;
+}
@@ -61,8 +61,21 @@ public:
      * exceeded)
      */
     void getTripStatus(int &itrip, int &itrip_prev);
+
+    /**
+     * Return true if a pickup or breaker timer of the relay is running
+     * @return true if relay is timing towards a trip
+     */
+    bool isTiming(void);
 	
 	
+    /**
+     * Create a copy of the model that includes its current state. This is
+     * used to checkpoint a simulation
+     * @return copy of model
+     */
+    boost::shared_ptr<BaseRelayModel> clone();
+
   private:
 	
 	//parameters
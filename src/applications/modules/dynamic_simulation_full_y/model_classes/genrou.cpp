@@ -264,7 +264,7 @@ void gridpack::dynamic_simulation::GenrouGenerator::predictor(
   //Efd = Efdinit;
 
   p_governor = getGovernor();
-  Pmech = p_governor->getMechanicalPower();
+  Pmech = getGovernorPower(false);
   //Pmech = Pmechinit;
  
   printf("Efd = %f, Pmech = %f\n", Efd, Pmech); 
@@ -309,7 +309,7 @@ void gridpack::dynamic_simulation::GenrouGenerator::predictor(
   p_exciter->predictor(t_inc, flag);
 
   p_governor->setRotorSpeedDeviation(x2w);
-  p_governor->predictor(t_inc, flag);
+  governorPredictor(t_inc, flag);
 }
 
 /**
@@ -365,7 +365,7 @@ void gridpack::dynamic_simulation::GenrouGenerator::corrector(
   //Efd = Efdinit;
 
   p_governor = getGovernor();
-  Pmech = p_governor->getMechanicalPower();
+  Pmech = getGovernorPower(true);
   //Pmech = Pmechinit; 
 
   printf("Efd = %f, Pmech = %f\n", Efd, Pmech); 
@@ -401,7 +401,7 @@ void gridpack::dynamic_simulation::GenrouGenerator::corrector(
   p_exciter->corrector(t_inc, flag);
  
   p_governor->setRotorSpeedDeviation(x2w);
-  p_governor->corrector(t_inc, flag);
+  governorCorrector(t_inc, flag);
 
   //if (p_bus_id == 1)
     //printf("\t%d          %12.6f   %12.6f   %12.6f   %12.6f   %12.6f	%12.6f\n",    
@@ -458,3 +458,35 @@ void gridpack::dynamic_simulation::GenrouGenerator::getWatchValues(
     vals.push_back(x2w_1);
   }
 }
+
+/**
+ * return a vector containing the current values of the generator
+ * state variables
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::GenrouGenerator::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+  vals.push_back(x1d_1);
+  vals.push_back(x2w_1);
+  vals.push_back(x3Eqp_1);
+  vals.push_back(x4Psidp_1);
+  vals.push_back(x5Psiqp_1);
+  vals.push_back(x6Edp_1);
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseGeneratorModel>
+gridpack::dynamic_simulation::GenrouGenerator::clone()
+{
+  boost::shared_ptr<GenrouGenerator> ret(new GenrouGenerator(*this));
+  ret->cloneComponents();
+  ret->p_exciter = ret->getExciter();
+  ret->p_governor = ret->getGovernor();
+  return ret;
+}
@@ -323,7 +323,7 @@ void gridpack::dynamic_simulation::GensalGenerator::predictor(
 
   if (p_hasGovernor){
 	p_governor = getGovernor();
-	Pmech = p_governor->getMechanicalPower();
+	Pmech = getGovernorPower(false);
 	// if (p_bus_id == 8022) Pmech = Pmechinit;
   }else{
 	Pmech = Pmechinit;
@@ -388,7 +388,7 @@ void gridpack::dynamic_simulation::GensalGenerator::predictor(
 
   if (p_hasGovernor){
 	p_governor->setRotorSpeedDeviation(x2w_0);
-	p_governor->predictor(t_inc, flag);
+	governorPredictor(t_inc, flag);
   }
 //  printf("predictor gensal: Efd = %f, Pmech = %f\n", Efd, Pmech); 
   }else {
@@ -473,7 +473,7 @@ void gridpack::dynamic_simulation::GensalGenerator::corrector(
 
   if (p_hasGovernor){
 	p_governor = getGovernor();
-	Pmech = p_governor->getMechanicalPower();
+	Pmech = getGovernorPower(true);
 	// if (p_bus_id == 8022) Pmech = Pmechinit;
   }else{
 	Pmech = Pmechinit;
@@ -530,7 +530,7 @@ void gridpack::dynamic_simulation::GensalGenerator::corrector(
  
  if (p_hasGovernor){
   p_governor->setRotorSpeedDeviation(x2w_0);
-  p_governor->corrector(t_inc, flag);
+  governorCorrector(t_inc, flag);
  }
 
   //if (p_bus_id == 1)
@@ -638,3 +638,35 @@ void gridpack::dynamic_simulation::GensalGenerator::getWatchValues(
     vals.push_back(x2w_1+1.0);
   }
 }
+
+/**
+ * return a vector containing the current values of the generator
+ * state variables
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::GensalGenerator::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+  vals.push_back(x1d_1);
+  vals.push_back(x2w_1);
+  vals.push_back(x3Eqp_1);
+  vals.push_back(x4Psidp_1);
+  vals.push_back(x5Psiqpp_1);
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseGeneratorModel>
+gridpack::dynamic_simulation::GensalGenerator::clone()
+{
+  boost::shared_ptr<GensalGenerator> ret(new GensalGenerator(*this));
+  ret->cloneComponents();
+  ret->p_exciter = ret->getExciter();
+  ret->p_governor = ret->getGovernor();
+  ret->p_pss = ret->getPss();
+  return ret;
+}
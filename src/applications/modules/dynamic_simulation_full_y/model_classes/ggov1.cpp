@@ -523,6 +523,17 @@ double gridpack::dynamic_simulation::Ggov1Model::getMechanicalPower()
   return Pmech; 
 }
 
+/**
+ * Return the rate group of the governor. The governor time constants are
+ * much larger than those of the generator so it is in the slow group
+ * @return slow rate group
+ */
+gridpack::dynamic_simulation::RateGroup
+gridpack::dynamic_simulation::Ggov1Model::getRateGroup()
+{
+  return SLOW_RATE;
+}
+
 /** 
  * Get the value of the rotor speed deviation
  * 
@@ -531,3 +542,36 @@ double gridpack::dynamic_simulation::Ggov1Model::getMechanicalPower()
 {
   return w;
 }*/
+
+/**
+ * return a vector containing the current values of the governor
+ * state variables
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::Ggov1Model::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+  vals.push_back(x1Pelec_1);
+  vals.push_back(x2GovDer_1);
+  vals.push_back(x3GovInt_1);
+  vals.push_back(x4Act_1);
+  vals.push_back(x5LL_1);
+  vals.push_back(x6Fload_1);
+  vals.push_back(x7LoadInt_1);
+  vals.push_back(x8LoadCtrl_1);
+  vals.push_back(x9Accel_1);
+  vals.push_back(x10TempLL_1);
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseGovernorModel>
+gridpack::dynamic_simulation::Ggov1Model::clone()
+{
+  boost::shared_ptr<BaseGovernorModel> ret(new Ggov1Model(*this));
+  return ret;
+}
@@ -327,3 +327,15 @@ bool gridpack::dynamic_simulation::IeelLoad::serialWrite(
 {
   return false;
 }
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseLoadModel>
+gridpack::dynamic_simulation::IeelLoad::clone()
+{
+  boost::shared_ptr<BaseLoadModel> ret(new IeelLoad(*this));
+  return ret;
+}
@@ -108,6 +108,13 @@ class IeelLoad : public BaseLoadModel
      */
     bool serialWrite(char* string, const int bufsize, const char* signal);
 
+    /**
+     * Create a copy of the model that includes its current state. This is
+     * used to checkpoint a simulation
+     * @return copy of model
+     */
+    boost::shared_ptr<BaseLoadModel> clone();
+
   private:
 
     //double p_sbase;
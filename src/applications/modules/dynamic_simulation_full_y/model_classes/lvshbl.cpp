@@ -171,6 +171,15 @@ void gridpack::dynamic_simulation::LvshblRelay::getTripStatus( int &itrip, int &
 	itrip_prev = iload_shed_prev;
 }
 
+/**
+ * Return true if a pickup or breaker timer of the relay is running
+ * @return true if relay is timing towards a trip
+ */
+bool gridpack::dynamic_simulation::LvshblRelay::isTiming(void)
+{
+  return (icount_pickup > 0 || iflag == 1);
+}
+
 double gridpack::dynamic_simulation::LvshblRelay::getLvshblRelayLoadFrac()
 {
 	return dloadshed_frac1;
@@ -180,3 +189,15 @@ double gridpack::dynamic_simulation::LvshblRelay::getRelayFracPar(void)
 {
 	return dloadshed_frac1;
 }
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseRelayModel>
+gridpack::dynamic_simulation::LvshblRelay::clone()
+{
+  boost::shared_ptr<BaseRelayModel> ret(new LvshblRelay(*this));
+  return ret;
+}
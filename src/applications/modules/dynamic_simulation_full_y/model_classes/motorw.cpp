@@ -855,4 +855,30 @@ double gridpack::dynamic_simulation::MotorwLoad::getInitReactivePower()
   return Qmotor_init;
 }
 
+/**
+ * return a vector containing the current values of the load
+ * state variables
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::MotorwLoad::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+  vals.push_back(epq);
+  vals.push_back(epd);
+  vals.push_back(eppq);
+  vals.push_back(eppd);
+  vals.push_back(slip);
+}
 
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseLoadModel>
+gridpack::dynamic_simulation::MotorwLoad::clone()
+{
+  boost::shared_ptr<BaseLoadModel> ret(new MotorwLoad(*this));
+  return ret;
+}
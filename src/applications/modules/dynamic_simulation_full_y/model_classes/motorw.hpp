@@ -115,6 +115,20 @@ class MotorwLoad : public BaseLoadModel
      */
     double getInitReactivePower(void);
 
+    /**
+     * return a vector containing the current values of the load
+     * state variables
+     * @param vals vector of state variables
+     */
+    void getStateValues(std::vector<double> &vals);
+
+    /**
+     * Create a copy of the model that includes its current state. This is
+     * used to checkpoint a simulation
+     * @return copy of model
+     */
+    boost::shared_ptr<BaseLoadModel> clone();
+
   private:
 
     double p_sbase;
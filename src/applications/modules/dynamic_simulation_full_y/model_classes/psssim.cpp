@@ -238,3 +238,28 @@ void gridpack::dynamic_simulation::PsssimModel::setWideAreaFreqforPSS(double fre
 	wideareafreq = freq;
 }
 
+/**
+ * return a vector containing the current values of the stabilizer
+ * state variables
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::PsssimModel::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+  vals.push_back(x1pss_1);
+  vals.push_back(x2pss_1);
+  vals.push_back(x3pss_1);
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BasePssModel>
+gridpack::dynamic_simulation::PsssimModel::clone()
+{
+  boost::shared_ptr<BasePssModel> ret(new PsssimModel(*this));
+  return ret;
+}
@@ -75,6 +75,20 @@ class PsssimModel : public BasePssModel
 	void setWideAreaFreqforPSS(double freq);	
 
 
+    /**
+     * return a vector containing the current values of the stabilizer
+     * state variables
+     * @param vals vector of state variables
+     */
+    void getStateValues(std::vector<double> &vals);
+
+    /**
+     * Create a copy of the model that includes its current state. This is
+     * used to checkpoint a simulation
+     * @return copy of model
+     */
+    boost::shared_ptr<BasePssModel> clone();
+
   private:
 
     //PSSSIM parameters from dyr
@@ -364,6 +364,17 @@ double gridpack::dynamic_simulation::WshygpModel::getMechanicalPower()
   return Pmech; 
 }
 
+/**
+ * Return the rate group of the governor. The governor time constants are
+ * much larger than those of the generator so it is in the slow group
+ * @return slow rate group
+ */
+gridpack::dynamic_simulation::RateGroup
+gridpack::dynamic_simulation::WshygpModel::getRateGroup()
+{
+  return SLOW_RATE;
+}
+
 /** 
  * Get the value of the rotor speed deviation
  * 
@@ -372,3 +383,33 @@ double gridpack::dynamic_simulation::WshygpModel::getMechanicalPower()
 {
   return w;
 }*/
+
+/**
+ * return a vector containing the current values of the governor
+ * state variables
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::WshygpModel::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+  vals.push_back(x1Pmech_1);
+  vals.push_back(x2Td_1);
+  vals.push_back(x3Int_1);
+  vals.push_back(x4Der_1);
+  vals.push_back(x5Pelec_1);
+  vals.push_back(x6Valve_1);
+  vals.push_back(x7Gate_1);
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseGovernorModel>
+gridpack::dynamic_simulation::WshygpModel::clone()
+{
+  boost::shared_ptr<BaseGovernorModel> ret(new WshygpModel(*this));
+  return ret;
+}
@@ -87,12 +87,32 @@ class WshygpModel : public BaseGovernorModel
      */
     double getMechanicalPower();
 
+    /**
+     * Return the rate group of the governor
+     * @return slow rate group
+     */
+    RateGroup getRateGroup();
+
     /** 
      * Get the value of the rotor speed deviation
      * @return value of rotor speed deviation
      */
     //double getRotorSpeedDeviation();
 
+    /**
+     * return a vector containing the current values of the governor
+     * state variables
+     * @param vals vector of state variables
+     */
+    void getStateValues(std::vector<double> &vals);
+
+    /**
+     * Create a copy of the model that includes its current state. This is
+     * used to checkpoint a simulation
+     * @return copy of model
+     */
+    boost::shared_ptr<BaseGovernorModel> clone();
+
   private:
 
     // Governor WSHYGP Parameters read from dyr
@@ -331,6 +331,17 @@ double gridpack::dynamic_simulation::Wsieg1Model::getMechanicalPower()
   return Pmech1; 
 }
 
+/**
+ * Return the rate group of the governor. The governor time constants are
+ * much larger than those of the generator so it is in the slow group
+ * @return slow rate group
+ */
+gridpack::dynamic_simulation::RateGroup
+gridpack::dynamic_simulation::Wsieg1Model::getRateGroup()
+{
+  return SLOW_RATE;
+}
+
 /** 
  * Get the value of the rotor speed deviation
  * 
@@ -339,3 +350,32 @@ double gridpack::dynamic_simulation::Wsieg1Model::getMechanicalPower()
 {
   return w;
 }*/
+
+/**
+ * return a vector containing the current values of the governor
+ * state variables
+ * @param vals vector of state variables
+ */
+void gridpack::dynamic_simulation::Wsieg1Model::getStateValues(
+    std::vector<double> &vals)
+{
+  vals.clear();
+  vals.push_back(x1LL_1);
+  vals.push_back(x2GovOut_1);
+  vals.push_back(x3Turb1_1);
+  vals.push_back(x4Turb2_1);
+  vals.push_back(x5Turb3_1);
+  vals.push_back(x6Turb4_1);
+}
+
+/**
+ * Create a copy of the model that includes its current state. This is
+ * used to checkpoint a simulation
+ * @return copy of model
+ */
+boost::shared_ptr<gridpack::dynamic_simulation::BaseGovernorModel>
+gridpack::dynamic_simulation::Wsieg1Model::clone()
+{
+  boost::shared_ptr<BaseGovernorModel> ret(new Wsieg1Model(*this));
+  return ret;
+}
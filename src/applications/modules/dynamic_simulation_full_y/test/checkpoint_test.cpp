@@ -0,0 +1,243 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   checkpoint_test.cpp
+ *
+ * @brief  Run a fault from the start of the simulation and again from a
+ * pre-fault checkpoint that has already been used to run a different
+ * fault. Check that the time series of the watched generators and the
+ * final states of all dynamic models are the same for both runs
+ */
+// -------------------------------------------------------------
+
+#include "mpi.h"
+#include <cmath>
+#include <algorithm>
+#include "gridpack/include/gridpack.hpp"
+#include "gridpack/applications/modules/powerflow/pf_app_module.hpp"
+#include "dsf_app_module.hpp"
+
+#define TOLERANCE 1.0e-6
+
+/**
+ * Transfer data from power flow to dynamic simulation
+ * @param pf_network power flow network
+ * @param ds_network dynamic simulation network
+ */
+void transferPFtoDS(
+    boost::shared_ptr<gridpack::powerflow::PFNetwork>
+    pf_network,
+    boost::shared_ptr<gridpack::dynamic_simulation::DSFullNetwork>
+    ds_network)
+{
+  int numBus = pf_network->numBuses();
+  int i, j;
+  gridpack::component::DataCollection *pfData;
+  gridpack::component::DataCollection *dsData;
+  double rval;
+  for (i=0; i<numBus; i++) {
+    pfData = pf_network->getBusData(i).get();
+    dsData = ds_network->getBusData(i).get();
+    pfData->getValue("BUS_PF_VMAG",&rval);
+    dsData->setValue(BUS_VOLTAGE_MAG,rval);
+    pfData->getValue("BUS_PF_VANG",&rval);
+    dsData->setValue(BUS_VOLTAGE_ANG,rval);
+    int ngen = 0;
+    if (pfData->getValue(GENERATOR_NUMBER, &ngen)) {
+      for (j=0; j<ngen; j++) {
+        pfData->getValue("GENERATOR_PF_PGEN",&rval,j);
+        dsData->setValue(GENERATOR_PG,rval,j);
+        pfData->getValue("GENERATOR_PF_QGEN",&rval,j);
+        dsData->setValue(GENERATOR_QG,rval,j);
+      }
+    }
+  }
+}
+
+/**
+ * Read the list of watched generators from the input deck
+ * @param config configuration
+ * @param buses IDs of buses containing generators
+ * @param tags generator IDs for watched generators
+ */
+void getWatchList(gridpack::utility::Configuration *config,
+    std::vector<int> &buses, std::vector<std::string> &tags)
+{
+  gridpack::utility::Configuration::CursorPtr cursor;
+  cursor = config->getCursor("Configuration.Dynamic_simulation.generatorWatch");
+  gridpack::utility::Configuration::ChildCursors generators;
+  if (cursor) cursor->children(generators);
+  gridpack::utility::StringUtils util;
+  int i, id;
+  std::string tag;
+  buses.clear();
+  tags.clear();
+  for (i=0; i<generators.size(); i++) {
+    generators[i]->get("busID",&id);
+    generators[i]->get("generatorID",&tag);
+    buses.push_back(id);
+    tags.push_back(util.clean2Char(tag));
+  }
+}
+
+/**
+ * Collect the state variables of all dynamic models on active buses
+ * @param network dynamic simulation network
+ * @return state variables, ordered by local bus index
+ */
+std::vector<double> getStates(
+    boost::shared_ptr<gridpack::dynamic_simulation::DSFullNetwork> network)
+{
+  std::vector<double> ret;
+  int nbus = network->numBuses();
+  int i;
+  for (i=0; i<nbus; i++) {
+    if (network->getActiveBus(i)) {
+      std::vector<double> vals = network->getBus(i)->getStateValues();
+      ret.insert(ret.end(), vals.begin(), vals.end());
+    }
+  }
+  return ret;
+}
+
+/**
+ * Compare two sets of values
+ * @param name description of values used in messages
+ * @param cold values from run without a checkpoint
+ * @param warm values from run started from a checkpoint
+ * @return true if values agree to within TOLERANCE
+ */
+bool compareValues(const char *name, const std::vector<double> &cold,
+    const std::vector<double> &warm)
+{
+  int me;
+  MPI_Comm_rank(MPI_COMM_WORLD,&me);
+  if (cold.size() != warm.size()) {
+    printf("p[%d] Number of %s without checkpoint: %d from checkpoint: %d\n",
+        me,name,static_cast<int>(cold.size()),static_cast<int>(warm.size()));
+    return false;
+  }
+  bool ok = true;
+  int i;
+  for (i=0; i<cold.size(); i++) {
+    double scale = std::max(1.0,std::abs(cold[i]));
+    if (std::abs(cold[i]-warm[i]) > TOLERANCE*scale) {
+      printf("p[%d] %s value %d without checkpoint: %f from checkpoint: %f\n",
+          me,name,i,cold[i],warm[i]);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+int
+main(int argc, char **argv)
+{
+  gridpack::Environment env(argc,argv);
+  int ret = 0;
+
+  if (1) {
+    gridpack::parallel::Communicator world;
+    gridpack::utility::Configuration *config =
+      gridpack::utility::Configuration::configuration();
+    if (argc >= 2 && argv[1] != NULL) {
+      config->open(argv[1],world);
+    } else {
+      config->open("input.xml",world);
+    }
+
+    // Run power flow calculation to get initial conditions
+    boost::shared_ptr<gridpack::powerflow::PFNetwork>
+      pf_network(new gridpack::powerflow::PFNetwork(world));
+    gridpack::powerflow::PFAppModule pf_app;
+    pf_app.readNetwork(pf_network, config);
+    pf_app.initialize();
+    pf_app.solve();
+    pf_app.saveData();
+
+    boost::shared_ptr<gridpack::dynamic_simulation::DSFullNetwork>
+      ds_network(new gridpack::dynamic_simulation::DSFullNetwork(world));
+    gridpack::dynamic_simulation::DSFullApp ds_app;
+    pf_network->clone<gridpack::dynamic_simulation::DSFullBus,
+      gridpack::dynamic_simulation::DSFullBranch>(ds_network);
+    transferPFtoDS(pf_network, ds_network);
+
+    gridpack::utility::Configuration::CursorPtr cursor;
+    cursor = config->getCursor("Configuration.Dynamic_simulation");
+    std::vector<gridpack::dynamic_simulation::Event> faults;
+    faults = ds_app.getFaults(cursor);
+    double step = cursor->get("timeStep",0.005);
+    gridpack::dynamic_simulation::Event fault = faults[0];
+    // A second fault on a different line that starts after the first one
+    gridpack::dynamic_simulation::Event other = fault;
+    other.from_idx = 6;
+    other.to_idx = 9;
+    other.start = fault.start + 0.5;
+    other.end = fault.end + 0.5;
+
+    ds_app.setNetwork(ds_network, config);
+    ds_app.readGenerators();
+    ds_app.initialize();
+    std::vector<int> buses;
+    std::vector<std::string> tags;
+    getWatchList(config, buses, tags);
+    ds_app.saveTimeSeries(true);
+
+    // Run fault from the start of the simulation
+    ds_app.setGeneratorWatch(buses, tags, false);
+    ds_app.solve(fault);
+    std::vector<std::vector<double> > cold_series
+      = ds_app.getGeneratorTimeSeries();
+    std::vector<double> cold_states = getStates(ds_network);
+
+    // Save a checkpoint one step before the fault, run the other fault
+    // from it and then run the original fault from the same checkpoint
+    ds_app.reload();
+    ds_app.setGeneratorWatch(buses, tags, false);
+    gridpack::dynamic_simulation::DSFullCheckpoint checkpoint;
+    ds_app.solve(fault, fault.start-step, checkpoint);
+    ds_app.restore(checkpoint);
+    ds_app.solve(other);
+    ds_app.restore(checkpoint);
+    ds_app.solve(fault);
+    std::vector<std::vector<double> > warm_series
+      = ds_app.getGeneratorTimeSeries();
+    std::vector<double> warm_states = getStates(ds_network);
+
+    bool ok = true;
+    if (cold_series.size() != warm_series.size()) {
+      printf("p[%d] Number of time series without checkpoint: %d"
+          " from checkpoint: %d\n",world.rank(),
+          static_cast<int>(cold_series.size()),
+          static_cast<int>(warm_series.size()));
+      ok = false;
+    } else {
+      int i;
+      for (i=0; i<cold_series.size(); i++) {
+        if (!compareValues("time series",cold_series[i],warm_series[i])) {
+          ok = false;
+        }
+      }
+    }
+    if (!compareValues("final state",cold_states,warm_states)) ok = false;
+
+    int iok = ok ? 0 : 1;
+    int nerr = 0;
+    MPI_Allreduce(&iok,&nerr,1,MPI_INT,MPI_SUM,world);
+    if (world.rank() == 0) {
+      if (nerr == 0) {
+        printf("\nFault restarted from checkpoint matches fault run"
+            " without checkpoint\n");
+      } else {
+        printf("\nError found in fault restarted from checkpoint\n");
+      }
+    }
+    if (nerr != 0) ret = 1;
+  }
+
+  return ret;
+}
@@ -0,0 +1,155 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   cosim_test.cpp
+ *
+ * @brief  Post values from all processes through a co-simulation exchange
+ * with a loopback transport and check that the values gathered on process
+ * 0 and broadcast back to all processes are the values that were posted,
+ * for both synchronous and pipelined exchanges
+ */
+// -------------------------------------------------------------
+
+#include "mpi.h"
+#include <cmath>
+#include "gridpack/include/gridpack.hpp"
+#include "dsf_cosim.hpp"
+
+#define NSTEPS 5
+#define NSIGNALS 3
+
+// Check the inputs received for a step. Each process posted the voltage
+// of bus rank+1 and process 0 also posted NSIGNALS signals
+bool checkInputs(const gridpack::dynamic_simulation::CosimValueSet &inputs,
+    int step, int nprocs, const char *mode)
+{
+  bool ok = true;
+  int me;
+  MPI_Comm_rank(MPI_COMM_WORLD,&me);
+  if (inputs.step() != step) {
+    printf("p[%d] (%s) Received step %d expected %d\n",me,mode,
+        inputs.step(),step);
+    ok = false;
+  }
+  if (inputs.size() != nprocs+NSIGNALS) {
+    printf("p[%d] (%s) Step %d has %d values expected %d\n",me,mode,step,
+        inputs.size(),nprocs+NSIGNALS);
+    ok = false;
+  }
+  int i, j;
+  for (i=0; i<nprocs; i++) {
+    bool found = false;
+    for (j=0; j<inputs.size(); j++) {
+      const gridpack::dynamic_simulation::CosimValue &val = inputs[j];
+      if (val.type == gridpack::dynamic_simulation::COSIM_BUS_VOLTAGE &&
+          val.idx1 == i+1) {
+        found = true;
+        if (std::abs(val.value[0]-(1.0+0.01*i)) > 1.0e-12 ||
+            std::abs(val.value[1]-0.1*step) > 1.0e-12) {
+          printf("p[%d] (%s) Step %d bus %d voltage (%f,%f) is wrong\n",
+              me,mode,step,i+1,val.value[0],val.value[1]);
+          ok = false;
+        }
+      }
+    }
+    if (!found) {
+      printf("p[%d] (%s) Step %d voltage of bus %d is missing\n",me,mode,
+          step,i+1);
+      ok = false;
+    }
+  }
+  double value;
+  for (i=0; i<NSIGNALS; i++) {
+    if (!inputs.getSignal(i,&value) ||
+        std::abs(value-static_cast<double>(10*step+i)) > 1.0e-12) {
+      printf("p[%d] (%s) Step %d signal %d is wrong\n",me,mode,step,i);
+      ok = false;
+    }
+  }
+  if (!inputs.getLastSignal(&value) ||
+      std::abs(value-static_cast<double>(10*step+NSIGNALS-1)) > 1.0e-12) {
+    printf("p[%d] (%s) Step %d last signal is wrong\n",me,mode,step);
+    ok = false;
+  }
+  return ok;
+}
+
+// Run NSTEPS exchanges and check the inputs returned for each step
+bool runExchange(const gridpack::parallel::Communicator &world,
+    bool pipelined)
+{
+  const char *mode = pipelined ? "pipelined" : "synchronous";
+  int me = world.rank();
+  int nprocs = world.size();
+  boost::shared_ptr<gridpack::dynamic_simulation::CosimTransport> transport;
+  if (me == 0) {
+    transport.reset(new gridpack::dynamic_simulation::LoopbackTransport);
+  }
+  gridpack::dynamic_simulation::CosimExchange exchange(world,transport,
+      pipelined);
+  bool ok = true;
+  int step, i;
+  for (step=0; step<NSTEPS; step++) {
+    gridpack::dynamic_simulation::CosimValueSet &outputs =
+      exchange.outputs(step,0.01*step);
+    outputs.addVoltage(me+1,1.0+0.01*me,0.1*step);
+    if (me == 0) {
+      for (i=0; i<NSIGNALS; i++) {
+        outputs.addSignal(i,static_cast<double>(10*step+i));
+      }
+    }
+    exchange.post();
+    gridpack::dynamic_simulation::CosimValueSet inputs;
+    bool received = exchange.receive(inputs);
+    if (pipelined && step == 0) {
+      if (received) {
+        printf("p[%d] (%s) Inputs received for first step\n",me,mode);
+        ok = false;
+      }
+    } else if (!received) {
+      printf("p[%d] (%s) No inputs received for step %d\n",me,mode,step);
+      ok = false;
+    } else {
+      if (!checkInputs(inputs,pipelined ? step-1 : step,nprocs,mode)) {
+        ok = false;
+      }
+    }
+  }
+  exchange.finalize();
+  if (exchange.numSteps() != NSTEPS) {
+    printf("p[%d] (%s) Completed %d exchanges expected %d\n",me,mode,
+        exchange.numSteps(),NSTEPS);
+    ok = false;
+  }
+  return ok;
+}
+
+int
+main(int argc, char **argv)
+{
+  gridpack::Environment env(argc,argv);
+  int ret = 0;
+
+  if (1) {
+    gridpack::parallel::Communicator world;
+    bool ok = runExchange(world,false);
+    if (!runExchange(world,true)) ok = false;
+    int iok = ok ? 0 : 1;
+    int nerr = 0;
+    MPI_Allreduce(&iok,&nerr,1,MPI_INT,MPI_SUM,world);
+    if (world.rank() == 0) {
+      if (nerr == 0) {
+        printf("\nCo-simulation loopback exchanges OK\n");
+      } else {
+        printf("\nError found in co-simulation loopback exchanges\n");
+      }
+    }
+    if (nerr != 0) ret = 1;
+  }
+
+  return ret;
+}
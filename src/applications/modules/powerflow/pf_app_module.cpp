@@ -14,6 +14,8 @@
  * 
  */
 // -------------------------------------------------------------
+#include <map>
+#include <algorithm>
 
 #include "pf_app_module.hpp"
 #include "pf_factory_module.hpp"
@@ -25,6 +27,7 @@
 #include "gridpack/export/PSSE33Export.hpp"
 #include "gridpack/parser/GOSS_parser.hpp"
 #include "gridpack/math/math.hpp"
+#include "gridpack/network/network_islands.hpp"
 #include "pf_helper.hpp"
 
 #define USE_REAL_VALUES
@@ -35,6 +38,16 @@
 gridpack::powerflow::PFAppModule::PFAppModule(void)
 {
   p_no_print = false;
+  p_iterations = 0;
+  p_fast_decoupled = false;
+  p_fd_max_updates = 10;
+  p_fd_bp.mode = BPrime;
+  p_fd_bp.factored = false;
+  p_fd_bpp.mode = BDoublePrime;
+  p_fd_bpp.factored = false;
+  p_screen_islands = false;
+  p_solvable = true;
+  p_block_storage = false;
 }
 
 /**
@@ -90,11 +103,6 @@ void gridpack::powerflow::PFAppModule::readNetwork(
       return;
     }
   }
-  // Convergence and iteration parameters
-  p_tolerance = cursor->get("tolerance",1.0e-6);
-  p_qlim = cursor->get("qlim",0);
-  p_max_iteration = cursor->get("maxIteration",50);
-  ComplexType tol;
   // Phase shift sign
   double phaseShiftSign = cursor->get("phaseShiftSign",1.0);
 
@@ -148,6 +156,43 @@ void gridpack::powerflow::PFAppModule::readNetwork(
   }
   timer->stop(t_pti);
 
+  // Read solver parameters and set up IO
+  setNetwork(network, config);
+
+  // partition network
+  int t_part = timer->createCategory("Powerflow: Partition");
+  timer->start(t_part);
+  network->partition();
+  timer->stop(t_part);
+  timer->stop(t_total);
+}
+
+/**
+ * Assume that PFNetwork already exists and just cache an internal pointer
+ * to it. This routine does not call the partition function. Also read in
+ * solver parameters from the Powerflow block in the configuration file
+ * @param network pointer to a complete PFNetwork object.
+ * @param config pointer to open configuration file
+ */
+void gridpack::powerflow::PFAppModule::setNetwork(
+    boost::shared_ptr<PFNetwork> &network,
+    gridpack::utility::Configuration *config)
+{
+  p_network = network;
+  p_comm = network->communicator();
+  p_config = config;
+
+  gridpack::utility::Configuration::CursorPtr cursor;
+  cursor = config->getCursor("Configuration.Powerflow");
+  // Convergence and iteration parameters
+  p_tolerance = cursor->get("tolerance",1.0e-6);
+  p_qlim = cursor->get("qlim",0);
+  p_max_iteration = cursor->get("maxIteration",50);
+  p_fast_decoupled = cursor->get("FastDecoupled",false);
+  p_fd_max_updates = cursor->get("FastDecoupledMaxUpdates",10);
+  p_screen_islands = cursor->get("IslandScreening",false);
+  p_block_storage = cursor->get("BlockStorage",false);
+
   // Create serial IO object to export data from buses
   p_busIO.reset(new gridpack::serial_io::SerialBusIO<PFNetwork>(512,network));
 
@@ -161,13 +206,6 @@ void gridpack::powerflow::PFAppModule::readNetwork(
     sprintf(ioBuf,"\nConvergence tolerance: %f\n",p_tolerance);
     p_busIO->header(ioBuf);
   }
-
-  // partition network
-  int t_part = timer->createCategory("Powerflow: Partition");
-  timer->start(t_part);
-  network->partition();
-  timer->stop(t_part);
-  timer->stop(t_total);
 }
 
 /**
@@ -221,6 +259,12 @@ void gridpack::powerflow::PFAppModule::reload()
   timer->start(t_load);
   p_factory->load();
   timer->stop(t_load);
+  // Network parameters may have changed so fast decoupled matrices must be
+  // refactored
+  p_fd_bp.solver.reset();
+  p_fd_bp.B.reset();
+  p_fd_bpp.solver.reset();
+  p_fd_bpp.B.reset();
 }
 
 /**
@@ -230,6 +274,7 @@ void gridpack::powerflow::PFAppModule::reload()
  */
 bool gridpack::powerflow::PFAppModule::solve()
 {
+  if (p_fast_decoupled) return fd_solve();
   bool ret = true;
   gridpack::utility::CoarseTimer *timer =
     gridpack::utility::CoarseTimer::instance();
@@ -240,6 +285,7 @@ bool gridpack::powerflow::PFAppModule::solve()
   int iter = 0;
   bool repeat = true;
   int int_repeat = 0;
+  p_iterations = 0;
   while (repeat) {
     iter = 0;
     tol = 2.0*p_tolerance;
@@ -303,6 +349,7 @@ bool gridpack::powerflow::PFAppModule::solve()
     timer->start(t_cmap);
     p_factory->setMode(Jacobian);
     gridpack::mapper::FullMatrixMap<PFNetwork> jMap(p_network);
+    if (p_block_storage) jMap.setBlockStorage(true);
     timer->stop(t_cmap);
     timer->start(t_mmap);
 #ifdef USE_REAL_VALUES
@@ -432,6 +479,7 @@ bool gridpack::powerflow::PFAppModule::solve()
       }
       iter++;
     }
+    p_iterations += iter;
 
     if (iter >= p_max_iteration) ret = false;
     if (p_qlim == 0) {
@@ -507,10 +555,19 @@ bool gridpack::powerflow::PFAppModule::nl_solve()
   }
 
   bool ret = true;
+  p_iterations = 0;
   try {
     solver->configure(cursor);
     solver->solve(*helper.X);
     helper.update(*helper.X);
+    p_iterations = solver->iterations();
+    if (!p_no_print) {
+      char ioBuf[128];
+      sprintf(ioBuf,"\nNonlinear solver: %d iterations,"
+          " %d Jacobian factorizations\n",
+          solver->iterations(),solver->factorizations());
+      p_busIO->header(ioBuf);
+    }
   } catch (const Exception& e) {
     std::cerr << e.what() << std::endl;
     timer->stop(t_lsolv);
@@ -523,6 +580,430 @@ bool gridpack::powerflow::PFAppModule::nl_solve()
   return ret;
 }
 
+/**
+ * Execute the iterative solve portion of the application using a
+ * fast decoupled (XB) solver. The B' and B'' matrices are factored on
+ * the first call and the factorizations are reused in later calls.
+ * Changes in branch status since the matrices were factored are
+ * handled with a low-rank correction as long as no more than
+ * FastDecoupledMaxUpdates branches have changed
+ * @return false if an error was caught in the solution algorithm
+ */
+bool gridpack::powerflow::PFAppModule::fd_solve()
+{
+  bool ret = true;
+  gridpack::utility::CoarseTimer *timer =
+    gridpack::utility::CoarseTimer::instance();
+  int t_total = timer->createCategory("Powerflow: Total Application");
+  timer->start(t_total);
+  p_factory->clearViolations();
+  int t_fact = timer->createCategory("Powerflow: Factory Operations");
+  int t_cmap = timer->createCategory("Powerflow: Create Mappers");
+  int t_vmap = timer->createCategory("Powerflow: Map to Vector");
+  int t_csolv = timer->createCategory("Powerflow: Create Linear Solver");
+  int t_lsolv = timer->createCategory("Powerflow: Solve Linear Equation");
+  int t_bmap = timer->createCategory("Powerflow: Map to Bus");
+  int t_updt = timer->createCategory("Powerflow: Bus Update");
+  char ioBuf[128];
+  double tol, qtol;
+  int iter = 0;
+  bool repeat = true;
+  int int_repeat = 0;
+  p_iterations = 0;
+  while (repeat) {
+    iter = 0;
+    int_repeat ++;
+    if (!p_no_print) {
+      printf (" repeat time = %d \n", int_repeat);
+    }
+
+    // set YBus components and S vector. These are needed to evaluate the
+    // mismatches and the B'' matrix
+    timer->start(t_fact);
+    p_factory->setYBus();
+    p_factory->setMode(S_Cal);
+    p_factory->setSBus();
+    timer->stop(t_fact);
+
+    // Factor B' and B'' or correct existing factorizations for changes in
+    // the network
+    timer->start(t_csolv);
+    bool ok = true;
+    try {
+      ok = p_fdUpdate(p_fd_bp);
+      ok = ok && p_fdUpdate(p_fd_bpp);
+    } catch (const gridpack::Exception e) {
+      std::string w(e.what());
+      if (!p_no_print) {
+        printf("p[%d] hit exception: %s\n",
+            p_network->communicator().rank(),
+            w.c_str());
+      }
+      ok = false;
+    }
+    timer->stop(t_csolv);
+    if (!ok) {
+      if (!p_no_print) {
+        p_busIO->header("Solver failure\n\n");
+      }
+      timer->stop(t_total);
+      return false;
+    }
+
+    // Create mismatch vectors
+    timer->start(t_cmap);
+    p_factory->setMode(BPrime);
+    gridpack::mapper::BusVectorMap<PFNetwork> pMap(p_network);
+    p_factory->setMode(BDoublePrime);
+    gridpack::mapper::BusVectorMap<PFNetwork> qMap(p_network);
+    timer->stop(t_cmap);
+    timer->start(t_vmap);
+    p_factory->setMode(BPrime);
+    boost::shared_ptr<gridpack::math::RealVector> P = pMap.mapToRealVector();
+    p_factory->setMode(BDoublePrime);
+    boost::shared_ptr<gridpack::math::RealVector> Q = qMap.mapToRealVector();
+    timer->stop(t_vmap);
+    boost::shared_ptr<gridpack::math::RealVector> dTheta(P->clone());
+    boost::shared_ptr<gridpack::math::RealVector> dV(Q->clone());
+    tol = P->normInfinity();
+    qtol = Q->normInfinity();
+    if (qtol > tol) tol = qtol;
+
+    while (tol > p_tolerance && iter < p_max_iteration) {
+      try {
+        // Update angles using real power mismatch
+        timer->start(t_lsolv);
+        p_factory->setMode(BPrime);
+        p_fdSolve(p_fd_bp, *P, *dTheta);
+        timer->stop(t_lsolv);
+        timer->start(t_bmap);
+        pMap.mapToBus(dTheta);
+        timer->stop(t_bmap);
+        timer->start(t_updt);
+        p_network->updateBuses();
+        timer->stop(t_updt);
+
+        // Update voltage magnitudes using reactive power mismatch at new
+        // angles
+        timer->start(t_vmap);
+        p_factory->setMode(BDoublePrime);
+        qMap.mapToRealVector(Q);
+        timer->stop(t_vmap);
+        timer->start(t_lsolv);
+        p_fdSolve(p_fd_bpp, *Q, *dV);
+        timer->stop(t_lsolv);
+        timer->start(t_bmap);
+        qMap.mapToBus(dV);
+        timer->stop(t_bmap);
+        timer->start(t_updt);
+        p_network->updateBuses();
+        timer->stop(t_updt);
+      } catch (const gridpack::Exception e) {
+        std::string w(e.what());
+        if (!p_no_print) {
+          printf("p[%d] hit exception: %s\n",
+              p_network->communicator().rank(),
+              w.c_str());
+          p_busIO->header("Solver failure\n\n");
+        }
+        timer->stop(t_lsolv);
+        timer->stop(t_total);
+        return false;
+      }
+
+      // Evaluate new mismatches
+      timer->start(t_vmap);
+      p_factory->setMode(BPrime);
+      pMap.mapToRealVector(P);
+      p_factory->setMode(BDoublePrime);
+      qMap.mapToRealVector(Q);
+      timer->stop(t_vmap);
+      tol = P->normInfinity();
+      qtol = Q->normInfinity();
+      if (qtol > tol) tol = qtol;
+      if (!p_no_print) {
+        sprintf(ioBuf,"\nIteration %d Tol: %12.6e\n",iter+1,tol);
+        p_busIO->header(ioBuf);
+      }
+      iter++;
+    }
+    p_iterations += iter;
+
+    if (tol > p_tolerance) ret = false;
+    if (p_qlim == 0) {
+      repeat = false;
+    } else {
+      if (p_factory->checkQlimViolations()) {
+        repeat =false;
+      } else {
+        if (!p_no_print) {
+          printf ("There are Qlim violations at iter =%d\n", iter);
+        }
+      }
+    }
+  }
+  timer->stop(t_total);
+  return ret;
+}
+
+/**
+ * Solve a small dense system A*x = b using Gaussian elimination with
+ * partial pivoting
+ * @param n dimension of system
+ * @param A matrix in row-major order (overwritten)
+ * @param b right hand side on input and solution on output
+ * @return false if matrix is singular
+ */
+static bool denseSolve(int n, std::vector<double> &A, std::vector<double> &b)
+{
+  int i, j, k;
+  for (k=0; k<n; k++) {
+    int piv = k;
+    for (i=k+1; i<n; i++) {
+      if (fabs(A[i*n+k]) > fabs(A[piv*n+k])) piv = i;
+    }
+    if (fabs(A[piv*n+k]) < 1.0e-12) return false;
+    if (piv != k) {
+      for (j=0; j<n; j++) std::swap(A[k*n+j],A[piv*n+j]);
+      std::swap(b[k],b[piv]);
+    }
+    for (i=k+1; i<n; i++) {
+      double f = A[i*n+k]/A[k*n+k];
+      for (j=k; j<n; j++) A[i*n+j] -= f*A[k*n+j];
+      b[i] -= f*b[k];
+    }
+  }
+  for (k=n-1; k>=0; k--) {
+    for (j=k+1; j<n; j++) b[k] -= A[k*n+j]*b[j];
+    b[k] /= A[k*n+k];
+  }
+  return true;
+}
+
+/**
+ * Factor the B' or B'' matrix or update the low-rank correction for
+ * branches that have changed status since it was factored. Buses must
+ * be in S_Cal mode with YBus set
+ * @param sys matrix to update
+ * @return false if the corrected matrix is singular
+ */
+bool gridpack::powerflow::PFAppModule::p_fdUpdate(FDSystem &sys)
+{
+  // The factorization can only be reused if every bus contributes the same
+  // rows as when the matrix was factored. This is not true if a bus has
+  // been isolated or switched between PV and PQ
+  p_factory->setMode(sys.mode);
+  std::vector<int> sizes;
+  int nbus = p_network->numBuses();
+  int i, j, k, size;
+  for (i=0; i<nbus; i++) {
+    if (p_network->getActiveBus(i)) {
+      if (!p_network->getBus(i)->vectorSize(&size)) size = 0;
+      sizes.push_back(size);
+    }
+  }
+  int changed = 0;
+  if (!sys.B || sizes != sys.sizes) changed = 1;
+  p_comm.sum(&changed,1);
+  std::vector<int> bus1, bus2;
+  std::vector<double> values;
+  int nchange = 0;
+  if (changed == 0) {
+    nchange = p_factory->getFDMatrixChanges(bus1,bus2,values);
+    if (nchange > p_fd_max_updates) changed = 1;
+  }
+  if (changed != 0) {
+    sys.solver.reset();
+    sys.B.reset();
+    sys.rows.clear();
+    sys.C.clear();
+    sys.M.clear();
+    sys.W.clear();
+    gridpack::mapper::FullMatrixMap<PFNetwork> bMap(p_network);
+    sys.B = bMap.mapToRealMatrix();
+    gridpack::utility::Configuration::CursorPtr cursor;
+    cursor = p_config->getCursor("Configuration.Powerflow");
+    sys.solver.reset(new gridpack::math::RealLinearSolver(*sys.B));
+    sys.solver->configure(cursor);
+    sys.factored = false;
+    sys.sizes = sizes;
+    p_factory->saveFDMatrix();
+    return true;
+  }
+
+  // Find the matrix rows of the buses at the ends of the changed branches.
+  // Buses that do not contribute a row (reference buses and, for B'', PV
+  // buses) are dropped from the correction
+  std::vector<int> buses;
+  std::map<int,int> busIdx;
+  for (i=0; i<nchange; i++) {
+    if (busIdx.find(bus1[i]) == busIdx.end()) {
+      busIdx.insert(std::pair<int,int>(bus1[i],buses.size()));
+      buses.push_back(bus1[i]);
+    }
+    if (busIdx.find(bus2[i]) == busIdx.end()) {
+      busIdx.insert(std::pair<int,int>(bus2[i],buses.size()));
+      buses.push_back(bus2[i]);
+    }
+  }
+  int nb = buses.size();
+  std::vector<int> brow(nb,-1);
+  if (nb > 0) {
+    if (sys.mode == BPrime) {
+      p_factory->setMode(BPrimeIndex);
+    } else {
+      p_factory->setMode(BDoublePrimeIndex);
+    }
+    gridpack::mapper::BusVectorMap<PFNetwork> iMap(p_network);
+    boost::shared_ptr<gridpack::math::RealVector> index =
+      iMap.mapToRealVector();
+    int lo, hi;
+    index->localIndexRange(lo,hi);
+    for (i=lo; i<hi; i++) {
+      double rval;
+      index->getElement(i,rval);
+      std::map<int,int>::iterator it =
+        busIdx.find(static_cast<int>(rval+0.5));
+      if (it != busIdx.end()) brow[it->second] = i;
+    }
+    p_comm.max(&brow[0],nb);
+    p_factory->setMode(sys.mode);
+  }
+  std::vector<int> rows;
+  std::vector<int> bpos(nb,-1);
+  for (i=0; i<nb; i++) {
+    if (brow[i] >= 0) {
+      bpos[i] = rows.size();
+      rows.push_back(brow[i]);
+    }
+  }
+  int m = rows.size();
+  std::vector<double> C(m*m,0.0);
+  for (k=0; k<nchange; k++) {
+    int pos[2];
+    pos[0] = bpos[busIdx[bus1[k]]];
+    pos[1] = bpos[busIdx[bus2[k]]];
+    for (i=0; i<2; i++) {
+      if (pos[i] < 0) continue;
+      for (j=0; j<2; j++) {
+        if (pos[j] < 0) continue;
+        C[pos[i]*m+pos[j]] += values[4*k+2*i+j];
+      }
+    }
+  }
+
+  // Nothing to do if the correction is the same as in the last call
+  if (rows == sys.rows && C == sys.C) return true;
+  sys.rows = rows;
+  sys.C = C;
+  sys.M.clear();
+  sys.W.clear();
+  if (m == 0) return true;
+
+  // Evaluate W = B0^-1*U and M = I + C*U^T*W
+  p_factory->setMode(sys.mode);
+  gridpack::mapper::BusVectorMap<PFNetwork> vMap(p_network);
+  boost::shared_ptr<gridpack::math::RealVector> e = vMap.mapToRealVector();
+  int lo, hi;
+  e->localIndexRange(lo,hi);
+  std::vector<double> UtW(m*m);
+  std::vector<double> col(m);
+  for (k=0; k<m; k++) {
+    e->zero();
+    if (rows[k] >= lo && rows[k] < hi) e->setElement(rows[k],1.0);
+    e->ready();
+    boost::shared_ptr<gridpack::math::RealVector> w(e->clone());
+    w->zero();
+    if (!sys.factored) {
+      sys.solver->solve(*e,*w);
+      sys.factored = true;
+    } else {
+      sys.solver->resolve(*e,*w);
+    }
+    p_fdGetElements(*w,rows,col);
+    for (i=0; i<m; i++) UtW[i*m+k] = col[i];
+    sys.W.push_back(w);
+  }
+  sys.M.resize(m*m);
+  for (i=0; i<m; i++) {
+    for (j=0; j<m; j++) {
+      double sum = (i == j ? 1.0 : 0.0);
+      for (k=0; k<m; k++) sum += C[i*m+k]*UtW[k*m+j];
+      sys.M[i*m+j] = sum;
+    }
+  }
+  // Check that corrected matrix is not singular. This happens if the
+  // changed branches split the network into islands
+  std::vector<double> A(sys.M);
+  std::vector<double> b(m,0.0);
+  if (!denseSolve(m,A,b)) {
+    if (!p_no_print) {
+      p_busIO->header("Fast decoupled matrix is singular\n");
+    }
+    sys.rows.clear();
+    sys.C.clear();
+    sys.M.clear();
+    sys.W.clear();
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Solve the corrected system B*x = b
+ * @param sys factored matrix
+ * @param b right hand side
+ * @param x solution
+ */
+void gridpack::powerflow::PFAppModule::p_fdSolve(FDSystem &sys,
+    const gridpack::math::RealVector &b, gridpack::math::RealVector &x)
+{
+  x.zero();
+  if (!sys.factored) {
+    sys.solver->solve(b,x);
+    sys.factored = true;
+  } else {
+    sys.solver->resolve(b,x);
+  }
+  int m = sys.rows.size();
+  if (m == 0) return;
+  // x = x0 - W*M^-1*C*U^T*x0
+  std::vector<double> z(m);
+  p_fdGetElements(x,sys.rows,z);
+  std::vector<double> y(m,0.0);
+  int i, j;
+  for (i=0; i<m; i++) {
+    for (j=0; j<m; j++) y[i] += sys.C[i*m+j]*z[j];
+  }
+  std::vector<double> A(sys.M);
+  denseSolve(m,A,y);
+  for (i=0; i<m; i++) {
+    x.add(*sys.W[i],-y[i]);
+  }
+}
+
+/**
+ * Return the elements of a distributed vector on all processors
+ * @param vec distributed vector
+ * @param rows global indices of elements
+ * @param values values of elements
+ */
+void gridpack::powerflow::PFAppModule::p_fdGetElements(
+    const gridpack::math::RealVector &vec, const std::vector<int> &rows,
+    std::vector<double> &values)
+{
+  int m = rows.size();
+  values.resize(m);
+  int lo, hi;
+  vec.localIndexRange(lo,hi);
+  int i;
+  for (i=0; i<m; i++) {
+    values[i] = 0.0;
+    if (rows[i] >= lo && rows[i] < hi) vec.getElement(rows[i],values[i]);
+  }
+  if (m > 0) p_comm.sum(&values[0],m);
+}
+
 
 /**
  * Write out results of powerflow calculation to standard output or a file
@@ -754,6 +1235,7 @@ bool gridpack::powerflow::PFAppModule::setContingency(
     p_contingency_name.clear();
   }
   p_factory->checkLoneBus();
+  if (p_screen_islands) screenIslands();
   return ret;
 }
 
@@ -765,6 +1247,7 @@ bool gridpack::powerflow::PFAppModule::setContingency(
 bool gridpack::powerflow::PFAppModule::unSetContingency(
     gridpack::powerflow::Contingency &event)
 {
+  if (p_screen_islands) clearIslands();
   p_factory->clearLoneBus();
   bool ret = true;
   if (event.p_type == Generator) {
@@ -807,6 +1290,121 @@ bool gridpack::powerflow::PFAppModule::unSetContingency(
   return ret;
 }
 
+// Branch test for island screening: a branch is in service if any of its
+// lines are in service
+struct PFClosedBranch
+{
+  PFClosedBranch(gridpack::powerflow::PFNetwork *network)
+    : p_network(network)
+  {}
+  bool operator() (int idx) const
+  {
+    std::vector<bool> status =
+      dynamic_cast<gridpack::powerflow::PFBranch*>(
+          p_network->getBranch(idx).get())->getLineStatus();
+    int i;
+    for (i=0; i<status.size(); i++) {
+      if (status[i]) return true;
+    }
+    return false;
+  }
+  gridpack::powerflow::PFNetwork *p_network;
+};
+
+// Slack score for island screening: the reference bus is preferred over
+// buses with generators that are in service
+struct PFSlackScore
+{
+  PFSlackScore(gridpack::powerflow::PFNetwork *network)
+    : p_network(network)
+  {}
+  double operator() (int idx) const
+  {
+    gridpack::powerflow::PFBus *bus =
+      dynamic_cast<gridpack::powerflow::PFBus*>(
+          p_network->getBus(idx).get());
+    if (bus->isIsolated()) return 0.0;
+    if (bus->getReferenceBus()) return 2.0;
+    std::vector<std::string> gens = bus->getGenerators();
+    int i;
+    for (i=0; i<gens.size(); i++) {
+      if (bus->getGenStatus(gens[i])) return 1.0;
+    }
+    return 0.0;
+  }
+  gridpack::powerflow::PFNetwork *p_network;
+};
+
+/**
+ * Find the islands formed by the branches that are in service. Each
+ * island gets a reference bus: the existing reference bus if it is in
+ * the island, otherwise the lowest numbered bus with a generator that
+ * is in service. Buses in islands without a generator are isolated.
+ * This is called by setContingency if the IslandScreening option is
+ * set. Changes are undone by clearIslands
+ * @return false if no island can be solved
+ */
+bool gridpack::powerflow::PFAppModule::screenIslands()
+{
+  gridpack::network::NetworkIslands<PFNetwork> islands(p_network);
+  islands.analyze(PFClosedBranch(p_network.get()),
+      PFSlackScore(p_network.get()));
+  p_island_isolated.clear();
+  p_island_reference.clear();
+  int nbus = p_network->numBuses();
+  int i;
+  for (i=0; i<nbus; i++) {
+    gridpack::powerflow::PFBus *bus =
+      dynamic_cast<gridpack::powerflow::PFBus*>(p_network->getBus(i).get());
+    if (islands.isDead(i)) {
+      if (!bus->isIsolated()) {
+        bus->setIsolated(true);
+        p_island_isolated.push_back(i);
+      }
+    } else if (islands.isSlack(i) && !bus->getReferenceBus()) {
+      bus->setReferenceBus(true);
+      p_island_reference.push_back(i);
+    }
+  }
+  p_solvable = (islands.numDeadIslands() < islands.numIslands());
+  if (!p_no_print && islands.numIslands() > 1) {
+    char ioBuf[128];
+    sprintf(ioBuf,"\nNetwork has %d islands, %d without generation"
+        " (%d buses)\n",islands.numIslands(),islands.numDeadIslands(),
+        islands.numDeadBuses());
+    p_busIO->header(ioBuf);
+  }
+  return p_solvable;
+}
+
+/**
+ * Return buses changed by screenIslands to their original state
+ */
+void gridpack::powerflow::PFAppModule::clearIslands()
+{
+  int i;
+  for (i=0; i<p_island_isolated.size(); i++) {
+    dynamic_cast<gridpack::powerflow::PFBus*>(
+        p_network->getBus(p_island_isolated[i]).get())->setIsolated(false);
+  }
+  for (i=0; i<p_island_reference.size(); i++) {
+    p_network->getBus(p_island_reference[i])->setReferenceBus(false);
+  }
+  p_island_isolated.clear();
+  p_island_reference.clear();
+  p_solvable = true;
+}
+
+/**
+ * Check if the last call to screenIslands found an island that can be
+ * solved. This is always true if islands have not been screened
+ * @return false if power flow equations have no buses
+ */
+bool gridpack::powerflow::PFAppModule::contingencySolvable()
+{
+  return p_solvable;
+}
+
 /**
  * Set voltage limits on all buses
  * @param Vmin lower bound on voltages
@@ -907,6 +1505,118 @@ void gridpack::powerflow::PFAppModule::resetVoltages()
   p_factory->resetVoltages();
 }
 
+/**
+ * Save the current (converged) voltages so that they can be used as
+ * the starting point of subsequent calculations. If predict is true, the
+ * Jacobian at the saved state is also kept so that warmStart can predict
+ * the effect of a contingency
+ * @param predict keep base case Jacobian for predictions
+ */
+void gridpack::powerflow::PFAppModule::saveBaseCase(bool predict)
+{
+  p_factory->saveVoltages();
+  p_base_solver.reset();
+  p_base_J.reset();
+  p_base_sizes.clear();
+  p_base_PQ.reset();
+  p_base_vMap.reset();
+  if (!predict) return;
+
+  p_factory->setYBus();
+  p_factory->setMode(S_Cal);
+  p_factory->setSBus();
+  p_factory->setMode(RHS);
+  int nbus = p_network->numBuses();
+  int i, size;
+  for (i=0; i<nbus; i++) {
+    if (p_network->getActiveBus(i)) {
+      if (!p_network->getBus(i)->vectorSize(&size)) size = 0;
+      p_base_sizes.push_back(size);
+    }
+  }
+  p_base_vMap.reset(new gridpack::mapper::BusVectorMap<PFNetwork>(p_network));
+  p_base_PQ = p_base_vMap->mapToRealVector();
+  p_factory->setMode(Jacobian);
+  gridpack::mapper::FullMatrixMap<PFNetwork> jMap(p_network);
+  if (p_block_storage) jMap.setBlockStorage(true);
+  p_base_J = jMap.mapToRealMatrix();
+  gridpack::utility::Configuration::CursorPtr cursor;
+  cursor = p_config->getCursor("Configuration.Powerflow");
+  p_base_solver.reset(new gridpack::math::RealLinearSolver(*p_base_J));
+  p_base_solver->configure(cursor);
+}
+
+/**
+ * Reset voltages to the values stored by saveBaseCase. This should be
+ * called after setContingency. If the base case Jacobian was saved and the
+ * contingency does not change the structure of the power flow equations,
+ * the voltages are corrected by a single solve of the base case Jacobian
+ * with the mismatch created by the contingency
+ * @return true if voltages were corrected by a prediction
+ */
+bool gridpack::powerflow::PFAppModule::warmStart()
+{
+  p_factory->restoreVoltages();
+  if (!p_base_solver) return false;
+
+  // The base case Jacobian can only be used if every bus contributes the
+  // same equations as in the base case. This is not true if the
+  // contingency isolates a bus or changes a PV bus to a PQ bus
+  p_factory->setYBus();
+  p_factory->setMode(S_Cal);
+  p_factory->setSBus();
+  p_factory->setMode(RHS);
+  int nbus = p_network->numBuses();
+  int i, size;
+  int icnt = 0;
+  int changed = 0;
+  for (i=0; i<nbus; i++) {
+    if (p_network->getActiveBus(i)) {
+      if (!p_network->getBus(i)->vectorSize(&size)) size = 0;
+      if (icnt >= p_base_sizes.size() || p_base_sizes[icnt] != size) {
+        changed = 1;
+      }
+      icnt++;
+    }
+  }
+  if (icnt != p_base_sizes.size()) changed = 1;
+  p_comm.sum(&changed,1);
+  if (changed != 0) return false;
+
+  // Mismatch at base case voltages is the change in injections due to the
+  // contingency. Only buses that were changed by setting or clearing
+  // contingencies since the last fill contribute new values, all other
+  // buses are at the base case state. Use base case Jacobian to estimate
+  // the change in voltages
+  p_base_vMap->updateRealVector(p_base_PQ);
+  boost::shared_ptr<gridpack::math::RealVector> X(p_base_PQ->clone());
+  X->zero();
+  try {
+    p_base_solver->solve(*p_base_PQ, *X);
+  } catch (const gridpack::Exception e) {
+    std::string w(e.what());
+    if (!p_no_print) {
+      printf("p[%d] prediction failed: %s\n",
+          p_network->communicator().rank(),
+          w.c_str());
+    }
+    return false;
+  }
+  p_base_vMap->mapToBus(X);
+  p_network->updateBuses();
+  return true;
+}
+
+/**
+ * Number of Newton-Raphson iterations taken by the last call to solve,
+ * summed over all Q limit repeats
+ * @return number of iterations
+ */
+int gridpack::powerflow::PFAppModule::getIterations()
+{
+  return p_iterations;
+}
+
 /**
  * Scale generator real power. If zone less than 1 then scale all
  * generators in the area.
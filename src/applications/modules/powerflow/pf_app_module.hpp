@@ -21,6 +21,9 @@
 #include "boost/smart_ptr/shared_ptr.hpp"
 #include "gridpack/serial_io/serial_io.hpp"
 #include "gridpack/configuration/configuration.hpp"
+#include "gridpack/math/matrix.hpp"
+#include "gridpack/math/linear_solver.hpp"
+#include "gridpack/mapper/bus_vector_map.hpp"
 #include "pf_factory_module.hpp"
 
 namespace gridpack {
@@ -95,6 +98,17 @@ class PFAppModule
     void readNetwork(boost::shared_ptr<PFNetwork> &network,
                      gridpack::utility::Configuration *config);
 
+    /**
+     * Assume that PFNetwork already exists and just cache an internal
+     * pointer to it. This routine does not call the partition function.
+     * Solver parameters are read from the Powerflow block in the
+     * configuration file
+     * @param network pointer to a complete PFNetwork object.
+     * @param config pointer to open configuration file
+     */
+    void setNetwork(boost::shared_ptr<PFNetwork> &network,
+                    gridpack::utility::Configuration *config);
+
     /**
      * Set up exchange buffers and other internal parameters and initialize
      * network components using data from data collection
@@ -120,6 +134,19 @@ class PFAppModule
      */
     bool nl_solve();
 
+    /**
+     * Execute the iterative solve portion of the application using a
+     * fast decoupled (XB) solver. The B' and B'' matrices are factored on
+     * the first call and the factorizations are reused in later calls.
+     * Changes in branch status since the matrices were factored are
+     * handled with a low-rank correction as long as no more than
+     * FastDecoupledMaxUpdates branches have changed. solve calls this
+     * method if FastDecoupled is set in the Powerflow block of the
+     * configuration file
+     * @return false if an error was caught in the solution algorithm
+     */
+    bool fd_solve();
+
     /**
      * Write out results of powerflow calculation to standard output
      * Separate calls for writing only data from buses or branches
@@ -173,6 +200,29 @@ class PFAppModule
      */
     bool unSetContingency(Contingency &event);
 
+    /**
+     * Find the islands formed by the branches that are in service. Each
+     * island gets a reference bus: the existing reference bus if it is in
+     * the island, otherwise the lowest numbered bus with a generator that
+     * is in service. Buses in islands without a generator are isolated.
+     * This is called by setContingency if the IslandScreening option is
+     * set. Changes are undone by clearIslands
+     * @return false if no island can be solved
+     */
+    bool screenIslands();
+
+    /**
+     * Return buses changed by screenIslands to their original state
+     */
+    void clearIslands();
+
+    /**
+     * Check if the last call to screenIslands found an island that can be
+     * solved. This is always true if islands have not been screened
+     * @return false if power flow equations have no buses
+     */
+    bool contingencySolvable();
+
     /**
      * Set voltage limits on all buses
      * @param Vmin lower bound on voltages
@@ -245,6 +295,33 @@ class PFAppModule
      */
     void resetVoltages();
 
+    /**
+     * Save the current (converged) voltages so that they can be used as
+     * the starting point of subsequent calculations, e.g. the contingencies
+     * of a contingency analysis. If predict is true, the Jacobian at the
+     * saved state is also kept so that warmStart can predict the effect of
+     * a contingency
+     * @param predict keep base case Jacobian for predictions
+     */
+    void saveBaseCase(bool predict = false);
+
+    /**
+     * Reset voltages to the values stored by saveBaseCase. This should be
+     * called after setContingency. If the base case Jacobian was saved
+     * and the contingency does not change the structure of the power flow
+     * equations, the voltages are corrected by a single solve of the
+     * base case Jacobian with the mismatch created by the contingency
+     * @return true if voltages were corrected by a prediction
+     */
+    bool warmStart();
+
+    /**
+     * Number of Newton-Raphson iterations taken by the last call to solve,
+     * summed over all Q limit repeats
+     * @return number of iterations
+     */
+    int getIterations();
+
     /**
      * Scale generator real power. If zone less than 1 then scale all
      * generators in the area.
@@ -364,6 +441,93 @@ class PFAppModule
     // Flag to suppress all printing to standard out
     bool p_no_print;
 
+    // number of iterations in last call to solve
+    int p_iterations;
+
+    // Jacobian and solver at the state saved by saveBaseCase. These are
+    // only created if predictions are requested. The solver must be
+    // declared after the matrix so that it is destroyed first
+    boost::shared_ptr<gridpack::math::RealMatrix> p_base_J;
+    boost::shared_ptr<gridpack::math::RealLinearSolver> p_base_solver;
+
+    // size of RHS block on each local bus when the base case was saved
+    std::vector<int> p_base_sizes;
+
+    // mismatch vector at the saved state and the mapper that created it.
+    // warmStart only refills the blocks of buses that have been marked
+    // as changed since the last fill
+    boost::shared_ptr<gridpack::mapper::BusVectorMap<PFNetwork> > p_base_vMap;
+    boost::shared_ptr<gridpack::math::RealVector> p_base_PQ;
+
+    // B' or B'' matrix used by the fast decoupled solver. The matrix and
+    // solver are the factored matrix B0. If branches have changed status
+    // since B0 was factored, the current matrix is B0 + U*C*U^T, where U
+    // selects the matrix rows in rows and C is a dense m x m matrix. The
+    // correction is applied using W = B0^-1*U and M = I + C*U^T*W
+    struct FDSystem {
+      int mode;
+      boost::shared_ptr<gridpack::math::RealMatrix> B;
+      boost::shared_ptr<gridpack::math::RealLinearSolver> solver;
+      bool factored;
+      std::vector<int> sizes;
+      std::vector<int> rows;
+      std::vector<double> C;
+      std::vector<double> M;
+      std::vector<boost::shared_ptr<gridpack::math::RealVector> > W;
+    };
+
+    /**
+     * Factor the B' or B'' matrix or update the low-rank correction for
+     * branches that have changed status since it was factored. Buses must
+     * be in S_Cal mode with YBus set
+     * @param sys matrix to update
+     * @return false if the corrected matrix is singular
+     */
+    bool p_fdUpdate(FDSystem &sys);
+
+    /**
+     * Solve the corrected system B*x = b
+     * @param sys factored matrix
+     * @param b right hand side
+     * @param x solution
+     */
+    void p_fdSolve(FDSystem &sys, const gridpack::math::RealVector &b,
+        gridpack::math::RealVector &x);
+
+    /**
+     * Return the elements of a distributed vector on all processors
+     * @param vec distributed vector
+     * @param rows global indices of elements
+     * @param values values of elements
+     */
+    void p_fdGetElements(const gridpack::math::RealVector &vec,
+        const std::vector<int> &rows, std::vector<double> &values);
+
+    // use fast decoupled solver in solve
+    bool p_fast_decoupled;
+
+    // maximum number of changed branches that are handled by a low-rank
+    // correction before the fast decoupled matrices are refactored
+    int p_fd_max_updates;
+
+    // B' and B'' matrices for fast decoupled solver
+    FDSystem p_fd_bp;
+    FDSystem p_fd_bpp;
+
+    // screen islands when setting contingencies
+    bool p_screen_islands;
+
+    // false if screenIslands found no island with a reference bus
+    bool p_solvable;
+
+    // use block storage for the Jacobian if all blocks have the same size
+    bool p_block_storage;
+
+    // local indices of buses isolated or made reference buses by
+    // screenIslands
+    std::vector<int> p_island_isolated;
+    std::vector<int> p_island_reference;
+
 #ifdef USE_GOSS
     gridpack::goss::GOSSClient p_goss_client;
 
@@ -699,6 +699,116 @@ void gridpack::powerflow::PFFactoryModule::resetVoltages()
   }
 }
 
+/**
+ * Save current voltages on all buses, including ghost buses
+ */
+void gridpack::powerflow::PFFactoryModule::saveVoltages()
+{
+  int numBus = p_network->numBuses();
+  int i;
+  for (i=0; i<numBus; i++) {
+    gridpack::powerflow::PFBus *bus =
+      dynamic_cast<gridpack::powerflow::PFBus*>
+      (p_network->getBus(i).get());
+    bus->saveVoltage();
+  }
+}
+
+/**
+ * Reset voltages on all buses to the values stored by saveVoltages
+ */
+void gridpack::powerflow::PFFactoryModule::restoreVoltages()
+{
+  int numBus = p_network->numBuses();
+  int i;
+  for (i=0; i<numBus; i++) {
+    gridpack::powerflow::PFBus *bus =
+      dynamic_cast<gridpack::powerflow::PFBus*>
+      (p_network->getBus(i).get());
+    bus->restoreVoltage();
+  }
+}
+
+/**
+ * Save the contributions of all branches to the B' or B'' matrix of the
+ * fast decoupled solver, depending on the current mode. This should be
+ * called when the matrix is factored
+ */
+void gridpack::powerflow::PFFactoryModule::saveFDMatrix()
+{
+  int numBranch = p_network->numBranches();
+  int i;
+  for (i=0; i<numBranch; i++) {
+    gridpack::powerflow::PFBranch *branch =
+      dynamic_cast<gridpack::powerflow::PFBranch*>
+      (p_network->getBranch(i).get());
+    branch->saveFDMatrix();
+  }
+}
+
+/**
+ * Collect the changes in the contributions of branches to the B' or
+ * B'' matrix since saveFDMatrix was called. Each change is a 2x2 block
+ * coupling the buses at either end of the branch. The same list is
+ * returned on all processors
+ * @param bus1 original index of bus 1 of each changed branch
+ * @param bus2 original index of bus 2 of each changed branch
+ * @param values 4 values of each change in row-major order
+ * @return number of changed branches
+ */
+int gridpack::powerflow::PFFactoryModule::getFDMatrixChanges(
+    std::vector<int> &bus1, std::vector<int> &bus2,
+    std::vector<double> &values)
+{
+  bus1.clear();
+  bus2.clear();
+  values.clear();
+  // Find changes on locally owned branches
+  std::vector<int> lbus1, lbus2;
+  std::vector<double> lvalues;
+  int numBranch = p_network->numBranches();
+  int i, j;
+  double block[4];
+  for (i=0; i<numBranch; i++) {
+    if (p_network->getActiveBranch(i)) {
+      gridpack::powerflow::PFBranch *branch =
+        dynamic_cast<gridpack::powerflow::PFBranch*>
+        (p_network->getBranch(i).get());
+      if (branch->getFDMatrixChange(block)) {
+        lbus1.push_back(branch->getBus1OriginalIndex());
+        lbus2.push_back(branch->getBus2OriginalIndex());
+        for (j=0; j<4; j++) lvalues.push_back(block[j]);
+      }
+    }
+  }
+
+  // Distribute changes to all processors
+  gridpack::parallel::Communicator comm = p_network->communicator();
+  int nproc = comm.size();
+  int me = comm.rank();
+  std::vector<int> sizes(nproc);
+  for (i=0; i<nproc; i++) sizes[i] = 0;
+  sizes[me] = lbus1.size();
+  comm.sum(&sizes[0],nproc);
+  int offset = 0;
+  for (i=0; i<me; i++) offset += sizes[i];
+  int total = 0;
+  for (i=0; i<nproc; i++) total += sizes[i];
+  if (total == 0) return 0;
+  bus1.resize(total,0);
+  bus2.resize(total,0);
+  values.resize(4*total,0.0);
+  for (i=0; i<sizes[me]; i++) {
+    bus1[offset+i] = lbus1[i];
+    bus2[offset+i] = lbus2[i];
+    for (j=0; j<4; j++) values[4*(offset+i)+j] = lvalues[4*i+j];
+  }
+  comm.sum(&bus1[0],total);
+  comm.sum(&bus2[0],total);
+  comm.sum(&values[0],4*total);
+  return total;
+}
+
 /**
  * Scale generator real power. If zone less than 1 then scale all
  * generators in the area.
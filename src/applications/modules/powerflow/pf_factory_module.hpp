@@ -167,6 +167,36 @@ class PFFactoryModule
      */
     void resetVoltages();
 
+    /**
+     * Save current voltages on all buses, including ghost buses
+     */
+    void saveVoltages();
+
+    /**
+     * Reset voltages on all buses to the values stored by saveVoltages
+     */
+    void restoreVoltages();
+
+    /**
+     * Save the contributions of all branches to the B' or B'' matrix of the
+     * fast decoupled solver, depending on the current mode. This should be
+     * called when the matrix is factored
+     */
+    void saveFDMatrix();
+
+    /**
+     * Collect the changes in the contributions of branches to the B' or
+     * B'' matrix since saveFDMatrix was called. Each change is a 2x2 block
+     * coupling the buses at either end of the branch. The same list is
+     * returned on all processors
+     * @param bus1 original index of bus 1 of each changed branch
+     * @param bus2 original index of bus 2 of each changed branch
+     * @param values 4 values of each change in row-major order
+     * @return number of changed branches
+     */
+    int getFDMatrixChanges(std::vector<int> &bus1, std::vector<int> &bus2,
+        std::vector<double> &values);
+
     /**
      * Scale generator real power. If zone less than 1 then scale all
      * generators in the area
@@ -0,0 +1,179 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   fd_test.cpp
+ *
+ * @brief  Compare the fast decoupled power flow solver with the
+ * Newton-Raphson solver for the base case and a set of single line
+ * outages. The outages are solved with the factorizations of the base case
+ * fast decoupled matrices
+ */
+// -------------------------------------------------------------
+
+#include "mpi.h"
+#include <ga.h>
+#include <macdecls.h>
+#include <cmath>
+#include "gridpack/include/gridpack.hpp"
+#include "gridpack/applications/modules/powerflow/pf_app_module.hpp"
+
+#define MAX_LINES 10
+#define TOLERANCE 1.0e-4
+
+// Store voltage magnitudes and angles of all locally owned buses
+void getVoltages(gridpack::powerflow::PFNetwork &network,
+    std::vector<double> &mag, std::vector<double> &ang)
+{
+  mag.clear();
+  ang.clear();
+  int nbus = network.numBuses();
+  int i;
+  for (i=0; i<nbus; i++) {
+    if (network.getActiveBus(i)) {
+      gridpack::powerflow::PFBus *bus =
+        dynamic_cast<gridpack::powerflow::PFBus*>(network.getBus(i).get());
+      mag.push_back(bus->getVoltage());
+      ang.push_back(bus->getPhase());
+    }
+  }
+}
+
+// Solve current configuration with both solvers and compare results.
+// Return false if the fast decoupled solution does not agree with a
+// converged Newton-Raphson solution
+bool compareSolvers(gridpack::powerflow::PFAppModule &pf_app,
+    gridpack::powerflow::PFNetwork &network, const char *name)
+{
+  gridpack::parallel::Communicator comm = network.communicator();
+  std::vector<double> nr_mag, nr_ang, fd_mag, fd_ang;
+
+  pf_app.resetVoltages();
+  double t_nr = MPI_Wtime();
+  bool nr_ok = pf_app.solve();
+  t_nr = MPI_Wtime() - t_nr;
+  int nr_iter = pf_app.getIterations();
+  getVoltages(network, nr_mag, nr_ang);
+
+  pf_app.resetVoltages();
+  double t_fd = MPI_Wtime();
+  bool fd_ok = pf_app.fd_solve();
+  t_fd = MPI_Wtime() - t_fd;
+  int fd_iter = pf_app.getIterations();
+  getVoltages(network, fd_mag, fd_ang);
+
+  double dv = 0.0;
+  double da = 0.0;
+  int i;
+  for (i=0; i<static_cast<int>(nr_mag.size()); i++) {
+    if (fabs(nr_mag[i]-fd_mag[i]) > dv) dv = fabs(nr_mag[i]-fd_mag[i]);
+    if (fabs(nr_ang[i]-fd_ang[i]) > da) da = fabs(nr_ang[i]-fd_ang[i]);
+  }
+  comm.max(&dv,1);
+  comm.max(&da,1);
+  comm.max(&t_nr,1);
+  comm.max(&t_fd,1);
+
+  bool ok = true;
+  if (nr_ok && (!fd_ok || dv > TOLERANCE || da > TOLERANCE)) ok = false;
+  if (comm.rank() == 0) {
+    printf("%-24s Newton: %s %3d iterations %10.4f s"
+        "  Fast decoupled: %s %3d iterations %10.4f s"
+        "  max dV: %10.3e max dA: %10.3e %s\n",
+        name, (nr_ok ? "conv" : "fail"), nr_iter, t_nr,
+        (fd_ok ? "conv" : "fail"), fd_iter, t_fd, dv, da,
+        (ok ? "" : "ERROR"));
+  }
+  return ok;
+}
+
+int
+main(int argc, char **argv)
+{
+  gridpack::Environment env(argc,argv);
+  int ret = 0;
+
+  if (1) {
+    gridpack::parallel::Communicator world;
+
+    // read configuration file
+    gridpack::utility::Configuration *config =
+      gridpack::utility::Configuration::configuration();
+    if (argc >= 2 && argv[1] != NULL) {
+      char inputfile[256];
+      sprintf(inputfile,"%s",argv[1]);
+      config->open(inputfile,world);
+    } else {
+      config->open("input.xml",world);
+    }
+
+    boost::shared_ptr<gridpack::powerflow::PFNetwork>
+      pf_network(new gridpack::powerflow::PFNetwork(world));
+
+    gridpack::powerflow::PFAppModule pf_app;
+    pf_app.readNetwork(pf_network,config);
+    pf_app.initialize();
+    pf_app.suppressOutput(true);
+    bool ok = compareSolvers(pf_app, *pf_network, "Base case");
+
+    // Find the first few lines in the network. Each process fills in the
+    // lines it owns and the results are summed over all processes
+    int nline = MAX_LINES;
+    int nbranch = pf_network->totalBranches();
+    if (nbranch < nline) nline = nbranch;
+    std::vector<int> from(nline,0), to(nline,0), ckt(2*nline,0);
+    int i, j;
+    for (i=0; i<pf_network->numBranches(); i++) {
+      int idx = pf_network->getGlobalBranchIndex(i);
+      if (pf_network->getActiveBranch(i) && idx < nline) {
+        gridpack::powerflow::PFBranch *branch =
+          dynamic_cast<gridpack::powerflow::PFBranch*>(
+              pf_network->getBranch(i).get());
+        std::vector<std::string> tags = branch->getLineIDs();
+        from[idx] = branch->getBus1OriginalIndex();
+        to[idx] = branch->getBus2OriginalIndex();
+        if (tags.size() > 0) {
+          for (j=0; j<2 && j<static_cast<int>(tags[0].size()); j++) {
+            ckt[2*idx+j] = static_cast<int>(tags[0][j]);
+          }
+        }
+      }
+    }
+    world.sum(&from[0],nline);
+    world.sum(&to[0],nline);
+    world.sum(&ckt[0],2*nline);
+
+    // Solve single line outages
+    for (i=0; i<nline; i++) {
+      gridpack::powerflow::Contingency event;
+      event.p_type = gridpack::powerflow::Branch;
+      std::string tag;
+      for (j=0; j<2; j++) {
+        if (ckt[2*i+j] != 0) tag.push_back(static_cast<char>(ckt[2*i+j]));
+      }
+      event.p_from.push_back(from[i]);
+      event.p_to.push_back(to[i]);
+      event.p_ckt.push_back(tag);
+      event.p_saveLineStatus.push_back(true);
+      char name[128];
+      sprintf(name,"Line %d-%d (%s)",from[i],to[i],tag.c_str());
+      pf_app.setContingency(event);
+      if (!compareSolvers(pf_app, *pf_network, name)) ok = false;
+      pf_app.unSetContingency(event);
+    }
+
+    if (world.rank() == 0) {
+      if (ok) {
+        printf("\nFast decoupled solutions OK\n");
+      } else {
+        printf("\nError found in fast decoupled solutions\n");
+      }
+    }
+    if (!ok) ret = 1;
+  }
+
+  return ret;
+}
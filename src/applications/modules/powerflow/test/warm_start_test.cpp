@@ -0,0 +1,241 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   warm_start_test.cpp
+ *
+ * @brief  Solve a set of single line outages with Q limit checking from
+ * the original voltages (cold start), from the saved base case voltages
+ * (warm start) and from a predicted start, and check that all three
+ * starts converge to the same voltages
+ */
+// -------------------------------------------------------------
+
+#include "mpi.h"
+#include <ga.h>
+#include <macdecls.h>
+#include <cmath>
+#include "gridpack/include/gridpack.hpp"
+#include "gridpack/applications/modules/powerflow/pf_app_module.hpp"
+
+#define MAX_LINES 10
+#define TOLERANCE 1.0e-4
+
+enum StartType{COLD_START, WARM_START, PREDICTED_START};
+
+// Store voltage magnitudes and angles of all locally owned buses
+void getVoltages(gridpack::powerflow::PFNetwork &network,
+    std::vector<double> &mag, std::vector<double> &ang)
+{
+  mag.clear();
+  ang.clear();
+  int nbus = network.numBuses();
+  int i;
+  for (i=0; i<nbus; i++) {
+    if (network.getActiveBus(i)) {
+      gridpack::powerflow::PFBus *bus =
+        dynamic_cast<gridpack::powerflow::PFBus*>(network.getBus(i).get());
+      mag.push_back(bus->getVoltage());
+      ang.push_back(bus->getPhase());
+    }
+  }
+}
+
+// Solve the current configuration, followed by a second solve if any
+// generators are moved to their Q limits. This is the same sequence used
+// by the contingency analysis application
+bool solveWithQlim(gridpack::powerflow::PFAppModule &pf_app, bool *switched)
+{
+  bool converged = pf_app.solve();
+  *switched = false;
+  if (converged && !pf_app.checkQlimViolations()) {
+    *switched = true;
+    converged = pf_app.solve();
+  }
+  return converged;
+}
+
+// Solve the base case and all contingencies using one type of start, in
+// the same sequence as the contingency analysis application. Q limit
+// changes are not completely undone by clearQlimViolations, so each type
+// of start uses a freshly read network. The voltages of each contingency
+// are stored in mag and ang and its convergence in conv
+void runContingencies(gridpack::utility::Configuration *config,
+    gridpack::parallel::Communicator &comm,
+    std::vector<gridpack::powerflow::Contingency> &events, StartType start,
+    std::vector<std::vector<double> > &mag,
+    std::vector<std::vector<double> > &ang, std::vector<bool> &conv)
+{
+  boost::shared_ptr<gridpack::powerflow::PFNetwork>
+    network(new gridpack::powerflow::PFNetwork(comm));
+  gridpack::powerflow::PFAppModule pf_app;
+  pf_app.readNetwork(network,config);
+  pf_app.initialize();
+  pf_app.suppressOutput(true);
+  int i;
+  bool switched;
+  mag.resize(events.size());
+  ang.resize(events.size());
+  conv.resize(events.size());
+
+  // Base case. Q limit changes are cleared before the base case is saved
+  pf_app.resetVoltages();
+  solveWithQlim(pf_app, &switched);
+  if (comm.rank() == 0 && start == COLD_START) {
+    printf("Base case %s generators at Q limits\n",
+        switched ? "has" : "has no");
+  }
+  pf_app.clearQlimViolations();
+  if (start != COLD_START) pf_app.saveBaseCase(start == PREDICTED_START);
+
+  for (i=0; i<static_cast<int>(events.size()); i++) {
+    if (start == COLD_START) {
+      pf_app.resetVoltages();
+      pf_app.setContingency(events[i]);
+    } else {
+      pf_app.setContingency(events[i]);
+      pf_app.warmStart();
+    }
+    conv[i] = false;
+    if (pf_app.contingencySolvable()) {
+      conv[i] = solveWithQlim(pf_app, &switched);
+    }
+    getVoltages(*network, mag[i], ang[i]);
+    pf_app.unSetContingency(events[i]);
+  }
+}
+
+// Compare the voltages of a warm or predicted start with the cold start.
+// Return false if a contingency that converged from a cold start does not
+// converge to the same voltages
+bool compareStarts(gridpack::parallel::Communicator &comm,
+    std::vector<gridpack::powerflow::Contingency> &events, const char *name,
+    std::vector<std::vector<double> > &cold_mag,
+    std::vector<std::vector<double> > &cold_ang,
+    std::vector<bool> &cold_conv,
+    std::vector<std::vector<double> > &mag,
+    std::vector<std::vector<double> > &ang, std::vector<bool> &conv)
+{
+  bool ok = true;
+  int i, j;
+  for (i=0; i<static_cast<int>(events.size()); i++) {
+    if (!cold_conv[i]) continue;
+    double dv = 0.0;
+    double da = 0.0;
+    for (j=0; j<static_cast<int>(mag[i].size()); j++) {
+      if (fabs(mag[i][j]-cold_mag[i][j]) > dv)
+        dv = fabs(mag[i][j]-cold_mag[i][j]);
+      if (fabs(ang[i][j]-cold_ang[i][j]) > da)
+        da = fabs(ang[i][j]-cold_ang[i][j]);
+    }
+    comm.max(&dv,1);
+    comm.max(&da,1);
+    bool cok = conv[i] && dv <= TOLERANCE && da <= TOLERANCE;
+    if (comm.rank() == 0) {
+      printf("%-24s %-16s %s max dV: %10.3e max dA: %10.3e %s\n",
+          events[i].p_name.c_str(), name, (conv[i] ? "conv" : "fail"),
+          dv, da, (cok ? "" : "ERROR"));
+    }
+    if (!cok) ok = false;
+  }
+  return ok;
+}
+
+int
+main(int argc, char **argv)
+{
+  gridpack::Environment env(argc,argv);
+  int ret = 0;
+
+  if (1) {
+    gridpack::parallel::Communicator world;
+
+    // read configuration file
+    gridpack::utility::Configuration *config =
+      gridpack::utility::Configuration::configuration();
+    if (argc >= 2 && argv[1] != NULL) {
+      char inputfile[256];
+      sprintf(inputfile,"%s",argv[1]);
+      config->open(inputfile,world);
+    } else {
+      config->open("input.xml",world);
+    }
+
+    boost::shared_ptr<gridpack::powerflow::PFNetwork>
+      pf_network(new gridpack::powerflow::PFNetwork(world));
+
+    gridpack::powerflow::PFAppModule pf_app;
+    pf_app.readNetwork(pf_network,config);
+
+    // Find the first few lines in the network. Each process fills in the
+    // lines it owns and the results are summed over all processes
+    int nline = MAX_LINES;
+    int nbranch = pf_network->totalBranches();
+    if (nbranch < nline) nline = nbranch;
+    std::vector<int> from(nline,0), to(nline,0), ckt(2*nline,0);
+    int i, j;
+    for (i=0; i<pf_network->numBranches(); i++) {
+      int idx = pf_network->getGlobalBranchIndex(i);
+      if (pf_network->getActiveBranch(i) && idx < nline) {
+        gridpack::powerflow::PFBranch *branch =
+          dynamic_cast<gridpack::powerflow::PFBranch*>(
+              pf_network->getBranch(i).get());
+        std::vector<std::string> tags = branch->getLineIDs();
+        from[idx] = branch->getBus1OriginalIndex();
+        to[idx] = branch->getBus2OriginalIndex();
+        if (tags.size() > 0) {
+          for (j=0; j<2 && j<static_cast<int>(tags[0].size()); j++) {
+            ckt[2*idx+j] = static_cast<int>(tags[0][j]);
+          }
+        }
+      }
+    }
+    world.sum(&from[0],nline);
+    world.sum(&to[0],nline);
+    world.sum(&ckt[0],2*nline);
+
+    std::vector<gridpack::powerflow::Contingency> events(nline);
+    for (i=0; i<nline; i++) {
+      gridpack::powerflow::Contingency &event = events[i];
+      event.p_type = gridpack::powerflow::Branch;
+      std::string tag;
+      for (j=0; j<2; j++) {
+        if (ckt[2*i+j] != 0) tag.push_back(static_cast<char>(ckt[2*i+j]));
+      }
+      event.p_from.push_back(from[i]);
+      event.p_to.push_back(to[i]);
+      event.p_ckt.push_back(tag);
+      event.p_saveLineStatus.push_back(true);
+      char name[128];
+      sprintf(name,"Line %d-%d (%s)",from[i],to[i],tag.c_str());
+      event.p_name = name;
+    }
+
+    std::vector<std::vector<double> > cold_mag, cold_ang, mag, ang;
+    std::vector<bool> cold_conv, conv;
+    runContingencies(config, world, events, COLD_START,
+        cold_mag, cold_ang, cold_conv);
+    runContingencies(config, world, events, WARM_START,
+        mag, ang, conv);
+    bool ok = compareStarts(world, events, "warm start", cold_mag, cold_ang,
+        cold_conv, mag, ang, conv);
+    runContingencies(config, world, events, PREDICTED_START,
+        mag, ang, conv);
+    if (!compareStarts(world, events, "predicted start", cold_mag,
+          cold_ang, cold_conv, mag, ang, conv)) ok = false;
+
+    if (world.rank() == 0) {
+      if (ok) {
+        printf("\nWarm started contingencies OK\n");
+      } else {
+        printf("\nError found in warm started contingencies\n");
+      }
+    }
+    if (!ok) ret = 1;
+  }
+
+  return ret;
+}
@@ -767,6 +767,16 @@ void gridpack::rtpr::RTPRDriver::execute(int argc, char** argv, gridpack::Enviro
   if (!cursor->get("groupSize",&grp_size)) {
     grp_size = 1;
   }
+  // Keep a single copy of the base case data on each node. This is only
+  // possible if each task runs on a single process
+  bool shared_base = cursor->get("sharedBaseCase",false);
+  if (shared_base && grp_size != 1) {
+    if (p_world.rank() == 0) {
+      printf("sharedBaseCase requires groupSize 1. Base case data will not"
+          " be shared\n");
+    }
+    shared_base = false;
+  }
   bool foundArea = true;
   bool found;
   found = cursor->get("sourceArea", &p_srcArea);
@@ -865,9 +875,39 @@ void gridpack::rtpr::RTPRDriver::execute(int argc, char** argv, gridpack::Enviro
   // Read in the network from an external file and partition it over the
   // processors in the task communicator. This will read in power flow
   // parameters from the Powerflow block in the input
-  p_pf_app.readNetwork(p_pf_network,config);
+  if (shared_base) {
+    // Only one process on each node reads the network. The others build
+    // their networks from the copy in shared memory
+    p_shared_network.reset(new gridpack::network::NodeSharedNetwork<
+        gridpack::powerflow::PFNetwork>(p_world));
+    if (p_shared_network->isNodeLeader()) {
+      p_pf_app.readNetwork(p_pf_network,config);
+    }
+    p_shared_network->share(p_pf_network);
+    if (!p_shared_network->isNodeLeader()) {
+      p_pf_app.setNetwork(p_pf_network,config);
+    }
+  } else {
+    p_pf_app.readNetwork(p_pf_network,config);
+  }
   // Finish initializing the network
   p_pf_app.initialize();
+  if (shared_base) {
+    long priv = p_shared_network->nodeSum(p_pf_network->dataMemoryUsage());
+    long unshared =
+      p_shared_network->nodeSum(p_shared_network->unsharedBytes());
+    int nnode = p_shared_network->nodeSize();
+    if (p_shared_network->isNodeLeader()) {
+      printf("Node with world rank %d: %d tasks of group size %d\n"
+          "  shared base case data: %ld bytes\n"
+          "  private data:          %ld bytes\n"
+          "  total:                 %ld bytes (%ld bytes without sharing)\n",
+          p_world.rank(),nnode,grp_size,
+          static_cast<long>(p_shared_network->sharedBytes()),priv,
+          static_cast<long>(p_shared_network->sharedBytes())+priv,
+          unshared*static_cast<long>(nnode));
+    }
+  }
 
   if (!calcGenCntngcy && !calcLineCntngcy) {
     // Read in contingency file name
@@ -20,6 +20,7 @@
 
 #include "gridpack/include/gridpack.hpp"
 #include "gridpack/applications/modules/powerflow/pf_app_module.hpp"
+#include "gridpack/network/node_shared_network.hpp"
 
 namespace gridpack {
 namespace rtpr {
@@ -175,6 +176,11 @@ class RTPRDriver
 
     private:
 
+    // Node-wide copy of the base case. This must be declared before the
+    // networks so that it is released after them
+    boost::shared_ptr<gridpack::network::NodeSharedNetwork<
+      gridpack::powerflow::PFNetwork> > p_shared_network;
+
     boost::shared_ptr<gridpack::powerflow::PFNetwork> p_pf_network;
 
     boost::shared_ptr<gridpack::dynamic_simulation::DSFullNetwork>
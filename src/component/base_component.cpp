@@ -432,7 +432,7 @@ void GenMatVecInterface::slabSetValues(RealType **values)
  * Simple constructor
  */
 BaseComponent::BaseComponent(void)
-  : p_XCBuf(NULL), p_XCBufSize(0), p_mode(-1), p_rank(-1)
+  : p_XCBuf(NULL), p_XCBufSize(0), p_mode(-1), p_rank(-1), p_revision(0)
 {
 }
 
@@ -565,6 +565,26 @@ int BaseComponent::getRank(void) const
   return p_rank;
 }
 
+/**
+ * Mark the matrix and vector contributions of this component as
+ * changed. Mappers that support incremental updates only query
+ * components that have been marked since the mapper last filled a
+ * matrix or vector
+ */
+void BaseComponent::markDirty(void)
+{
+  p_revision++;
+}
+
+/**
+ * Return the number of times the component has been marked as changed
+ * @return revision count of component
+ */
+unsigned int BaseComponent::getRevision(void) const
+{
+  return p_revision;
+}
+
 
 // Base implementation for a bus object. Provides a mechanism for the bus to
 // provide a list of the branches that are directly connected to it as well as a
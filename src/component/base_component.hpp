@@ -450,6 +450,21 @@ class BaseComponent
      */
     int getRank(void) const;
 
+    /**
+     * Mark the matrix and vector contributions of this component as
+     * changed. Mappers that support incremental updates (e.g.
+     * FullMatrixMap::updateMatrix) only query components that have been
+     * marked since the mapper last filled a matrix or vector
+     */
+    void markDirty(void);
+
+    /**
+     * Return the number of times the component has been marked as changed.
+     * Mappers compare this with the value they recorded at their last fill
+     * @return revision count of component
+     */
+    unsigned int getRevision(void) const;
+
   protected:
     /**
      * A buffer that can be used for exchanging component data. This is
@@ -472,6 +487,13 @@ class BaseComponent
      */
     int p_rank;
 
+    /**
+     * Number of times component has been marked as changed. This is not
+     * serialized, since mappers are created after the network is
+     * distributed
+     */
+    unsigned int p_revision;
+
   private:
 
   friend class boost::serialization::access;
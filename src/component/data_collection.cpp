@@ -6,11 +6,198 @@
 #include "gridpack/component/data_collection.hpp"
 #include <iostream>
 #include <cstdio>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+/**
+ * Create tag for an indexed data element
+ * @param name name of data element
+ * @param idx index of data element
+ * @return tag of the form "name:idx"
+ */
+std::string indexedName(const char *name, const int idx)
+{
+  std::string str = name;
+  str.append(":");
+  char buf[16];
+  sprintf(buf,"%d",idx);
+  str.append(buf);
+  return str;
+}
+
+/**
+ * Heap memory used by a string. Short strings are assumed to fit in
+ * the string object itself
+ */
+size_t stringBytes(const std::string &str)
+{
+  if (str.capacity() < sizeof(std::string)) return 0;
+  return str.capacity() + 1;
+}
+
+template <typename T> size_t valueBytes(const T &value)
+{
+  return 0;
+}
+
+size_t valueBytes(const std::string &value)
+{
+  return stringBytes(value);
+}
+
+/**
+ * Approximate memory used by a map. Each entry is counted as a tree
+ * node holding the key/value pair plus any heap storage for strings
+ */
+template <typename M> size_t mapBytes(const M &map)
+{
+  size_t ret = 0;
+  typename M::const_iterator it;
+  for (it = map.begin(); it != map.end(); it++) {
+    ret += sizeof(typename M::value_type) + 4*sizeof(void*);
+    ret += stringBytes(it->first) + valueBytes(it->second);
+  }
+  return ret;
+}
+
+/**
+ * Maximum number of shared layers under a collection. Deeper stacks are
+ * merged into a single new layer, so lookups never have to search more
+ * than a few layers
+ */
+const size_t maxSharedLayers = 4;
+
+/**
+ * Copy all entries in src to dest, replacing entries that already exist
+ */
+template <typename M> void overlayMap(M &dest, const M &src)
+{
+  typename M::const_iterator it;
+  for (it = src.begin(); it != src.end(); it++) {
+    dest[it->first] = it->second;
+  }
+}
+
+// Packed images have the layout
+//   uint32_t n
+//   uint32_t offset[n]   offsets of entries from start of image
+//   entries
+// Each entry is a one byte type tag, a uint32_t name length, the name
+// and the value. Numerical values are stored as raw bytes, strings as a
+// uint32_t length followed by the characters. Offsets are sorted by
+// name and then by tag so that entries can be found with a binary
+// search. All fields are read with memcpy, so no alignment is assumed
+
+typedef unsigned int PackedSize;
+
+char packedTag(const int*) { return 0; }
+char packedTag(const long*) { return 1; }
+char packedTag(const bool*) { return 2; }
+char packedTag(const std::string*) { return 3; }
+char packedTag(const float*) { return 4; }
+char packedTag(const double*) { return 5; }
+char packedTag(const gridpack::ComplexType*) { return 6; }
+
+template <typename T> void packValue(std::string &buf, const T &value)
+{
+  buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void packValue(std::string &buf, const std::string &value)
+{
+  PackedSize len = value.size();
+  buf.append(reinterpret_cast<const char*>(&len), sizeof(PackedSize));
+  buf.append(value);
+}
+
+template <typename T> void unpackValue(const char *ptr, T *value)
+{
+  memcpy(value, ptr, sizeof(T));
+}
+
+void unpackValue(const char *ptr, std::string *value)
+{
+  PackedSize len;
+  memcpy(&len, ptr, sizeof(PackedSize));
+  value->assign(ptr+sizeof(PackedSize), len);
+}
+
+/**
+ * Entry of a packed image. The name and tag are kept separately for
+ * sorting, data holds the complete packed entry
+ */
+struct PackedEntry {
+  std::string name;
+  char tag;
+  std::string data;
+  bool operator<(const PackedEntry &rhs) const
+  {
+    if (name != rhs.name) return name < rhs.name;
+    return tag < rhs.tag;
+  }
+};
+
+template <typename M> void packMap(std::vector<PackedEntry> &entries,
+    const M &map)
+{
+  typename M::const_iterator it;
+  for (it = map.begin(); it != map.end(); it++) {
+    PackedEntry entry;
+    entry.name = it->first;
+    entry.tag = packedTag(&it->second);
+    PackedSize len = entry.name.size();
+    entry.data.append(1, entry.tag);
+    entry.data.append(reinterpret_cast<const char*>(&len),
+        sizeof(PackedSize));
+    entry.data.append(entry.name);
+    packValue(entry.data, it->second);
+    entries.push_back(entry);
+  }
+}
+
+/**
+ * Find the value of an element in a packed image
+ * @param image packed image
+ * @param key name of element
+ * @param tag type tag of element
+ * @return pointer to packed value or NULL if element is not found
+ */
+const char* findPacked(const char *image, const std::string &key, char tag)
+{
+  PackedSize n;
+  memcpy(&n, image, sizeof(PackedSize));
+  const char *offsets = image + sizeof(PackedSize);
+  PackedSize lo = 0;
+  PackedSize hi = n;
+  while (lo < hi) {
+    PackedSize mid = lo + (hi-lo)/2;
+    PackedSize off, len;
+    memcpy(&off, offsets + mid*sizeof(PackedSize), sizeof(PackedSize));
+    const char *entry = image + off;
+    memcpy(&len, entry+1, sizeof(PackedSize));
+    const char *name = entry + 1 + sizeof(PackedSize);
+    int cmp = key.compare(0, std::string::npos, name, len);
+    if (cmp == 0) cmp = tag - entry[0];
+    if (cmp == 0) return name + len;
+    if (cmp < 0) {
+      hi = mid;
+    } else {
+      lo = mid+1;
+    }
+  }
+  return NULL;
+}
+
+}
 
 /**
  * Simple constructor
  */
 gridpack::component::DataCollection::DataCollection(void)
+  : p_image(NULL)
 {
 }
 
@@ -22,19 +209,23 @@ gridpack::component::DataCollection::~DataCollection(void)
 }
 
 /**
- * Assignment operator
+ * Assignment operator. The layers of rhs are shared with this
+ * collection. The private layer of rhs becomes a shared layer of this
+ * collection; rhs keeps it as its private layer but moves it to its own
+ * shared layers the next time that it adds or modifies a value. rhs is
+ * not modified
  */
 gridpack::component::DataCollection & gridpack::component::DataCollection::operator=
   (const gridpack::component::DataCollection &rhs)
 {
   if (this == &rhs) return *this;
-  p_ints = rhs.p_ints;
-  p_longs = rhs.p_longs;
-  p_bools = rhs.p_bools;
-  p_strings = rhs.p_strings;
-  p_floats = rhs.p_floats;
-  p_doubles = rhs.p_doubles;
-  p_complexType = rhs.p_complexType;
+  p_image = rhs.p_image;
+  p_shared = rhs.p_shared;
+  if (rhs.p_local && rhs.p_local->size() > 0) {
+    p_shared.push_back(rhs.p_local);
+  }
+  p_local.reset();
+  p_compact();
   return *this;
 }
 
@@ -43,47 +234,40 @@ gridpack::component::DataCollection & gridpack::component::DataCollection::opera
  *  @param name name given to data element
  *  @param value value of data element
  */
+
 void gridpack::component::DataCollection::addValue(const char *name, const int value)
 {
-  std::string str = name;
-  p_ints.insert(std::pair<std::string, int>(str,value));
+  p_add<int>(std::string(name),value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const long value)
 {
-  std::string str = name;
-  p_longs.insert(std::pair<std::string, long>(str,value));
+  p_add<long>(std::string(name),value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const bool value)
 {
-  std::string str = name;
-  p_bools.insert(std::pair<std::string, bool>(str,value));
+  p_add<bool>(std::string(name),value);
 }
 
-void gridpack::component::DataCollection::addValue(const char *name, const char *value)
+void gridpack::component::DataCollection::addValue(const char *name, const char * value)
 {
-  std::string str = name;
-  std::string val = value;
-  p_strings.insert(std::pair<std::string, std::string>(str,val));
+  p_add<std::string>(std::string(name),std::string(value));
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const float value)
 {
-  std::string str = name;
-  p_floats.insert(std::pair<std::string, float>(str,value));
+  p_add<float>(std::string(name),value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const double value)
 {
-  std::string str = name;
-  p_doubles.insert(std::pair<std::string, double>(str,value));
+  p_add<double>(std::string(name),value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const gridpack::ComplexType value)
 {
-  std::string str = name;
-  p_complexType.insert(std::pair<std::string, gridpack::ComplexType>(str,value));
+  p_add<gridpack::ComplexType>(std::string(name),value);
 }
 
 /**
@@ -94,82 +278,47 @@ void gridpack::component::DataCollection::addValue(const char *name, const gridp
  *  @param value value of data element
  *  @param idx index of value
  */
+
 void gridpack::component::DataCollection::addValue(const char *name, const int value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  p_ints.insert(std::pair<std::string, int>(str,value));
+  p_add<int>(indexedName(name,idx),value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const long value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  p_longs.insert(std::pair<std::string, long>(str,value));
+  p_add<long>(indexedName(name,idx),value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const bool value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  p_bools.insert(std::pair<std::string, bool>(str,value));
+  p_add<bool>(indexedName(name,idx),value);
 }
 
-void gridpack::component::DataCollection::addValue(const char *name, const char *value,
+void gridpack::component::DataCollection::addValue(const char *name, const char * value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  std::string val = value;
-  p_strings.insert(std::pair<std::string, std::string>(str,val));
+  p_add<std::string>(indexedName(name,idx),std::string(value));
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const float value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  p_floats.insert(std::pair<std::string, float>(str,value));
+  p_add<float>(indexedName(name,idx),value);
 }
 
 void gridpack::component::DataCollection::addValue(const char *name, const double value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  p_doubles.insert(std::pair<std::string, double>(str,value));
+  p_add<double>(indexedName(name,idx),value);
 }
 
-void gridpack::component::DataCollection::addValue(const char *name,
-    const gridpack::ComplexType value, const int idx)
+void gridpack::component::DataCollection::addValue(const char *name, const gridpack::ComplexType value,
+    const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  p_complexType.insert(std::pair<std::string, gridpack::ComplexType>(str,value));
+  p_add<gridpack::ComplexType>(indexedName(name,idx),value);
 }
 
 /**
@@ -180,124 +329,40 @@ void gridpack::component::DataCollection::addValue(const char *name,
  *  @return false if no element of the correct name and type exists in
  *  DataCollection object
  */
+
 bool gridpack::component::DataCollection::setValue(const char *name, const int value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, int>::iterator it;
-#else
-  boost::unordered_map<std::string, int>::iterator it;
-#endif
-  it = p_ints.find(str);
-  if (it != p_ints.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<int>(std::string(name),value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const long value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, long>::iterator it;
-#else
-  boost::unordered_map<std::string, long>::iterator it;
-#endif
-  it = p_longs.find(str);
-  if (it != p_longs.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<long>(std::string(name),value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const bool value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, bool>::iterator it;
-#else
-  boost::unordered_map<std::string, bool>::iterator it;
-#endif
-  it = p_bools.find(str);
-  if (it != p_bools.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<bool>(std::string(name),value);
 }
 
-bool gridpack::component::DataCollection::setValue(const char *name, const char *value)
+bool gridpack::component::DataCollection::setValue(const char *name, const char * value)
 {
-  std::string str = name;
-  std::string val = value;
-#ifdef OLD_MAP
-  std::map<std::string, std::string>::iterator it;
-#else
-  boost::unordered_map<std::string, std::string>::iterator it;
-#endif
-  it = p_strings.find(str);
-  if (it != p_strings.end()) {
-    it->second = val;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<std::string>(std::string(name),std::string(value));
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const float value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, float>::iterator it;
-#else
-  boost::unordered_map<std::string, float>::iterator it;
-#endif
-  it = p_floats.find(str);
-  if (it != p_floats.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<float>(std::string(name),value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const double value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, double>::iterator it;
-#else
-  boost::unordered_map<std::string, double>::iterator it;
-#endif
-  it = p_doubles.find(str);
-  if (it != p_doubles.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<double>(std::string(name),value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const gridpack::ComplexType value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, gridpack::ComplexType>::iterator it;
-#else
-  boost::unordered_map<std::string, gridpack::ComplexType>::iterator it;
-#endif
-  it = p_complexType.find(str);
-  if (it != p_complexType.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<gridpack::ComplexType>(std::string(name),value);
 }
 
 /**
@@ -310,159 +375,47 @@ bool gridpack::component::DataCollection::setValue(const char *name, const gridp
  *  @return false if no element of the correct name and type exists in
  *  DataCollection object
  */
+
 bool gridpack::component::DataCollection::setValue(const char *name, const int value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, int>::iterator it;
-#else
-  boost::unordered_map<std::string, int>::iterator it;
-#endif
-  it = p_ints.find(str);
-  if (it != p_ints.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<int>(indexedName(name,idx),value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const long value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, long>::iterator it;
-#else
-  boost::unordered_map<std::string, long>::iterator it;
-#endif
-  it = p_longs.find(str);
-  if (it != p_longs.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<long>(indexedName(name,idx),value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const bool value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, bool>::iterator it;
-#else
-  boost::unordered_map<std::string, bool>::iterator it;
-#endif
-  it = p_bools.find(str);
-  if (it != p_bools.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<bool>(indexedName(name,idx),value);
 }
 
-bool gridpack::component::DataCollection::setValue(const char *name, const char *value,
+bool gridpack::component::DataCollection::setValue(const char *name, const char * value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-  std::string val = value;
-#ifdef OLD_MAP
-  std::map<std::string, std::string>::iterator it;
-#else
-  boost::unordered_map<std::string, std::string>::iterator it;
-#endif
-  it = p_strings.find(str);
-  if (it != p_strings.end()) {
-    it->second = val;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<std::string>(indexedName(name,idx),std::string(value));
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const float value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, float>::iterator it;
-#else
-  boost::unordered_map<std::string, float>::iterator it;
-#endif
-  it = p_floats.find(str);
-  if (it != p_floats.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<float>(indexedName(name,idx),value);
 }
 
 bool gridpack::component::DataCollection::setValue(const char *name, const double value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, double>::iterator it;
-#else
-  boost::unordered_map<std::string, double>::iterator it;
-#endif
-  it = p_doubles.find(str);
-  if (it != p_doubles.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<double>(indexedName(name,idx),value);
 }
 
-bool gridpack::component::DataCollection::setValue(const char *name,
-    const gridpack::ComplexType value, const int idx)
+bool gridpack::component::DataCollection::setValue(const char *name, const gridpack::ComplexType value,
+    const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, gridpack::ComplexType>::iterator it;
-#else
-  boost::unordered_map<std::string, gridpack::ComplexType>::iterator it;
-#endif
-  it = p_complexType.find(str);
-  if (it != p_complexType.end()) {
-    it->second = value;
-    return true;
-  } else {
-    return false;
-  }
+  return p_set<gridpack::ComplexType>(indexedName(name,idx),value);
 }
 
 /**
@@ -473,123 +426,40 @@ bool gridpack::component::DataCollection::setValue(const char *name,
  *  @return false if no element of the correct name and type exists in
  *  DataCollection object
  */
+
 bool gridpack::component::DataCollection::getValue(const char *name, int *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, int>::iterator it;
-#else
-  boost::unordered_map<std::string, int>::iterator it;
-#endif
-  it = p_ints.find(str);
-  if (it != p_ints.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(std::string(name),value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, long *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, long>::iterator it;
-#else
-  boost::unordered_map<std::string, long>::iterator it;
-#endif
-  it = p_longs.find(str);
-  if (it != p_longs.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(std::string(name),value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, bool *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, bool>::iterator it;
-#else
-  boost::unordered_map<std::string, bool>::iterator it;
-#endif
-  it = p_bools.find(str);
-  if (it != p_bools.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(std::string(name),value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, std::string *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, std::string>::iterator it;
-#else
-  boost::unordered_map<std::string, std::string>::iterator it;
-#endif
-  it = p_strings.find(str);
-  if (it != p_strings.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(std::string(name),value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, float *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, float>::iterator it;
-#else
-  boost::unordered_map<std::string, float>::iterator it;
-#endif
-  it = p_floats.find(str);
-  if (it != p_floats.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(std::string(name),value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, double *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, double>::iterator it;
-#else
-  boost::unordered_map<std::string, double>::iterator it;
-#endif
-  it = p_doubles.find(str);
-  if (it != p_doubles.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(std::string(name),value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, gridpack::ComplexType *value)
 {
-  std::string str = name;
-#ifdef OLD_MAP
-  std::map<std::string, gridpack::ComplexType>::iterator it;
-#else
-  boost::unordered_map<std::string, gridpack::ComplexType>::iterator it;
-#endif
-  it = p_complexType.find(str);
-  if (it != p_complexType.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(std::string(name),value);
 }
 
 /**
@@ -602,158 +472,47 @@ bool gridpack::component::DataCollection::getValue(const char *name, gridpack::C
  *  @return false if no element of the correct name and type exists in
  *  DataCollection object
  */
+
 bool gridpack::component::DataCollection::getValue(const char *name, int *value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, int>::iterator it;
-#else
-  boost::unordered_map<std::string, int>::iterator it;
-#endif
-  it = p_ints.find(str);
-  if (it != p_ints.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(indexedName(name,idx),value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, long *value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, long>::iterator it;
-#else
-  boost::unordered_map<std::string, long>::iterator it;
-#endif
-  it = p_longs.find(str);
-  if (it != p_longs.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(indexedName(name,idx),value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, bool *value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, bool>::iterator it;
-  it = p_bools.find(str);
-#else
-  boost::unordered_map<std::string, bool>::iterator it;
-#endif
-  if (it != p_bools.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(indexedName(name,idx),value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, std::string *value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, std::string>::iterator it;
-#else
-  boost::unordered_map<std::string, std::string>::iterator it;
-#endif
-  it = p_strings.find(str);
-  if (it != p_strings.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(indexedName(name,idx),value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, float *value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, float>::iterator it;
-#else
-  boost::unordered_map<std::string, float>::iterator it;
-#endif
-  it = p_floats.find(str);
-  if (it != p_floats.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(indexedName(name,idx),value);
 }
 
 bool gridpack::component::DataCollection::getValue(const char *name, double *value,
     const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, double>::iterator it;
-#else
-  boost::unordered_map<std::string, double>::iterator it;
-#endif
-  it = p_doubles.find(str);
-  if (it != p_doubles.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(indexedName(name,idx),value);
 }
 
-bool gridpack::component::DataCollection::getValue(const char *name,
-    gridpack::ComplexType *value, const int idx)
+bool gridpack::component::DataCollection::getValue(const char *name, gridpack::ComplexType *value,
+    const int idx)
 {
-  std::string str = name;
-  str.append(":");
-  char buf[8];
-  sprintf(buf,"%d",idx);
-  str.append(buf);
-#ifdef OLD_MAP
-  std::map<std::string, gridpack::ComplexType>::iterator it;
-#else
-  boost::unordered_map<std::string, gridpack::ComplexType>::iterator it;
-#endif
-  it = p_complexType.find(str);
-  if (it != p_complexType.end()) {
-    *value = it->second;
-    return true;
-  } else {
-    return false;
-  }
+  return p_get(indexedName(name,idx),value);
 }
 
 /**
@@ -761,96 +520,361 @@ bool gridpack::component::DataCollection::getValue(const char *name,
  */
 void gridpack::component::DataCollection::dump(void)
 {
+  Storage data;
+  p_merged(data);
   // print out integers
-#ifdef OLD_MAP
-  std::map<std::string, int>::iterator int_it;
-#else
-  boost::unordered_map<std::string, int>::iterator int_it;
-#endif
-  int_it = p_ints.begin();
-  int i = 0;
-  while (int_it != p_ints.end()) {
+  Map<int>::type::iterator int_it;
+  int_it = data.p_ints.begin();
+  while (int_it != data.p_ints.end()) {
     std::string key = int_it->first;
     int ival = int_it->second;
     std::cout << "  (INTEGER) key: "<<key<<" value: "<<ival<<std::endl;
     int_it++;
   }
   // print out longs
-#ifdef OLD_MAP
-  std::map<std::string, long>::iterator long_it;
-#else
-  boost::unordered_map<std::string, long>::iterator long_it;
-#endif
-  long_it = p_longs.begin();
-  while (long_it != p_longs.end()) {
+  Map<long>::type::iterator long_it;
+  long_it = data.p_longs.begin();
+  while (long_it != data.p_longs.end()) {
     std::string key = long_it->first;
     long lval = long_it->second;
     std::cout << "  (LONG) key: "<<key<<" value: "<<lval<<std::endl;
     long_it++;
   }
   // print out bools
-#ifdef OLD_MAP
-  std::map<std::string, bool>::iterator bool_it;
-#else
-  boost::unordered_map<std::string, bool>::iterator bool_it;
-#endif
-  bool_it = p_bools.begin();
-  while (bool_it != p_bools.end()) {
+  Map<bool>::type::iterator bool_it;
+  bool_it = data.p_bools.begin();
+  while (bool_it != data.p_bools.end()) {
     std::string key = bool_it->first;
     bool bval = bool_it->second;
     std::cout << "  (BOOL) key: "<<key<<" value: "<<bval<<std::endl;
     bool_it++;
   }
   // print out strings
-#ifdef OLD_MAP
-  std::map<std::string, std::string>::iterator str_it;
-#else
-  boost::unordered_map<std::string, std::string>::iterator str_it;
-#endif
-  str_it = p_strings.begin();
-  while (str_it != p_strings.end()) {
+  Map<std::string>::type::iterator str_it;
+  str_it = data.p_strings.begin();
+  while (str_it != data.p_strings.end()) {
     std::string key = str_it->first;
     std::string sval = str_it->second;
     std::cout << "  (STRING) key: "<<key<<" value: "<<sval<<std::endl;
     str_it++;
   }
   // print out floats
-#ifdef OLD_MAP
-  std::map<std::string, float>::iterator flt_it;
-#else
-  boost::unordered_map<std::string, float>::iterator flt_it;
-#endif
-  flt_it = p_floats.begin();
-  while (flt_it != p_floats.end()) {
+  Map<float>::type::iterator flt_it;
+  flt_it = data.p_floats.begin();
+  while (flt_it != data.p_floats.end()) {
     std::string key = flt_it->first;
     float fval = flt_it->second;
     std::cout << "  (FLOAT) key: "<<key<<" value: "<<fval<<std::endl;
     flt_it++;
   }
   // print out doubles
-#ifdef OLD_MAP
-  std::map<std::string, double>::iterator dbl_it;
-#else
-  boost::unordered_map<std::string, double>::iterator dbl_it;
-#endif
-  dbl_it = p_doubles.begin();
-  while (dbl_it != p_doubles.end()) {
+  Map<double>::type::iterator dbl_it;
+  dbl_it = data.p_doubles.begin();
+  while (dbl_it != data.p_doubles.end()) {
     std::string key = dbl_it->first;
     double dval = dbl_it->second;
     std::cout << "  (DOUBLE) key: "<<key<<" value: "<<dval<<std::endl;
     dbl_it++;
   }
   // print out complex
-#ifdef OLD_MAP
-  std::map<std::string, gridpack::ComplexType>::iterator cmplx_it;
-#else
-  boost::unordered_map<std::string, gridpack::ComplexType>::iterator cmplx_it;
-#endif
-  cmplx_it = p_complexType.begin();
-  while (cmplx_it != p_complexType.end()) {
+  Map<gridpack::ComplexType>::type::iterator cmplx_it;
+  cmplx_it = data.p_complexType.begin();
+  while (cmplx_it != data.p_complexType.end()) {
     std::string key = cmplx_it->first;
     ComplexType cval = cmplx_it->second;
     std::cout << "  (COMPLEX) key: "<<key<<" value: "<<cval<<std::endl;
     cmplx_it++;
   }
 }
+
+/**
+ * Total number of data elements in collection
+ * @return number of elements
+ */
+int gridpack::component::DataCollection::size(void) const
+{
+  if (!p_image && p_shared.empty()) return p_local ? p_local->size() : 0;
+  Storage data;
+  p_merged(data);
+  return data.size();
+}
+
+/**
+ * Number of data elements held in storage that is not shared with
+ * any other collection. This does not include values in shared layers
+ * or a packed image
+ * @return number of private elements
+ */
+int gridpack::component::DataCollection::privateSize(void) const
+{
+  if (!p_local || !p_local.unique()) return 0;
+  return p_local->size();
+}
+
+/**
+ * Approximate number of bytes used to store the data elements. Storage
+ * that is shared with other collections is divided evenly between the
+ * collections that share it, so summing this value over all
+ * collections gives the total memory used by all of them
+ * @return approximate memory footprint in bytes
+ */
+size_t gridpack::component::DataCollection::memoryUsage(void) const
+{
+  size_t ret = 0;
+  size_t i;
+  for (i=0; i<p_shared.size(); i++) {
+    ret += p_shared[i]->memoryUsage()/
+      static_cast<size_t>(p_shared[i].use_count());
+  }
+  if (p_local) {
+    ret += p_local->memoryUsage()/static_cast<size_t>(p_local.use_count());
+  }
+  return ret;
+}
+
+/**
+ * Number of bytes needed to hold a packed image of the collection
+ * @return size of packed image in bytes
+ */
+size_t gridpack::component::DataCollection::packedSize(void) const
+{
+  Storage data;
+  p_merged(data);
+  std::vector<PackedEntry> entries;
+  packMap(entries, data.p_ints);
+  packMap(entries, data.p_longs);
+  packMap(entries, data.p_bools);
+  packMap(entries, data.p_strings);
+  packMap(entries, data.p_floats);
+  packMap(entries, data.p_doubles);
+  packMap(entries, data.p_complexType);
+  size_t ret = sizeof(PackedSize)*(entries.size()+1);
+  size_t i;
+  for (i=0; i<entries.size(); i++) ret += entries[i].data.size();
+  return ret;
+}
+
+/**
+ * Write a packed, read-only image of the collection
+ * @param buf buffer of at least packedSize() bytes
+ */
+void gridpack::component::DataCollection::pack(char *buf) const
+{
+  Storage data;
+  p_merged(data);
+  std::vector<PackedEntry> entries;
+  packMap(entries, data.p_ints);
+  packMap(entries, data.p_longs);
+  packMap(entries, data.p_bools);
+  packMap(entries, data.p_strings);
+  packMap(entries, data.p_floats);
+  packMap(entries, data.p_doubles);
+  packMap(entries, data.p_complexType);
+  std::sort(entries.begin(), entries.end());
+  PackedSize n = entries.size();
+  memcpy(buf, &n, sizeof(PackedSize));
+  PackedSize off = sizeof(PackedSize)*(n+1);
+  PackedSize i;
+  for (i=0; i<n; i++) {
+    memcpy(buf+sizeof(PackedSize)*(i+1), &off, sizeof(PackedSize));
+    memcpy(buf+off, entries[i].data.data(), entries[i].data.size());
+    off += entries[i].data.size();
+  }
+}
+
+/**
+ * Replace the contents of the collection with a packed image created by
+ * pack. The image is used in place and is not copied
+ * @param buf packed image
+ */
+void gridpack::component::DataCollection::attach(const char *buf)
+{
+  p_shared.clear();
+  p_local.reset();
+  p_image = buf;
+}
+
+/**
+ * Add element if it does not already exist
+ */
+template <typename T>
+void gridpack::component::DataCollection::p_add(const std::string &key,
+    const T &value)
+{
+  T tmp;
+  if (p_get(key, &tmp)) return;
+  p_writable().map(static_cast<T*>(NULL)).insert(
+      std::pair<std::string, T>(key,value));
+}
+
+/**
+ * Modify an existing element. Only the private layer is modified; an
+ * element that is found in a shared layer or the packed image is
+ * overridden by a new element in the private layer
+ */
+template <typename T>
+bool gridpack::component::DataCollection::p_set(const std::string &key,
+    const T &value)
+{
+  if (p_local && p_local.unique()) {
+    typename Map<T>::type &data = p_local->map(static_cast<T*>(NULL));
+    typename Map<T>::type::iterator it = data.find(key);
+    if (it != data.end()) {
+      it->second = value;
+      return true;
+    }
+  }
+  T tmp;
+  if (!p_get(key, &tmp)) return false;
+  p_writable().map(static_cast<T*>(NULL))[key] = value;
+  return true;
+}
+
+/**
+ * Find an element, looking in the private layer, then the shared layers
+ * from newest to oldest and finally the packed image
+ */
+template <typename T>
+bool gridpack::component::DataCollection::p_get(const std::string &key,
+    T *value) const
+{
+  typename Map<T>::type::const_iterator it;
+  if (p_local) {
+    const typename Map<T>::type &data = p_local->map(static_cast<T*>(NULL));
+    it = data.find(key);
+    if (it != data.end()) {
+      *value = it->second;
+      return true;
+    }
+  }
+  size_t i = p_shared.size();
+  while (i > 0) {
+    i--;
+    const typename Map<T>::type &data =
+      p_shared[i]->map(static_cast<T*>(NULL));
+    it = data.find(key);
+    if (it != data.end()) {
+      *value = it->second;
+      return true;
+    }
+  }
+  if (p_image) {
+    const char *ptr = findPacked(p_image, key, packedTag(value));
+    if (ptr) {
+      unpackValue(ptr, value);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Return the private layer of the collection. If the current private
+ * layer is shared with another collection it becomes a shared layer and
+ * a new, empty private layer is started
+ */
+gridpack::component::DataCollection::Storage&
+gridpack::component::DataCollection::p_writable(void)
+{
+  if (p_local && !p_local.unique()) {
+    p_shared.push_back(p_local);
+    p_local.reset();
+    p_compact();
+  }
+  if (!p_local) p_local.reset(new Storage);
+  return *p_local;
+}
+
+/**
+ * Merge the shared layers into a single new layer if there are more
+ * than maxSharedLayers of them. The layers themselves are not modified
+ */
+void gridpack::component::DataCollection::p_compact(void)
+{
+  if (p_shared.size() <= maxSharedLayers) return;
+  boost::shared_ptr<Storage> merged(new Storage(*p_shared[0]));
+  size_t i;
+  for (i=1; i<p_shared.size(); i++) merged->overlay(*p_shared[i]);
+  p_shared.clear();
+  p_shared.push_back(merged);
+}
+
+/**
+ * Merge packed image, shared layers and private layer into a single
+ * storage object
+ */
+void gridpack::component::DataCollection::p_merged(Storage &storage) const
+{
+  storage.clear();
+  if (p_image) {
+    PackedSize n, i, off, len;
+    memcpy(&n, p_image, sizeof(PackedSize));
+    for (i=0; i<n; i++) {
+      memcpy(&off, p_image+sizeof(PackedSize)*(i+1), sizeof(PackedSize));
+      const char *entry = p_image + off;
+      memcpy(&len, entry+1, sizeof(PackedSize));
+      std::string key(entry+1+sizeof(PackedSize), len);
+      const char *ptr = entry + 1 + sizeof(PackedSize) + len;
+      switch (entry[0]) {
+        case 0: unpackValue(ptr, &storage.p_ints[key]); break;
+        case 1: unpackValue(ptr, &storage.p_longs[key]); break;
+        case 2: unpackValue(ptr, &storage.p_bools[key]); break;
+        case 3: unpackValue(ptr, &storage.p_strings[key]); break;
+        case 4: unpackValue(ptr, &storage.p_floats[key]); break;
+        case 5: unpackValue(ptr, &storage.p_doubles[key]); break;
+        case 6: unpackValue(ptr, &storage.p_complexType[key]); break;
+      }
+    }
+  }
+  size_t i;
+  for (i=0; i<p_shared.size(); i++) storage.overlay(*p_shared[i]);
+  if (p_local) storage.overlay(*p_local);
+}
+
+/**
+ * Clear all elements
+ */
+void gridpack::component::DataCollection::Storage::clear(void)
+{
+  p_ints.clear();
+  p_longs.clear();
+  p_bools.clear();
+  p_strings.clear();
+  p_floats.clear();
+  p_doubles.clear();
+  p_complexType.clear();
+}
+
+/**
+ * Number of elements
+ */
+int gridpack::component::DataCollection::Storage::size(void) const
+{
+  return p_ints.size() + p_longs.size() + p_bools.size() + p_strings.size()
+    + p_floats.size() + p_doubles.size() + p_complexType.size();
+}
+
+/**
+ * Approximate number of bytes used by elements
+ */
+size_t gridpack::component::DataCollection::Storage::memoryUsage(void) const
+{
+  return mapBytes(p_ints) + mapBytes(p_longs) + mapBytes(p_bools)
+    + mapBytes(p_strings) + mapBytes(p_floats) + mapBytes(p_doubles)
+    + mapBytes(p_complexType);
+}
+
+/**
+ * Copy all elements of other into this storage, replacing any
+ * elements that already exist
+ */
+void gridpack::component::DataCollection::Storage::overlay(const Storage &other)
+{
+  overlayMap(p_ints, other.p_ints);
+  overlayMap(p_longs, other.p_longs);
+  overlayMap(p_bools, other.p_bools);
+  overlayMap(p_strings, other.p_strings);
+  overlayMap(p_floats, other.p_floats);
+  overlayMap(p_doubles, other.p_doubles);
+  overlayMap(p_complexType, other.p_complexType);
+}
@@ -13,14 +13,27 @@
 #endif
 #include <map>
 #include <string>
+#include <vector>
+#include <cstddef>
+#include <boost/shared_ptr.hpp>
 #include <boost/serialization/map.hpp>
 #include <boost/serialization/string.hpp>
+#include <boost/serialization/split_member.hpp>
 
 #include "gridpack/utilities/complex.hpp"
 
 #include <boost/serialization/export.hpp>
 
-// Simple outline of data collection object
+// Simple outline of data collection object. Values are held in a stack of
+// layers. The bottom layers are read-only and can be shared with other
+// collections; the top layer holds the values that this collection has
+// added or modified. Copying a collection with the assignment operator
+// shares its layers instead of copying them, so networks that are
+// created with BaseNetwork::clone only store the individual values that
+// they subsequently change. A collection can also be attached to a
+// packed, read-only image of another collection (see pack and attach),
+// so that the image can be placed in memory that is shared between
+// processes.
 
 namespace gridpack{
 namespace component{
@@ -38,7 +51,9 @@ public:
   ~DataCollection(void);
 
   /**
-   * Assignment operator
+   * Assignment operator. The layers of rhs are shared with this
+   * collection. Values that either collection subsequently adds or
+   * modifies are stored only by that collection. rhs is not modified
    */
   DataCollection & operator= (const DataCollection &rhs);
 
@@ -143,40 +158,206 @@ public:
    * Dump contents of data collection to standard out
    */
   void dump(void);
+
+  /**
+   * Total number of data elements in collection
+   * @return number of elements
+   */
+  int size(void) const;
+
+  /**
+   * Number of data elements held in storage that is not shared with
+   * any other collection. These are the values that the collection has
+   * added or modified since it was last copied. This does not include
+   * values in shared layers or a packed image
+   * @return number of private elements
+   */
+  int privateSize(void) const;
+
+  /**
+   * Approximate number of bytes used to store the data elements. Storage
+   * that is shared with other collections is divided evenly between the
+   * collections that share it, so summing this value over all
+   * collections gives the total memory used by all of them
+   * @return approximate memory footprint in bytes
+   */
+  size_t memoryUsage(void) const;
+
+  /**
+   * Number of bytes needed to hold a packed image of the collection
+   * @return size of packed image in bytes
+   */
+  size_t packedSize(void) const;
+
+  /**
+   * Write a packed, read-only image of the collection. The image
+   * contains no pointers, so it can be copied or placed in memory that
+   * is mapped at different addresses in different processes
+   * @param buf buffer of at least packedSize() bytes
+   */
+  void pack(char *buf) const;
+
+  /**
+   * Replace the contents of the collection with a packed image created
+   * by pack. The image is used in place and is not copied, so it must
+   * not be modified or released while the collection (or any collection
+   * that it is assigned to) uses it. Values that are subsequently added
+   * or modified are stored by this collection and override the image. Memory used by
+   * the image is not included in memoryUsage
+   * @param buf packed image
+   */
+  void attach(const char *buf);
+
 private:
+
 #ifdef OLD_MAP
-  std::map<std::string, int> p_ints; 
-  std::map<std::string, long> p_longs; 
-  std::map<std::string, bool> p_bools; 
-  std::map<std::string, std::string> p_strings; 
-  std::map<std::string, float> p_floats; 
-  std::map<std::string, double> p_doubles; 
-  std::map<std::string, gridpack::ComplexType> p_complexType; 
+  template <typename T> struct Map {
+    typedef std::map<std::string, T> type;
+  };
 #else
-  boost::unordered_map<std::string, int> p_ints; 
-  boost::unordered_map<std::string, long> p_longs; 
-  boost::unordered_map<std::string, bool> p_bools; 
-  boost::unordered_map<std::string, std::string> p_strings; 
-  boost::unordered_map<std::string, float> p_floats; 
-  boost::unordered_map<std::string, double> p_doubles; 
-  boost::unordered_map<std::string, gridpack::ComplexType> p_complexType; 
+  template <typename T> struct Map {
+    typedef boost::unordered_map<std::string, T> type;
+  };
 #endif
 
+  /// All data elements in one layer of collection
+  struct Storage {
+    Map<int>::type p_ints;
+    Map<long>::type p_longs;
+    Map<bool>::type p_bools;
+    Map<std::string>::type p_strings;
+    Map<float>::type p_floats;
+    Map<double>::type p_doubles;
+    Map<gridpack::ComplexType>::type p_complexType;
+
+    /**
+     * Clear all elements
+     */
+    void clear(void);
+
+    /**
+     * Number of elements
+     */
+    int size(void) const;
+
+    /**
+     * Approximate number of bytes used by elements
+     */
+    size_t memoryUsage(void) const;
+
+    /**
+     * Copy all elements of other into this storage, replacing any
+     * elements that already exist
+     */
+    void overlay(const Storage &other);
+
+    /// Element maps for each type
+    Map<int>::type& map(int*) { return p_ints; }
+    Map<long>::type& map(long*) { return p_longs; }
+    Map<bool>::type& map(bool*) { return p_bools; }
+    Map<std::string>::type& map(std::string*) { return p_strings; }
+    Map<float>::type& map(float*) { return p_floats; }
+    Map<double>::type& map(double*) { return p_doubles; }
+    Map<gridpack::ComplexType>::type& map(gridpack::ComplexType*)
+      { return p_complexType; }
+    const Map<int>::type& map(int*) const { return p_ints; }
+    const Map<long>::type& map(long*) const { return p_longs; }
+    const Map<bool>::type& map(bool*) const { return p_bools; }
+    const Map<std::string>::type& map(std::string*) const
+      { return p_strings; }
+    const Map<float>::type& map(float*) const { return p_floats; }
+    const Map<double>::type& map(double*) const { return p_doubles; }
+    const Map<gridpack::ComplexType>::type& map(gridpack::ComplexType*) const
+      { return p_complexType; }
+  };
+
+  /**
+   * Add element if it does not already exist
+   */
+  template <typename T> void p_add(const std::string &key, const T &value);
+
+  /**
+   * Modify an existing element
+   */
+  template <typename T> bool p_set(const std::string &key, const T &value);
+
+  /**
+   * Find an element, looking in the private layer, then the shared
+   * layers from newest to oldest and finally the packed image
+   */
+  template <typename T> bool p_get(const std::string &key, T *value) const;
+
+  /**
+   * Return the private layer of the collection. If the current private
+   * layer is shared with another collection it becomes a shared layer
+   * and a new, empty private layer is started
+   */
+  Storage& p_writable(void);
+
+  /**
+   * Merge the shared layers into a single new layer if the stack of
+   * shared layers has become too deep
+   */
+  void p_compact(void);
+
+  /**
+   * Merge packed image, shared layers and private layer into a single
+   * storage object
+   */
+  void p_merged(Storage &storage) const;
+
+  /// Read-only layers shared with other collections, oldest first. A
+  /// layer is never modified once it is in this list
+  std::vector<boost::shared_ptr<const Storage> > p_shared;
+
+  /// Values added or modified by this collection (may be NULL). This
+  /// layer is only modified while no other collection refers to it
+  boost::shared_ptr<Storage> p_local;
+
+  /// Packed read-only image underneath all layers (may be NULL).
+  /// This is not owned by the collection
+  const char *p_image;
+
 private:
   friend class boost::serialization::access;
 
-  /// Serialization method
-  template<class Archive> void serialize(Archive &ar, const unsigned int)
+  /// Serialization methods. Layers and packed image are written out as
+  /// a single set of maps, so the archive format is the same as for an
+  /// unshared collection
+  template<class Archive> void save(Archive &ar, const unsigned int) const
+  {
+    Storage tmp;
+    const Storage *data = &tmp;
+    if (p_image || !p_shared.empty()) {
+      p_merged(tmp);
+    } else if (p_local) {
+      data = p_local.get();
+    }
+    ar & data->p_ints
+      & data->p_longs
+      & data->p_bools
+      & data->p_strings
+      & data->p_floats
+      & data->p_doubles
+      & data->p_complexType;
+  }
+
+  template<class Archive> void load(Archive &ar, const unsigned int)
   {
-    ar & p_ints
-      & p_longs
-      & p_bools
-      & p_strings
-      & p_floats
-      & p_doubles
-      & p_complexType;
+    p_shared.clear();
+    p_local.reset(new Storage);
+    p_image = NULL;
+    ar & p_local->p_ints
+      & p_local->p_longs
+      & p_local->p_bools
+      & p_local->p_strings
+      & p_local->p_floats
+      & p_local->p_doubles
+      & p_local->p_complexType;
   }
 
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+
 };
 
 
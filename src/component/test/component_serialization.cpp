@@ -299,6 +299,174 @@ BOOST_AUTO_TEST_CASE( DataCollection_mpi )
   check_data_collection(key, *dcin, *dcout);
 }
 
+BOOST_AUTO_TEST_CASE( DataCollection_share )
+{
+  char key[] = "key name";
+  boost::scoped_ptr<gridpack::component::DataCollection>
+    dcin(make_a_data_collection(key, 14, "A string value"));
+  dcin->addValue("indexed", 1.0, 0);
+  dcin->addValue("indexed", 2.0, 1);
+  int nvals = dcin->size();
+  BOOST_CHECK_EQUAL(dcin->privateSize(), nvals);
+
+  // copies share values with the original
+  gridpack::component::DataCollection copy1, copy2;
+  copy1 = *dcin;
+  copy2 = copy1;
+  check_data_collection(key, *dcin, copy1);
+  check_data_collection(key, *dcin, copy2);
+  BOOST_CHECK_EQUAL(copy1.size(), nvals);
+  BOOST_CHECK_EQUAL(dcin->size(), nvals);
+  BOOST_CHECK_EQUAL(dcin->privateSize(), 0);
+  BOOST_CHECK_EQUAL(copy1.privateSize(), 0);
+  BOOST_CHECK_EQUAL(copy2.privateSize(), 0);
+  BOOST_CHECK(copy1.memoryUsage() < dcin->memoryUsage() + 1);
+
+  // modifying a copy only affects that copy, and only the modified
+  // value is stored privately
+  double dval;
+  size_t shared = copy1.memoryUsage() + copy2.memoryUsage() +
+    dcin->memoryUsage();
+  BOOST_CHECK(copy1.setValue("indexed", 5.0, 1));
+  BOOST_CHECK_EQUAL(copy1.privateSize(), 1);
+  BOOST_CHECK_EQUAL(copy2.privateSize(), 0);
+  BOOST_CHECK(copy1.memoryUsage() + copy2.memoryUsage() +
+      dcin->memoryUsage() < shared + shared/2);
+  BOOST_CHECK(copy1.getValue("indexed", &dval, 1));
+  BOOST_CHECK_CLOSE(dval, 5.0, delta);
+  BOOST_CHECK(copy2.getValue("indexed", &dval, 1));
+  BOOST_CHECK_CLOSE(dval, 2.0, delta);
+  BOOST_CHECK(dcin->getValue("indexed", &dval, 1));
+  BOOST_CHECK_CLOSE(dval, 2.0, delta);
+
+  // modifying the original does not affect the copies
+  BOOST_CHECK(dcin->setValue(key, 20));
+  int ival;
+  copy2.getValue(key, &ival);
+  BOOST_CHECK_EQUAL(ival, 14);
+  dcin->getValue(key, &ival);
+  BOOST_CHECK_EQUAL(ival, 20);
+
+  // values that are not present cannot be set, and adding a value that
+  // is already present does not change it
+  BOOST_CHECK(!copy1.setValue("missing", 1.0));
+  copy1.addValue("indexed", 7.0, 0);
+  BOOST_CHECK(copy1.getValue("indexed", &dval, 0));
+  BOOST_CHECK_CLOSE(dval, 1.0, delta);
+  copy1.addValue("new value", 3.0);
+  BOOST_CHECK(copy1.getValue("new value", &dval));
+  BOOST_CHECK(!copy2.getValue("new value", &dval));
+  BOOST_CHECK_EQUAL(copy1.size(), nvals+1);
+
+  // a copy of a modified collection sees the modifications
+  gridpack::component::DataCollection copy3;
+  copy3 = copy1;
+  BOOST_CHECK(copy3.getValue("indexed", &dval, 1));
+  BOOST_CHECK_CLOSE(dval, 5.0, delta);
+  BOOST_CHECK(copy3.getValue("new value", &dval));
+  BOOST_CHECK(copy1.getValue("indexed", &dval, 1));
+  BOOST_CHECK_CLOSE(dval, 5.0, delta);
+
+  // modifying the source of a copy does not affect the copy
+  BOOST_CHECK(copy1.setValue("indexed", 6.0, 1));
+  BOOST_CHECK(copy3.getValue("indexed", &dval, 1));
+  BOOST_CHECK_CLOSE(dval, 5.0, delta);
+  BOOST_CHECK(copy1.setValue("indexed", 5.0, 1));
+
+  // long chains of modified copies see all modifications
+  gridpack::component::DataCollection chain[8];
+  chain[0] = copy1;
+  int i;
+  for (i=1; i<8; i++) {
+    chain[i] = chain[i-1];
+    BOOST_CHECK(chain[i].setValue("indexed", static_cast<double>(i), 0));
+    BOOST_CHECK_EQUAL(chain[i].size(), nvals+1);
+    BOOST_CHECK_EQUAL(chain[i].privateSize(), 1);
+  }
+  for (i=1; i<8; i++) {
+    BOOST_CHECK(chain[i].getValue("indexed", &dval, 0));
+    BOOST_CHECK_CLOSE(dval, static_cast<double>(i), delta);
+  }
+  check_data_collection(key, copy1, chain[7]);
+
+  // shared and private values are both serialized
+  boost::scoped_ptr<gridpack::component::DataCollection> dcout;
+  std::stringstream obuf;
+  {
+    outarchive oa(obuf);
+    boost::scoped_ptr<gridpack::component::DataCollection>
+      ptr(new gridpack::component::DataCollection);
+    *ptr = copy1;
+    oa << ptr;
+  }
+  {
+    inarchive ia(obuf);
+    ia >> dcout;
+  }
+  check_data_collection(key, copy1, *dcout);
+  BOOST_CHECK_EQUAL(dcout->size(), nvals+1);
+  BOOST_CHECK(dcout->getValue("indexed", &dval, 1));
+  BOOST_CHECK_CLOSE(dval, 5.0, delta);
+}
+
+BOOST_AUTO_TEST_CASE( DataCollection_packed )
+{
+  char key[] = "key name";
+  boost::scoped_ptr<gridpack::component::DataCollection>
+    dcin(make_a_data_collection(key, 14, "A string value"));
+  dcin->addValue("indexed", 1.0, 0);
+  dcin->addValue("indexed", 2.0, 1);
+  int nvals = dcin->size();
+
+  // an attached collection reads values from the packed image
+  std::vector<char> image(dcin->packedSize());
+  dcin->pack(&image[0]);
+  gridpack::component::DataCollection attached;
+  attached.attach(&image[0]);
+  check_data_collection(key, *dcin, attached);
+  BOOST_CHECK_EQUAL(attached.size(), nvals);
+  BOOST_CHECK_EQUAL(attached.privateSize(), 0);
+  double dval;
+  BOOST_CHECK(attached.getValue("indexed", &dval, 1));
+  BOOST_CHECK_CLOSE(dval, 2.0, delta);
+  BOOST_CHECK(!attached.getValue("missing", &dval));
+
+  // modified and added values are private and do not change the image
+  BOOST_CHECK(attached.setValue("indexed", 5.0, 1));
+  attached.addValue("indexed", 7.0, 0);
+  attached.addValue("new value", 3.0);
+  BOOST_CHECK_EQUAL(attached.privateSize(), 2);
+  BOOST_CHECK_EQUAL(attached.size(), nvals+1);
+  BOOST_CHECK(attached.getValue("indexed", &dval, 0));
+  BOOST_CHECK_CLOSE(dval, 1.0, delta);
+  gridpack::component::DataCollection other;
+  other.attach(&image[0]);
+  BOOST_CHECK(other.getValue("indexed", &dval, 1));
+  BOOST_CHECK_CLOSE(dval, 2.0, delta);
+
+  // copies and serialized collections include the packed values
+  gridpack::component::DataCollection copy;
+  copy = attached;
+  check_data_collection(key, *dcin, copy);
+  BOOST_CHECK(copy.getValue("indexed", &dval, 1));
+  BOOST_CHECK_CLOSE(dval, 5.0, delta);
+  boost::scoped_ptr<gridpack::component::DataCollection> dcout;
+  std::stringstream obuf;
+  {
+    outarchive oa(obuf);
+    boost::scoped_ptr<gridpack::component::DataCollection>
+      ptr(new gridpack::component::DataCollection);
+    *ptr = attached;
+    oa << ptr;
+  }
+  {
+    inarchive ia(obuf);
+    ia >> dcout;
+  }
+  check_data_collection(key, *dcin, *dcout);
+  BOOST_CHECK_EQUAL(dcout->size(), nvals+1);
+}
+
 BOOST_AUTO_TEST_CASE ( Component_bin )
 {
   static int the_id(1);
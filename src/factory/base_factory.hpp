@@ -21,6 +21,7 @@
 #include <vector>
 #include "boost/smart_ptr/shared_ptr.hpp"
 #include "gridpack/timer/coarse_timer.hpp"
+#include "gridpack/parallel/threads.hpp"
 #include "gridpack/network/base_network.hpp"
 #include "gridpack/component/base_component.hpp"
 
@@ -100,12 +101,14 @@ class BaseFactory {
       int numActiveBus = 0;
       for (i=0; i<p_numBuses; i++) {
         p_network->getBus(i)->clearBuses();
-        std::vector<int> nghbrBus = p_network->getConnectedBuses(i);
+        gridpack::network::NeighborRange nghbrBus =
+          p_network->connectedBuses(i);
         for (j=0; j<nghbrBus.size(); j++) {
           p_network->getBus(i)->addBus(p_network->getBus(nghbrBus[j]));
         }
         p_network->getBus(i)->clearBranches();
-        std::vector<int> nghbrBranch = p_network->getConnectedBranches(i);
+        gridpack::network::NeighborRange nghbrBranch =
+          p_network->connectedBranches(i);
         for (j=0; j<nghbrBranch.size(); j++) {
           p_network->getBus(i)->addBranch(p_network->getBranch(nghbrBranch[j]));
         }
@@ -258,13 +261,19 @@ class BaseFactory {
       timer->stop(t_nbus);
       int i;
       int rank = p_network->communicator().rank();
+      bool threaded = gridpack::parallel::threadedLoops();
 
       // Invoke load method on all bus objects
       int t_load1 = timer->createCategory("Factory:load:bus");
       timer->start(t_load1);
+#pragma omp parallel for schedule(dynamic,64) if(threaded)
       for (i=0; i<p_numBuses; i++) {
         p_network->getBus(i)->setRank(rank);
         p_network->getBus(i)->load(p_network->getBusData(i));
+      }
+      // Setting the reference bus modifies the network, so do it
+      // after the (possibly threaded) loop
+      for (i=0; i<p_numBuses; i++) {
         if (p_network->getBus(i)->getReferenceBus())
           p_network->setReferenceBus(i);
       }
@@ -273,6 +282,7 @@ class BaseFactory {
       // Invoke load method on all branch objects
       int t_load2 = timer->createCategory("Factory:load:branch");
       timer->start(t_load2);
+#pragma omp parallel for schedule(dynamic,64) if(threaded)
       for (i=0; i<p_numBranches; i++) {
         p_network->getBranch(i)->setRank(rank);
         p_network->getBranch(i)->load(p_network->getBranchData(i));
@@ -368,9 +378,12 @@ class BaseFactory {
     virtual void setMode(int mode)
     {
       int i;
+      bool threaded = gridpack::parallel::threadedLoops();
+#pragma omp parallel for if(threaded)
       for (i=0; i<p_numBuses; i++) {
         p_buses[i]->setMode(mode);
       }
+#pragma omp parallel for if(threaded)
       for (i=0; i<p_numBranches; i++) {
         p_branches[i]->setMode(mode);
       }
@@ -383,6 +396,8 @@ class BaseFactory {
     virtual void setBusMode(int mode)
     {
       int i;
+      bool threaded = gridpack::parallel::threadedLoops();
+#pragma omp parallel for if(threaded)
       for (i=0; i<p_numBuses; i++) {
         p_buses[i]->setMode(mode);
       }
@@ -395,6 +410,8 @@ class BaseFactory {
     virtual void setBranchMode(int mode)
     {
       int i;
+      bool threaded = gridpack::parallel::threadedLoops();
+#pragma omp parallel for if(threaded)
       for (i=0; i<p_numBranches; i++) {
         p_branches[i]->setMode(mode);
       }
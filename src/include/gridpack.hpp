@@ -32,6 +32,7 @@
 #include "gridpack/parallel/ga_shuffler.hpp"
 #include "gridpack/parallel/index_hash.hpp"
 #include "gridpack/parallel/random.hpp"
+#include "gridpack/parallel/threads.hpp"
 #include "gridpack/parallel/parallel.hpp"
 #include "gridpack/parallel/printit.hpp"
 #include "gridpack/parallel/shuffler.hpp"
@@ -41,6 +42,7 @@
 #include "gridpack/parser/PTI23_parser.hpp"
 #include "gridpack/parser/PTI33_parser.hpp"
 #include "gridpack/parser/GOSS_parser.hpp"
+#include "gridpack/parser/memory_parser.hpp"
 #include "gridpack/parser/hash_distr.hpp"
 #include "gridpack/parser/bus_table.hpp"
 #include "gridpack/parser/dictionary.hpp"
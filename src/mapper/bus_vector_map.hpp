@@ -17,10 +17,13 @@
 #ifndef BUSVECTORMAP_HPP_
 #define BUSVECTORMAP_HPP_
 
+#include <vector>
+#include <string>
 #include <boost/smart_ptr/shared_ptr.hpp>
 #include <ga.h>
 #include "gridpack/parallel/parallel.hpp"
 #include <gridpack/parallel/distributed.hpp>
+#include <gridpack/parallel/threads.hpp>
 #include <gridpack/component/base_component.hpp>
 #include <gridpack/network/base_network.hpp>
 #include <gridpack/math/vector.hpp>
@@ -49,9 +52,13 @@ BusVectorMap(boost::shared_ptr<_network> network)
   int                     iSize    = 0;
   p_contributingBuses              = NULL;
   p_Indices                        = NULL;
+  p_firstIndex                     = 0;
+  p_updatedBlocks                  = 0;
+  p_totalUpdatedBlocks             = 0;
 
   p_timer = NULL;
   p_timer = gridpack::utility::CoarseTimer::instance();
+  setTimerCategories();
 
   p_GAgrp = network->communicator().getGroup();
   p_me = GA_Pgroup_nodeid(p_GAgrp);
@@ -62,7 +69,16 @@ BusVectorMap(boost::shared_ptr<_network> network)
 
   contributions();
 
-  setBusIndexArrays();
+  // Reuse the first index of this processor from a previous mapper on the
+  // same network if the contributions of the buses have not changed
+  std::vector<int> sig;
+  indexSignature(sig);
+  std::string key = p_network->mapperCacheKey("BusVectorMap",sig);
+  p_cached = loadIndexCache(key, sig);
+  if (!p_cached) {
+    setBusIndexArrays();
+    storeIndexCache(key, sig);
+  }
 }
 
 ~BusVectorMap()
@@ -82,20 +98,16 @@ BusVectorMap(boost::shared_ptr<_network> network)
 boost::shared_ptr<gridpack::math::Vector> mapToVector(void)
 {
   gridpack::parallel::Communicator comm = p_network->communicator();
-  int t_new(0), t_bus(0), t_set(0);
-  if (p_timer) t_new = p_timer->createCategory("Vector Map: New Vector");
-  if (p_timer) p_timer->start(t_new);
+  if (p_timer) p_timer->start(p_tNew);
   boost::shared_ptr<gridpack::math::Vector>
              Ret(new gridpack::math::Vector(comm, p_numValues));
-  if (p_timer) p_timer->stop(t_new);
-  if (p_timer) t_bus = p_timer->createCategory("Vector Map: Load Bus Data");
-  if (p_timer) p_timer->start(t_bus);
+  if (p_timer) p_timer->stop(p_tNew);
+  if (p_timer) p_timer->start(p_tBus);
   loadBusData(*Ret,true);
-  if (p_timer) p_timer->stop(t_bus);
-  if (p_timer) t_set = p_timer->createCategory("Vector Map: Set Vector");
-  if (p_timer) p_timer->start(t_set);
+  if (p_timer) p_timer->stop(p_tBus);
+  if (p_timer) p_timer->start(p_tSet);
   Ret->ready();
-  if (p_timer) p_timer->stop(t_set);
+  if (p_timer) p_timer->stop(p_tSet);
   return Ret;
 }
 
@@ -106,20 +118,16 @@ boost::shared_ptr<gridpack::math::Vector> mapToVector(void)
 boost::shared_ptr<gridpack::math::RealVector> mapToRealVector(void)
 {
   gridpack::parallel::Communicator comm = p_network->communicator();
-  int t_new(0), t_bus(0), t_set(0);
-  if (p_timer) t_new = p_timer->createCategory("Vector Map: New Vector");
-  if (p_timer) p_timer->start(t_new);
+  if (p_timer) p_timer->start(p_tNew);
   boost::shared_ptr<gridpack::math::RealVector>
              Ret(new gridpack::math::RealVector(comm, p_numValues));
-  if (p_timer) p_timer->stop(t_new);
-  if (p_timer) t_bus = p_timer->createCategory("Vector Map: Load Bus Data");
-  if (p_timer) p_timer->start(t_bus);
+  if (p_timer) p_timer->stop(p_tNew);
+  if (p_timer) p_timer->start(p_tBus);
   loadRealBusData(*Ret,true);
-  if (p_timer) p_timer->stop(t_bus);
-  if (p_timer) t_set = p_timer->createCategory("Vector Map: Set Vector");
-  if (p_timer) p_timer->start(t_set);
+  if (p_timer) p_timer->stop(p_tBus);
+  if (p_timer) p_timer->start(p_tSet);
   Ret->ready();
-  if (p_timer) p_timer->stop(t_set);
+  if (p_timer) p_timer->stop(p_tSet);
   return Ret;
 }
 
@@ -131,20 +139,16 @@ boost::shared_ptr<gridpack::math::RealVector> mapToRealVector(void)
 gridpack::math::Vector* intMapToVector(void)
 {
   gridpack::parallel::Communicator comm = p_network->communicator();
-  int t_new, t_bus, t_set;
-  if (p_timer) t_new = p_timer->createCategory("Vector Map: New Vector");
-  if (p_timer) p_timer->start(t_new);
+  if (p_timer) p_timer->start(p_tNew);
   gridpack::math::Vector*
      Ret(new gridpack::math::Vector(comm, p_numValues));
-  if (p_timer) p_timer->stop(t_new);
-  if (p_timer) t_bus = p_timer->createCategory("Vector Map: Load Bus Data");
-  if (p_timer) p_timer->start(t_bus);
+  if (p_timer) p_timer->stop(p_tNew);
+  if (p_timer) p_timer->start(p_tBus);
   loadBusData(*Ret,true);
-  if (p_timer) p_timer->stop(t_bus);
-  if (p_timer) t_set = p_timer->createCategory("Vector Map: Set Vector");
-  if (p_timer) p_timer->start(t_set);
+  if (p_timer) p_timer->stop(p_tBus);
+  if (p_timer) p_timer->start(p_tSet);
   Ret->ready();
-  if (p_timer) p_timer->stop(t_set);
+  if (p_timer) p_timer->stop(p_tSet);
   return Ret;
 }
 
@@ -155,18 +159,15 @@ gridpack::math::Vector* intMapToVector(void)
  */
 void mapToVector(gridpack::math::Vector &vector)
 {
-  int t_bus(0), t_set(0);
-  if (p_timer) t_set = p_timer->createCategory("Vector Map: Set Vector");
-  if (p_timer) p_timer->start(t_set);
+  if (p_timer) p_timer->start(p_tSet);
   vector.zero();
-  if (p_timer) p_timer->stop(t_set);
-  if (p_timer) t_bus = p_timer->createCategory("Vector Map: Load Bus Data");
-  if (p_timer) p_timer->start(t_bus);
+  if (p_timer) p_timer->stop(p_tSet);
+  if (p_timer) p_timer->start(p_tBus);
   loadBusData(vector,false);
-  if (p_timer) p_timer->stop(t_bus);
-  if (p_timer) p_timer->start(t_set);
+  if (p_timer) p_timer->stop(p_tBus);
+  if (p_timer) p_timer->start(p_tSet);
   vector.ready();
-  if (p_timer) p_timer->stop(t_set);
+  if (p_timer) p_timer->stop(p_tSet);
 }
 
 /**
@@ -176,18 +177,15 @@ void mapToVector(gridpack::math::Vector &vector)
  */
 void mapToRealVector(gridpack::math::RealVector &vector)
 {
-  int t_bus(0), t_set(0);
-  if (p_timer) t_set = p_timer->createCategory("Vector Map: Set Vector");
-  if (p_timer) p_timer->start(t_set);
+  if (p_timer) p_timer->start(p_tSet);
   vector.zero();
-  if (p_timer) p_timer->stop(t_set);
-  if (p_timer) t_bus = p_timer->createCategory("Vector Map: Load Bus Data");
-  if (p_timer) p_timer->start(t_bus);
+  if (p_timer) p_timer->stop(p_tSet);
+  if (p_timer) p_timer->start(p_tBus);
   loadRealBusData(vector,false);
-  if (p_timer) p_timer->stop(t_bus);
-  if (p_timer) p_timer->start(t_set);
+  if (p_timer) p_timer->stop(p_tBus);
+  if (p_timer) p_timer->start(p_tSet);
   vector.ready();
-  if (p_timer) p_timer->stop(t_set);
+  if (p_timer) p_timer->stop(p_tSet);
 }
 
 /**
@@ -217,24 +215,7 @@ void mapToRealVector(boost::shared_ptr<gridpack::math::RealVector> &vector)
  */
 void mapToBus(const gridpack::math::Vector &vector)
 {
-  ComplexType *values = new ComplexType[p_numValues];
-  int t_get, t_unpack;
-  int i, j, isize, offset;
-  int one = 1;
-  if (p_timer) t_get = p_timer->createCategory("mapToBus: get Data");
-  if (p_timer) p_timer->start(t_get);
-  vector.getElements(p_numValues, p_Indices, values);
-  if (p_timer) p_timer->stop(t_get);
-  ComplexType *vptr = values;
-  if (p_timer) t_unpack = p_timer->createCategory("mapToBus: set Data");
-  if (p_timer) p_timer->start(t_unpack);
-  for (i=0; i<p_busContribution; i++) {
-    p_contributingBuses[i]->setValues(vptr);
-    isize = p_ISize[i];
-    vptr += isize;
-  }
-  if (p_timer) p_timer->stop(t_unpack);
-  delete [] values;
+  unloadBusData(vector, p_complexValues);
 }
 
 /**
@@ -244,24 +225,7 @@ void mapToBus(const gridpack::math::Vector &vector)
  */
 void mapToBus(const gridpack::math::RealVector &vector)
 {
-  RealType *values = new RealType[p_numValues];
-  int t_get, t_unpack;
-  int i, j, isize, offset;
-  int one = 1;
-  if (p_timer) t_get = p_timer->createCategory("mapToBus: get Data");
-  if (p_timer) p_timer->start(t_get);
-  vector.getElements(p_numValues, p_Indices, values);
-  if (p_timer) p_timer->stop(t_get);
-  RealType *vptr = values;
-  if (p_timer) t_unpack = p_timer->createCategory("mapToBus: set Data");
-  if (p_timer) p_timer->start(t_unpack);
-  for (i=0; i<p_busContribution; i++) {
-    p_contributingBuses[i]->setValues(vptr);
-    isize = p_ISize[i];
-    vptr += isize;
-  }
-  if (p_timer) p_timer->stop(t_unpack);
-  delete [] values;
+  unloadBusData(vector, p_realValues);
 }
 
 /**
@@ -292,6 +256,86 @@ void getLocalOffset(int idx, int *offset, int *size)
   *size = p_LocSize[idx];
 }
 
+/**
+ * Refill an existing vector using only the buses that have called
+ * markDirty since this mapper last filled a vector. The values of these
+ * buses are overwritten in place and the vector is assembled once. The
+ * vector should be the one most recently filled by this mapper.
+ * @param vector existing vector (should be generated from same mapper)
+ * @return number of bus blocks rewritten on this processor
+ */
+int updateVector(gridpack::math::Vector &vector)
+{
+  int nblocks = updateValues(vector, p_complexValues);
+  vector.ready();
+  return nblocks;
+}
+
+/**
+ * Refill an existing vector using only the buses that have called
+ * markDirty since this mapper last filled a vector
+ * @param vector existing vector (should be generated from same mapper)
+ * @return number of bus blocks rewritten on this processor
+ */
+int updateVector(boost::shared_ptr<gridpack::math::Vector> &vector)
+{
+  return updateVector(*vector);
+}
+
+/**
+ * Refill an existing real vector using only the buses that have called
+ * markDirty since this mapper last filled a vector
+ * @param vector existing vector (should be generated from same mapper)
+ * @return number of bus blocks rewritten on this processor
+ */
+int updateRealVector(gridpack::math::RealVector &vector)
+{
+  int nblocks = updateValues(vector, p_realValues);
+  vector.ready();
+  return nblocks;
+}
+
+/**
+ * Refill an existing real vector using only the buses that have called
+ * markDirty since this mapper last filled a vector
+ * @param vector existing vector (should be generated from same mapper)
+ * @return number of bus blocks rewritten on this processor
+ */
+int updateRealVector(boost::shared_ptr<gridpack::math::RealVector> &vector)
+{
+  return updateRealVector(*vector);
+}
+
+/**
+ * Return the number of bus blocks rewritten on this processor by the
+ * last call to updateVector or updateRealVector
+ * @return number of rewritten blocks
+ */
+int updatedBlocks(void) const
+{
+  return p_updatedBlocks;
+}
+
+/**
+ * Return the total number of bus blocks rewritten on this processor by
+ * all calls to updateVector or updateRealVector
+ * @return number of rewritten blocks
+ */
+long totalUpdatedBlocks(void) const
+{
+  return p_totalUpdatedBlocks;
+}
+
+/**
+ * Return true if the vector indices of this mapper were taken from a
+ * mapper that was previously created on the same network
+ * @return true if mapper was set up from the network cache
+ */
+bool cached(void) const
+{
+  return p_cached;
+}
+
 private:
 /**
  * Add block contributions from buses to vector
@@ -300,39 +344,7 @@ private:
  */
 void loadBusData(gridpack::math::Vector &vector, bool flag)
 {
-  int i,idx,isize,icnt;
-  // Add vector elements
-  boost::shared_ptr<gridpack::component::BaseBusComponent> bus;
-  int t_bus(0);
-  if (p_timer) t_bus = p_timer->createCategory("loadBusData: Add Vector Elements");
-  if (p_timer) p_timer->start(t_bus);
-  int j;
-  int t_pack, t_add;
-  if (p_timer) t_pack = p_timer->createCategory("loadBusData: Fill Buffer");
-  if (p_timer) p_timer->start(t_pack);
-  ComplexType *vbuf = new ComplexType[p_numValues];
-  ComplexType *vptr = vbuf;
-  int *ibuf = new int[p_numValues];
-  icnt = 0;
-  for (i=0; i<p_busContribution; i++) {
-    p_contributingBuses[i]->vectorValues(vptr);
-    isize = p_ISize[i];
-    idx = p_Offsets[i];
-    for (j=0; j<isize; j++) {
-      ibuf[icnt] = idx;
-      idx++;
-      icnt++;
-    }
-    vptr += isize;
-  }
-  if (p_timer) p_timer->stop(t_pack);
-  if (p_timer) t_add = p_timer->createCategory("loadBusData: Add Elements");
-  if (p_timer) p_timer->start(t_add);
-  vector.addElements(p_numValues,ibuf,vbuf);
-  if (p_timer) p_timer->stop(t_add);
-  delete [] vbuf;
-  delete [] ibuf;
-  if (p_timer) p_timer->stop(t_bus);
+  loadValues(vector, p_complexValues);
 }
 
 /**
@@ -342,39 +354,7 @@ void loadBusData(gridpack::math::Vector &vector, bool flag)
  */
 void loadRealBusData(gridpack::math::RealVector &vector, bool flag)
 {
-  int i,idx,isize,icnt;
-  // Add vector elements
-  boost::shared_ptr<gridpack::component::BaseBusComponent> bus;
-  int t_bus(0);
-  if (p_timer) t_bus = p_timer->createCategory("loadBusData: Add Vector Elements");
-  if (p_timer) p_timer->start(t_bus);
-  int j;
-  int t_pack, t_add;
-  if (p_timer) t_pack = p_timer->createCategory("loadBusData: Fill Buffer");
-  if (p_timer) p_timer->start(t_pack);
-  RealType *vbuf = new RealType[p_numValues];
-  RealType *vptr = vbuf;
-  int *ibuf = new int[p_numValues];
-  icnt = 0;
-  for (i=0; i<p_busContribution; i++) {
-    p_contributingBuses[i]->vectorValues(vptr);
-    isize = p_ISize[i];
-    idx = p_Offsets[i];
-    for (j=0; j<isize; j++) {
-      ibuf[icnt] = idx;
-      idx++;
-      icnt++;
-    }
-    vptr += isize;
-  }
-  if (p_timer) p_timer->stop(t_pack);
-  if (p_timer) t_add = p_timer->createCategory("loadBusData: Add Elements");
-  if (p_timer) p_timer->start(t_add);
-  vector.addElements(p_numValues,ibuf,vbuf);
-  if (p_timer) p_timer->stop(t_add);
-  delete [] vbuf;
-  delete [] ibuf;
-  if (p_timer) p_timer->stop(t_bus);
+  loadValues(vector, p_realValues);
 }
 
 /**
@@ -397,6 +377,177 @@ void loadRealBusData(boost::shared_ptr<gridpack::math::RealVector> &vector, bool
   loadRealBusData(*vector, flag);
 }
 
+/**
+ * Create timer categories used by the mapper. This is done once so that
+ * repeated calls do not have to look up categories by name
+ */
+void setTimerCategories(void)
+{
+  p_tNew = 0;
+  p_tBus = 0;
+  p_tSet = 0;
+  p_tLoad = 0;
+  p_tPack = 0;
+  p_tAdd = 0;
+  p_tGet = 0;
+  p_tUnpack = 0;
+  if (p_timer) {
+    p_tNew = p_timer->createCategory("Vector Map: New Vector");
+    p_tBus = p_timer->createCategory("Vector Map: Load Bus Data");
+    p_tSet = p_timer->createCategory("Vector Map: Set Vector");
+    p_tLoad = p_timer->createCategory("loadBusData: Add Vector Elements");
+    p_tPack = p_timer->createCategory("loadBusData: Fill Buffer");
+    p_tAdd = p_timer->createCategory("loadBusData: Add Elements");
+    p_tGet = p_timer->createCategory("mapToBus: get Data");
+    p_tUnpack = p_timer->createCategory("mapToBus: set Data");
+  }
+}
+
+/**
+ * Check whether the locally owned part of a vector is exactly the block
+ * of values contributed by buses on this process. This is true for any
+ * vector created by this mapper
+ * @param vector vector to check
+ * @return true if the local part of the vector matches the mapper
+ */
+template <typename _type>
+bool isLocalBlock(const gridpack::math::VectorT<_type> &vector) const
+{
+  int lo, hi;
+  vector.localIndexRange(lo, hi);
+  return (lo == p_firstIndex && hi - lo == p_numValues);
+}
+
+/**
+ * Add contributions from buses to vector. If the local part of the
+ * vector matches the contributions from this process, values are
+ * written directly into the local vector storage, otherwise they are
+ * packed into a buffer and added using the index list.
+ * @param vector vector to which contributions are added
+ * @param buffer persistent buffer used if values cannot be written
+ *        directly to the vector
+ */
+template <typename _type>
+void loadValues(gridpack::math::VectorT<_type> &vector,
+    std::vector<_type> &buffer)
+{
+  int i;
+  bool threaded = gridpack::parallel::threadedLoops();
+  if (p_timer) p_timer->start(p_tLoad);
+  if (isLocalBlock(vector)) {
+    if (p_timer) p_timer->start(p_tPack);
+    _type *values = vector.getLocalElements();
+    // Each bus writes to its own segment, so buses can be handled by
+    // different threads
+#pragma omp parallel for schedule(dynamic,64) if(threaded)
+    for (i=0; i<p_busContribution; i++) {
+      p_contributingBuses[i]->vectorValues(values+p_Offsets[i]-p_firstIndex);
+    }
+    vector.releaseLocalElements(values);
+    if (p_timer) p_timer->stop(p_tPack);
+  } else {
+    if (p_timer) p_timer->start(p_tPack);
+    if (buffer.size() != p_numValues) buffer.resize(p_numValues);
+    _type *vptr = p_numValues > 0 ? &buffer[0] : NULL;
+#pragma omp parallel for schedule(dynamic,64) if(threaded)
+    for (i=0; i<p_busContribution; i++) {
+      p_contributingBuses[i]->vectorValues(vptr+p_Offsets[i]-p_firstIndex);
+    }
+    if (p_timer) p_timer->stop(p_tPack);
+    if (p_timer) p_timer->start(p_tAdd);
+    if (p_numValues > 0) vector.addElements(p_numValues,p_Indices,&buffer[0]);
+    if (p_timer) p_timer->stop(p_tAdd);
+  }
+  for (i=0; i<p_busContribution; i++) {
+    p_revisions[i] = p_contributingBuses[i]->getRevision();
+  }
+  if (p_timer) p_timer->stop(p_tLoad);
+}
+
+/**
+ * Overwrite the values of buses whose revision differs from the one
+ * recorded at the last fill. Values are written directly into local
+ * vector storage if possible, otherwise the changed values are packed
+ * into the buffer and set using the index list. Each value belongs to
+ * exactly one bus, so setting it replaces the old contribution.
+ * @param vector vector to update
+ * @param buffer persistent buffer used if values cannot be written
+ *        directly to the vector
+ * @return number of bus blocks rewritten
+ */
+template <typename _type>
+int updateValues(gridpack::math::VectorT<_type> &vector,
+    std::vector<_type> &buffer)
+{
+  int i, j, nsize;
+  int nblocks = 0;
+  unsigned int rev;
+  if (p_timer) p_timer->start(p_tLoad);
+  if (isLocalBlock(vector)) {
+    _type *values = vector.getLocalElements();
+    for (i=0; i<p_busContribution; i++) {
+      rev = p_contributingBuses[i]->getRevision();
+      if (rev == p_revisions[i]) continue;
+      p_revisions[i] = rev;
+      p_contributingBuses[i]->vectorValues(values+p_Offsets[i]-p_firstIndex);
+      nblocks++;
+    }
+    vector.releaseLocalElements(values);
+  } else {
+    if (buffer.size() != p_numValues) buffer.resize(p_numValues);
+    std::vector<int> indices;
+    int nvals = 0;
+    for (i=0; i<p_busContribution; i++) {
+      rev = p_contributingBuses[i]->getRevision();
+      if (rev == p_revisions[i]) continue;
+      p_revisions[i] = rev;
+      nsize = p_ISize[i];
+      p_contributingBuses[i]->vectorValues(&buffer[nvals]);
+      for (j=0; j<nsize; j++) indices.push_back(p_Offsets[i]+j);
+      nvals += nsize;
+      nblocks++;
+    }
+    if (nvals > 0) vector.setElements(nvals,&indices[0],&buffer[0]);
+  }
+  p_updatedBlocks = nblocks;
+  p_totalUpdatedBlocks += nblocks;
+  if (p_timer) p_timer->stop(p_tLoad);
+  return nblocks;
+}
+
+/**
+ * Push values from vector back onto buses. If the local part of the
+ * vector matches the contributions from this process, values are
+ * copied in one block from local vector storage, otherwise they are
+ * gathered using the index list.
+ * @param vector vector containing data to be pushed to buses
+ * @param buffer persistent buffer that holds values from vector
+ */
+template <typename _type>
+void unloadBusData(const gridpack::math::VectorT<_type> &vector,
+    std::vector<_type> &buffer)
+{
+  int i;
+  if (p_numValues == 0) return;
+  if (buffer.size() != p_numValues) buffer.resize(p_numValues);
+  if (p_timer) p_timer->start(p_tGet);
+  if (isLocalBlock(vector)) {
+    vector.getElementRange(p_firstIndex, p_firstIndex+p_numValues,
+        &buffer[0]);
+  } else {
+    vector.getElements(p_numValues, p_Indices, &buffer[0]);
+  }
+  if (p_timer) p_timer->stop(p_tGet);
+  if (p_timer) p_timer->start(p_tUnpack);
+  _type *vptr = &buffer[0];
+  bool threaded = gridpack::parallel::threadedLoops();
+#pragma omp parallel for schedule(dynamic,64) if(threaded)
+  for (i=0; i<p_busContribution; i++) {
+    p_contributingBuses[i]->setValues(vptr+p_Offsets[i]-p_firstIndex);
+  }
+  if (p_timer) p_timer->stop(p_tUnpack);
+}
+
 /**
  * Calculate how many buses contribute to vector
  */
@@ -428,12 +579,14 @@ void contributions(void)
   p_contributingBuses 
     = new gridpack::component::BaseBusComponent*[p_busContribution];
   p_ISize = new int[p_busContribution];
+  p_revisions.assign(p_busContribution, 0);
   int icnt = 0;
   for (i=0; i<p_nBuses; i++) {
     if (p_network->getActiveBus(i)) {
       if (p_network->getBus(i)->vectorSize(&isize)) {
         p_contributingBuses[icnt] = p_network->getBus(i).get();
         p_ISize[icnt] = isize;
+        p_revisions[icnt] = p_contributingBuses[icnt]->getRevision();
         icnt++;
       }
     }
@@ -447,7 +600,7 @@ void setBusIndexArrays(void)
 {
   // Exchange number of values contributed by each process
   std::vector<int> nVals(p_nNodes);
-  int i, j, nsize;
+  int i;
   for (i=0; i<p_nNodes; i++) {
     nVals[i] = 0;
   }
@@ -462,7 +615,18 @@ void setBusIndexArrays(void)
   for (i=0; i<p_me; i++) {
     offset += nVals[i];
   }
-  
+  setBusIndices(offset);
+}
+
+/**
+ * Set up the vector indices of the contributing buses
+ * @param offset first vector index owned by this process
+ */
+void setBusIndices(int offset)
+{
+  int i, j, nsize;
+  p_firstIndex = offset;
+
   // Loop over contributing buses and get indices
   p_Offsets = new int[p_busContribution];
   p_Indices = new int[p_numValues];
@@ -479,6 +643,75 @@ void setBusIndexArrays(void)
   }
 }
 
+/**
+ * Index information that is stored in the network so that it can be
+ * reused by later mappers
+ */
+struct IndexCache {
+  int generation;
+  std::vector<int> signature;
+  int firstIndex;
+};
+
+/**
+ * Evaluate the quantities on this processor that determine the layout of
+ * the vector: the active status of each bus and the size of its
+ * contribution in the current mode
+ * @param sig signature of bus contributions
+ */
+void indexSignature(std::vector<int> &sig)
+{
+  int i;
+  sig.clear();
+  sig.reserve(p_nBuses+1);
+  sig.push_back(p_nBuses);
+  for (i=0; i<p_nBuses; i++) {
+    if (p_network->getActiveBus(i)) {
+      sig.push_back(p_LocOffsets[i] >= 0 ? p_LocSize[i] : -1);
+    } else {
+      sig.push_back(-2);
+    }
+  }
+}
+
+/**
+ * Set up vector indices from the network cache. The cached first index
+ * can only be used if it was found on all processors and was created by
+ * the same mapper, which requires a single reduction. This must be called
+ * on all processors
+ * @param key key for network cache
+ * @param sig signature of bus contributions
+ * @return true if index information was found
+ */
+bool loadIndexCache(const std::string &key, const std::vector<int> &sig)
+{
+  boost::shared_ptr<IndexCache> cache
+    = boost::static_pointer_cast<IndexCache>(p_network->getMapperCache(key));
+  int gen[2];
+  gen[0] = -1;
+  if (cache && cache->signature == sig) gen[0] = cache->generation;
+  gen[1] = -gen[0];
+  p_network->communicator().min(gen,2);
+  if (gen[0] < 0 || gen[0] != -gen[1]) return false;
+  setBusIndices(cache->firstIndex);
+  return true;
+}
+
+/**
+ * Store index information in the network cache. This must be called on
+ * all processors
+ * @param key key for network cache
+ * @param sig signature of bus contributions
+ */
+void storeIndexCache(const std::string &key, const std::vector<int> &sig)
+{
+  boost::shared_ptr<IndexCache> cache(new IndexCache);
+  cache->generation = p_network->nextMapperGeneration();
+  cache->signature = sig;
+  cache->firstIndex = p_firstIndex;
+  p_network->setMapperCache(key, cache);
+}
+
     // GA information
 int                         p_me;
 int                         p_nNodes;
@@ -496,13 +729,25 @@ int*                        p_LocOffsets;
 int*                        p_LocSize;
 int*                        p_ISize;
 int*                        p_Indices;
+int                         p_firstIndex; // First vector index owned by this process
+bool                        p_cached; // first index from network cache
+
+    // persistent buffers used to move values between buses and vectors
+std::vector<ComplexType>    p_complexValues;
+std::vector<RealType>       p_realValues;
 gridpack::component::BaseBusComponent **p_contributingBuses;
 
+    // bus revisions at last fill and incremental update statistics
+std::vector<unsigned int>   p_revisions;
+int                         p_updatedBlocks;
+long                        p_totalUpdatedBlocks;
+
     // global vector block size array
 int                         p_GAgrp; // GA group
 
     // pointer to timer
 gridpack::utility::CoarseTimer *p_timer;
+int p_tNew, p_tBus, p_tSet, p_tLoad, p_tPack, p_tAdd, p_tGet, p_tUnpack;
 
 };
 
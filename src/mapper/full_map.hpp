@@ -19,10 +19,15 @@
 
 //#define NZ_PER_ROW
 
+#include <climits>
+#include <algorithm>
+#include <vector>
+#include <string>
 #include <boost/smart_ptr/shared_ptr.hpp>
 #include <ga.h>
 #include "gridpack/parallel/parallel.hpp"
 #include <gridpack/parallel/distributed.hpp>
+#include <gridpack/parallel/threads.hpp>
 #include <gridpack/component/base_component.hpp>
 #include <gridpack/network/base_network.hpp>
 #include <gridpack/math/matrix.hpp>
@@ -67,17 +72,37 @@ FullMatrixMap(boost::shared_ptr<_network> network)
 
   p_activeBuses         = getActiveBuses();
 
-  setupGlobalArrays(p_activeBuses);  // allocate globalIndex arrays
-
-  setupIndexingArrays();
-
-  setupOffsetArrays();
-
-  contributions();
-  GA_Pgroup_sync(p_GAgrp);
-  setBusOffsets();
-  setBranchOffsets();
+  // Reuse index structures from a previous mapper on the same network if
+  // the contributions of the network components have not changed
+  std::vector<int> sig;
+  indexSignature(sig);
+  std::string key = p_network->mapperCacheKey("FullMatrixMap",sig);
+  p_cacheKey = key;
+  p_cached = loadIndexCache(key, sig);
+  if (!p_cached) {
+    setupGlobalArrays(p_activeBuses);  // allocate globalIndex arrays
+
+    setupIndexingArrays();
+
+    setupOffsetArrays();
+
+    contributions();
+    GA_Pgroup_sync(p_GAgrp);
+    setBusOffsets();
+    setBranchOffsets();
+    GA_Destroy(gaOffsetI);
+    GA_Destroy(gaOffsetJ);
+
+    // the block size requires a reduction, so it is only evaluated if
+    // block storage is requested
+    p_blockSize = -1;
+    storeIndexCache(key, sig);
+  }
+  setUpdateIndices();
 
+  p_useBlocks = false;
+  p_updatedBlocks = 0;
+  p_totalUpdatedBlocks = 0;
 }
 
 ~FullMatrixMap()
@@ -89,9 +114,6 @@ FullMatrixMap(boost::shared_ptr<_network> network)
 #ifdef NZ_PER_ROW
   if (p_nz_per_row != NULL) delete [] p_nz_per_row;
 #endif
-  GA_Destroy(gaOffsetI);
-  GA_Destroy(gaOffsetJ);
-  GA_Pgroup_sync(p_GAgrp);
 }
 
 /**
@@ -113,6 +135,9 @@ boost::shared_ptr<gridpack::math::Matrix> mapToMatrix(bool isDense = false)
   if (isDense) {
     Ret.reset(new gridpack::math::Matrix(comm, p_rowBlockSize, p_colBlockSize,
         gridpack::math::Dense));
+  } else if (p_useBlocks) {
+    Ret.reset(gridpack::math::Matrix::createBlock(comm, p_rowBlockSize,
+          p_colBlockSize, p_blockSize, p_maxcol/p_blockSize));
   } else {
 #ifndef NZ_PER_ROW
     Ret.reset(new gridpack::math::Matrix(comm, p_rowBlockSize, p_colBlockSize,
@@ -157,6 +182,9 @@ boost::shared_ptr<gridpack::math::RealMatrix> mapToRealMatrix(bool isDense = fal
   if (isDense) {
     Ret.reset(new gridpack::math::RealMatrix(comm, p_rowBlockSize, p_colBlockSize,
         gridpack::math::Dense));
+  } else if (p_useBlocks) {
+    Ret.reset(gridpack::math::RealMatrix::createBlock(comm, p_rowBlockSize,
+          p_colBlockSize, p_blockSize, p_maxcol/p_blockSize));
   } else {
 #ifndef NZ_PER_ROW
     Ret.reset(new gridpack::math::RealMatrix(comm, p_rowBlockSize, p_colBlockSize,
@@ -199,6 +227,9 @@ gridpack::math::Matrix* intMapToMatrix(bool isDense = false)
   if (isDense) {
     Ret = new gridpack::math::Matrix(comm, p_rowBlockSize, p_colBlockSize,
         gridpack::math::Dense);
+  } else if (p_useBlocks) {
+    Ret = gridpack::math::Matrix::createBlock(comm, p_rowBlockSize,
+        p_colBlockSize, p_blockSize, p_maxcol/p_blockSize);
   } else {
 #ifndef NZ_PER_ROW
     Ret = new gridpack::math::Matrix(comm, p_rowBlockSize, p_colBlockSize,
@@ -344,6 +375,139 @@ void incrementMatrix(boost::shared_ptr<gridpack::math::Matrix> &matrix)
   incrementMatrix(*matrix);
 }
 
+/**
+ * Use block storage for new sparse matrices if all buses and branches
+ * contribute square blocks of the same size. Values are then stored
+ * and inserted one block at a time. Block storage is not used by
+ * default, since some direct solvers (e.g. SuperLU_DIST) only accept
+ * matrices with scalar sparse storage. The first call with flag set to
+ * true checks the block sizes on all processors, so it must be called on
+ * all processors
+ * @param flag true if block storage should be used when possible
+ * @return true if new matrices will use block storage
+ */
+bool setBlockStorage(bool flag)
+{
+  if (flag && p_blockSize < 0) {
+    p_blockSize = uniformBlockSize();
+    boost::shared_ptr<IndexCache> cache = boost::static_pointer_cast
+      <IndexCache>(p_network->getMapperCache(p_cacheKey));
+    if (cache) cache->blockSize = p_blockSize;
+  }
+  p_useBlocks = flag && p_blockSize > 0;
+  return p_useBlocks;
+}
+
+/**
+ * Return the size of the blocks contributed by buses and branches
+ * @return block size, 0 if blocks are not all the same size or -1 if
+ * setBlockStorage has not been called with flag set to true
+ */
+int blockSize(void) const
+{
+  return p_blockSize;
+}
+
+/**
+ * Refill an existing matrix using only the buses and branches that have
+ * called markDirty since this mapper last filled a matrix. The blocks
+ * contributed by these components are overwritten in place and the
+ * matrix is assembled once. All other elements are left unchanged, so
+ * the matrix should be the one most recently filled by this mapper and
+ * the components must not change the size of their contributions.
+ * @param matrix existing matrix (should be generated from same mapper)
+ * @return number of blocks rewritten on this processor
+ */
+int updateMatrix(gridpack::math::Matrix &matrix)
+{
+  ComplexType *values = new ComplexType[p_maxIBlock*p_maxJBlock];
+  GA_Pgroup_sync(p_GAgrp);
+  int nblocks = updateBlocks(matrix, values);
+  GA_Pgroup_sync(p_GAgrp);
+  matrix.ready();
+  delete [] values;
+  return nblocks;
+}
+
+/**
+ * Refill an existing matrix using only the buses and branches that have
+ * called markDirty since this mapper last filled a matrix
+ * @param matrix existing matrix (should be generated from same mapper)
+ * @return number of blocks rewritten on this processor
+ */
+int updateMatrix(boost::shared_ptr<gridpack::math::Matrix> &matrix)
+{
+  return updateMatrix(*matrix);
+}
+
+/**
+ * Refill an existing real matrix using only the buses and branches that
+ * have called markDirty since this mapper last filled a matrix
+ * @param matrix existing matrix (should be generated from same mapper)
+ * @return number of blocks rewritten on this processor
+ */
+int updateRealMatrix(gridpack::math::RealMatrix &matrix)
+{
+  RealType *values = new RealType[p_maxIBlock*p_maxJBlock];
+  GA_Pgroup_sync(p_GAgrp);
+  int nblocks = updateBlocks(matrix, values);
+  GA_Pgroup_sync(p_GAgrp);
+  matrix.ready();
+  delete [] values;
+  return nblocks;
+}
+
+/**
+ * Refill an existing real matrix using only the buses and branches that
+ * have called markDirty since this mapper last filled a matrix
+ * @param matrix existing matrix (should be generated from same mapper)
+ * @return number of blocks rewritten on this processor
+ */
+int updateRealMatrix(boost::shared_ptr<gridpack::math::RealMatrix> &matrix)
+{
+  return updateRealMatrix(*matrix);
+}
+
+/**
+ * Return the number of blocks this processor contributes to a full fill
+ * of the matrix
+ * @return number of bus and branch blocks on this processor
+ */
+int numBlocks(void) const
+{
+  return p_busContribution + p_branchContribution;
+}
+
+/**
+ * Return the number of blocks rewritten on this processor by the last
+ * call to updateMatrix or updateRealMatrix
+ * @return number of rewritten blocks
+ */
+int updatedBlocks(void) const
+{
+  return p_updatedBlocks;
+}
+
+/**
+ * Return the total number of blocks rewritten on this processor by all
+ * calls to updateMatrix or updateRealMatrix
+ * @return number of rewritten blocks
+ */
+long totalUpdatedBlocks(void) const
+{
+  return p_totalUpdatedBlocks;
+}
+
+/**
+ * Return true if the index structures of this mapper were taken from a
+ * mapper that was previously created on the same network
+ * @return true if mapper was set up from the network cache
+ */
+bool cached(void) const
+{
+  return p_cached;
+}
+
 /**
  * Check to see if matrix looks well formed. This method runs through all
  * branches and verifies that the dimensions of the branch contributions match
@@ -613,6 +777,7 @@ void loadBusArrays(int * iSizeArray, int * jSizeArray,
 
 #ifdef NZ_PER_ROW
   int size = nz_per_row.size();
+  p_nz_rows = size;
   p_nz_per_row = new int[size];
   for (int i = 0; i<size; i++) {
     p_nz_per_row[i] = nz_per_row[i];
@@ -930,6 +1095,10 @@ void setBusOffsets(void)
  */
 void loadBusData(gridpack::math::Matrix &matrix, bool flag)
 {
+  if (gridpack::parallel::threadedLoops()) {
+    loadThreadedBusData(matrix, flag, static_cast<ComplexType*>(NULL));
+    return;
+  }
   int i,idx,jdx,isize,jsize,icnt;
   boost::shared_ptr<gridpack::component::BaseBusComponent> bus;
   // Add matrix elements
@@ -945,22 +1114,17 @@ void loadBusData(gridpack::math::Matrix &matrix, bool flag)
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (bus->matrixDiagValues(values)) {
-          icnt = 0;
-          for (k=0; k<jsize; k++) {
-            jdx = p_j_busOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              idx = p_i_busOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(idx, jdx, values[icnt]);
-              } else {
-                matrix.setElement(idx, jdx, values[icnt]);
-              }
-              icnt++;
-            }
+          if (flag) {
+            matrix.addBlock(p_i_busOffsets[jcnt], p_j_busOffsets[jcnt],
+                isize, jsize, values);
+          } else {
+            matrix.setBlock(p_i_busOffsets[jcnt], p_j_busOffsets[jcnt],
+                isize, jsize, values);
           }
         }
         jcnt++;
       }
+      if (!flag) p_busRevision[i] = bus->getRevision();
     }
   }
 
@@ -975,6 +1139,10 @@ void loadBusData(gridpack::math::Matrix &matrix, bool flag)
  */
 void loadRealBusData(gridpack::math::RealMatrix &matrix, bool flag)
 {
+  if (gridpack::parallel::threadedLoops()) {
+    loadThreadedBusData(matrix, flag, static_cast<RealType*>(NULL));
+    return;
+  }
   int i,idx,jdx,isize,jsize,icnt;
   boost::shared_ptr<gridpack::component::BaseBusComponent> bus;
   // Add matrix elements
@@ -990,22 +1158,17 @@ void loadRealBusData(gridpack::math::RealMatrix &matrix, bool flag)
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (bus->matrixDiagValues(values)) {
-          icnt = 0;
-          for (k=0; k<jsize; k++) {
-            jdx = p_j_busOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              idx = p_i_busOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(idx, jdx, values[icnt]);
-              } else {
-                matrix.setElement(idx, jdx, values[icnt]);
-              }
-              icnt++;
-            }
+          if (flag) {
+            matrix.addBlock(p_i_busOffsets[jcnt], p_j_busOffsets[jcnt],
+                isize, jsize, values);
+          } else {
+            matrix.setBlock(p_i_busOffsets[jcnt], p_j_busOffsets[jcnt],
+                isize, jsize, values);
           }
         }
         jcnt++;
       }
+      if (!flag) p_busRevision[i] = bus->getRevision();
     }
   }
 
@@ -1113,6 +1276,10 @@ void setBranchOffsets(void)
  */
 void loadBranchData(gridpack::math::Matrix &matrix, bool flag)
 {
+  if (gridpack::parallel::threadedLoops()) {
+    loadThreadedBranchData(matrix, flag, static_cast<ComplexType*>(NULL));
+    return;
+  }
   int i,idx,jdx,isize,jsize,icnt;
   // Add matrix elements
   int t_add(0);
@@ -1132,18 +1299,12 @@ void loadBranchData(gridpack::math::Matrix &matrix, bool flag)
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (branch->matrixForwardValues(values)) {
-          icnt = 0;
-          for (k=0; k<jsize; k++) {
-            jdx = p_j_branchOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              idx = p_i_branchOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(idx, jdx, values[icnt]);
-              } else {
-                matrix.setElement(idx, jdx, values[icnt]);
-              }
-              icnt++;
-            }
+          if (flag) {
+            matrix.addBlock(p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt],
+                isize, jsize, values);
+          } else {
+            matrix.setBlock(p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt],
+                isize, jsize, values);
           }
         }
         jcnt++;
@@ -1157,25 +1318,20 @@ void loadBranchData(gridpack::math::Matrix &matrix, bool flag)
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (branch->matrixReverseValues(values)) {
-          icnt = 0;
-          // Note that because the indices have been reversed, we need to switch
-          // the ordering of the offsets as well
-          for (k=0; k<jsize; k++) {
-            idx = p_j_branchOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              jdx = p_i_branchOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(jdx, idx, values[icnt]);
-              } else {
-                matrix.setElement(jdx, idx, values[icnt]);
-              }
-              icnt++;
-            }
+          // The offsets were reversed when they were set up, so the
+          // block starts at the same offsets as a forward block
+          if (flag) {
+            matrix.addBlock(p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt],
+                isize, jsize, values);
+          } else {
+            matrix.setBlock(p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt],
+                isize, jsize, values);
           }
         }
         jcnt++;
       }
     }
+    if (!flag) p_branchRevision[i] = branch->getRevision();
   }
   if (p_timer) p_timer->stop(t_add);
 
@@ -1190,6 +1346,10 @@ void loadBranchData(gridpack::math::Matrix &matrix, bool flag)
  */
 void loadRealBranchData(gridpack::math::RealMatrix &matrix, bool flag)
 {
+  if (gridpack::parallel::threadedLoops()) {
+    loadThreadedBranchData(matrix, flag, static_cast<RealType*>(NULL));
+    return;
+  }
   int i,idx,jdx,isize,jsize,icnt;
   // Add matrix elements
   int t_add(0);
@@ -1209,18 +1369,12 @@ void loadRealBranchData(gridpack::math::RealMatrix &matrix, bool flag)
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (branch->matrixForwardValues(values)) {
-          icnt = 0;
-          for (k=0; k<jsize; k++) {
-            jdx = p_j_branchOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              idx = p_i_branchOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(idx, jdx, values[icnt]);
-              } else {
-                matrix.setElement(idx, jdx, values[icnt]);
-              }
-              icnt++;
-            }
+          if (flag) {
+            matrix.addBlock(p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt],
+                isize, jsize, values);
+          } else {
+            matrix.setBlock(p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt],
+                isize, jsize, values);
           }
         }
         jcnt++;
@@ -1234,25 +1388,20 @@ void loadRealBranchData(gridpack::math::RealMatrix &matrix, bool flag)
         for (k=0; k<ijsize; k++) values[k] = 0.0;
 #endif
         if (branch->matrixReverseValues(values)) {
-          icnt = 0;
-          // Note that because the indices have been reversed, we need to switch
-          // the ordering of the offsets as well
-          for (k=0; k<jsize; k++) {
-            idx = p_j_branchOffsets[jcnt] + k;
-            for (j=0; j<isize; j++) {
-              jdx = p_i_branchOffsets[jcnt] + j;
-              if (flag) {
-                matrix.addElement(jdx, idx, values[icnt]);
-              } else {
-                matrix.setElement(jdx, idx, values[icnt]);
-              }
-              icnt++;
-            }
+          // The offsets were reversed when they were set up, so the
+          // block starts at the same offsets as a forward block
+          if (flag) {
+            matrix.addBlock(p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt],
+                isize, jsize, values);
+          } else {
+            matrix.setBlock(p_i_branchOffsets[jcnt], p_j_branchOffsets[jcnt],
+                isize, jsize, values);
           }
         }
         jcnt++;
       }
     }
+    if (!flag) p_branchRevision[i] = branch->getRevision();
   }
   if (p_timer) p_timer->stop(t_add);
 
@@ -1280,6 +1429,266 @@ void loadRealBranchData(boost::shared_ptr<gridpack::math::Matrix> &matrix, bool
   loadRealBranchData(*matrix, flag);
 }
 
+/**
+ * Add diagonal block contributions from buses to matrix using threads.
+ * Bus values are evaluated in parallel into a single buffer and then
+ * inserted into the matrix by one thread, since matrix insertion is not
+ * thread safe
+ * @param matrix matrix to which contributions are added
+ * @param flag flag to distinguish new matrix (true) from old (false)
+ * @param type pointer used only to select the value type
+ */
+template <class _matrix, typename _type>
+void loadThreadedBusData(_matrix &matrix, bool flag, _type *type)
+{
+  int i, k, isize, jsize;
+  int nblk = p_busContribution;
+  std::vector<int> buses(nblk), isizes(nblk), jsizes(nblk);
+  std::vector<int> start(nblk+1, 0);
+  for (i=0; i<p_nBuses; i++) {
+    k = p_busBlock[i];
+    if (k < 0) continue;
+    p_network->getBus(i)->matrixDiagSize(&isize,&jsize);
+    buses[k] = i;
+    isizes[k] = isize;
+    jsizes[k] = jsize;
+    start[k+1] = isize*jsize;
+  }
+  for (k=0; k<nblk; k++) start[k+1] += start[k];
+  std::vector<_type> values(start[nblk]);
+  _type *vbuf = values.empty() ? NULL : &values[0];
+  std::vector<char> ok(nblk);
+#pragma omp parallel for schedule(dynamic,64)
+  for (k=0; k<nblk; k++) {
+    gridpack::component::BaseBusComponent *bus
+      = p_network->getBus(buses[k]).get();
+    ok[k] = bus->matrixDiagValues(vbuf+start[k]);
+  }
+  for (k=0; k<nblk; k++) {
+    if (!ok[k]) continue;
+    if (flag) {
+      matrix.addBlock(p_i_busOffsets[k], p_j_busOffsets[k],
+          isizes[k], jsizes[k], vbuf+start[k]);
+    } else {
+      matrix.setBlock(p_i_busOffsets[k], p_j_busOffsets[k],
+          isizes[k], jsizes[k], vbuf+start[k]);
+    }
+  }
+  if (!flag) {
+    for (i=0; i<p_nBuses; i++) {
+      if (p_network->getActiveBus(i)) {
+        p_busRevision[i] = p_network->getBus(i)->getRevision();
+      }
+    }
+  }
+}
+
+/**
+ * Add off-diagonal block contributions from branches to matrix using
+ * threads. Branch values are evaluated in parallel into a single buffer
+ * and then inserted into the matrix by one thread
+ * @param matrix matrix to which contributions are added
+ * @param flag flag to distinguish new matrix (true) from old (false)
+ * @param type pointer used only to select the value type
+ */
+template <class _matrix, typename _type>
+void loadThreadedBranchData(_matrix &matrix, bool flag, _type *type)
+{
+  int i, k, isize, jsize;
+  int nblk = p_branchContribution;
+  // Block k comes from entry p_branchBlock[ends[k]] (2*branch for the
+  // forward block, 2*branch+1 for the reverse block)
+  std::vector<int> ends(nblk), isizes(nblk), jsizes(nblk);
+  std::vector<int> start(nblk+1, 0);
+  for (i=0; i<2*p_nBranches; i++) {
+    k = p_branchBlock[i];
+    if (k < 0) continue;
+    if (i%2 == 0) {
+      p_network->getBranch(i/2)->matrixForwardSize(&isize,&jsize);
+    } else {
+      p_network->getBranch(i/2)->matrixReverseSize(&isize,&jsize);
+    }
+    ends[k] = i;
+    isizes[k] = isize;
+    jsizes[k] = jsize;
+    start[k+1] = isize*jsize;
+  }
+  for (k=0; k<nblk; k++) start[k+1] += start[k];
+  std::vector<_type> values(start[nblk]);
+  _type *vbuf = values.empty() ? NULL : &values[0];
+  std::vector<char> ok(nblk);
+#pragma omp parallel for schedule(dynamic,64)
+  for (k=0; k<nblk; k++) {
+    gridpack::component::BaseBranchComponent *branch
+      = p_network->getBranch(ends[k]/2).get();
+    if (ends[k]%2 == 0) {
+      ok[k] = branch->matrixForwardValues(vbuf+start[k]);
+    } else {
+      ok[k] = branch->matrixReverseValues(vbuf+start[k]);
+    }
+  }
+  for (k=0; k<nblk; k++) {
+    if (!ok[k]) continue;
+    if (flag) {
+      matrix.addBlock(p_i_branchOffsets[k], p_j_branchOffsets[k],
+          isizes[k], jsizes[k], vbuf+start[k]);
+    } else {
+      matrix.setBlock(p_i_branchOffsets[k], p_j_branchOffsets[k],
+          isizes[k], jsizes[k], vbuf+start[k]);
+    }
+  }
+  if (!flag) {
+    for (i=0; i<p_nBranches; i++) {
+      p_branchRevision[i] = p_network->getBranch(i)->getRevision();
+    }
+  }
+}
+
+/**
+ * Record which block of the offset arrays belongs to each bus and each
+ * end of each branch, so that individual components can be reloaded
+ * without walking the whole network. Also initialize the component
+ * revisions seen by this mapper
+ */
+void setUpdateIndices(void)
+{
+  int i, idx, jdx, isize, jsize;
+  int jcnt = 0;
+  p_busBlock.assign(p_nBuses, -1);
+  p_busRevision.assign(p_nBuses, 0);
+  for (i=0; i<p_nBuses; i++) {
+    if (p_network->getActiveBus(i)) {
+      if (p_network->getBus(i)->matrixDiagSize(&isize,&jsize)) {
+        p_busBlock[i] = jcnt;
+        jcnt++;
+      }
+      p_busRevision[i] = p_network->getBus(i)->getRevision();
+    }
+  }
+  jcnt = 0;
+  p_branchBlock.assign(2*p_nBranches, -1);
+  p_branchRevision.assign(p_nBranches, 0);
+  boost::shared_ptr<gridpack::component::BaseBranchComponent> branch;
+  for (i=0; i<p_nBranches; i++) {
+    branch = p_network->getBranch(i);
+    if (branch->matrixForwardSize(&isize,&jsize)) {
+      branch->getMatVecIndices(&idx, &jdx);
+      if (idx >= p_minRowIndex && idx <= p_maxRowIndex) {
+        p_branchBlock[2*i] = jcnt;
+        jcnt++;
+      }
+    }
+    if (branch->matrixReverseSize(&isize,&jsize)) {
+      branch->getMatVecIndices(&idx, &jdx);
+      if (jdx >= p_minRowIndex && jdx <= p_maxRowIndex) {
+        p_branchBlock[2*i+1] = jcnt;
+        jcnt++;
+      }
+    }
+    p_branchRevision[i] = branch->getRevision();
+  }
+}
+
+/**
+ * Overwrite the blocks of all buses and branches whose revision differs
+ * from the one recorded at the last fill. A component that does not
+ * return values for a block contributes zeros, as it would after the
+ * matrix is zeroed in mapToMatrix. Each block belongs to exactly one
+ * component, so writing the new block replaces the old contribution
+ * without storing it.
+ * @param matrix matrix to update
+ * @param values work array of size p_maxIBlock*p_maxJBlock
+ * @return number of blocks rewritten
+ */
+template <class _matrix, typename _type>
+int updateBlocks(_matrix &matrix, _type *values)
+{
+  int i, k, isize, jsize, blk;
+  int nblocks = 0;
+  unsigned int rev;
+  int t_upd(0);
+  if (p_timer) t_upd = p_timer->createCategory("Mapper: Update Matrix");
+  if (p_timer) p_timer->start(t_upd);
+  for (i=0; i<p_nBuses; i++) {
+    if (!p_network->getActiveBus(i)) continue;
+    gridpack::component::BaseBusComponent *bus = p_network->getBus(i).get();
+    rev = bus->getRevision();
+    if (rev == p_busRevision[i]) continue;
+    p_busRevision[i] = rev;
+    blk = p_busBlock[i];
+    if (blk < 0 || !bus->matrixDiagSize(&isize,&jsize)) continue;
+    if (!bus->matrixDiagValues(values)) {
+      for (k=0; k<isize*jsize; k++) values[k] = 0.0;
+    }
+    matrix.setBlock(p_i_busOffsets[blk], p_j_busOffsets[blk],
+        isize, jsize, values);
+    nblocks++;
+  }
+  for (i=0; i<p_nBranches; i++) {
+    gridpack::component::BaseBranchComponent *branch
+      = p_network->getBranch(i).get();
+    rev = branch->getRevision();
+    if (rev == p_branchRevision[i]) continue;
+    p_branchRevision[i] = rev;
+    blk = p_branchBlock[2*i];
+    if (blk >= 0 && branch->matrixForwardSize(&isize,&jsize)) {
+      if (!branch->matrixForwardValues(values)) {
+        for (k=0; k<isize*jsize; k++) values[k] = 0.0;
+      }
+      matrix.setBlock(p_i_branchOffsets[blk], p_j_branchOffsets[blk],
+          isize, jsize, values);
+      nblocks++;
+    }
+    blk = p_branchBlock[2*i+1];
+    if (blk >= 0 && branch->matrixReverseSize(&isize,&jsize)) {
+      if (!branch->matrixReverseValues(values)) {
+        for (k=0; k<isize*jsize; k++) values[k] = 0.0;
+      }
+      matrix.setBlock(p_i_branchOffsets[blk], p_j_branchOffsets[blk],
+          isize, jsize, values);
+      nblocks++;
+    }
+  }
+  p_updatedBlocks = nblocks;
+  p_totalUpdatedBlocks += nblocks;
+  if (p_timer) p_timer->stop(t_upd);
+  return nblocks;
+}
+
+/**
+ * Check whether all buses and branches contribute square blocks of the
+ * same size. This must be called on all processors
+ * @return common block size or 0 if blocks are not all the same size
+ */
+int uniformBlockSize(void)
+{
+  int i, isize, jsize;
+  int lo = INT_MAX;
+  int hi = 0;
+  for (i=0; i<p_nBuses; i++) {
+    if (p_network->getActiveBus(i)) {
+      if (p_network->getBus(i)->matrixDiagSize(&isize, &jsize)) {
+        lo = std::min(lo,std::min(isize,jsize));
+        hi = std::max(hi,std::max(isize,jsize));
+      }
+    }
+  }
+  for (i=0; i<p_nBranches; i++) {
+    if (p_network->getBranch(i)->matrixForwardSize(&isize, &jsize)) {
+      lo = std::min(lo,std::min(isize,jsize));
+      hi = std::max(hi,std::max(isize,jsize));
+    }
+    if (p_network->getBranch(i)->matrixReverseSize(&isize, &jsize)) {
+      lo = std::min(lo,std::min(isize,jsize));
+      hi = std::max(hi,std::max(isize,jsize));
+    }
+  }
+  p_network->communicator().min(&lo,1);
+  p_network->communicator().max(&hi,1);
+  if (lo == hi && lo > 0) return lo;
+  return 0;
+}
+
 /**
  * Calculate how many buses and branches contribute to matrix
  */
@@ -1314,6 +1723,172 @@ void contributions(void)
   }
 }
 
+/**
+ * Index structures that are stored in the network so that they can be
+ * reused by later mappers
+ */
+struct IndexCache {
+  int generation;
+  std::vector<int> signature;
+  int totalBuses;
+  int minRowIndex;
+  int maxRowIndex;
+  int rowBlockSize;
+  int colBlockSize;
+  int busContribution;
+  int branchContribution;
+  int maxIBlock;
+  int maxJBlock;
+  int maxcol;
+  int blockSize;
+  std::vector<int> nzPerRow;
+  std::vector<int> iBusOffsets;
+  std::vector<int> jBusOffsets;
+  std::vector<int> iBranchOffsets;
+  std::vector<int> jBranchOffsets;
+};
+
+/**
+ * Evaluate the quantities on this processor that determine the layout of
+ * the matrix: the active status and matrix index of each bus and the
+ * sizes of the blocks contributed by buses and branches in the current
+ * mode
+ * @param sig signature of component contributions
+ */
+void indexSignature(std::vector<int> &sig)
+{
+  int i, idx, jdx, isize, jsize;
+  sig.clear();
+  sig.reserve(4*p_nBuses+6*p_nBranches+2);
+  sig.push_back(p_nBuses);
+  sig.push_back(p_nBranches);
+  for (i=0; i<p_nBuses; i++) {
+    gridpack::component::BaseBusComponent *bus = p_network->getBus(i).get();
+    bus->getMatVecIndex(&idx);
+    sig.push_back(p_network->getActiveBus(i) ? 1 : 0);
+    sig.push_back(idx);
+    if (bus->matrixDiagSize(&isize,&jsize)) {
+      sig.push_back(isize);
+      sig.push_back(jsize);
+    } else {
+      sig.push_back(-1);
+      sig.push_back(-1);
+    }
+  }
+  for (i=0; i<p_nBranches; i++) {
+    gridpack::component::BaseBranchComponent *branch
+      = p_network->getBranch(i).get();
+    branch->getMatVecIndices(&idx, &jdx);
+    sig.push_back(idx);
+    sig.push_back(jdx);
+    if (branch->matrixForwardSize(&isize,&jsize)) {
+      sig.push_back(isize);
+      sig.push_back(jsize);
+    } else {
+      sig.push_back(-1);
+      sig.push_back(-1);
+    }
+    if (branch->matrixReverseSize(&isize,&jsize)) {
+      sig.push_back(isize);
+      sig.push_back(jsize);
+    } else {
+      sig.push_back(-1);
+      sig.push_back(-1);
+    }
+  }
+}
+
+/**
+ * Set up index structures from the network cache. The structures can only
+ * be used if they were found on all processors and were created by the
+ * same mapper, which requires a single reduction. This must be called on
+ * all processors
+ * @param key key for network cache
+ * @param sig signature of component contributions
+ * @return true if index structures were found
+ */
+bool loadIndexCache(const std::string &key, const std::vector<int> &sig)
+{
+  boost::shared_ptr<IndexCache> cache
+    = boost::static_pointer_cast<IndexCache>(p_network->getMapperCache(key));
+  int gen[2];
+  gen[0] = -1;
+  if (cache && cache->signature == sig) gen[0] = cache->generation;
+  gen[1] = -gen[0];
+  p_network->communicator().min(gen,2);
+  if (gen[0] < 0 || gen[0] != -gen[1]) return false;
+
+  p_totalBuses = cache->totalBuses;
+  p_minRowIndex = cache->minRowIndex;
+  p_maxRowIndex = cache->maxRowIndex;
+  p_rowBlockSize = cache->rowBlockSize;
+  p_colBlockSize = cache->colBlockSize;
+  p_busContribution = cache->busContribution;
+  p_branchContribution = cache->branchContribution;
+  p_maxIBlock = cache->maxIBlock;
+  p_maxJBlock = cache->maxJBlock;
+  p_maxcol = cache->maxcol;
+  p_blockSize = cache->blockSize;
+#ifdef NZ_PER_ROW
+  p_nz_rows = cache->nzPerRow.size();
+  p_nz_per_row = new int[p_nz_rows];
+  std::copy(cache->nzPerRow.begin(), cache->nzPerRow.end(), p_nz_per_row);
+#endif
+  if (p_busContribution > 0) {
+    p_i_busOffsets = new int[p_busContribution];
+    p_j_busOffsets = new int[p_busContribution];
+    std::copy(cache->iBusOffsets.begin(), cache->iBusOffsets.end(),
+        p_i_busOffsets);
+    std::copy(cache->jBusOffsets.begin(), cache->jBusOffsets.end(),
+        p_j_busOffsets);
+  }
+  p_i_branchOffsets = new int[p_branchContribution];
+  p_j_branchOffsets = new int[p_branchContribution];
+  std::copy(cache->iBranchOffsets.begin(), cache->iBranchOffsets.end(),
+      p_i_branchOffsets);
+  std::copy(cache->jBranchOffsets.begin(), cache->jBranchOffsets.end(),
+      p_j_branchOffsets);
+  return true;
+}
+
+/**
+ * Store index structures in the network cache. This must be called on all
+ * processors
+ * @param key key for network cache
+ * @param sig signature of component contributions
+ */
+void storeIndexCache(const std::string &key, const std::vector<int> &sig)
+{
+  boost::shared_ptr<IndexCache> cache(new IndexCache);
+  cache->generation = p_network->nextMapperGeneration();
+  cache->signature = sig;
+  cache->totalBuses = p_totalBuses;
+  cache->minRowIndex = p_minRowIndex;
+  cache->maxRowIndex = p_maxRowIndex;
+  cache->rowBlockSize = p_rowBlockSize;
+  cache->colBlockSize = p_colBlockSize;
+  cache->busContribution = p_busContribution;
+  cache->branchContribution = p_branchContribution;
+  cache->maxIBlock = p_maxIBlock;
+  cache->maxJBlock = p_maxJBlock;
+  cache->maxcol = p_maxcol;
+  cache->blockSize = p_blockSize;
+#ifdef NZ_PER_ROW
+  cache->nzPerRow.assign(p_nz_per_row, p_nz_per_row+p_nz_rows);
+#endif
+  if (p_busContribution > 0) {
+    cache->iBusOffsets.assign(p_i_busOffsets,
+        p_i_busOffsets+p_busContribution);
+    cache->jBusOffsets.assign(p_j_busOffsets,
+        p_j_busOffsets+p_busContribution);
+  }
+  cache->iBranchOffsets.assign(p_i_branchOffsets,
+      p_i_branchOffsets+p_branchContribution);
+  cache->jBranchOffsets.assign(p_j_branchOffsets,
+      p_j_branchOffsets+p_branchContribution);
+  p_network->setMapperCache(key, cache);
+}
+
     // GA information
 int                         p_me;
 int                         p_nNodes;
@@ -1335,8 +1910,13 @@ int                         p_branchContribution;
 int                         p_maxIBlock;
 int                         p_maxJBlock;
 int                         p_maxcol;
+int                         p_blockSize; // uniform block size, 0 or -1
+bool                        p_useBlocks; // create block storage matrices
+bool                        p_cached; // index structures from network cache
+std::string                 p_cacheKey; // key for network cache
 #ifdef NZ_PER_ROW
 int*                        p_nz_per_row;
+int                         p_nz_rows;
 #endif
 
 int*                        p_i_busOffsets;
@@ -1344,6 +1924,14 @@ int*                        p_j_busOffsets;
 int*                        p_i_branchOffsets;
 int*                        p_j_branchOffsets;
 
+    // incremental update information
+std::vector<int>            p_busBlock; // offset array entry for each bus
+std::vector<int>            p_branchBlock; // forward/reverse entries
+std::vector<unsigned int>   p_busRevision; // revisions at last fill
+std::vector<unsigned int>   p_branchRevision;
+int                         p_updatedBlocks;
+long                        p_totalUpdatedBlocks;
+
     // global matrix block size array
 int                         gaMatBlksI; // g_idx
 int                         gaMatBlksJ; // g_jdx
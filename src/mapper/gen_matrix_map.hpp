@@ -285,7 +285,8 @@ void setOffsets(void)
       icnt += p_network->getBus(i)->matrixNumRows();
       j_bus_offsets[i] = jcnt;
       jcnt += p_network->getBus(i)->matrixNumCols();
-      std::vector<int> nghbrs = p_network->getConnectedBranches(i);
+      gridpack::network::NeighborRange nghbrs =
+        p_network->connectedBranches(i);
       nsize = nghbrs.size();
       for (j=0; j<nsize; j++) {
         // Need to avoid double counting of branches when evaluating offsets.
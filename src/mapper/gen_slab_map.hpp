@@ -386,7 +386,8 @@ void setOffsets(void)
       i_bus_offsets[i] = icnt;
       p_network->getBus(i)->slabSize(&ival,&jval);
       icnt += ival;
-      std::vector<int> nghbrs = p_network->getConnectedBranches(i);
+      gridpack::network::NeighborRange nghbrs =
+        p_network->connectedBranches(i);
       nsize = nghbrs.size();
       for (j=0; j<nsize; j++) {
         // Need to avoid double counting of branches when evaluating offsets.
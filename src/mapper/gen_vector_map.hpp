@@ -266,7 +266,8 @@ void setOffsets(void)
     if (p_network->getActiveBus(i)) {
       i_bus_offsets[i] = icnt;
       icnt += p_network->getBus(i)->vectorNumElements();
-      std::vector<int> nghbrs = p_network->getConnectedBranches(i);
+      gridpack::network::NeighborRange nghbrs =
+        p_network->connectedBranches(i);
       nsize = nghbrs.size();
       for (j=0; j<nsize; j++) {
         // Need to avoid double counting of branches when evaluating offsets.
@@ -5,6 +5,7 @@
  */
 #include "mpi.h"
 #include <vector>
+#include <cmath>
 #include <macdecls.h>
 #include "gridpack/utilities/complex.hpp"
 #include "gridpack/network/base_network.hpp"
@@ -26,6 +27,7 @@ class TestBus
   public: 
 
   TestBus(void) {
+    p_diag = -4.0;
     p_vals = new double*[2];
     p_vals[0] = new double[NSLAB];
     p_vals[1] = new double[NSLAB];
@@ -51,7 +53,7 @@ class TestBus
 
   bool matrixDiagValues(gridpack::ComplexType *values) {
     if (!getReferenceBus()) {
-      *values = -4.0;
+      *values = p_diag;
       return true;
     } else {
       return false;
@@ -102,6 +104,11 @@ class TestBus
     return real(p_val);
   }
 
+  void setDiag(double diag, bool mark = true) {
+    p_diag = diag;
+    if (mark) markDirty();
+  }
+
   double getRealValue() {
     return p_rval;
   }
@@ -255,6 +262,7 @@ class TestBus
 
   gridpack::ComplexType p_val;
   gridpack::RealType p_rval;
+  double p_diag;
   int p_row_idx;
   int p_col_idx;
   int p_vec_idx1;
@@ -861,6 +869,217 @@ void run (const int &me, const int &nprocs)
     }
   }
 
+  if (me == 0) {
+    printf("\nTesting incremental matrix and vector updates\n");
+  }
+
+  // Change diagonal values of buses with even indices and refill only
+  // their blocks. Buses with odd indices also change their values but do
+  // not mark themselves as dirty, so their blocks must keep the old values
+  int ndirty = 0;
+  for (i=0; i<nbus; i++) {
+    if (network->getActiveBus(i)) {
+      network->getBus(i)->getMatVecIndex(&idx);
+      if (idx%2 == 0) {
+        network->getBus(i)->setDiag(-5.0);
+        if (network->getBus(i)->matrixDiagSize(&isize,&jsize)) ndirty++;
+      } else {
+        network->getBus(i)->setDiag(-6.0, false);
+      }
+    }
+  }
+  chk = 0;
+  if (mMap.updateMatrix(M) != ndirty || mMap.updatedBlocks() != ndirty) {
+    printf("p[%d] Incorrect number of updated blocks: %d expected: %d\n",
+        me,mMap.updatedBlocks(),ndirty);
+    chk = 1;
+  }
+  for (i=0; i<nbus; i++) {
+    if (network->getActiveBus(i)) {
+      if (network->getBus(i)->matrixDiagSize(&isize,&jsize)) {
+        network->getBus(i)->getMatVecIndex(&idx);
+        M->getElement(idx-1,idx-1,v);
+        rv = real(v);
+        if (rv != (idx%2 == 0 ? -5.0 : -4.0)) {
+          printf("p[%d] Updated diagonal error i: %d v: %f\n",me,idx-1,rv);
+          chk = 1;
+        }
+      }
+    }
+  }
+  // A second update with no changes should not touch any blocks
+  if (mMap.updateMatrix(M) != 0) {
+    printf("p[%d] Blocks updated without changes\n",me);
+    chk = 1;
+  }
+
+  // The vector still holds doubled values. Only dirty buses are reset
+  vMap.updateVector(V);
+  for (i=0; i<nbus; i++) {
+    if (network->getActiveBus(i)) {
+      if (network->getBus(i)->vectorSize(&isize)) {
+        network->getBus(i)->getMatVecIndex(&idx);
+        V->getElement(idx-1,v);
+        rv = real(v);
+        if (rv != (idx%2 == 0 ? (double)idx : (double)(2*idx))) {
+          printf("p[%d] Updated vector error i: %d v: %f\n",me,idx,rv);
+          chk = 1;
+        }
+      }
+    }
+  }
+  for (i=0; i<nbus; i++) {
+    if (network->getActiveBus(i)) network->getBus(i)->setDiag(-4.0);
+  }
+  GA_Igop(&chk,one,"+");
+  if (me == 0) {
+    if (chk == 0) {
+      printf("\nIncremental updates are ok\n");
+    } else {
+      printf("\nError found in incremental updates\n");
+    }
+  }
+
+  if (me == 0) {
+    printf("\nTesting threaded matrix fill\n");
+  }
+  mMap.mapToMatrix(M);
+  if (gridpack::parallel::numThreads() > 1) {
+    // Matrix filled using threads should be identical to the original
+    gridpack::parallel::setThreadedLoops(true);
+    boost::shared_ptr<gridpack::math::Matrix> TM = mMap.mapToMatrix();
+    gridpack::parallel::setThreadedLoops(false);
+    TM->scale(-1.0);
+    TM->add(*M);
+    rv = TM->norm2();
+    if (me == 0) {
+      if (rv == 0.0) {
+        printf("\nThreaded matrix elements are ok\n");
+      } else {
+        printf("\nError found in threaded matrix elements: %e\n",rv);
+      }
+    }
+  } else if (me == 0) {
+    printf("\nSkipping threaded matrix fill: only one thread is available"
+        " (build with USE_OPENMP and set OMP_NUM_THREADS)\n");
+  }
+
+  if (me == 0) {
+    printf("\nTesting block matrix fill\n");
+  }
+  // All contributions are 1x1 blocks, so the mapper can use block storage.
+  // The block matrix should have the same elements as the original
+  chk = 0;
+  gridpack::mapper::FullMatrixMap<TestNetwork> bMap(network);
+  if (!bMap.setBlockStorage(true) || bMap.blockSize() != 1) {
+    printf("p[%d] Block storage not used, block size: %d\n",me,
+        bMap.blockSize());
+    chk = 1;
+  }
+  boost::shared_ptr<gridpack::math::Matrix> BM = bMap.mapToMatrix();
+  if (BM->storageType() != gridpack::math::Block) {
+    printf("p[%d] Matrix does not use block storage\n",me);
+    chk = 1;
+  }
+  gridpack::ComplexType bv;
+  for (i=0; i<nbus; i++) {
+    if (network->getActiveBus(i)) {
+      if (network->getBus(i)->matrixDiagSize(&isize,&jsize)) {
+        network->getBus(i)->getMatVecIndex(&idx);
+        idx--;
+        M->getElement(idx,idx,v);
+        BM->getElement(idx,idx,bv);
+        if (v != bv) {
+          printf("p[%d] Block diagonal error i: %d v: %f expected: %f\n",
+              me,idx,real(bv),real(v));
+          chk = 1;
+        }
+      }
+    }
+  }
+  for (i=0; i<nbranch; i++) {
+    if (network->getBranch(i)->matrixForwardSize(&isize,&jsize)) {
+      network->getBranch(i)->getMatVecIndices(&idx,&jdx);
+      idx--;
+      jdx--;
+      if (idx >= rlo-1 && idx <= rhi-1) {
+        M->getElement(idx,jdx,v);
+        BM->getElement(idx,jdx,bv);
+        if (v != bv) {
+          printf("p[%d] Block forward error i: %d j: %d v: %f expected: %f\n",
+              me,idx,jdx,real(bv),real(v));
+          chk = 1;
+        }
+      }
+      if (jdx >= rlo-1 && jdx <= rhi-1) {
+        M->getElement(jdx,idx,v);
+        BM->getElement(jdx,idx,bv);
+        if (v != bv) {
+          printf("p[%d] Block reverse error i: %d j: %d v: %f expected: %f\n",
+              me,jdx,idx,real(bv),real(v));
+          chk = 1;
+        }
+      }
+    }
+  }
+  // Check that there are no extra elements in the block matrix
+  double bnorm = BM->norm2();
+  rv = M->norm2();
+  if (fabs(bnorm-rv) > 1.0e-12*rv) {
+    printf("p[%d] Block matrix norm: %e expected: %e\n",me,bnorm,rv);
+    chk = 1;
+  }
+  GA_Igop(&chk,one,"+");
+  if (me == 0) {
+    if (chk == 0) {
+      printf("\nBlock matrix elements are ok\n");
+    } else {
+      printf("\nError found in block matrix elements\n");
+    }
+  }
+
+  if (me == 0) {
+    printf("\nTesting cached mapper construction\n");
+  }
+  // Mappers created on an unchanged network reuse the index structures of
+  // the first mappers and produce the same matrix and vector
+  chk = 0;
+  gridpack::mapper::FullMatrixMap<TestNetwork> cmMap(network);
+  if (!cmMap.cached()) {
+    printf("p[%d] Matrix mapper did not use cached indices\n",me);
+    chk = 1;
+  }
+  boost::shared_ptr<gridpack::math::Matrix> CM = cmMap.mapToMatrix();
+  CM->scale(-1.0);
+  CM->add(*M);
+  rv = CM->norm2();
+  if (rv != 0.0) {
+    printf("p[%d] Cached matrix differs from original: %e\n",me,rv);
+    chk = 1;
+  }
+  gridpack::mapper::BusVectorMap<TestNetwork> cvMap(network);
+  if (!cvMap.cached()) {
+    printf("p[%d] Vector mapper did not use cached indices\n",me);
+    chk = 1;
+  }
+  vMap.mapToVector(V);
+  boost::shared_ptr<gridpack::math::Vector> CV = cvMap.mapToVector();
+  CV->scale(-1.0);
+  CV->add(*V);
+  rv = CV->norm2();
+  if (rv != 0.0) {
+    printf("p[%d] Cached vector differs from original: %e\n",me,rv);
+    chk = 1;
+  }
+  GA_Igop(&chk,one,"+");
+  if (me == 0) {
+    if (chk == 0) {
+      printf("\nCached mappers are ok\n");
+    } else {
+      printf("\nError found in cached mappers\n");
+    }
+  }
+
   if (me == 0) {
     printf("\nTesting general matrix interface\n");
   }
@@ -177,6 +177,30 @@ protected:
   {
     p_impl->terminated(flag);
   }
+
+  /// Get the matrix used to hold the Jacobian (specialized)
+  MatrixType& p_jacobian(void)
+  {
+    return p_impl->jacobian();
+  }
+
+  /// Force the Jacobian to be rebuilt at the next opportunity (specialized)
+  void p_invalidateJacobian(void)
+  {
+    p_impl->invalidateJacobian();
+  }
+
+  /// Get the number of times the Jacobian was built (specialized)
+  int p_jacobianBuilds(void) const
+  {
+    return p_impl->jacobianBuilds();
+  }
+
+  /// Get the number of times the Jacobian was reused (specialized)
+  int p_jacobianReuses(void) const
+  {
+    return p_impl->jacobianReuses();
+  }
 };
 
 typedef DAESolverT<ComplexType> ComplexDAESolver;
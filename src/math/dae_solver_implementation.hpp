@@ -20,6 +20,7 @@
 #ifndef _dae_solver_implementation_hpp_
 #define _dae_solver_implementation_hpp_
 
+#include <cmath>
 #include <boost/shared_ptr.hpp>
 #include <gridpack/math/dae_solver_interface.hpp>
 #include <gridpack/parallel/distributed.hpp>
@@ -60,7 +61,16 @@ public:
       p_J(comm, local_size, local_size),
       p_Fbuilder(fbuilder), p_Jbuilder(jbuilder),
       p_eventManager(eman),
-      p_doAdaptive(true)
+      p_doAdaptive(true),
+      p_jacobianLag(1),
+      p_jacobianShiftTolerance(0.3),
+      p_jacobianMaxIterations(4),
+      p_matrixFree(false),
+      p_jacobianStale(true),
+      p_jacobianShift(0.0),
+      p_jacobianAge(0),
+      p_jacobianBuildCount(0),
+      p_jacobianReuseCount(0)
   {
     
   }
@@ -94,12 +104,119 @@ protected:
   /// Is the time stepper adaptive?
   bool p_doAdaptive;
 
+  /// Maximum number of Jacobian requests served by one Jacobian build
+  /**
+   * A value of 1 (the default) rebuilds the Jacobian every time the
+   * underlying solver asks for it.
+   */
+  int p_jacobianLag;
+
+  /// Relative change in the shift (i.e. time step) that forces a rebuild
+  double p_jacobianShiftTolerance;
+
+  /// Nonlinear iteration count that is considered stagnation and forces a rebuild
+  int p_jacobianMaxIterations;
+
+  /// Use a matrix-free (finite difference) Jacobian-vector product
+  /**
+   * If true, the assembled Jacobian is only used to build the
+   * preconditioner. It is not built at all if there is no
+   * preconditioner.
+   */
+  bool p_matrixFree;
+
+  /// Must the Jacobian be rebuilt at the next request?
+  bool p_jacobianStale;
+
+  /// The shift used for the last Jacobian build
+  double p_jacobianShift;
+
+  /// The number of requests served by the current Jacobian
+  int p_jacobianAge;
+
+  /// The number of times the Jacobian was built
+  int p_jacobianBuildCount;
+
+  /// The number of times the Jacobian was reused
+  int p_jacobianReuseCount;
+
   /// Specialized way to configure from property tree
   void p_configure(utility::Configuration::CursorPtr props)
   {
     if (props) {
       p_doAdaptive = props->get("Adaptive", p_doAdaptive);
+      p_jacobianLag = props->get("JacobianLag", p_jacobianLag);
+      p_jacobianShiftTolerance = 
+        props->get("JacobianShiftTolerance", p_jacobianShiftTolerance);
+      p_jacobianMaxIterations = 
+        props->get("JacobianMaxIterations", p_jacobianMaxIterations);
+      p_matrixFree = props->get("MatrixFree", p_matrixFree);
+    }
+  }
+
+  /// Decide whether the Jacobian needs to be rebuilt
+  /** 
+   * The Jacobian is rebuilt if it has been invalidated (by an event,
+   * reinitialization, or explicitly), if it has been reused the
+   * maximum number of times, if the shift has changed more than the
+   * allowed relative amount, or if the nonlinear solve appears to be
+   * stagnating.  Otherwise, the previous Jacobian is reused.
+   *
+   * All arguments must be the same on all processes.
+   * 
+   * @param shift current shift (scales the dF/dxdot part of the Jacobian)
+   * @param iterations number of nonlinear iterations in the current solve
+   * 
+   * @return true if the Jacobian needs to be rebuilt
+   */
+  bool p_rebuildJacobian(const double& shift, const int& iterations)
+  {
+    bool result(p_jacobianStale || 
+                p_jacobianLag <= 1 ||
+                p_jacobianAge >= p_jacobianLag);
+    if (!result && 
+        std::abs(shift - p_jacobianShift) > 
+        p_jacobianShiftTolerance*std::abs(p_jacobianShift)) {
+      result = true;
+    }
+    if (!result && p_jacobianMaxIterations > 0 &&
+        iterations >= p_jacobianMaxIterations) {
+      result = true;
     }
+    if (result) {
+      p_jacobianStale = false;
+      p_jacobianShift = shift;
+      p_jacobianAge = 0;
+      p_jacobianBuildCount++;
+    } else {
+      p_jacobianReuseCount++;
+    }
+    p_jacobianAge++;
+    return result;
+  }
+
+  /// Get the matrix used to hold the Jacobian (specialized)
+  MatrixType& p_jacobian(void)
+  {
+    return p_J;
+  }
+
+  /// Force the Jacobian to be rebuilt at the next opportunity (specialized)
+  void p_invalidateJacobian(void)
+  {
+    p_jacobianStale = true;
+  }
+
+  /// Get the number of times the Jacobian was built (specialized)
+  int p_jacobianBuilds(void) const
+  {
+    return p_jacobianBuildCount;
+  }
+
+  /// Get the number of times the Jacobian was reused (specialized)
+  int p_jacobianReuses(void) const
+  {
+    return p_jacobianReuseCount;
   }
 
   /// Set a function to call before each time step (specialized)
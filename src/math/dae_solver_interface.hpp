@@ -118,6 +118,54 @@ public:
     this->p_terminated(flag);
   }
 
+  /// Get the matrix used to hold the Jacobian
+  /**
+   * The returned matrix may be shared with other solvers (e.g. a
+   * NonlinearSolver used to compute consistent initial conditions)
+   * to avoid allocating a second Jacobian.  If another solver
+   * changes its contents, ::invalidateJacobian() must be called
+   * before the next call to ::solve().
+   *
+   * @return the Jacobian matrix owned by this solver
+   */
+  MatrixType& jacobian(void)
+  {
+    return this->p_jacobian();
+  }
+
+  /// Force the Jacobian to be rebuilt at the next opportunity
+  /**
+   * Call this after a discrete change to the system (e.g. a fault
+   * or switching action) or after the Jacobian matrix has been
+   * modified outside of this solver.
+   */
+  void invalidateJacobian(void)
+  {
+    this->p_invalidateJacobian();
+  }
+
+  /// Get the number of times the Jacobian was built
+  /** 
+   * With the default JacobianLag of 1 the Jacobian is built every
+   * time the underlying solver asks for it.  In matrix-free mode
+   * without a preconditioner it is never built.
+   * 
+   * @return number of Jacobian builds since the solver was created
+   */
+  int jacobianBuilds(void) const
+  {
+    return this->p_jacobianBuilds();
+  }
+
+  /// Get the number of times a previously built Jacobian was reused
+  /** 
+   * @return number of Jacobian reuses since the solver was created
+   */
+  int jacobianReuses(void) const
+  {
+    return this->p_jacobianReuses();
+  }
+
 protected:
 
   /// Initialize the system (specialized)
@@ -140,6 +188,18 @@ protected:
 
   /// Reset solver if it has been terminated by an event, maybe (specialized)
   virtual void p_terminated(const bool& flag) = 0;
+
+  /// Get the matrix used to hold the Jacobian (specialized)
+  virtual MatrixType& p_jacobian(void) = 0;
+
+  /// Force the Jacobian to be rebuilt at the next opportunity (specialized)
+  virtual void p_invalidateJacobian(void) = 0;
+
+  /// Get the number of times the Jacobian was built (specialized)
+  virtual int p_jacobianBuilds(void) const = 0;
+
+  /// Get the number of times the Jacobian was reused (specialized)
+  virtual int p_jacobianReuses(void) const = 0;
 };
 
 
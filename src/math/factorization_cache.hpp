@@ -0,0 +1,79 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+// -------------------------------------------------------------
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   factorization_cache.hpp
+ *
+ * @brief Statistics and control of the process-wide cache of
+ * coefficient matrix factorizations shared by linear solvers.
+ *
+ *
+ */
+// -------------------------------------------------------------
+
+#ifndef _factorization_cache_hpp_
+#define _factorization_cache_hpp_
+
+namespace gridpack {
+namespace math {
+
+// -------------------------------------------------------------
+//  struct FactorizationCacheStatistics
+// -------------------------------------------------------------
+/// Counts kept by the factorization cache on this process
+/**
+ * Linear solvers with the \c FactorizationCache option look up the
+ * factorization of their coefficient matrix in a process-wide cache
+ * before factoring it. Factorizations are found by the sparsity
+ * pattern and values of the matrix, so different solver instances
+ * working on the same matrix share one factorization if they use the
+ * same PETSc option prefix, solver, factorization package and factor
+ * options.
+ *
+ */
+struct FactorizationCacheStatistics {
+
+  /// Number of lookups that found a factorization
+  int hits;
+
+  /// Number of lookups that required a new factorization
+  int misses;
+
+  /// Number of factorizations removed to stay within the memory budget
+  int evictions;
+
+  /// Number of factorizations currently in the cache
+  int entries;
+
+  /// Estimated memory used by the cached factorizations (MB)
+  double memory;
+
+  /// The memory budget of the cache (MB)
+  double budget;
+};
+
+/// Get the factorization cache statistics of this process
+extern FactorizationCacheStatistics factorizationCacheStatistics(void);
+
+/// Set the memory budget (MB) of the factorization cache
+/**
+ * The budget applies separately to the factorizations on each
+ * communicator, so all processes make the same eviction decisions.
+ * This must be called with the same value on all processes.
+ *
+ * @param mbytes memory budget in MB
+ */
+extern void factorizationCacheBudget(const double& mbytes);
+
+/// Remove all factorizations from the cache (collective on all processes)
+extern void clearFactorizationCache(void);
+
+} // namespace math
+} // namespace gridpack
+
+#endif
@@ -202,6 +202,18 @@ protected:
     return p_solver->solve(B);
   }
 
+  /// Get the number of refinement iterations used in the last solve (specialized)
+  int p_refinementIterations(void) const
+  {
+    return p_solver->refinementIterations();
+  }
+
+  /// Get the number of full precision fallbacks (specialized)
+  int p_refinementFallbacks(void) const
+  {
+    return p_solver->refinementFallbacks();
+  }
+
 
 };
 
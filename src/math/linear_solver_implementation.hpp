@@ -25,6 +25,7 @@
 #ifndef _linear_solver_implementation_hpp_
 #define _linear_solver_implementation_hpp_
 
+#include <string>
 #include <boost/scoped_ptr.hpp>
 #include <gridpack/math/linear_solver_interface.hpp>
 #include <gridpack/parallel/distributed.hpp>
@@ -63,7 +64,16 @@ public:
       p_doSerial(false),
       p_constSerialMatrix(),
       p_guessZero(false),
-      p_serialSolution()
+      p_serialSolution(),
+      p_refine(false),
+      p_refinePrecision("single"),
+      p_refineTolerance(1.0e-10),
+      p_refineMaxIterations(10),
+      p_refineStallFactor(0.5),
+      p_refineIterations(0),
+      p_refineFallbacks(0),
+      p_cacheFactorization(false),
+      p_cacheMemory(-1.0)
   {
   }
 
@@ -137,6 +147,50 @@ protected:
   /// A buffer to use for value transfer
   mutable std::vector<TheType> p_valueBuffer;
 
+  /// Solve using a reduced precision factorization and iterative refinement
+  /**
+   * If true, each solution is computed with a factorization stored in
+   * reduced precision (::p_refinePrecision). The residual is computed
+   * in full precision and used to correct the solution until its
+   * norm is reduced by ::p_refineTolerance. If the residual stops
+   * decreasing, or does not converge in ::p_refineMaxIterations
+   * iterations, the system is solved again with the regular, full
+   * precision solver.
+   * 
+   */
+  bool p_refine;
+
+  /// The precision of the factorization used for refinement
+  std::string p_refinePrecision;
+
+  /// The relative residual norm at which refinement stops
+  double p_refineTolerance;
+
+  /// The maximum number of refinement iterations
+  int p_refineMaxIterations;
+
+  /// Refinement has stalled if the residual norm is not reduced by this factor
+  double p_refineStallFactor;
+
+  /// The number of refinement iterations used in the last solution
+  mutable int p_refineIterations;
+
+  /// The number of solutions that fell back to full precision
+  mutable int p_refineFallbacks;
+
+  /// Share factorizations of identical matrices with other solvers
+  /**
+   * If true, and the solver is direct, the factorization of the
+   * coefficient matrix is taken from the process-wide factorization
+   * cache if any solver has already factored a matrix with the same
+   * pattern and values. New factorizations are added to the cache.
+   * 
+   */
+  bool p_cacheFactorization;
+
+  /// Memory budget of the factorization cache (MB), if > 0
+  double p_cacheMemory;
+
   /// Specialized way to configure from property tree
   void p_configure(utility::Configuration::CursorPtr props)
   {
@@ -152,6 +206,15 @@ protected:
       p_doSerial = (p_doSerial && (this->processor_size() > 1));
 
       p_guessZero = props->get("InitialGuessZero", p_guessZero);
+
+      p_refine = props->get("IterativeRefinement", p_refine);
+      p_refinePrecision = props->get("RefinementPrecision", p_refinePrecision);
+      p_refineTolerance = props->get("RefinementTolerance", p_refineTolerance);
+      p_refineMaxIterations = props->get("RefinementMaxIterations", p_refineMaxIterations);
+      p_refineStallFactor = props->get("RefinementStallFactor", p_refineStallFactor);
+
+      p_cacheFactorization = props->get("FactorizationCache", p_cacheFactorization);
+      p_cacheMemory = props->get("FactorizationCacheMemory", p_cacheMemory);
     }
   }
 
@@ -179,6 +242,18 @@ protected:
     p_maxIterations = n;
   }
 
+  /// Get the number of refinement iterations used in the last solve (specialized)
+  int p_refinementIterations(void) const
+  {
+    return p_refineIterations;
+  }
+
+  /// Get the number of full precision fallbacks (specialized)
+  int p_refinementFallbacks(void) const
+  {
+    return p_refineFallbacks;
+  }
+
   /// Solve the specified system w/ RHS and estimate (implementation)  
   virtual void p_solveImpl(MatrixType& A, const VectorType& b, VectorType& x) const = 0;
 
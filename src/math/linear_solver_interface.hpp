@@ -156,6 +156,32 @@ public:
     return this->p_solve(B);
   }
 
+  /// Get the number of refinement iterations used in the last solve
+  /** 
+   * When iterative refinement is enabled, each solution is computed
+   * with a reduced precision factorization and corrected using
+   * residuals computed in full precision.
+   * 
+   * @return number of refinement iterations used by the last call
+   * to solve() or resolve(), or zero if refinement is not enabled
+   */
+  int refinementIterations(void) const
+  {
+    return this->p_refinementIterations();
+  }
+
+  /// Get the number of times refinement fell back to a full precision solve
+  /** 
+   * 
+   * 
+   * @return number of solutions, since construction, for which
+   * refinement stalled or failed to converge and the system was
+   * solved again in full precision
+   */
+  int refinementFallbacks(void) const
+  {
+    return this->p_refinementFallbacks();
+  }
 
 protected:
 
@@ -195,6 +221,12 @@ protected:
   /// Solve multiple systems w/ each column of the Matrix a single RHS
   virtual MatrixType *p_solve(const MatrixType& B) const = 0;
 
+  /// Get the number of refinement iterations used in the last solve (specialized)
+  virtual int p_refinementIterations(void) const = 0;
+
+  /// Get the number of full precision fallbacks (specialized)
+  virtual int p_refinementFallbacks(void) const = 0;
+
 };
 
 
@@ -156,6 +156,33 @@ public:
               const int& local_rows,
               const int& local_cols);
   
+  /// Create a ::Block or ::SymmetricBlock Matrix instance
+  /** 
+   * Block matrices store fixed size dense blocks and keep one column
+   * index per block. Use setBlock() or addBlock() to insert whole
+   * blocks at once. A ::SymmetricBlock matrix only stores blocks on
+   * or above the diagonal; values below the diagonal are ignored.
+   * 
+   * @param comm parallel environment
+   * @param local_rows matrix rows owned by the local process (a
+   *        multiple of @c block_size)
+   * @param local_cols matrix columns owned by the local process (a
+   *        multiple of @c block_size)
+   * @param block_size number of rows and columns in each block
+   * @param max_blocks_per_row estimate of the maximum number of nonzero
+   *        blocks in a block row
+   * @param stype ::Block or ::SymmetricBlock
+   * 
+   * @return new MatrixT
+   */
+  static MatrixT *
+  createBlock(const parallel::Communicator& comm,
+              const int& local_rows,
+              const int& local_cols,
+              const int& block_size,
+              const int& max_blocks_per_row,
+              const MatrixStorageType& stype = Block);
+
   /// Get the storage type of this matrix
   MatrixStorageType storageType(void) const;
 
@@ -328,6 +355,22 @@ protected:
     p_matrix_impl->addElements(n, i, j, x); 
   }
 
+  /// Set a dense block of elements
+  void p_setBlock(const IdxType& i, const IdxType& j, 
+                  const IdxType& m, const IdxType& n, 
+                  const TheType *x)
+  { 
+    p_matrix_impl->setBlock(i, j, m, n, x); 
+  }
+
+  /// Add to a dense block of elements
+  void p_addBlock(const IdxType& i, const IdxType& j, 
+                  const IdxType& m, const IdxType& n, 
+                  const TheType *x)
+  { 
+    p_matrix_impl->addBlock(i, j, m, n, x); 
+  }
+
   /// Get an individual element
   void p_getElement(const IdxType& i, const IdxType& j, TheType& x) const
   { 
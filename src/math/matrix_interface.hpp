@@ -171,6 +171,48 @@ public:
     this->p_addElements(n, i, j, x);
   }
 
+  /// Set a dense block of elements
+  /** 
+   * @e Local.
+   *
+   * This overwrites an @c m by @c n block of contiguous elements
+   * starting at row @c i and column @c j. Values are ordered by column
+   * (the row index varies fastest), which is the order in which
+   * network components supply their matrix blocks. If the matrix uses
+   * ::Block storage and the block matches its block size, the values
+   * are inserted with a single blocked operation. ready() must be
+   * called after all setBlock() calls and before using the matrix.
+   * 
+   * @param i global, 0-based row index of the first row of the block
+   * @param j global, 0-based column index of the first column of the block
+   * @param m number of rows in the block
+   * @param n number of columns in the block
+   * @param x array of @c m*n values in column order
+   */
+  void setBlock(const IdxType& i, const IdxType& j, 
+                const IdxType& m, const IdxType& n, const TheType *x)
+  {
+    this->p_setBlock(i, j, m, n, x);
+  }
+
+  /// Add to a dense block of elements
+  /** 
+   * @e Local.
+   *
+   * Same as setBlock() but values are added to existing elements.
+   * 
+   * @param i global, 0-based row index of the first row of the block
+   * @param j global, 0-based column index of the first column of the block
+   * @param m number of rows in the block
+   * @param n number of columns in the block
+   * @param x array of @c m*n values in column order
+   */
+  void addBlock(const IdxType& i, const IdxType& j, 
+                const IdxType& m, const IdxType& n, const TheType *x)
+  {
+    this->p_addBlock(i, j, m, n, x);
+  }
+
   /// Get an individual element
   /** 
    * @c Local.
@@ -409,6 +451,16 @@ protected:
   virtual void p_addElements(const IdxType& n, const IdxType *i, const IdxType *j, 
                              const TheType *x) = 0;
 
+  /// Set a dense block of elements (specialized)
+  virtual void p_setBlock(const IdxType& i, const IdxType& j, 
+                          const IdxType& m, const IdxType& n, 
+                          const TheType *x) = 0;
+
+  /// Add to a dense block of elements (specialized)
+  virtual void p_addBlock(const IdxType& i, const IdxType& j, 
+                          const IdxType& m, const IdxType& n, 
+                          const TheType *x) = 0;
+
   /// Get an individual element (specialized)
   virtual void p_getElement(const IdxType& i, const IdxType& j, TheType& x) const = 0;
 
@@ -20,9 +20,11 @@ namespace math {
 
 /// The types of matrices that can be created
 /**
- * The gridpack::math library provides two storage schemes for
+ * The gridpack::math library provides several storage schemes for
  * matrices. This is used by Matrix and MatrixImplementation
- * subclasses.
+ * subclasses. ::Block and ::SymmetricBlock matrices store small dense
+ * blocks of a fixed size (e.g. the per-bus blocks of a Jacobian) with
+ * one index per block instead of one per element.
  *
  * The actual storage scheme and memory used is dependent upon the
  * underlying math library implementation.
@@ -30,7 +32,9 @@ namespace math {
  */
 enum MatrixStorageType { 
   Dense,                      /**< dense matrix storage scheme */
-  Sparse                      /**< sparse matrix storage scheme */
+  Sparse,                     /**< sparse matrix storage scheme */
+  Block,                      /**< sparse storage of uniform dense blocks */
+  SymmetricBlock              /**< block storage of the upper triangle only */
 };
 
 } // namespace math
@@ -21,7 +21,9 @@
 #define _newton_raphson_solver_implementation_hpp_
 
 #include <iostream>
+#include <boost/format.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <gridpack/utilities/exception.hpp>
 #include "nonlinear_solver_functions.hpp"
 #include "nonlinear_solver_implementation.hpp"
 #include "linear_solver.hpp"
@@ -60,6 +62,20 @@ namespace math {
  * The interative process is ended when the L<sup>2</sup> \ref
  * Vector::norm2() "norm" of \f$ \Delta \mathbf{x}^{k} \f$ is less
  * then some specified small tolerance.
+ *
+ * By default, the Jacobian is rebuilt and factored every iteration.
+ * The \c JacobianReuse option selects a variant that reuses the
+ * factored Jacobian from an earlier iteration:
+ *  - \c newton: rebuild every iteration (default)
+ *  - \c chord: build the Jacobian once, at the start of each solve
+ *  - \c shamanskii: rebuild every \c JacobianLag iterations
+ *  - \c adaptive: rebuild when the function norm is reduced by less
+ *    than a factor of \c JacobianContractionTolerance in an iteration
+ *
+ * Any other value of \c JacobianReuse throws an Exception.
+ *
+ * The reuse variants take more iterations but far fewer
+ * factorizations.
  */
 template <typename T, typename I>
 class NewtonRaphsonSolverImplementation 
@@ -90,7 +106,10 @@ public:
                                     JacobianBuilder form_jacobian,
                                     FunctionBuilder form_function)
     : NonlinearSolverImplementation<T, I>(comm, local_size, form_jacobian, form_function),
-      p_linear_solver()
+      p_linear_solver(),
+      p_jacobianReuse(ReuseNever),
+      p_jacobianLag(3),
+      p_jacobianContractionTolerance(0.25)
   {
     this->configurationKey("NewtonRaphsonSolver");
   }
@@ -101,7 +120,10 @@ public:
                                     JacobianBuilder form_jacobian,
                                     FunctionBuilder form_function)
     : NonlinearSolverImplementation<T, I>(J, form_jacobian, form_function),
-      p_linear_solver()
+      p_linear_solver(),
+      p_jacobianReuse(ReuseNever),
+      p_jacobianLag(3),
+      p_jacobianContractionTolerance(0.25)
   {
     this->configurationKey("NewtonRaphsonSolver");
   }
@@ -129,40 +151,130 @@ protected:
   /// Maximum number of iterations to perform
   int p_max_iterations;
 
+  /// Ways to reuse the Jacobian
+  enum JacobianReuse { ReuseNever, ReuseChord, ReuseShamanskii, ReuseAdaptive };
+
   /// The linear solver
   boost::scoped_ptr< LinearSolverT<T, I> > p_linear_solver;
 
+  /// How the Jacobian is reused
+  JacobianReuse p_jacobianReuse;
+
+  /// Number of iterations between Jacobian builds (Shamanskii)
+  int p_jacobianLag;
+
+  /// Function norm reduction that is too slow and forces a rebuild (adaptive)
+  double p_jacobianContractionTolerance;
+
+  /// Decide whether the Jacobian needs to be rebuilt
+  /** 
+   * All arguments must be the same on all processes.
+   * 
+   * @param age number of iterations since the Jacobian was built (<
+   * 0 if it has not been built in this solve)
+   * @param ftol current function norm
+   * @param fprev function norm in previous iteration
+   * 
+   * @return true if the Jacobian needs to be rebuilt
+   */
+  bool p_rebuildJacobian(const int& age, const double& ftol,
+                         const double& fprev) const
+  {
+    if (age < 0) return true;
+    switch (p_jacobianReuse) {
+    case ReuseChord:
+      return false;
+    case ReuseShamanskii:
+      return (age >= p_jacobianLag);
+    case ReuseAdaptive:
+      return (ftol > p_jacobianContractionTolerance*fprev);
+    default:
+      break;
+    }
+    return true;
+  }
+
   /// Solve w/ using the specified initial guess (specialized)
   void p_solve(VectorType& x)
   {
     NonlinearSolverImplementation<T, I>::p_solve(x);
     double stol(1.0e+30);
     double ftol(1.0e+30);
+    double fprev(1.0e+30);
     int iter(0);
+    int age(-1);
+    this->p_iterationCount = 0;
+    this->p_factorizationCount = 0;
 
     boost::scoped_ptr<VectorType> deltaX(this->p_X->clone());
     while (stol > this->p_solutionTolerance && iter < this->p_maxIterations) {
       this->p_function(*(this->p_X), *(this->p_F));
       this->p_F->scale(-1.0);
-      this->p_jacobian(*(this->p_X), *(this->p_J));
-      if (!p_linear_solver) {
-        p_linear_solver.reset(new LinearSolverT<T, I>(*(this->p_J)));
-        p_linear_solver->configure(this->p_configCursor);
-      } 
+      ftol = this->p_F->norm2();
+      bool rebuild(p_rebuildJacobian(age, ftol, fprev));
       deltaX->zero();
-      p_linear_solver->solve(*(this->p_F), *deltaX);
+      if (rebuild) {
+        this->p_jacobian(*(this->p_X), *(this->p_J));
+        if (!p_linear_solver) {
+          p_linear_solver.reset(new LinearSolverT<T, I>(*(this->p_J)));
+          p_linear_solver->configure(this->p_configCursor);
+        } 
+        p_linear_solver->solve(*(this->p_F), *deltaX);
+        this->p_factorizationCount += 1;
+        age = 0;
+      } else {
+        // the Jacobian matrix has not changed, so the factorization
+        // from the last solve() is used
+        p_linear_solver->resolve(*(this->p_F), *deltaX);
+      }
+      age += 1;
+      fprev = ftol;
       stol = deltaX->norm2();
-      ftol = this->p_F->norm2();
       this->p_X->add(*deltaX);
       iter += 1;
+      this->p_iterationCount = iter;
       if (this->processor_rank() == 0) {
         std::cout << "Newton-Raphson "
                   << "iteration " << iter << ": "
                   << "solution residual norm = " << stol << ", "
                   << "function norm = " << ftol
+                  << (rebuild ? "" : " (Jacobian reused)")
                   << std::endl;
       }
     }
+    if (this->processor_rank() == 0) {
+      std::cout << "Newton-Raphson: "
+                << iter << " iterations, "
+                << this->p_factorizationCount << " Jacobian factorizations"
+                << std::endl;
+    }
+  }
+
+  /// Specialized way to configure from property tree
+  void p_configure(utility::Configuration::CursorPtr props)
+  {
+    NonlinearSolverImplementation<T, I>::p_configure(props);
+    if (props) {
+      std::string reuse(props->get("JacobianReuse", std::string("newton")));
+      if (reuse == "chord") {
+        p_jacobianReuse = ReuseChord;
+      } else if (reuse == "shamanskii") {
+        p_jacobianReuse = ReuseShamanskii;
+      } else if (reuse == "adaptive") {
+        p_jacobianReuse = ReuseAdaptive;
+      } else if (reuse == "newton") {
+        p_jacobianReuse = ReuseNever;
+      } else {
+        std::string msg =
+          boost::str(boost::format("%s configuration: unrecognized \"JacobianReuse\": \"%s\"") %
+                     this->configurationKey() % reuse);
+        throw Exception(msg);
+      }
+      p_jacobianLag = props->get("JacobianLag", p_jacobianLag);
+      if (p_jacobianLag < 1) p_jacobianLag = 1;
+      p_jacobianContractionTolerance = 
+        props->get("JacobianContractionTolerance", p_jacobianContractionTolerance);
+    }
   }
 
 };
@@ -143,6 +143,18 @@ protected:
     p_impl->maximumIterations(n);
   }
 
+  /// Get the number of iterations taken by the last solve (specialized)
+  int p_iterations(void) const
+  {
+    return p_impl->iterations();
+  }
+
+  /// Get the number of Jacobian factorizations in the last solve (specialized)
+  int p_factorizations(void) const
+  {
+    return p_impl->factorizations();
+  }
+
   /// Solve w/ the specified initial estimated, put result in same vector
   void p_solve(VectorType& x)
   {
@@ -70,7 +70,9 @@ public:
       p_function(form_function),
       p_solutionTolerance(1.0e-05),
     p_functionTolerance(1.0e-10),
-    p_maxIterations(50)
+    p_maxIterations(50),
+    p_iterationCount(0),
+    p_factorizationCount(0)
   {
     p_F.reset(new VectorType(this->communicator(), local_size));
     // std::cout << this->processor_rank() << ": "
@@ -94,7 +96,9 @@ public:
       p_function(form_function),
       p_solutionTolerance(1.0e-05),
       p_functionTolerance(1.0e-10),
-      p_maxIterations(50)
+      p_maxIterations(50),
+      p_iterationCount(0),
+      p_factorizationCount(0)
   {
     p_F.reset(new VectorType(this->communicator(), J.localRows()));
   }
@@ -133,6 +137,12 @@ protected:
   /// The maximum number of iterations to perform
   int p_maxIterations;
 
+  /// The number of iterations taken by the last solve
+  int p_iterationCount;
+
+  /// The number of Jacobian factorizations in the last solve
+  int p_factorizationCount;
+
   /// Get the solution tolerance (specialized)
   double p_tolerance(void) const
   {
@@ -157,6 +167,18 @@ protected:
     p_maxIterations = n;
   }
 
+  /// Get the number of iterations taken by the last solve (specialized)
+  int p_iterations(void) const
+  {
+    return p_iterationCount;
+  }
+
+  /// Get the number of Jacobian factorizations in the last solve (specialized)
+  int p_factorizations(void) const
+  {
+    return p_factorizationCount;
+  }
+
   /// Solve w/ using the specified initial guess, put solution in same vector
   void p_solve(VectorType& x)
   {
@@ -109,6 +109,31 @@ public:
     p_maximumIterations(n);
   }
 
+  /// Get the number of iterations taken by the last solve
+  /** 
+   * 
+   * 
+   * 
+   * @return number of nonlinear iterations in the last call to solve()
+   */
+  int iterations(void) const
+  {
+    return p_iterations();
+  }
+
+  /// Get the number of Jacobian factorizations in the last solve
+  /** 
+   * This is the same as iterations() unless the solver reuses the
+   * Jacobian.
+   * 
+   * @return number of times the Jacobian was built and factored in
+   * the last call to solve()
+   */
+  int factorizations(void) const
+  {
+    return p_factorizations();
+  }
+
   /// Solve w/ the specified initial estimated, put result in same vector
   /** 
    * This solves the system of nonlinear equations using the contents
@@ -136,6 +161,12 @@ protected:
   /// Set the maximum solution iterations  (specialized)
   virtual void p_maximumIterations(const int& n) = 0;
 
+  /// Get the number of iterations taken by the last solve (specialized)
+  virtual int p_iterations(void) const = 0;
+
+  /// Get the number of Jacobian factorizations in the last solve (specialized)
+  virtual int p_factorizations(void) const = 0;
+
   /// Solve w/ the specified initial estimated, put result in same vector
   virtual void p_solve(VectorType& x) = 0;
   
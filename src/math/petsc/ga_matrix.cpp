@@ -16,6 +16,7 @@
 
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include <boost/assert.hpp>
 
 #include <ga.h>
@@ -66,6 +67,32 @@ static const PetscScalarGA zero =
   
 
 
+// -------------------------------------------------------------
+// struct MatGAStash
+// -------------------------------------------------------------
+/// Values set on a GA matrix that have not been sent to the GA yet
+struct MatGAStash {
+  InsertMode mode;                   /**< How stashed values are applied */
+  std::vector<int> rows;             /**< Row of each stashed value */
+  std::vector<int> cols;             /**< Column of each stashed value */
+  std::vector<PetscScalar> values;   /**< Stashed values */
+};
+
+// -------------------------------------------------------------
+// struct MatGAStashOrder
+// -------------------------------------------------------------
+/// Order stashed values by row and then by column
+struct MatGAStashOrder {
+  const struct MatGAStash *stash;
+  bool operator()(const int& a, const int& b) const
+  {
+    if (stash->rows[a] != stash->rows[b]) {
+      return stash->rows[a] < stash->rows[b];
+    }
+    return stash->cols[a] < stash->cols[b];
+  }
+};
+
 // -------------------------------------------------------------
 // struct MatGACtx
 // -------------------------------------------------------------
@@ -74,6 +101,8 @@ struct MatGACtx {
   int ga;                       /**< GA handle */
   int lo[2];                    /**< Lower limits of "local" matrix ownership */
   int hi[2];                    /**< Upper limits of "local" matrix ownership */
+  PetscBool useStash;           /**< Buffer values until assembly */
+  struct MatGAStash *stash;     /**< Values waiting for assembly */
 };
 
 static PetscErrorCode MatSetOperations_DenseGA(Mat A);
@@ -430,6 +459,107 @@ GA2Vec(int ga, Vec x)
   return ierr;
 }  
 
+// -------------------------------------------------------------
+// MatStashFlush_DenseGA
+// Send all stashed values to the GA. Values are sorted by row and
+// column, which also groups them by owner since the GA is distributed
+// by rows. Rectangular blocks of values are sent with one call each and
+// any remaining values are sent with a single scatter. The values are
+// not guaranteed to be complete until the GA is synchronized.
+// -------------------------------------------------------------
+static
+PetscErrorCode
+MatStashFlush_DenseGA(struct MatGACtx *ctx)
+{
+  PetscErrorCode ierr = 0;
+  struct MatGAStash *stash = ctx->stash;
+  int nstash = stash->values.size();
+  if (nstash == 0) return ierr;
+
+  // The sort is stable so that the last of several values inserted into
+  // the same element is the one that is kept
+  std::vector<int> order(nstash);
+  int i, k;
+  for (i = 0; i < nstash; ++i) order[i] = i;
+  MatGAStashOrder cmp;
+  cmp.stash = stash;
+  std::stable_sort(order.begin(), order.end(), cmp);
+
+  // Combine values for the same element
+  std::vector<int> rows, cols;
+  std::vector<PetscScalar> vals;
+  rows.reserve(nstash);
+  cols.reserve(nstash);
+  vals.reserve(nstash);
+  for (i = 0; i < nstash; ++i) {
+    k = order[i];
+    if (!rows.empty() && rows.back() == stash->rows[k] &&
+        cols.back() == stash->cols[k]) {
+      if (stash->mode == ADD_VALUES) {
+        vals.back() += stash->values[k];
+      } else {
+        vals.back() = stash->values[k];
+      }
+    } else {
+      rows.push_back(stash->rows[k]);
+      cols.push_back(stash->cols[k]);
+      vals.push_back(stash->values[k]);
+    }
+  }
+
+  PetscScalar one(1.0);
+  int nval = vals.size();
+  std::vector<int> subs;
+  std::vector<PetscScalar> svals;
+  k = 0;
+  while (k < nval) {
+    // Find contiguous columns in this row and then any following rows
+    // that contain the same columns
+    int r0 = rows[k];
+    int c0 = cols[k];
+    int len = 1;
+    while (k+len < nval && rows[k+len] == r0 && cols[k+len] == c0+len) len++;
+    int nrow = 1;
+    int next = k+len;
+    while (next+len <= nval && rows[next] == r0+nrow && cols[next] == c0 &&
+        rows[next+len-1] == r0+nrow && cols[next+len-1] == c0+len-1) {
+      nrow++;
+      next += len;
+    }
+    if (len*nrow > 1) {
+      int lo[2] = {r0, c0};
+      int hi[2] = {r0+nrow-1, c0+len-1};
+      int ld[1] = {len};
+      if (stash->mode == ADD_VALUES) {
+        NGA_Acc(ctx->ga, lo, hi, (void *)&vals[k], ld, &one);
+      } else {
+        NGA_Put(ctx->ga, lo, hi, (void *)&vals[k], ld);
+      }
+    } else {
+      subs.push_back(r0);
+      subs.push_back(c0);
+      svals.push_back(vals[k]);
+    }
+    k += len*nrow;
+  }
+
+  int nscat = svals.size();
+  if (nscat > 0) {
+    std::vector<int*> sptr(nscat);
+    for (i = 0; i < nscat; ++i) sptr[i] = &subs[2*i];
+    if (stash->mode == ADD_VALUES) {
+      NGA_Scatter_acc(ctx->ga, (void *)&svals[0], &sptr[0], nscat, &one);
+    } else {
+      NGA_Scatter(ctx->ga, (void *)&svals[0], &sptr[0], nscat);
+    }
+  }
+
+  stash->rows.clear();
+  stash->cols.clear();
+  stash->values.clear();
+  return ierr;
+}
+
 // -------------------------------------------------------------
 // MatSetValues_DenseGA
 // -------------------------------------------------------------
@@ -446,6 +576,28 @@ MatSetValues_DenseGA(Mat mat,
   int lo[2], hi[2], ld[2] = {1, 1};
   ierr = MatShellGetContext(mat, (void *)&ctx); CHKERRQ(ierr);
 
+  if (ctx->useStash) {
+    BOOST_ASSERT_MSG(addv == INSERT_VALUES || addv == ADD_VALUES,
+                     "Unknown set operation");
+    // Values that were stashed with a different mode must be applied
+    // first so that the order of operations is preserved
+    struct MatGAStash *stash = ctx->stash;
+    if (!stash->values.empty() && stash->mode != addv) {
+      ierr = MatStashFlush_DenseGA(ctx); CHKERRQ(ierr);
+    }
+    stash->mode = addv;
+    idx = 0;
+    for (i = 0; i < m; ++i) {
+      for (j = 0; j < n; ++j, ++idx) {
+        if (idxm[i] < 0 || idxn[j] < 0) continue;
+        stash->rows.push_back(idxm[i]);
+        stash->cols.push_back(idxn[j]);
+        stash->values.push_back(v[idx]);
+      }
+    }
+    return ierr;
+  }
+
   idx = 0;
   for (i = 0; i < m; ++i) {
     for (j = 0; j < n; ++j, ++idx) {
@@ -509,6 +661,7 @@ MatAssemmblyBegin_DenseGA(Mat mat, MatAssemblyType type)
   PetscErrorCode ierr = 0;
   struct MatGACtx *ctx;
   ierr = MatShellGetContext(mat, &ctx); CHKERRQ(ierr);
+  ierr = MatStashFlush_DenseGA(ctx); CHKERRQ(ierr);
   return ierr;
 }
 
@@ -697,6 +850,7 @@ MatDestroy_DenseGA(Mat A)
   GA_Pgroup_sync(ctx->gaGroup);
   GA_Destroy(ctx->ga);
   GA_Pgroup_destroy(ctx->gaGroup);
+  delete ctx->stash;
   ierr = PetscFree(ctx);
   return ierr;
 }
@@ -722,6 +876,8 @@ MatTranspose_DenseGA(Mat mat, MatReuse reuse, Mat *B)
 
   ierr = PetscMalloc(sizeof(struct MatGACtx), &newctx); CHKERRQ(ierr);
   ierr = MPIComm2GApgroup(comm, &(newctx->gaGroup));
+  newctx->useStash = ctx->useStash;
+  newctx->stash = new MatGAStash;
 
   ierr = CreateMatGA(newctx->gaGroup, lcols, lrows, gcols, grows, &(newctx->ga)); CHKERRQ(ierr);
   GA_Transpose(ctx->ga, newctx->ga);
@@ -747,6 +903,8 @@ MatCreateDenseGA(MPI_Comm comm,
 
   ierr = PetscMalloc(sizeof(struct MatGACtx), &ctx); CHKERRQ(ierr);
   ierr = MPIComm2GApgroup(comm, &(ctx->gaGroup)); CHKERRQ(ierr);
+  ctx->useStash = PETSC_TRUE;
+  ctx->stash = new MatGAStash;
   
   lrows = m; lcols = n;
   grows = M; gcols = N;
@@ -788,6 +946,8 @@ MatDuplicate_DenseGA(Mat mat, MatDuplicateOption op, Mat *M)
 
   ierr = PetscMalloc(sizeof(struct MatGACtx), &newctx); CHKERRQ(ierr);
   ierr = MPIComm2GApgroup(comm, &(newctx->gaGroup));
+  newctx->useStash = ctx->useStash;
+  newctx->stash = new MatGAStash;
   
   ierr = CreateMatGA(newctx->gaGroup, 
                      lrows, lcols, grows, gcols, &(newctx->ga)); CHKERRQ(ierr);
@@ -809,6 +969,20 @@ MatDuplicate_DenseGA(Mat mat, MatDuplicateOption op, Mat *M)
   return ierr;
 }
 
+// -------------------------------------------------------------
+// MatDenseGASetStash
+// -------------------------------------------------------------
+PetscErrorCode
+MatDenseGASetStash(Mat A, PetscBool flag)
+{
+  PetscErrorCode ierr = 0;
+  struct MatGACtx *ctx;
+  ierr = MatShellGetContext(A, &ctx); CHKERRQ(ierr);
+  ierr = MatStashFlush_DenseGA(ctx); CHKERRQ(ierr);
+  ctx->useStash = flag;
+  return ierr;
+}
+
 // -------------------------------------------------------------
 // MatConvertToDenseGA
 // -------------------------------------------------------------
@@ -39,6 +39,21 @@ MatCreateDenseGA(MPI_Comm comm,
                  Mat *A);
 
 
+/// Control buffering of values set on a GA-based Matrix
+/** 
+ * By default, values passed to MatSetValues() are kept locally and
+ * sent to the GA in bulk by MatAssemblyBegin(). If buffering is turned
+ * off, each value is sent to the GA as soon as it is set.
+ * 
+ * @param A GA-based matrix
+ * @param flag PETSC_TRUE to buffer values until assembly
+ * 
+ * @return 
+ */
+extern
+PetscErrorCode
+MatDenseGASetStash(Mat A, PetscBool flag);
+
 /// Convert a PETSc Matrix to a GA-based one
 /** 
  * 
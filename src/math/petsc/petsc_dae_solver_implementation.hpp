@@ -21,6 +21,7 @@
 #ifndef _petsc_dae_solver_implementation_hpp_
 #define _petsc_dae_solver_implementation_hpp_
 
+#include <cstring>
 #include <boost/format.hpp>
 #include <petscts.h>
 
@@ -62,6 +63,7 @@ public:
       PETScConfigurable(this->communicator()),
       p_ts(),
       p_petsc_J(NULL),
+      p_mfJ(NULL),
       p_eventv(),
       p_termFlag(false)
   {
@@ -77,6 +79,9 @@ public:
       ierr = PetscInitialized(&ok); CHKERRXX(ierr);
       if (ok) {
         ierr = TSDestroy(&p_ts); CHKERRXX(ierr);
+        if (p_mfJ != NULL) {
+          ierr = MatDestroy(&p_mfJ); CHKERRXX(ierr);
+        }
       }
     } catch (...) {
       // just eat it
@@ -92,6 +97,9 @@ protected:
   /// The Jacobian matrix
   Mat *p_petsc_J;
 
+  /// The matrix-free Jacobian operator, if used
+  Mat p_mfJ;
+
   /// An array to store event values
   std::vector<PetscScalar> p_eventv;
 
@@ -122,7 +130,17 @@ protected:
 
       p_petsc_J = PETScMatrix(this->p_J);
       ierr = TSSetIFunction(p_ts, NULL, FormIFunction, this); CHKERRXX(ierr);
-      ierr = TSSetIJacobian(p_ts, *p_petsc_J, *p_petsc_J, FormIJacobian, this); CHKERRXX(ierr);
+      if (this->p_matrixFree) {
+        // The Jacobian-vector product is approximated by differencing
+        // the (TS-wrapped) function builder; the assembled Jacobian
+        // is only used to precondition
+        SNES snes;
+        ierr = TSGetSNES(p_ts, &snes); CHKERRXX(ierr);
+        ierr = MatCreateSNESMF(snes, &p_mfJ); CHKERRXX(ierr);
+        ierr = TSSetIJacobian(p_ts, p_mfJ, *p_petsc_J, FormIJacobian, this); CHKERRXX(ierr);
+      } else {
+        ierr = TSSetIJacobian(p_ts, *p_petsc_J, *p_petsc_J, FormIJacobian, this); CHKERRXX(ierr);
+      }
       ierr = TSSetApplicationContext(p_ts, this); CHKERRXX(ierr);
       ierr = TSSetPreStep(p_ts, PreTimeStep); CHKERRXX(ierr);
       ierr = TSSetPostStep(p_ts, PostTimeStep); CHKERRXX(ierr);
@@ -192,6 +210,7 @@ protected:
 #endif
       Vec *xvec(PETScVector(x0));
       ierr = TSSetSolution(p_ts, *xvec);
+      this->p_jacobianStale = true;
     } catch (const PETSC_EXCEPTION_TYPE& e) {
       throw PETScException(ierr, e);
     }
@@ -253,6 +272,13 @@ protected:
                     << "actual time = " << maxtime
                     << std::endl;
         }
+        if (this->p_jacobianLag > 1 || this->p_matrixFree) {
+          std::cout << this->processor_rank() << ": "
+                    << "PETSc DAE Solver Jacobian built "
+                    << this->p_jacobianBuildCount << " times, reused "
+                    << this->p_jacobianReuseCount << " times"
+                    << std::endl;
+        }
       } else {
         boost::format f("%d: PETSc DAE Solver diverged after %d steps, reason : %d");
         std::string msg = 
@@ -269,6 +295,45 @@ protected:
   }
 
 
+  /// Apply the Jacobian reuse policy and build the Jacobian, if necessary
+  static PetscErrorCode p_formJacobian(PETScDAESolverImplementation *solver,
+                                       TS ts, PetscReal t, Vec x, Vec xdot,
+                                       PetscReal a, Mat jac)
+  {
+    PetscErrorCode ierr(0);
+
+    SNES snes;
+    PetscInt its(0);
+    ierr = TSGetSNES(ts, &snes); CHKERRXX(ierr);
+
+    // A matrix-free operator needs to know the current state
+    if (jac != *(solver->p_petsc_J)) {
+      BOOST_ASSERT(jac == solver->p_mfJ);
+      ierr = MatAssemblyBegin(jac, MAT_FINAL_ASSEMBLY); CHKERRXX(ierr);
+      ierr = MatAssemblyEnd(jac, MAT_FINAL_ASSEMBLY); CHKERRXX(ierr);
+
+      // The assembled Jacobian is only needed by a preconditioner
+      KSP ksp;
+      PC pc;
+      PCType pctype;
+      ierr = SNESGetKSP(snes, &ksp); CHKERRXX(ierr);
+      ierr = KSPGetPC(ksp, &pc); CHKERRXX(ierr);
+      ierr = PCGetType(pc, &pctype); CHKERRXX(ierr);
+      if (pctype != NULL && strcmp(pctype, PCNONE) == 0) return ierr;
+    }
+    ierr = SNESGetIterationNumber(snes, &its); CHKERRXX(ierr);
+
+    if (solver->p_rebuildJacobian(a, its)) {
+      boost::scoped_ptr<VectorType> 
+        xtmp(new VectorType(new PETScVectorImplementation<T, I>(x, false))),
+        xdottmp(new VectorType(new PETScVectorImplementation<T, I>(xdot, false)));
+
+      // Call the user-specified function (object) to form the Jacobian
+      (solver->p_Jbuilder)(t, *xtmp, *xdottmp, a, solver->p_J);
+    }
+    return ierr;
+  }
+
 #if PETSC_VERSION_LT(3,5,0)
 
   /// Routine to assemble Jacobian that is sent to PETSc
@@ -285,15 +350,9 @@ protected:
     // Copy PETSc's current estimate into 
 
     // Should be the case, but just make sure
-    BOOST_ASSERT(*jac == *solver->p_petsc_J);
     BOOST_ASSERT(*B == *solver->p_petsc_J);
 
-    boost::scoped_ptr<VectorType> 
-      xtmp(new VectorType(new PETScVectorImplementation<T, I>(x, false))),
-      xdottmp(new VectorType(new PETScVectorImplementation<T, I>(xdot, false)));
-
-    // Call the user-specified function (object) to form the Jacobian
-    (solver->p_Jbuilder)(t, *xtmp, *xdottmp, a, solver->p_J);
+    ierr = p_formJacobian(solver, ts, t, x, xdot, a, *jac);
 
     *flag = SAME_NONZERO_PATTERN;
 
@@ -318,15 +377,9 @@ protected:
     // Copy PETSc's current estimate into 
 
     // Should be the case, but just make sure
-    BOOST_ASSERT(jac == *(solver->p_petsc_J));
     BOOST_ASSERT(B == *(solver->p_petsc_J));
 
-    boost::scoped_ptr<VectorType> 
-      xtmp(new VectorType(new PETScVectorImplementation<T, I>(x, false))),
-      xdottmp(new VectorType(new PETScVectorImplementation<T, I>(xdot, false)));
-
-    // Call the user-specified function (object) to form the Jacobian
-    (solver->p_Jbuilder)(t, *xtmp, *xdottmp, a, solver->p_J);
+    ierr = p_formJacobian(solver, ts, t, x, xdot, a, jac);
 
     return ierr;
   
@@ -366,6 +419,18 @@ protected:
     PETScDAESolverImplementation *solver =
       (PETScDAESolverImplementation *)dummy;
 
+    // If the nonlinear solve for this step needed too many
+    // iterations, the Jacobian is probably too old
+    if (solver->p_jacobianLag > 1 && solver->p_jacobianMaxIterations > 0) {
+      SNES snes;
+      PetscInt its(0);
+      ierr = TSGetSNES(ts, &snes); CHKERRXX(ierr);
+      ierr = SNESGetIterationNumber(snes, &its); CHKERRXX(ierr);
+      if (its >= solver->p_jacobianMaxIterations) {
+        solver->p_jacobianStale = true;
+      }
+    }
+
     if (solver->p_postStepFunc) {
       PetscReal thetime;
       ierr = TSGetTime(ts, &thetime); CHKERRXX(ierr);
@@ -442,6 +507,9 @@ protected:
       state(new VectorType(new PETScVectorImplementation<T, I>(U, false)));
 
     solver->p_eventManager->handle(nevents_zero, events_zero, t, *state);
+
+    // Events are discrete changes, so the Jacobian is no longer valid
+    solver->p_jacobianStale = true;
     return ierr;
   }
 };
@@ -0,0 +1,321 @@
+// -------------------------------------------------------------
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   petsc_factorization_cache.cpp
+ *
+ * @brief  Process-wide cache of PETSc coefficient matrix
+ * factorizations shared by the direct linear solvers.
+ *
+ *
+ */
+// -------------------------------------------------------------
+
+#include <cstring>
+#include "petsc_exception.hpp"
+#include "petsc_factorization_cache.hpp"
+
+namespace gridpack {
+namespace math {
+
+// -------------------------------------------------------------
+// FNV-1a hash of a block of bytes
+// -------------------------------------------------------------
+static void
+hashBytes(unsigned long long& h, const void *buf, size_t len)
+{
+  const unsigned char *p(static_cast<const unsigned char *>(buf));
+  for (size_t i = 0; i < len; ++i) {
+    h ^= static_cast<unsigned long long>(p[i]);
+    h *= 1099511628211ULL;
+  }
+}
+
+// -------------------------------------------------------------
+//  class PETScFactorizationCache
+// -------------------------------------------------------------
+
+// -------------------------------------------------------------
+// PETScFactorizationCache:: constructors / destructor
+// -------------------------------------------------------------
+PETScFactorizationCache::PETScFactorizationCache(void)
+  : p_entries(), p_budget(512.0*1024.0*1024.0),
+    p_hits(0), p_misses(0), p_evictions(0)
+{
+}
+
+PETScFactorizationCache::~PETScFactorizationCache(void)
+{
+  try {
+    PetscBool ok;
+    PetscInitialized(&ok);
+    if (ok) clear();
+  } catch (...) {
+    // just eat it
+  }
+}
+
+// -------------------------------------------------------------
+// PETScFactorizationCache::instance
+// -------------------------------------------------------------
+PETScFactorizationCache&
+PETScFactorizationCache::instance(void)
+{
+  static PETScFactorizationCache theCache;
+  return theCache;
+}
+
+// -------------------------------------------------------------
+// PETScFactorizationCache::p_hash
+// -------------------------------------------------------------
+void
+PETScFactorizationCache::p_hash(Mat A, Key& key)
+{
+  PetscErrorCode ierr(0);
+  try {
+    MPI_Comm comm;
+    PetscInt lo, hi;
+    ierr = PetscObjectGetComm((PetscObject)A, &comm); CHKERRXX(ierr);
+    ierr = MatGetSize(A, &key.rows, &key.cols); CHKERRXX(ierr);
+    ierr = MatGetOwnershipRange(A, &lo, &hi); CHKERRXX(ierr);
+
+    // each row is hashed separately, with its global index, so the
+    // local hashes can be combined in any order
+    unsigned long long hash[2] = { 0, 0 };
+    for (PetscInt i = lo; i < hi; ++i) {
+      PetscInt ncols;
+      const PetscInt *cols;
+      const PetscScalar *vals;
+      unsigned long long ph(14695981039346656037ULL), vh(ph);
+      ierr = MatGetRow(A, i, &ncols, &cols, &vals); CHKERRXX(ierr);
+      hashBytes(ph, &i, sizeof(PetscInt));
+      hashBytes(ph, cols, ncols*sizeof(PetscInt));
+      hashBytes(vh, &i, sizeof(PetscInt));
+      hashBytes(vh, vals, ncols*sizeof(PetscScalar));
+      ierr = MatRestoreRow(A, i, &ncols, &cols, &vals); CHKERRXX(ierr);
+      hash[0] ^= ph;
+      hash[1] ^= vh;
+    }
+    unsigned long long ghash[2];
+    MPI_Allreduce(hash, ghash, 2, MPI_UNSIGNED_LONG_LONG, MPI_BXOR, comm);
+    key.pattern = ghash[0];
+    key.values = ghash[1];
+  } catch (const PETSC_EXCEPTION_TYPE& e) {
+    throw PETScException(ierr, e);
+  }
+}
+
+// -------------------------------------------------------------
+// PETScFactorizationCache::p_memory
+// -------------------------------------------------------------
+double
+PETScFactorizationCache::p_memory(Mat A)
+{
+  PetscErrorCode ierr(0);
+  double result(0.0);
+  try {
+    MatInfo info;
+    ierr = MatGetInfo(A, MAT_GLOBAL_SUM, &info); CHKERRXX(ierr);
+    result = info.memory;
+
+    // external factorization packages may not report memory
+    double nzmem(info.nz_used*(sizeof(PetscScalar) + sizeof(PetscInt)));
+    if (result < nzmem) result = nzmem;
+  } catch (const PETSC_EXCEPTION_TYPE& e) {
+    throw PETScException(ierr, e);
+  }
+  return result;
+}
+
+// -------------------------------------------------------------
+// PETScFactorizationCache::p_sameComm
+// -------------------------------------------------------------
+bool
+PETScFactorizationCache::p_sameComm(MPI_Comm c1, MPI_Comm c2)
+{
+  int result;
+  MPI_Comm_compare(c1, c2, &result);
+  return (result == MPI_IDENT || result == MPI_CONGRUENT);
+}
+
+// -------------------------------------------------------------
+// PETScFactorizationCache::p_destroy
+// -------------------------------------------------------------
+void
+PETScFactorizationCache::p_destroy(Entry& entry)
+{
+  PetscErrorCode ierr(0);
+  try {
+    ierr = PetscObjectDestroy(&entry.factor); CHKERRXX(ierr);
+    ierr = MatDestroy(&entry.A); CHKERRXX(ierr);
+  } catch (const PETSC_EXCEPTION_TYPE& e) {
+    throw PETScException(ierr, e);
+  }
+}
+
+// -------------------------------------------------------------
+// PETScFactorizationCache::find
+// -------------------------------------------------------------
+PetscObject
+PETScFactorizationCache::find(Mat A, const std::string& method, Key& key)
+{
+  PetscErrorCode ierr(0);
+  PetscObject result(NULL);
+  key.method = method;
+  p_hash(A, key);
+  try {
+    MPI_Comm comm;
+    ierr = PetscObjectGetComm((PetscObject)A, &comm); CHKERRXX(ierr);
+
+    // the entries on a communicator are in the same order on all of
+    // its processes, so every process compares the same entries
+    std::list<Entry>::iterator e;
+    for (e = p_entries.begin(); e != p_entries.end(); ++e) {
+      if (e->key.method != key.method || e->key.rows != key.rows ||
+          e->key.cols != key.cols || e->key.pattern != key.pattern ||
+          e->key.values != key.values) continue;
+      if (!p_sameComm(e->comm, comm)) continue;
+      PetscBool same;
+      ierr = MatEqual(e->A, A, &same); CHKERRXX(ierr);
+      if (same) break;
+    }
+    if (e != p_entries.end()) {
+      p_entries.splice(p_entries.begin(), p_entries, e);
+      result = p_entries.front().factor;
+      ierr = PetscObjectReference(result); CHKERRXX(ierr);
+      p_hits++;
+    } else {
+      p_misses++;
+    }
+  } catch (const PETSC_EXCEPTION_TYPE& e) {
+    throw PETScException(ierr, e);
+  }
+  return result;
+}
+
+// -------------------------------------------------------------
+// PETScFactorizationCache::insert
+// -------------------------------------------------------------
+void
+PETScFactorizationCache::insert(const Key& key, Mat A, PetscObject factor, Mat F)
+{
+  PetscErrorCode ierr(0);
+  try {
+    Entry entry;
+    entry.key = key;
+    ierr = PetscObjectGetComm((PetscObject)A, &entry.comm); CHKERRXX(ierr);
+    entry.memory = p_memory(A) + p_memory(F);
+    ierr = PetscObjectReference((PetscObject)A); CHKERRXX(ierr);
+    ierr = PetscObjectReference(factor); CHKERRXX(ierr);
+    entry.A = A;
+    entry.factor = factor;
+    p_entries.push_front(entry);
+    p_evict(entry.comm);
+  } catch (const PETSC_EXCEPTION_TYPE& e) {
+    throw PETScException(ierr, e);
+  }
+}
+
+// -------------------------------------------------------------
+// PETScFactorizationCache::p_evict
+// -------------------------------------------------------------
+void
+PETScFactorizationCache::p_evict(MPI_Comm comm)
+{
+  // memory estimates are global sums, so all processes on comm agree
+  double used(0.0);
+  std::list<Entry>::iterator e;
+  for (e = p_entries.begin(); e != p_entries.end(); ++e) {
+    if (p_sameComm(e->comm, comm)) used += e->memory;
+  }
+
+  // the newest entry (at the front) is always kept
+  std::list<Entry>::iterator first(p_entries.begin());
+  e = p_entries.end();
+  while (used > p_budget) {
+    --e;
+    if (e == first) break;
+    if (!p_sameComm(e->comm, comm)) continue;
+    used -= e->memory;
+    p_destroy(*e);
+    e = p_entries.erase(e);
+    p_evictions++;
+  }
+}
+
+// -------------------------------------------------------------
+// PETScFactorizationCache::statistics
+// -------------------------------------------------------------
+FactorizationCacheStatistics
+PETScFactorizationCache::statistics(void) const
+{
+  FactorizationCacheStatistics result;
+  result.hits = p_hits;
+  result.misses = p_misses;
+  result.evictions = p_evictions;
+  result.entries = p_entries.size();
+  result.memory = 0.0;
+  std::list<Entry>::const_iterator e;
+  for (e = p_entries.begin(); e != p_entries.end(); ++e) {
+    result.memory += e->memory;
+  }
+  result.memory /= 1024.0*1024.0;
+  result.budget = p_budget/(1024.0*1024.0);
+  return result;
+}
+
+// -------------------------------------------------------------
+// PETScFactorizationCache::budget
+// -------------------------------------------------------------
+void
+PETScFactorizationCache::budget(const double& mbytes)
+{
+  p_budget = mbytes*1024.0*1024.0;
+}
+
+// -------------------------------------------------------------
+// PETScFactorizationCache::clear
+// -------------------------------------------------------------
+void
+PETScFactorizationCache::clear(void)
+{
+  std::list<Entry>::iterator e;
+  for (e = p_entries.begin(); e != p_entries.end(); ++e) {
+    p_destroy(*e);
+  }
+  p_entries.clear();
+}
+
+// -------------------------------------------------------------
+// factorizationCacheStatistics
+// -------------------------------------------------------------
+FactorizationCacheStatistics
+factorizationCacheStatistics(void)
+{
+  return PETScFactorizationCache::instance().statistics();
+}
+
+// -------------------------------------------------------------
+// factorizationCacheBudget
+// -------------------------------------------------------------
+void
+factorizationCacheBudget(const double& mbytes)
+{
+  PETScFactorizationCache::instance().budget(mbytes);
+}
+
+// -------------------------------------------------------------
+// clearFactorizationCache
+// -------------------------------------------------------------
+void
+clearFactorizationCache(void)
+{
+  PETScFactorizationCache::instance().clear();
+}
+
+} // namespace math
+} // namespace gridpack
@@ -0,0 +1,148 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+// -------------------------------------------------------------
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   petsc_factorization_cache.hpp
+ *
+ * @brief A process-wide cache of PETSc coefficient matrix
+ * factorizations, keyed by the sparsity pattern and values of the
+ * matrix
+ *
+ *
+ */
+// -------------------------------------------------------------
+
+#ifndef _petsc_factorization_cache_hpp_
+#define _petsc_factorization_cache_hpp_
+
+#include <list>
+#include <string>
+#include <petscmat.h>
+#include "gridpack/math/factorization_cache.hpp"
+#include "gridpack/utilities/uncopyable.hpp"
+
+namespace gridpack {
+namespace math {
+
+// -------------------------------------------------------------
+//  class PETScFactorizationCache
+// -------------------------------------------------------------
+/// A cache of factorizations shared by all solvers in a process
+/**
+ * Each entry holds a copy of a coefficient matrix and an object that
+ * owns a factorization of it (a factored Mat or a direct KSP). The
+ * factorization is found again if a matrix with the same size, type,
+ * sparsity pattern and values is used with the same solution method.
+ * Entries are found with a hash of the pattern and a checksum of the
+ * values. A match is confirmed by comparing the matrix with the
+ * stored copy, so a hash collision cannot return the wrong
+ * factorization.
+ *
+ * Objects in the cache must never be changed. The cached copy of the
+ * matrix is used as the operator of a cached KSP so that PETSc never
+ * refactors it.
+ *
+ * All lookups and insertions are collective on the matrix
+ * communicator. When the factorizations on a communicator use more
+ * memory than the budget, the least recently used of them are
+ * removed.
+ */
+class PETScFactorizationCache
+  : private utility::Uncopyable
+{
+public:
+
+  /// Identifies a matrix and solution method
+  struct Key {
+    std::string method;
+    PetscInt rows, cols;
+    unsigned long long pattern;
+    unsigned long long values;
+  };
+
+  /// Get the cache of this process
+  static PETScFactorizationCache& instance(void);
+
+  /// Look for a factorization of a matrix
+  /**
+   * @param A coefficient matrix
+   * @param method description of the solution method
+   * @param key filled with the key of A, for use with insert()
+   *
+   * @return the cached factorization object, with a new reference
+   * that the caller must destroy, or NULL if there is none
+   */
+  PetscObject find(Mat A, const std::string& method, Key& key);
+
+  /// Add a factorization to the cache
+  /**
+   * The cache takes its own references to @c A and @c factor. The
+   * matrix @c A must be a copy that is never changed.
+   *
+   * @param key key from find()
+   * @param A copy of the coefficient matrix
+   * @param factor object that owns the factorization
+   * @param F factored matrix, used to estimate memory
+   */
+  void insert(const Key& key, Mat A, PetscObject factor, Mat F);
+
+  /// Get the statistics of this cache
+  FactorizationCacheStatistics statistics(void) const;
+
+  /// Set the memory budget (MB)
+  void budget(const double& mbytes);
+
+  /// Remove all entries
+  void clear(void);
+
+protected:
+
+  /// An entry in the cache
+  struct Entry {
+    Key key;
+    MPI_Comm comm;
+    Mat A;
+    PetscObject factor;
+    double memory;
+  };
+
+  /// Entries, most recently used first
+  std::list<Entry> p_entries;
+
+  /// The memory budget (bytes)
+  double p_budget;
+
+  /// Statistics
+  int p_hits, p_misses, p_evictions;
+
+  /// Default constructor.
+  PETScFactorizationCache(void);
+
+  /// Destructor
+  ~PETScFactorizationCache(void);
+
+  /// Compute the pattern hash and value checksum of a matrix
+  static void p_hash(Mat A, Key& key);
+
+  /// Estimate the memory used by a matrix (bytes)
+  static double p_memory(Mat A);
+
+  /// Are the two communicators the same group of processes
+  static bool p_sameComm(MPI_Comm c1, MPI_Comm c2);
+
+  /// Remove an entry's references
+  static void p_destroy(Entry& entry);
+
+  /// Remove entries on a communicator until within budget
+  void p_evict(MPI_Comm comm);
+};
+
+} // namespace math
+} // namespace gridpack
+
+#endif
@@ -30,6 +30,7 @@
 #include "petsc_matrix_implementation.hpp"
 #include "petsc_matrix_extractor.hpp"
 #include "petsc_exception.hpp"
+#include "petsc_factorization_cache.hpp"
 
 namespace gridpack {
 namespace math {
@@ -60,7 +61,8 @@ public:
       p_solverPackage(MATSOLVERPETSC),
 #endif    
       p_factorType(MAT_FACTOR_LU),
-      p_fill(5), p_pivot(false)
+      p_fill(5), p_pivot(false),
+      p_cacheFactorization(false)
   {
     // FIXME: maybe enforce the following: A is square, A uses sparse storage
   }
@@ -124,6 +126,9 @@ protected:
   /// Flag to enable pivoting
   bool p_pivot;
 
+  /// Share factorizations of identical matrices with other solvers
+  bool p_cacheFactorization;
+
   /// Do what is necessary to build this instance
   void p_build(const std::string& option_prefix)
   {
@@ -191,6 +196,9 @@ protected:
       }
       p_fill = props->get("Fill", p_fill);
       p_pivot = props->get("Pivot", p_pivot);
+      p_cacheFactorization = props->get("FactorizationCache", p_cacheFactorization);
+      double mbytes(props->get("FactorizationCacheMemory", -1.0));
+      if (mbytes > 0.0) factorizationCacheBudget(mbytes);
     }
 
     // FIXME: I cannot make this test work. Not sure why. It would be
@@ -222,13 +230,41 @@ protected:
     this->build(props);
   }
 
+  /// Describe the factorization method for the factorization cache
+  std::string p_cacheMethod(Mat A) const
+  {
+    PetscErrorCode ierr(0);
+    MatType mtype;
+    try {
+      ierr = MatGetType(A, &mtype); CHKERRXX(ierr);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+    return boost::str(boost::format("MatFactor %s %s %d %d %s") %
+                      p_solverPackage % p_orderingType % p_fill % p_pivot % mtype);
+  }
+
   /// Factor the coefficient matrix
+  /**
+   * If the factorization cache is used, the factored matrix is
+   * taken from the cache if possible, and new factorizations are
+   * added to it, with a copy of the coefficient matrix.
+   */
   void p_factor(void) const
   {
     PetscErrorCode ierr(0);
   
     try {
       Mat *A(PETScMatrix(*LinearMatrixSolverImplementation<T, I>::p_A));
+      PETScFactorizationCache::Key key;
+      if (p_cacheFactorization) {
+        PetscObject factor(PETScFactorizationCache::instance().find(*A, p_cacheMethod(*A), key));
+        if (factor != NULL) {
+          p_Fmat = (Mat)factor;
+          p_factored = true;
+          return;
+        }
+      }
       MatFactorInfo  info;
       IS perm, iperm;
 
@@ -243,6 +279,13 @@ protected:
       ierr = ISDestroy(&perm); CHKERRXX(ierr);
       ierr = ISDestroy(&iperm); CHKERRXX(ierr);
 
+      if (p_cacheFactorization) {
+        Mat Acopy;
+        ierr = MatDuplicate(*A, MAT_COPY_VALUES, &Acopy); CHKERRXX(ierr);
+        PETScFactorizationCache::instance().insert(key, Acopy, (PetscObject)p_Fmat, p_Fmat);
+        ierr = MatDestroy(&Acopy); CHKERRXX(ierr);
+      }
+
     } catch (const PETSC_EXCEPTION_TYPE& e) {
       throw PETScException(ierr, e);
     }
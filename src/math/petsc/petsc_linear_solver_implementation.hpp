@@ -21,6 +21,7 @@
 #define _petsc_linear_solver_implementation_hpp_
 
 #include <boost/format.hpp>
+#include <boost/tokenizer.hpp>
 
 #include <petscksp.h>
 #include "petsc/petsc_exception.hpp"
@@ -28,6 +29,7 @@
 #include "petsc_configurable.hpp"
 #include "petsc/petsc_matrix_extractor.hpp"
 #include "petsc/petsc_vector_extractor.hpp"
+#include "petsc/petsc_factorization_cache.hpp"
 
 namespace gridpack {
 namespace math {
@@ -50,7 +52,11 @@ public:
   PETScLinearSolverImplementation(MatrixType& A)
     : LinearSolverImplementation<T, I>(A),
       PETScConfigurable(this->communicator()),
-      p_matrixSet(false)
+      p_matrixSet(false),
+      p_refineKSP(NULL), p_refineA(NULL),
+      p_refineR(NULL), p_refineD(NULL), p_refineReported(false),
+      p_cacheable(false), p_cacheKSP(NULL),
+      p_cacheMat(NULL), p_cacheState(0)
   {
   }
 
@@ -63,6 +69,23 @@ public:
       ierr = PetscInitialized(&ok);
       if (ok) {
         ierr = KSPDestroy(&p_KSP); CHKERRXX(ierr);
+        if (p_cacheKSP != NULL) {
+          ierr = KSPDestroy(&p_cacheKSP); CHKERRXX(ierr);
+        }
+        if (p_refineKSP != NULL) {
+          ierr = KSPDestroy(&p_refineKSP); CHKERRXX(ierr);
+        }
+        if (p_refineR != NULL) {
+          ierr = VecDestroy(&p_refineR); CHKERRXX(ierr);
+          ierr = VecDestroy(&p_refineD); CHKERRXX(ierr);
+        }
+        if (!p_refineOption.empty()) {
+          ierr = PetscOptionsClearValue(
+#if PETSC_VERSION_GE(3,7,0)
+                                        NULL,
+#endif
+                                        p_refineOption.c_str()); CHKERRXX(ierr);
+        }
       }
     } catch (...) {
       // just eat it
@@ -78,35 +101,348 @@ protected:
   /// For constant matrices, has the coefficient matrix been set
   mutable bool p_matrixSet;
 
-  /// Do what is necessary to build this instance
-  void p_build(const std::string& option_prefix)
+  /// The PETSc solver holding the reduced precision factorization
+  KSP p_refineKSP;
+
+  /// The coefficient matrix used to compute refinement residuals
+  mutable Mat p_refineA;
+
+  /// Work vectors for the refinement residual and correction
+  mutable Vec p_refineR, p_refineD;
+
+  /// The PETSc option inserted to select the refinement precision
+  std::string p_refineOption;
+
+  /// Has the refinement factorization been described
+  mutable bool p_refineReported;
+
+  /// The PETSc option prefix of this solver
+  std::string p_optionPrefix;
+
+  /// Can factorizations be taken from the factorization cache
+  bool p_cacheable;
+
+  /// The solver, from the factorization cache, holding the current factorization
+  mutable KSP p_cacheKSP;
+
+  /// The matrix, and its PETSc object state, factored by ::p_cacheKSP
+  mutable Mat p_cacheMat;
+  mutable PetscObjectState p_cacheState;
+
+  /// Create and configure a PETSc solver
+  void p_createKSP(MPI_Comm comm, const std::string& option_prefix, KSP& ksp) const
   {
-    PetscErrorCode ierr;
+    PetscErrorCode ierr(0);
     try  {
-      parallel::Communicator comm(this->communicator());
-      if (this->p_doSerial) {
-        comm = this->communicator().self();
-      }
-      ierr = KSPCreate(comm, &p_KSP); CHKERRXX(ierr);
+      ierr = KSPCreate(comm, &ksp); CHKERRXX(ierr);
       if (!this->p_guessZero) {
-        ierr = KSPSetInitialGuessNonzero(p_KSP,PETSC_TRUE); CHKERRXX(ierr); 
+        ierr = KSPSetInitialGuessNonzero(ksp,PETSC_TRUE); CHKERRXX(ierr); 
       } else {
-        ierr = KSPSetInitialGuessNonzero(p_KSP,PETSC_FALSE); CHKERRXX(ierr); 
+        ierr = KSPSetInitialGuessNonzero(ksp,PETSC_FALSE); CHKERRXX(ierr); 
       }
-      ierr = KSPSetOptionsPrefix(p_KSP, option_prefix.c_str()); CHKERRXX(ierr);
+      ierr = KSPSetOptionsPrefix(ksp, option_prefix.c_str()); CHKERRXX(ierr);
 
-      ierr = KSPSetTolerances(p_KSP, 
+      ierr = KSPSetTolerances(ksp, 
                               LinearSolverImplementation<T, I>::p_relativeTolerance, 
                               LinearSolverImplementation<T, I>::p_solutionTolerance, 
                               PETSC_DEFAULT,
                               LinearSolverImplementation<T, I>::p_maxIterations); CHKERRXX(ierr);
 
-      ierr = KSPSetFromOptions(p_KSP);CHKERRXX(ierr);
+      ierr = KSPSetFromOptions(ksp);CHKERRXX(ierr);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+  }
+
+  /// Do what is necessary to build this instance
+  void p_build(const std::string& option_prefix)
+  {
+    PetscErrorCode ierr;
+    try  {
+      parallel::Communicator comm(this->communicator());
+      if (this->p_doSerial) {
+        comm = this->communicator().self();
+      }
+      p_optionPrefix = option_prefix;
+      p_createKSP(comm, option_prefix, p_KSP);
+
+      if (this->p_refine) {
+        p_buildRefinement(comm, option_prefix + "refine_");
+      }
+
+      if (this->p_cacheMemory > 0.0) {
+        factorizationCacheBudget(this->p_cacheMemory);
+      }
+      if (this->p_cacheFactorization && !this->p_refine) {
+        p_cacheable = p_isDirect();
+        if (!p_cacheable && this->processor_rank() == 0) {
+          std::cerr << this->configurationKey() << ": "
+                    << "factorization cache is only used with direct solvers "
+                    << "(-ksp_type preonly -pc_type lu or cholesky)"
+                    << std::endl;
+        }
+      }
     } catch (const PETSC_EXCEPTION_TYPE& e) {
       throw PETScException(ierr, e);
     }
   }  
 
+  /// Build the solver used for iterative refinement
+  /**
+   * The refinement solver applies a direct factorization of the
+   * coefficient matrix once per refinement iteration. If the
+   * requested precision is "single," the factorization is done by
+   * MUMPS, which is asked to factor and store the matrix in single
+   * precision. This needs the -pc_precision option, which is only
+   * available in PETSc 3.22 and later. Any part of this can be changed
+   * with PETSc options using the "refine_" prefix following the
+   * solver's prefix.
+   *
+   * @param comm communicator used by the solver
+   * @param option_prefix PETSc option prefix for the refinement solver
+   */
+  void p_buildRefinement(const parallel::Communicator& comm,
+                         const std::string& option_prefix)
+  {
+    PetscErrorCode ierr(0);
+    try {
+      PC pc;
+      ierr = KSPCreate(comm, &p_refineKSP); CHKERRXX(ierr);
+      ierr = KSPSetOptionsPrefix(p_refineKSP, option_prefix.c_str()); CHKERRXX(ierr);
+      ierr = KSPSetType(p_refineKSP, KSPPREONLY); CHKERRXX(ierr);
+      ierr = KSPGetPC(p_refineKSP, &pc); CHKERRXX(ierr);
+      ierr = PCSetType(pc, PCLU); CHKERRXX(ierr);
+
+      if (this->p_refinePrecision == "single") {
+#if defined(PETSC_HAVE_MUMPS) && PETSC_VERSION_GE(3,22,0)
+        ierr = PCFactorSetMatSolverType(pc, MATSOLVERMUMPS); CHKERRXX(ierr);
+        std::string opt("-" + option_prefix + "pc_precision");
+        PetscBool isset;
+        ierr = PetscOptionsHasName(
+#if PETSC_VERSION_GE(3,7,0)
+                                   NULL,
+#endif
+                                   NULL, opt.c_str(), &isset); CHKERRXX(ierr);
+        if (!isset) {
+          ierr = PetscOptionsSetValue(
+#if PETSC_VERSION_GE(3,7,0)
+                                      NULL,
+#endif
+                                      opt.c_str(), "single"); CHKERRXX(ierr);
+          p_refineOption = opt;
+        }
+#else
+        if (this->processor_rank() == 0) {
+          std::cerr << "PETSc was built without MUMPS or is older than 3.22: "
+                    << "iterative refinement will use a full precision factorization"
+                    << std::endl;
+        }
+#endif
+      } else if (this->p_refinePrecision != "double") {
+        std::string msg =
+          boost::str(boost::format("%s PETSc configuration: unrecognized \"RefinementPrecision\": \"%s\"") %
+                     this->configurationKey() % this->p_refinePrecision);
+        throw Exception(msg);
+      }
+
+      ierr = KSPSetFromOptions(p_refineKSP);CHKERRXX(ierr);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+  }
+
+  /// Is the PETSc solver a direct solver
+  bool p_isDirect(void) const
+  {
+    PetscErrorCode ierr(0);
+    try {
+      KSPType ktype;
+      PCType ptype;
+      PC pc;
+      ierr = KSPGetType(p_KSP, &ktype); CHKERRXX(ierr);
+      ierr = KSPGetPC(p_KSP, &pc); CHKERRXX(ierr);
+      ierr = PCGetType(pc, &ptype); CHKERRXX(ierr);
+      if (ktype == NULL || ptype == NULL) return false;
+      std::string sktype(ktype), sptype(ptype);
+      return (sktype == KSPPREONLY && (sptype == PCLU || sptype == PCCHOLESKY));
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+    return false;
+  }
+
+  /// Describe the solution method for the factorization cache
+  std::string p_cacheMethod(Mat A) const
+  {
+    PetscErrorCode ierr(0);
+    std::string result("KSP");
+    try {
+      KSPType ktype;
+      PCType ptype;
+      MatType mtype;
+      PC pc;
+#if PETSC_VERSION_LT(3,9,0)
+      MatSolverPackage pkg;
+#else
+      MatSolverType pkg;
+#endif
+      ierr = KSPGetType(p_KSP, &ktype); CHKERRXX(ierr);
+      ierr = KSPGetPC(p_KSP, &pc); CHKERRXX(ierr);
+      ierr = PCGetType(pc, &ptype); CHKERRXX(ierr);
+#if PETSC_VERSION_LT(3,9,0)
+      ierr = PCFactorGetMatSolverPackage(pc, &pkg); CHKERRXX(ierr);
+#else
+      ierr = PCFactorGetMatSolverType(pc, &pkg); CHKERRXX(ierr);
+#endif
+      ierr = MatGetType(A, &mtype); CHKERRXX(ierr);
+      result = boost::str(boost::format("KSP \"%s\" %s %s %s %s%s") %
+                          p_optionPrefix % ktype % ptype %
+                          (pkg != NULL ? pkg : "default") % mtype %
+                          p_factorOptions());
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+    return result;
+  }
+
+  /// Get the PETSc options of this solver that change a factorization
+  /**
+   * These are the factor options of the preconditioner (ordering,
+   * pivoting, shifts, etc.) and the options of the factorization
+   * package (MUMPS ICNTL and CNTL, etc.) that are set in the PETSc
+   * options database with this solver's prefix. Each option is
+   * returned with its value, preceded by a blank, so that solvers
+   * configured differently do not share factorizations.
+   */
+  std::string p_factorOptions(void) const
+  {
+    PetscErrorCode ierr(0);
+    std::string result;
+    try {
+      char *all(NULL);
+      ierr = PetscOptionsGetAll(
+#if PETSC_VERSION_GE(3,7,0)
+                                NULL,
+#endif
+                                &all); CHKERRXX(ierr);
+      std::string opts(all != NULL ? all : "");
+      ierr = PetscFree(all); CHKERRXX(ierr);
+
+      std::string lead("-" + p_optionPrefix);
+      boost::char_separator<char> sep(" \t\f\n\r\v", "");
+      boost::tokenizer<boost::char_separator<char> > opttok(opts, sep);
+      boost::tokenizer<boost::char_separator<char> >::iterator o;
+      bool keep(false);
+      for (o = opttok.begin(); o != opttok.end(); ++o) {
+        if ((*o)[0] == '-' && islower((*o)[1])) {
+          keep = false;
+          if (o->compare(0, lead.size(), lead) == 0) {
+            std::string name(o->substr(lead.size()));
+            keep = (name.compare(0, 10, "pc_factor_") == 0 ||
+                    name.compare(0, 4, "mat_") == 0);
+          }
+        }
+        if (keep) {
+          result.append(" ");
+          result.append(*o);
+        }
+      }
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+    return result;
+  }
+
+  /// Get the factorization of a matrix from the factorization cache
+  /**
+   * If the matrix is not in the cache, a copy is factored by a new
+   * solver configured like this one, and both are added to the
+   * cache. The cached solver becomes ::p_cacheKSP. The cached copy is
+   * the solver's operator, so the factorization is never changed.
+   * The lookup is skipped if A is the matrix used for the last lookup
+   * and its object state has not changed since. The state is increased
+   * on all processes when the matrix is assembled, so all processes
+   * make the same choice.
+   *
+   * @param A coefficient matrix
+   */
+  void p_cachedFactor(Mat A) const
+  {
+    PetscErrorCode ierr(0);
+    try {
+      PetscObjectState state;
+      ierr = PetscObjectStateGet((PetscObject)A, &state); CHKERRXX(ierr);
+      if (p_cacheKSP != NULL && A == p_cacheMat && state == p_cacheState) {
+        return;
+      }
+      p_cacheMat = A;
+      p_cacheState = state;
+
+      PETScFactorizationCache& cache(PETScFactorizationCache::instance());
+      PETScFactorizationCache::Key key;
+      PetscObject factor(cache.find(A, p_cacheMethod(A), key));
+      if (p_cacheKSP != NULL) {
+        ierr = KSPDestroy(&p_cacheKSP); CHKERRXX(ierr);
+      }
+      if (factor != NULL) {
+        p_cacheKSP = (KSP)factor;
+        return;
+      }
+
+      MPI_Comm comm;
+      Mat Acopy, F;
+      PC pc;
+      ierr = PetscObjectGetComm((PetscObject)p_KSP, &comm); CHKERRXX(ierr);
+      ierr = MatDuplicate(A, MAT_COPY_VALUES, &Acopy); CHKERRXX(ierr);
+      p_createKSP(comm, p_optionPrefix, p_cacheKSP);
+#if PETSC_VERSION_LT(3,5,0)
+      ierr = KSPSetOperators(p_cacheKSP, Acopy, Acopy, SAME_NONZERO_PATTERN); CHKERRXX(ierr);
+#else
+      ierr = KSPSetOperators(p_cacheKSP, Acopy, Acopy); CHKERRXX(ierr);
+#endif
+      ierr = KSPSetUp(p_cacheKSP); CHKERRXX(ierr);
+      ierr = KSPGetPC(p_cacheKSP, &pc); CHKERRXX(ierr);
+      ierr = PCFactorGetMatrix(pc, &F); CHKERRXX(ierr);
+      cache.insert(key, Acopy, (PetscObject)p_cacheKSP, F);
+      ierr = MatDestroy(&Acopy); CHKERRXX(ierr);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+  }
+
+  /// Adjust the preconditioner for block matrix storage
+  /**
+   * Point Jacobi is replaced by point-block Jacobi if the coefficient
+   * matrix uses block storage. ILU is not available for symmetric
+   * block storage, so it is replaced by incomplete Cholesky.
+   */
+  void p_blockPreconditioner(Mat& A) const
+  {
+    PetscErrorCode ierr(0);
+    try {
+      MatType mtype;
+      ierr = MatGetType(A, &mtype); CHKERRXX(ierr);
+      std::string stype(mtype);
+      bool symmetric(stype == MATSEQSBAIJ || stype == MATMPISBAIJ);
+      bool block(symmetric || stype == MATSEQBAIJ || stype == MATMPIBAIJ);
+      if (!block) return;
+
+      PC pc;
+      PCType ptype;
+      ierr = KSPGetPC(p_KSP, &pc); CHKERRXX(ierr);
+      ierr = PCGetType(pc, &ptype); CHKERRXX(ierr);
+      if (ptype == NULL) return;
+      std::string sptype(ptype);
+      if (sptype == PCJACOBI) {
+        ierr = PCSetType(pc, PCPBJACOBI); CHKERRXX(ierr);
+      } else if (symmetric && sptype == PCILU) {
+        ierr = PCSetType(pc, PCICC); CHKERRXX(ierr);
+      }
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+  }
+
   /// Solve w/ the specified RHS and estimate (result in x)
   void p_solveImpl(MatrixType& A, const VectorType& b, VectorType& x) const
   {
@@ -116,12 +452,23 @@ protected:
 
       if (p_matrixSet && this->p_constSerialMatrix) {
         // KSPSetOperators can be skipped
+      } else if (p_cacheable) {
+        p_cachedFactor(*Amat);
+        p_matrixSet = true;
       } else {
 #if PETSC_VERSION_LT(3,5,0)
         ierr = KSPSetOperators(p_KSP, *Amat, *Amat, SAME_NONZERO_PATTERN); CHKERRXX(ierr);
+        if (p_refineKSP != NULL) {
+          ierr = KSPSetOperators(p_refineKSP, *Amat, *Amat, SAME_NONZERO_PATTERN); CHKERRXX(ierr);
+        }
 #else
         ierr = KSPSetOperators(p_KSP, *Amat, *Amat); CHKERRXX(ierr);
+        if (p_refineKSP != NULL) {
+          ierr = KSPSetOperators(p_refineKSP, *Amat, *Amat); CHKERRXX(ierr);
+        }
 #endif
+        p_refineA = *Amat;
+        if (!p_matrixSet) p_blockPreconditioner(*Amat);
         p_matrixSet = true;
       }
 
@@ -143,13 +490,19 @@ protected:
       const Vec *bvec(PETScVector(b));
       Vec *xvec(PETScVector(x));
 
-      ierr = KSPSolve(p_KSP, *bvec, *xvec); CHKERRXX(ierr);
+      if (p_refineKSP != NULL) {
+        if (p_refineSolve(*bvec, *xvec)) return;
+        this->p_refineFallbacks++;
+      }
+
+      KSP ksp(p_cacheKSP != NULL ? p_cacheKSP : p_KSP);
+      ierr = KSPSolve(ksp, *bvec, *xvec); CHKERRXX(ierr);
       int its;
       KSPConvergedReason reason;
       PetscReal rnorm;
-      ierr = KSPGetIterationNumber(p_KSP, &its); CHKERRXX(ierr);
-      ierr = KSPGetConvergedReason(p_KSP, &reason); CHKERRXX(ierr);
-      ierr = KSPGetResidualNorm(p_KSP, &rnorm); CHKERRXX(ierr);
+      ierr = KSPGetIterationNumber(ksp, &its); CHKERRXX(ierr);
+      ierr = KSPGetConvergedReason(ksp, &reason); CHKERRXX(ierr);
+      ierr = KSPGetResidualNorm(ksp, &rnorm); CHKERRXX(ierr);
       std::string msg;
       if (reason < 0) {
         msg = 
@@ -170,6 +523,169 @@ protected:
   }    
   
 
+  /// Solve using the reduced precision factorization and refinement
+  /**
+   * The residual of the current solution estimate is computed in full
+   * precision, and the correction is computed with the reduced
+   * precision factorization. This is repeated until the residual norm
+   * is reduced by the refinement tolerance.
+   *
+   * @param b right hand side
+   * @param x solution estimate, replaced with the refined solution
+   *
+   * @return true if refinement converged, false if it stalled or
+   * reached the maximum number of iterations
+   */
+  bool p_refineSolve(const Vec& b, Vec& x) const
+  {
+    PetscErrorCode ierr(0);
+    int me(this->processor_rank());
+    bool converged(false);
+    try {
+      if (p_refineR == NULL) {
+        ierr = VecDuplicate(b, &p_refineR); CHKERRXX(ierr);
+        ierr = VecDuplicate(b, &p_refineD); CHKERRXX(ierr);
+      }
+      this->p_refineIterations = 0;
+
+      PetscReal bnorm, rnorm, rlast;
+      ierr = VecNorm(b, NORM_2, &bnorm); CHKERRXX(ierr);
+      if (bnorm == 0.0) {
+        ierr = VecSet(x, 0.0); CHKERRXX(ierr);
+        return true;
+      }
+      if (this->p_guessZero) {
+        ierr = VecSet(x, 0.0); CHKERRXX(ierr);
+        ierr = VecCopy(b, p_refineR); CHKERRXX(ierr);
+      } else {
+        ierr = MatMult(p_refineA, x, p_refineR); CHKERRXX(ierr);
+        ierr = VecAYPX(p_refineR, -1.0, b); CHKERRXX(ierr);
+      }
+      ierr = VecNorm(p_refineR, NORM_2, &rnorm); CHKERRXX(ierr);
+
+      double tol(this->p_refineTolerance*bnorm);
+      while (rnorm > tol && this->p_refineIterations < this->p_refineMaxIterations) {
+        KSPConvergedReason reason;
+        ierr = KSPSolve(p_refineKSP, p_refineR, p_refineD); CHKERRXX(ierr);
+        ierr = KSPGetConvergedReason(p_refineKSP, &reason); CHKERRXX(ierr);
+        if (reason < 0) break;
+        if (!p_refineReported) p_reportRefinement();
+        ierr = VecAXPY(x, 1.0, p_refineD); CHKERRXX(ierr);
+        ierr = MatMult(p_refineA, x, p_refineR); CHKERRXX(ierr);
+        ierr = VecAYPX(p_refineR, -1.0, b); CHKERRXX(ierr);
+        rlast = rnorm;
+        ierr = VecNorm(p_refineR, NORM_2, &rnorm); CHKERRXX(ierr);
+        this->p_refineIterations++;
+        if (!(rnorm < this->p_refineStallFactor*rlast)) break;
+      }
+      converged = (rnorm <= tol);
+
+      // do not hand a useless estimate to the full precision solver
+      if (!converged && !(rnorm < bnorm)) {
+        ierr = VecSet(x, 0.0); CHKERRXX(ierr);
+      }
+
+      if (me == 0) {
+        std::string msg;
+        if (converged) {
+          msg = 
+            boost::str(boost::format("%d: PETSc refinement converged after %d iterations, relative residual: %g") % 
+                       me % this->p_refineIterations % (rnorm/bnorm));
+        } else {
+          msg = 
+            boost::str(boost::format("%d: PETSc refinement stalled after %d iterations, relative residual: %g, solving in full precision") % 
+                       me % this->p_refineIterations % (rnorm/bnorm));
+        }
+        std::cerr << msg << std::endl;
+      }
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+    return converged;
+  }
+
+  /// Describe the refinement factorization once it has been computed
+  /**
+   * The solver package, the precision actually used and the memory
+   * used by the factorization are printed once. The precision is taken
+   * from the -pc_precision option if PETSc used it, otherwise the
+   * factorization is in full precision.
+   */
+  void p_reportRefinement(void) const
+  {
+    PetscErrorCode ierr(0);
+    try {
+      PC pc;
+      Mat F;
+      MatInfo info;
+#if PETSC_VERSION_LT(3,9,0)
+      MatSolverPackage pkg;
+#else
+      MatSolverType pkg;
+#endif
+      ierr = KSPGetPC(p_refineKSP, &pc); CHKERRXX(ierr);
+#if PETSC_VERSION_LT(3,9,0)
+      ierr = PCFactorGetMatSolverPackage(pc, &pkg); CHKERRXX(ierr);
+#else
+      ierr = PCFactorGetMatSolverType(pc, &pkg); CHKERRXX(ierr);
+#endif
+      ierr = PCFactorGetMatrix(pc, &F); CHKERRXX(ierr);
+      ierr = MatGetInfo(F, MAT_GLOBAL_SUM, &info); CHKERRXX(ierr);
+
+      // external factorization packages may not report memory
+      double memory(info.memory);
+      double nzmem(info.nz_used*(sizeof(PetscScalar) + sizeof(PetscInt)));
+      if (memory < nzmem) memory = nzmem;
+
+      const char *prefix;
+      ierr = KSPGetOptionsPrefix(p_refineKSP, &prefix); CHKERRXX(ierr);
+      std::string opt("-" + std::string(prefix != NULL ? prefix : "") +
+                      "pc_precision");
+      PetscBool isset(PETSC_FALSE), used(PETSC_FALSE);
+      ierr = PetscOptionsHasName(
+#if PETSC_VERSION_GE(3,7,0)
+                                 NULL,
+#endif
+                                 NULL, opt.c_str(), &isset); CHKERRXX(ierr);
+      if (isset) {
+        ierr = PetscOptionsUsed(
+#if PETSC_VERSION_GE(3,7,0)
+                                NULL,
+#endif
+                                opt.c_str(), &used); CHKERRXX(ierr);
+      }
+      std::string precision("double");
+      if (used) {
+        char value[32];
+        PetscBool flg;
+        ierr = PetscOptionsGetString(
+#if PETSC_VERSION_GE(3,7,0)
+                                     NULL,
+#endif
+                                     NULL, opt.c_str(), value, sizeof(value),
+                                     &flg); CHKERRXX(ierr);
+        if (flg) precision = value;
+      }
+      if (this->processor_rank() == 0) {
+        if (isset && !used) {
+          std::cerr << this->configurationKey() << ": "
+                    << opt << " was not used: "
+                    << "iterative refinement uses a full precision factorization"
+                    << std::endl;
+        }
+        std::string msg =
+          boost::str(boost::format("%s: refinement factorization: %s, %s precision, %.1f MB") %
+                     this->configurationKey() %
+                     (pkg != NULL ? pkg : "default") % precision %
+                     (memory/1048576.0));
+        std::cerr << msg << std::endl;
+      }
+      p_refineReported = true;
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+  }
+
   /// Specialized way to configure from property tree
   void p_configure(utility::Configuration::CursorPtr props)
   {
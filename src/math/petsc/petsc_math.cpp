@@ -16,6 +16,7 @@
  */
 // -------------------------------------------------------------
 
+#include <cstdio>
 #include <petscsys.h>
 #if USE_PROGRESS_RANKS
 #include "ga-mpi.h"
@@ -89,6 +90,20 @@ Finalize(void)
 {
   if (!Initialized()) return;
   PetscErrorCode ierr(0);
+
+  // cached factorizations must be destroyed before PETSc is shut down
+  FactorizationCacheStatistics stats(factorizationCacheStatistics());
+  if (stats.hits + stats.misses > 0) {
+    int me;
+    MPI_Comm_rank(PETSC_COMM_WORLD, &me);
+    if (me == 0) {
+      printf("Factorization cache: %d hits, %d misses, %d evictions,"
+             " %d entries using %.1f MB\n", stats.hits, stats.misses,
+             stats.evictions, stats.entries, stats.memory);
+    }
+  }
+  clearFactorizationCache();
+
   try {
     ierr = PetscFinalize(); CHKERRXX(ierr);
   } catch (const PETSC_EXCEPTION_TYPE& e) {
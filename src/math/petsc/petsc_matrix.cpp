@@ -164,6 +164,47 @@ MatrixT<RealType>::createDense(const parallel::Communicator& comm,
                                const int& local_cols);
 
 
+// -------------------------------------------------------------
+// Matrix::createBlock
+// -------------------------------------------------------------
+template <typename T, typename I>
+MatrixT<T, I> *
+MatrixT<T, I>::createBlock(const parallel::Communicator& comm,
+                           const int& local_rows,
+                           const int& local_cols,
+                           const int& block_size,
+                           const int& max_blocks_per_row,
+                           const MatrixStorageType& stype)
+{
+  PETScMatrixImplementation<T, I> *impl = 
+    PETScMatrixImplementation<T, I>::createBlock(comm, 
+                                                 local_rows, local_cols,
+                                                 block_size,
+                                                 max_blocks_per_row,
+                                                 (stype == SymmetricBlock));
+  MatrixT<T, I> *result = new MatrixT<T, I>(impl);
+  return result;
+}
+
+template 
+MatrixT<ComplexType> *
+MatrixT<ComplexType>::createBlock(const parallel::Communicator& comm,
+                                  const int& local_rows,
+                                  const int& local_cols,
+                                  const int& block_size,
+                                  const int& max_blocks_per_row,
+                                  const MatrixStorageType& stype);
+
+template 
+MatrixT<RealType> *
+MatrixT<RealType>::createBlock(const parallel::Communicator& comm,
+                               const int& local_rows,
+                               const int& local_cols,
+                               const int& block_size,
+                               const int& max_blocks_per_row,
+                               const MatrixStorageType& stype);
+
+
 // -------------------------------------------------------------
 // Matrix::equate
 // -------------------------------------------------------------
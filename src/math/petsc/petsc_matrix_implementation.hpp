@@ -164,6 +164,94 @@ public:
     return result;
   }
 
+  /// Create a block sparse matrix
+  /** 
+   * The PETSc block size is @c block_size times ::elementSize, so a
+   * complex matrix stored in a real PETSc build gets (at least) 2x2
+   * real blocks. If the resulting block size is one, ordinary AIJ
+   * storage is used. Symmetric block storage is only possible if
+   * matrix elements map directly to PETSc scalars.
+   * 
+   * @param comm parallel environment
+   * @param local_rows number of locally owned rows
+   * @param local_cols number of locally owned columns
+   * @param block_size number of rows/columns in each block
+   * @param max_blocks_per_row estimate of nonzero blocks in each block row
+   * @param symmetric use SBAIJ storage, keeping only the upper triangle
+   * 
+   * @return new implementation
+   */
+  static 
+  PETScMatrixImplementation *
+  createBlock(const parallel::Communicator& comm,
+              const IdxType& local_rows, 
+              const IdxType& local_cols,
+              const IdxType& block_size,
+              const IdxType& max_blocks_per_row,
+              const bool& symmetric)
+  {
+    PetscErrorCode ierr(0);
+    Mat mtmp;
+    PETScMatrixImplementation *result;
+    PetscInt bs(block_size*elementSize);
+    PetscInt lrow(local_rows*elementSize);
+    PetscInt lcol(local_cols*elementSize);
+    if (bs < 1 || lrow % bs != 0 || lcol % bs != 0) {
+      std::string msg = 
+        boost::str(boost::format("PETScMatrixImplementation::createBlock: "
+                                 "local size (%d x %d) is not a multiple of "
+                                 "block size %d") % 
+                   local_rows % local_cols % block_size);
+      throw Exception(msg);
+    }
+    if (symmetric && elementSize > 1) {
+      throw Exception("PETScMatrixImplementation::createBlock: "
+                      "symmetric block storage requires complex PETSc "
+                      "for complex matrices");
+    }
+    PetscInt nz(max_blocks_per_row > 0 ? max_blocks_per_row : PETSC_DEFAULT);
+    try {
+      ierr = MatCreate(comm, &mtmp); CHKERRXX(ierr);
+      ierr = MatSetSizes(mtmp, lrow, lcol, 
+                         PETSC_DETERMINE, PETSC_DETERMINE); CHKERRXX(ierr);
+      if (symmetric) {
+        if (comm.size() == 1) {
+          ierr = MatSetType(mtmp, MATSEQSBAIJ); CHKERRXX(ierr);
+          ierr = MatSeqSBAIJSetPreallocation(mtmp, bs, nz, PETSC_NULL); CHKERRXX(ierr);
+        } else {
+          ierr = MatSetType(mtmp, MATMPISBAIJ); CHKERRXX(ierr);
+          ierr = MatMPISBAIJSetPreallocation(mtmp, bs, nz, PETSC_NULL,
+                                             nz, PETSC_NULL); CHKERRXX(ierr);
+        }
+        ierr = MatSetOption(mtmp, MAT_IGNORE_LOWER_TRIANGULAR, PETSC_TRUE); CHKERRXX(ierr);
+      } else if (bs > 1) {
+        if (comm.size() == 1) {
+          ierr = MatSetType(mtmp, MATSEQBAIJ); CHKERRXX(ierr);
+          ierr = MatSeqBAIJSetPreallocation(mtmp, bs, nz, PETSC_NULL); CHKERRXX(ierr);
+        } else {
+          ierr = MatSetType(mtmp, MATMPIBAIJ); CHKERRXX(ierr);
+          ierr = MatMPIBAIJSetPreallocation(mtmp, bs, nz, PETSC_NULL,
+                                            nz, PETSC_NULL); CHKERRXX(ierr);
+        }
+      } else {
+        if (comm.size() == 1) {
+          ierr = MatSetType(mtmp, MATSEQAIJ); CHKERRXX(ierr);
+          ierr = MatSeqAIJSetPreallocation(mtmp, nz, PETSC_NULL); CHKERRXX(ierr);
+        } else {
+          ierr = MatSetType(mtmp, MATMPIAIJ); CHKERRXX(ierr);
+          ierr = MatMPIAIJSetPreallocation(mtmp, nz, PETSC_NULL,
+                                           nz, PETSC_NULL); CHKERRXX(ierr);
+        }
+      }
+      // the number of blocks per row is only an estimate
+      ierr = MatSetOption(mtmp, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE); CHKERRXX(ierr);
+      result = new PETScMatrixImplementation(mtmp, false);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+    return result;
+  }
+
   /// Get the PETSc matrix
   Mat *getMatrix(void)
   {
@@ -181,6 +269,12 @@ protected:
   /// The actual PETSc matrix to be used
   boost::scoped_ptr<PetscMatrixWrapper> p_mwrap;
 
+  /// Work space used to insert blocks of values
+  std::vector<PetscScalar> p_blockValues;
+
+  /// Row and column indexes used to insert blocks of values
+  std::vector<PetscInt> p_blockRows, p_blockCols;
+
   /// Apply a specific unary operation to the vector
   void p_applyOperation(base_unary_function<TheType>& op)
   {
@@ -386,6 +480,72 @@ protected:
     }
   }
 
+  /// Set or add to a dense block of elements
+  /** 
+   * The block is converted to a row-ordered array of PETSc scalars.
+   * If it is exactly one aligned block of a block matrix, it is
+   * inserted with MatSetValuesBlocked(), otherwise with a single
+   * MatSetValues() call.
+   */
+  void p_setOrAddBlock(const IdxType& i, const IdxType& j, 
+                       const IdxType& m, const IdxType& n, 
+                       const TheType *x, InsertMode mode)
+  {
+    PetscErrorCode ierr(0);
+    try {
+      Mat *mat = p_mwrap->getMatrix();
+      const int es(elementSize);
+      PetscInt prows(m*es), pcols(n*es);
+      p_blockValues.resize(prows*pcols);
+      PetscScalar px[elementSize*elementSize];
+      for (IdxType c = 0; c < n; ++c) {
+        for (IdxType r = 0; r < m; ++r) {
+          TheType tmp(x[c*m + r]);
+          MatrixValueTransferToLibrary<TheType, PetscScalar> trans(1, &tmp, &px[0]);
+          trans.go();
+          for (int a = 0; a < es; ++a) {
+            for (int b = 0; b < es; ++b) {
+              p_blockValues[(r*es + a)*pcols + c*es + b] = px[a*es + b];
+            }
+          }
+        }
+      }
+
+      PetscInt bs;
+      ierr = MatGetBlockSize(*mat, &bs); CHKERRXX(ierr);
+      PetscInt pi(i*es), pj(j*es);
+      if (bs > 1 && prows == bs && pcols == bs && 
+          pi % bs == 0 && pj % bs == 0) {
+        PetscInt ib(pi/bs), jb(pj/bs);
+        ierr = MatSetValuesBlocked(*mat, 1, &ib, 1, &jb, 
+                                   &p_blockValues[0], mode); CHKERRXX(ierr);
+      } else {
+        p_blockRows.resize(prows);
+        p_blockCols.resize(pcols);
+        for (PetscInt k = 0; k < prows; ++k) p_blockRows[k] = pi + k;
+        for (PetscInt k = 0; k < pcols; ++k) p_blockCols[k] = pj + k;
+        ierr = MatSetValues(*mat, prows, &p_blockRows[0], pcols, &p_blockCols[0],
+                            &p_blockValues[0], mode); CHKERRXX(ierr);
+      }
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+  }
+
+  /// Set a dense block of elements (specialized)
+  void p_setBlock(const IdxType& i, const IdxType& j, 
+                  const IdxType& m, const IdxType& n, const TheType *x)
+  {
+    p_setOrAddBlock(i, j, m, n, x, INSERT_VALUES);
+  }
+
+  /// Add to a dense block of elements (specialized)
+  void p_addBlock(const IdxType& i, const IdxType& j, 
+                  const IdxType& m, const IdxType& n, const TheType *x)
+  {
+    p_setOrAddBlock(i, j, m, n, x, ADD_VALUES);
+  }
+
   /// Get an individual element
   void p_getElement(const IdxType& i, const IdxType& j, TheType& x) const
   {
@@ -492,6 +492,14 @@ MatrixT<T, I>::storageType(void) const
                stype == MATSEQAIJ || 
                stype == MATMPIAIJ) {
       result = Sparse;
+    } else if (stype == MATBAIJ || 
+               stype == MATSEQBAIJ || 
+               stype == MATMPIBAIJ) {
+      result = Block;
+    } else if (stype == MATSBAIJ || 
+               stype == MATSEQSBAIJ || 
+               stype == MATMPISBAIJ) {
+      result = SymmetricBlock;
     } else {
       std::string msg("Matrix: unexpected PETSc storage type: ");
       msg += "\"";
@@ -540,6 +548,20 @@ storageType(const MatrixT<T, I>& A, const MatrixStorageType& new_type)
         new_mat_type = MATSEQAIJ;
       } 
       break;
+    case (Block):
+      if (nproc > 1) {
+        new_mat_type = MATMPIBAIJ;
+      } else {
+        new_mat_type = MATSEQBAIJ;
+      } 
+      break;
+    case (SymmetricBlock):
+      if (nproc > 1) {
+        new_mat_type = MATMPISBAIJ;
+      } else {
+        new_mat_type = MATSEQSBAIJ;
+      } 
+      break;
     }
   
     const Mat *Amat(PETScMatrix(A));
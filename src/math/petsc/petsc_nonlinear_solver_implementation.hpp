@@ -153,12 +153,17 @@ protected:
     p_petsc_X = PETScVector(*(this->p_X));
     int me(this->processor_rank());
 
+    // FormJacobian() counts the factorizations
+    this->p_iterationCount = 0;
+    this->p_factorizationCount = 0;
+
     try {
       ierr = SNESSolve(p_snes, NULL, *p_petsc_X); CHKERRXX(ierr);
       SNESConvergedReason reason;
       PetscInt iter;
       ierr = SNESGetConvergedReason(p_snes, &reason); CHKERRXX(ierr);
       ierr = SNESGetIterationNumber(p_snes, &iter); CHKERRXX(ierr);
+      this->p_iterationCount = iter;
 
       std::string msg;
       if (reason < 0) {
@@ -213,6 +218,7 @@ protected:
 
     // Call the user-specified function (object) to form the Jacobian
     (solver->p_jacobian)(*(solver->p_X), *(solver->p_J));
+    solver->p_factorizationCount += 1;
 
     *flag = SAME_NONZERO_PATTERN;
 
@@ -244,6 +250,7 @@ protected:
 
     // Call the user-specified function (object) to form the Jacobian
     (solver->p_jacobian)(*(solver->p_X), *(solver->p_J));
+    solver->p_factorizationCount += 1;
 
     return ierr;
   }
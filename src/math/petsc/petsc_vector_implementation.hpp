@@ -58,6 +58,17 @@ public:
   /// The number of library elements used to represent a single vector element
   static const unsigned int elementSize = PetscElementSize<TheType>::value;
 
+  /// A flag to denote whether the local PETSc array can be used in place
+  /**
+   * If a vector element has the same memory layout as the PETSc
+   * scalars that represent it (including a complex element stored as
+   * two real PETSc scalars), the local PETSc array can be handed out
+   * directly without copying.
+   * 
+   */
+  static const bool directAccess = 
+    (sizeof(TheType) == elementSize*sizeof(PetscScalar));
+
   /// Default constructor.
   /** 
    * @e Collective on @c comm.
@@ -69,13 +80,14 @@ public:
    */
   PETScVectorImplementation(const parallel::Communicator& comm,
                             const IdxType& local_length)
-    : VectorImplementation<T>(comm), p_vwrap(comm, local_length*elementSize)
+    : VectorImplementation<T>(comm), p_vwrap(comm, local_length*elementSize),
+      p_localArray(NULL)
   { }
 
   /// Construct from an existing PETSc vector
   PETScVectorImplementation(Vec& pvec, const bool& copyvec = true)
     : VectorImplementation<T>(PetscVectorWrapper::getCommunicator(pvec)), 
-      p_vwrap(pvec, copyvec)
+      p_vwrap(pvec, copyvec), p_localArray(NULL)
   { }
 
   /// Destructor
@@ -93,6 +105,9 @@ protected:
   /// Where the actual vector is stored
   PetscVectorWrapper p_vwrap;
 
+  /// The local PETSc array, if handed out by getLocalElements()
+  PetscScalar *p_localArray;
+
   /// Apply a specific unary operation to the vector
   void p_applyOperation(base_unary_function<TheType>& op)
   {
@@ -261,6 +276,82 @@ protected:
     }
   }
 
+  /// Get a range of elements (lo to hi-1) (specialized)
+  /**
+   * If the range is locally owned and the layouts match, the values
+   * are copied straight out of the local PETSc array, which avoids
+   * building an index list and calling VecGetValues().
+   */
+  void p_getElementRange(const IdxType& lo, const IdxType& hi, TheType *x) const
+  {
+    IdxType mylo, myhi;
+    this->p_localIndexRange(mylo, myhi);
+    if (!directAccess || lo < mylo || hi > myhi) {
+      VectorImplementation<T, I>::p_getElementRange(lo, hi, x);
+      return;
+    }
+    PetscErrorCode ierr;
+    try {
+      const Vec *v = p_vwrap.getVector();
+      const PetscScalar *p;
+      ierr = VecGetArrayRead(*v, &p);  CHKERRXX(ierr);
+      const TheType *tp = reinterpret_cast<const TheType *>(p);
+      std::copy(tp + (lo - mylo), tp + (hi - mylo), x);
+      ierr = VecRestoreArrayRead(*v, &p); CHKERRXX(ierr);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+  }
+
+  /// Get an array of local elements (specialized)
+  /**
+   * If the layouts match, the local PETSc array is returned directly
+   * so that modifications are made in place.
+   */
+  TheType *p_getLocalElements(void)
+  {
+    if (!directAccess) {
+      return VectorImplementation<T, I>::p_getLocalElements();
+    }
+    if (p_localArray != NULL) {
+      throw gridpack::Exception("PETScVectorImplementation: "
+                                "getLocalElements called twice");
+    }
+    PetscErrorCode ierr;
+    try {
+      Vec *v = p_vwrap.getVector();
+      ierr = VecGetArray(*v, &p_localArray);  CHKERRXX(ierr);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+    return reinterpret_cast<TheType *>(p_localArray);
+  }
+
+  /// Release the local elements array produced by getLocalElements() (specialized)
+  void p_releaseLocalElements(TheType *array)
+  {
+    if (!directAccess) {
+      VectorImplementation<T, I>::p_releaseLocalElements(array);
+      return;
+    }
+    if (p_localArray == NULL) {
+      throw gridpack::Exception("PETScVectorImplementation: "
+                                "releaseLocalElements called w/o getLocalElements");
+    }
+    if (array != reinterpret_cast<TheType *>(p_localArray)) {
+      throw gridpack::Exception("PETScVectorImplementation: "
+                                "releaseLocalElements array does not match getLocalElements");
+    }
+    PetscErrorCode ierr;
+    try {
+      Vec *v = p_vwrap.getVector();
+      ierr = VecRestoreArray(*v, &p_localArray); CHKERRXX(ierr);
+    } catch (const PETSC_EXCEPTION_TYPE& e) {
+      throw PETScException(ierr, e);
+    }
+    p_localArray = NULL;
+  }
+
   /// Get all of vector elements (on all processes)
   void p_getAllElements(TheType *x) const
   {
@@ -62,7 +62,8 @@ public:
     : p_size(local_size),
       p_maxtime(maxtime),
       p_outstep(outstep),
-      p_maxsteps(1000)
+      p_maxsteps(1000),
+      p_steps(0), p_builds(0), p_reuses(0)
   {}
 
   /// Destructor
@@ -75,6 +76,24 @@ public:
     return p_size;
   }
 
+  /// Get the number of time steps taken by the last solve
+  int steps(void) const
+  {
+    return p_steps;
+  }
+
+  /// Get the number of Jacobian builds in the last solve
+  int builds(void) const
+  {
+    return p_builds;
+  }
+
+  /// Get the number of Jacobian reuses in the last solve
+  int reuses(void) const
+  {
+    return p_reuses;
+  }
+
   /// Build a Jacobian
   virtual void operator() (const double& time, 
                            const VectorType& X, 
@@ -131,7 +150,12 @@ public:
       solver.solve(t, mxstep);
       std::cout << "Time = " << t << ", Steps = " << mxstep << std::endl;
       x->print();
+      p_steps = mxstep;
     }
+    p_builds = solver.jacobianBuilds();
+    p_reuses = solver.jacobianReuses();
+    std::cout << "Jacobian builds = " << p_builds 
+              << ", reuses = " << p_reuses << std::endl;
   }
 
 protected:
@@ -148,6 +172,12 @@ protected:
   /// The number of steps allowed/taken (per ::outstep)
   int p_maxsteps;
 
+  /// The total number of steps taken by the last solve
+  int p_steps;
+
+  /// The number of Jacobian builds and reuses in the last solve
+  int p_builds, p_reuses;
+
 };
 
 // -------------------------------------------------------------
@@ -395,6 +425,33 @@ BOOST_AUTO_TEST_CASE( CE )
 
 }
 
+BOOST_AUTO_TEST_CASE( RoberLaggedJacobian )
+{
+  gridpack::parallel::Communicator world;
+
+  std::auto_ptr<Problem> p(new RoberProblem());
+
+  p->solve(world, test_config->getCursor("LaggedJacobian"));
+
+  // a lagged Jacobian is built less often than once per step
+  BOOST_CHECK_GT(p->steps(), 0);
+  BOOST_CHECK_GT(p->reuses(), 0);
+  BOOST_CHECK_LT(p->builds(), p->steps());
+}
+
+BOOST_AUTO_TEST_CASE( OregoMatrixFree )
+{
+  gridpack::parallel::Communicator world;
+
+  std::auto_ptr<Problem> p(new OregoProblem());
+
+  p->solve(world, test_config->getCursor("MatrixFreeJacobian"));
+
+  // without a preconditioner, the Jacobian is never assembled
+  BOOST_CHECK_GT(p->steps(), 0);
+  BOOST_CHECK_EQUAL(p->builds(), 0);
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -21,6 +21,7 @@
 #include <boost/format.hpp>
 #include "linear_solver.hpp"
 #include "linear_matrix_solver.hpp"
+#include "factorization_cache.hpp"
 
 #include "test_main.cpp"
 
@@ -218,6 +219,152 @@ BOOST_AUTO_TEST_CASE( Versteeg )
   }
 }
 
+// -------------------------------------------------------------
+// Solve the same problem using a reduced precision factorization and
+// iterative refinement
+// -------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( VersteegRefinement )
+{
+  gridpack::parallel::Communicator world;
+
+  static const int imax = 3*world.size();
+  static const int jmax = 4*world.size();
+  static const int global_size = imax*jmax;
+  int local_size(global_size/world.size());
+
+  std::auto_ptr<gridpack::math::RealMatrix> 
+    A(new gridpack::math::RealMatrix(world, local_size, local_size, 
+                                 gridpack::math::Sparse));
+  std::auto_ptr<gridpack::math::RealVector>
+    b(new gridpack::math::RealVector(world, local_size)),
+    x(new gridpack::math::RealVector(world, local_size));
+
+  assemble(imax, jmax, *A, *b);
+  A->ready();
+  b->ready();
+
+  x->fill(0.0);
+  x->ready();
+
+  std::auto_ptr<gridpack::math::RealLinearSolver> 
+    solver(new gridpack::math::RealLinearSolver(*A));
+
+  BOOST_REQUIRE(test_config);
+  solver->configurationKey("RefinedLinearSolver");
+  solver->configure(test_config);
+
+  double bnorm(b->norm2());
+
+  for (int k = 0; k < 2; ++k) {
+    x->fill(0.0);
+    if (k == 0) {
+      solver->solve(*b, *x);
+    } else {
+      solver->resolve(*b, *x);
+    }
+
+    std::auto_ptr<gridpack::math::RealVector>
+      res(multiply(*A, *x));
+    res->add(*b, -1.0);
+
+    double l2norm(res->norm2());
+
+    if (world.rank() == 0) {
+      std::cout << "Refinement iterations = " 
+                << solver->refinementIterations() << std::endl;
+      std::cout << "Relative Residual L2 Norm = " 
+                << l2norm/bnorm << std::endl;
+    }
+
+    BOOST_CHECK(solver->refinementIterations() > 0);
+    BOOST_CHECK(l2norm/bnorm < 1.0e-10);
+  }
+  BOOST_CHECK_EQUAL(solver->refinementFallbacks(), 0);
+}
+
+// -------------------------------------------------------------
+// Solve the same problem with two solvers that share a cached
+// factorization
+// -------------------------------------------------------------
+BOOST_AUTO_TEST_CASE( VersteegCached )
+{
+  gridpack::parallel::Communicator world;
+
+  static const int imax = 3*world.size();
+  static const int jmax = 4*world.size();
+  static const int global_size = imax*jmax;
+  int local_size(global_size/world.size());
+
+  std::auto_ptr<gridpack::math::RealMatrix> 
+    A(new gridpack::math::RealMatrix(world, local_size, local_size, 
+                                 gridpack::math::Sparse));
+  std::auto_ptr<gridpack::math::RealVector>
+    b(new gridpack::math::RealVector(world, local_size)),
+    x(new gridpack::math::RealVector(world, local_size));
+
+  assemble(imax, jmax, *A, *b);
+  A->ready();
+  b->ready();
+
+  BOOST_REQUIRE(test_config);
+
+  gridpack::math::FactorizationCacheStatistics 
+    start(gridpack::math::factorizationCacheStatistics());
+
+  // the first solver factors the matrix, the second finds that
+  // factorization in the cache, and the scaled matrix (k == 2) needs
+  // a new one
+  for (int k = 0; k < 3; ++k) {
+    std::auto_ptr<gridpack::math::RealLinearSolver> 
+      solver(new gridpack::math::RealLinearSolver(*A));
+    solver->configurationKey("CachedLinearSolver");
+    solver->configure(test_config);
+
+    if (k == 2) {
+      A->scale(2.0);
+      b->scale(2.0);
+    }
+
+    x->fill(0.0);
+    solver->solve(*b, *x);
+
+    std::auto_ptr<gridpack::math::RealVector>
+      res(multiply(*A, *x));
+    res->add(*b, -1.0);
+    double l2norm(res->norm2()/b->norm2());
+
+    gridpack::math::FactorizationCacheStatistics 
+      stats(gridpack::math::factorizationCacheStatistics());
+    if (world.rank() == 0) {
+      std::cout << "Factorization cache hits = " 
+                << stats.hits - start.hits << ", misses = "
+                << stats.misses - start.misses << std::endl;
+      std::cout << "Relative Residual L2 Norm = " 
+                << l2norm << std::endl;
+    }
+    BOOST_CHECK(l2norm < 1.0e-10);
+    BOOST_CHECK_EQUAL(stats.hits - start.hits, (k > 0 ? 1 : 0));
+    BOOST_CHECK_EQUAL(stats.misses - start.misses, (k < 2 ? 1 : 2));
+
+    // solving again with an unchanged matrix does not look in the
+    // cache, but changing the matrix does: restoring the original
+    // values finds the first factorization
+    solver->solve(*b, *x);
+    gridpack::math::FactorizationCacheStatistics 
+      again(gridpack::math::factorizationCacheStatistics());
+    BOOST_CHECK_EQUAL(again.hits, stats.hits);
+    BOOST_CHECK_EQUAL(again.misses, stats.misses);
+    if (k == 2) {
+      A->scale(0.5);
+      b->scale(0.5);
+      solver->solve(*b, *x);
+      again = gridpack::math::factorizationCacheStatistics();
+      BOOST_CHECK_EQUAL(again.hits, stats.hits + 1);
+      BOOST_CHECK_EQUAL(again.misses, stats.misses);
+    }
+  }
+}
+
 // FIXME
 BOOST_AUTO_TEST_CASE ( VersteegInverse )
 {
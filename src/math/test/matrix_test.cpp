@@ -18,6 +18,7 @@
 
 #include <iostream>
 #include <iterator>
+#include <vector>
 #include <boost/assert.hpp>
 #include <boost/mpi/collectives.hpp>
 #include "gridpack/parallel/random.hpp"
@@ -232,6 +233,59 @@ BOOST_AUTO_TEST_CASE( set_and_get )
   }
 }
 
+BOOST_AUTO_TEST_CASE( block_set_and_get )
+{
+  gridpack::parallel::Communicator world;
+  const int bs(2);
+  const int lrows(bs*local_size);
+  int global_size;
+  boost::mpi::all_reduce(world, lrows, global_size, std::plus<int>());
+
+  boost::scoped_ptr< TestMatrixType > 
+    A(TestMatrixType::createBlock(world, lrows, lrows, bs, 3)),
+    B(new TestMatrixType(world, lrows, lrows, gridpack::math::Sparse));
+  BOOST_CHECK_EQUAL(A->storageType(), gridpack::math::Block);
+  BOOST_CHECK_EQUAL(A->localRows(), lrows);
+
+  // block tridiagonal; values are in column order
+  int lo, hi;
+  A->localRowRange(lo, hi);
+  std::vector<TestType> x(bs*bs);
+  for (int i = lo; i < hi; i += bs) {
+    int jmin(std::max(i-bs, 0)), jmax(std::min(i+bs, global_size-bs));
+    for (int j = jmin; j <= jmax; j += bs) {
+      for (int c = 0; c < bs; ++c) {
+        for (int r = 0; r < bs; ++r) {
+          x[c*bs + r] = TEST_VALUE(static_cast<double>(i+r+1), 
+                                   static_cast<double>(j+c));
+          B->addElement(i+r, j+c, x[c*bs + r]);
+        }
+      }
+      A->addBlock(i, j, bs, bs, &x[0]);
+    }
+  }
+  A->ready();
+  B->ready();
+
+  for (int i = lo; i < hi; ++i) {
+    int jmin(std::max((i/bs)*bs-bs, 0)), jmax(std::min((i/bs)*bs+2*bs, global_size));
+    for (int j = jmin; j < jmax; ++j) {
+      TestType y, z;
+      A->getElement(i, j, y);
+      B->getElement(i, j, z);
+      TEST_VALUE_CLOSE(z, y, delta);
+    }
+  }
+  BOOST_CHECK_CLOSE(A->norm2(), B->norm2(), delta);
+
+  // a block smaller than the storage block falls back to scalar insertion
+  A->setBlock(lo, lo, 1, 1, &x[0]);
+  A->ready();
+  TestType y;
+  A->getElement(lo, lo, y);
+  TEST_VALUE_CLOSE(x[0], y, delta);
+}
+
 BOOST_AUTO_TEST_CASE( bad_get )
 {
   int global_size;
@@ -244,6 +244,86 @@ BOOST_AUTO_TEST_CASE( tiny_nr_serial_2 )
 
   TEST_VALUE_CLOSE(x, static_cast<TestType>(1.0), 1.0e-04);
   TEST_VALUE_CLOSE(y, static_cast<TestType>(2.0), 1.0e-04);
+
+  // the Jacobian is factored every iteration by default
+  BOOST_CHECK_EQUAL(solver.factorizations(), solver.iterations());
+}
+
+// -------------------------------------------------------------
+// Solve tiny problem 2 with one of the Jacobian reuse variants
+// configured in the named block
+// -------------------------------------------------------------
+void
+tiny_nr_reuse_2(const char *name, int& iterations, int& factorizations)
+{
+  gridpack::parallel::Communicator world;
+  gridpack::parallel::Communicator self = world.split(world.rank());
+
+  TheNewtonRaphsonSolver::JacobianBuilder j = &build_tiny_jacobian_2;
+  TheNewtonRaphsonSolver::FunctionBuilder f = &build_tiny_function_2;
+
+  TheNewtonRaphsonSolver solver(self, 2, j, f);
+
+  BOOST_REQUIRE(test_config);
+  solver.configure(test_config->getCursor(name));
+
+  VectorType X(self, 2);
+  X.setElement(0, 2.00);
+  X.setElement(1, 3.00);
+  X.ready();
+  solver.solve(X);
+
+  BOOST_TEST_MESSAGE("tiny_serial_2 results (" << name << "):");
+  X.print();
+
+  TestType x, y;
+  X.getElement(0, x);
+  X.getElement(1, y);
+
+  TEST_VALUE_CLOSE(x, static_cast<TestType>(1.0), 1.0e-04);
+  TEST_VALUE_CLOSE(y, static_cast<TestType>(2.0), 1.0e-04);
+
+  iterations = solver.iterations();
+  factorizations = solver.factorizations();
+}
+
+BOOST_AUTO_TEST_CASE( tiny_nr_chord_2 )
+{
+  int iterations, factorizations;
+  tiny_nr_reuse_2("ChordNewton", iterations, factorizations);
+  BOOST_CHECK_EQUAL(factorizations, 1);
+  BOOST_CHECK(iterations > factorizations);
+}
+
+BOOST_AUTO_TEST_CASE( tiny_nr_shamanskii_2 )
+{
+  int iterations, factorizations;
+  tiny_nr_reuse_2("ShamanskiiNewton", iterations, factorizations);
+  BOOST_CHECK(factorizations > 0);
+  BOOST_CHECK(factorizations <= (iterations + 2)/3);
+}
+
+BOOST_AUTO_TEST_CASE( tiny_nr_adaptive_2 )
+{
+  int iterations, factorizations;
+  tiny_nr_reuse_2("AdaptiveNewton", iterations, factorizations);
+  BOOST_CHECK(factorizations > 0);
+  BOOST_CHECK(factorizations < iterations);
+}
+
+BOOST_AUTO_TEST_CASE( tiny_nr_unknown_reuse )
+{
+  gridpack::parallel::Communicator world;
+  gridpack::parallel::Communicator self = world.split(world.rank());
+
+  TheNewtonRaphsonSolver::JacobianBuilder j = &build_tiny_jacobian_2;
+  TheNewtonRaphsonSolver::FunctionBuilder f = &build_tiny_function_2;
+
+  TheNewtonRaphsonSolver solver(self, 2, j, f);
+
+  BOOST_REQUIRE(test_config);
+  BOOST_CHECK_THROW(solver.configure(test_config->getCursor("UnknownNewton")),
+                    gridpack::Exception);
 }
 
 // -------------------------------------------------------------
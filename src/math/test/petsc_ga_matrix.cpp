@@ -351,6 +351,72 @@ BOOST_AUTO_TEST_CASE(Transpose)
   ierr = MatDestroy(&A); CHKERRXX(ierr);
 }
 
+BOOST_AUTO_TEST_CASE(StashedAssembly)
+{
+  PetscErrorCode ierr(0);
+  gridpack::parallel::Communicator world;
+
+  // Fill the same values into a matrix that buffers values until
+  // assembly and one that sends them immediately. Each process sets
+  // values in rows owned by the next process, including complete rows,
+  // isolated elements and repeated elements
+  Mat A, B;
+  ierr = MatCreateDenseGA(world, local_size, local_size, PETSC_DETERMINE, PETSC_DETERMINE, &A); CHKERRXX(ierr);
+  ierr = MatCreateDenseGA(world, local_size, local_size, PETSC_DETERMINE, PETSC_DETERMINE, &B); CHKERRXX(ierr);
+  ierr = MatDenseGASetStash(B, PETSC_FALSE); CHKERRXX(ierr);
+
+  PetscInt grows, gcols;
+  ierr = MatGetSize(A, &grows, &gcols); CHKERRXX(ierr);
+  int target = (world.rank()+1)%world.size();
+  PetscInt rlo = target*local_size;
+  PetscInt rhi = rlo + local_size;
+
+  std::vector<PetscInt> cidx(gcols);
+  std::vector<PetscScalar> rvals(gcols);
+  for (int j = 0; j < gcols; ++j) cidx[j] = j;
+
+  Mat M[2] = {A, B};
+  for (int k = 0; k < 2; ++k) {
+    for (int i = rlo; i < rhi; ++i) {
+      for (int j = 0; j < gcols; ++j) rvals[j] = (PetscScalar)(100*i+j);
+      ierr = MatSetValues(M[k], 1, &i, gcols, &cidx[0], &rvals[0], INSERT_VALUES); CHKERRXX(ierr);
+      PetscScalar v(-1.0);
+      ierr = MatSetValues(M[k], 1, &i, 1, &i, &v, INSERT_VALUES); CHKERRXX(ierr);
+      v = -2.0;
+      ierr = MatSetValues(M[k], 1, &i, 1, &i, &v, INSERT_VALUES); CHKERRXX(ierr);
+    }
+    ierr = MatAssemblyBegin(M[k], MAT_FLUSH_ASSEMBLY);  CHKERRXX(ierr);
+    ierr = MatAssemblyEnd(M[k], MAT_FLUSH_ASSEMBLY);  CHKERRXX(ierr);
+    for (int i = rlo; i < rhi; ++i) {
+      PetscInt j = (7*i)%gcols;
+      PetscScalar v(1.0);
+      ierr = MatSetValues(M[k], 1, &i, 1, &j, &v, ADD_VALUES); CHKERRXX(ierr);
+      ierr = MatSetValues(M[k], 1, &i, 1, &j, &v, ADD_VALUES); CHKERRXX(ierr);
+      for (int c = 0; c < gcols; ++c) rvals[c] = 0.5;
+      ierr = MatSetValues(M[k], 1, &i, gcols, &cidx[0], &rvals[0], ADD_VALUES); CHKERRXX(ierr);
+    }
+    ierr = MatAssemblyBegin(M[k], MAT_FINAL_ASSEMBLY);  CHKERRXX(ierr);
+    ierr = MatAssemblyEnd(M[k], MAT_FINAL_ASSEMBLY);  CHKERRXX(ierr);
+  }
+
+  for (int i = 0; i < grows; ++i) {
+    for (int j = 0; j < gcols; ++j) {
+      PetscScalar x, y;
+      PetscScalar v((PetscScalar)(100*i+j));
+      if (i == j) v = -2.0;
+      if (j == (7*i)%gcols) v += 2.0;
+      v += 0.5;
+      ierr = MatGetValues(A, 1, &i, 1, &j, &x);  CHKERRXX(ierr);
+      ierr = MatGetValues(B, 1, &i, 1, &j, &y);  CHKERRXX(ierr);
+      BOOST_CHECK_EQUAL(x, v);
+      BOOST_CHECK_EQUAL(y, v);
+    }
+  }
+
+  ierr = MatDestroy(&A); CHKERRXX(ierr);
+  ierr = MatDestroy(&B); CHKERRXX(ierr);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
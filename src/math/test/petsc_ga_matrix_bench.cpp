@@ -0,0 +1,142 @@
+// -------------------------------------------------------------
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+// -------------------------------------------------------------
+/**
+ * @file   petsc_ga_matrix_bench.cpp
+ *
+ * @brief Time filling a GA-based dense matrix with and without
+ * buffering values until assembly.
+ *
+ * Usage: petsc_ga_matrix_bench [rows [columns [repetitions]]]
+ *
+ * Each process fills the rows owned by the next process one row at a
+ * time, which is how MatCopy() fills the matrix in
+ * MatConvertToDenseGA(). The default is a 20000 x 200 matrix.
+ */
+// -------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <ga.h>
+
+#include "gridpack/parallel/parallel.hpp"
+#include "gridpack/environment/environment.hpp"
+#include "gridpack/timer/coarse_timer.hpp"
+#include "math.hpp"
+#include "petsc/ga_matrix.hpp"
+#include "petsc/petsc_exception.hpp"
+
+// -------------------------------------------------------------
+// fill
+// -------------------------------------------------------------
+static
+double
+fill(const gridpack::parallel::Communicator& comm, Mat A, int reps)
+{
+  PetscErrorCode ierr(0);
+  PetscInt grows, gcols, lrows, lcols;
+  ierr = MatGetSize(A, &grows, &gcols); CHKERRXX(ierr);
+  ierr = MatGetLocalSize(A, &lrows, &lcols); CHKERRXX(ierr);
+
+  // rows owned by the next process
+  std::vector<PetscInt> offset(comm.size()+1, 0);
+  offset[comm.rank()+1] = lrows;
+  std::vector<PetscInt> tmp(offset);
+  MPI_Allreduce(&tmp[0], &offset[0], comm.size()+1, MPIU_INT, MPI_SUM, comm);
+  for (int p = 1; p <= comm.size(); ++p) offset[p] += offset[p-1];
+  int target = (comm.rank()+1)%comm.size();
+
+  std::vector<PetscInt> cidx(gcols);
+  std::vector<PetscScalar> rvals(gcols);
+  for (int j = 0; j < gcols; ++j) cidx[j] = j;
+
+  gridpack::utility::CoarseTimer *timer =
+    gridpack::utility::CoarseTimer::instance();
+  comm.barrier();
+  double start = timer->currentTime();
+  for (int k = 0; k < reps; ++k) {
+    for (PetscInt i = offset[target]; i < offset[target+1]; ++i) {
+      for (int j = 0; j < gcols; ++j) rvals[j] = (PetscScalar)(i+j+k);
+      ierr = MatSetValues(A, 1, &i, gcols, &cidx[0], &rvals[0], INSERT_VALUES); CHKERRXX(ierr);
+    }
+    ierr = MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);  CHKERRXX(ierr);
+    ierr = MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);  CHKERRXX(ierr);
+  }
+  double elapsed = (timer->currentTime() - start)/(double)reps;
+  comm.max(&elapsed, 1);
+  return elapsed;
+}
+
+// -------------------------------------------------------------
+// check
+// -------------------------------------------------------------
+static
+bool
+check(const gridpack::parallel::Communicator& comm, Mat A, int reps)
+{
+  PetscErrorCode ierr(0);
+  PetscInt grows, gcols, lo, hi;
+  ierr = MatGetSize(A, &grows, &gcols); CHKERRXX(ierr);
+  ierr = MatGetOwnershipRange(A, &lo, &hi);  CHKERRXX(ierr);
+  std::vector<PetscInt> cidx(gcols);
+  std::vector<PetscScalar> rvals(gcols);
+  for (int j = 0; j < gcols; ++j) cidx[j] = j;
+  int ok = 1;
+  for (PetscInt i = lo; i < hi; ++i) {
+    ierr = MatGetValues(A, 1, &i, gcols, &cidx[0], &rvals[0]); CHKERRXX(ierr);
+    for (int j = 0; j < gcols; ++j) {
+      if (std::abs(rvals[j] - (PetscScalar)(i+j+reps-1)) > 0.0) ok = 0;
+    }
+  }
+  int result;
+  MPI_Allreduce(&ok, &result, 1, MPI_INT, MPI_MIN, comm);
+  return result != 0;
+}
+
+// -------------------------------------------------------------
+//  Main Program
+// -------------------------------------------------------------
+int
+main(int argc, char **argv)
+{
+  gridpack::Environment env(argc, argv);
+  gridpack::parallel::Communicator world;
+
+  PetscInt grows(20000), gcols(200);
+  int reps(5);
+  if (argc > 1) grows = atoi(argv[1]);
+  if (argc > 2) gcols = atoi(argv[2]);
+  if (argc > 3) reps = atoi(argv[3]);
+  if (reps < 1) reps = 1;
+
+  PetscErrorCode ierr(0);
+  Mat A, B;
+  ierr = MatCreateDenseGA(world, PETSC_DECIDE, PETSC_DECIDE, grows, gcols, &A); CHKERRXX(ierr);
+  ierr = MatCreateDenseGA(world, PETSC_DECIDE, PETSC_DECIDE, grows, gcols, &B); CHKERRXX(ierr);
+  ierr = MatDenseGASetStash(B, PETSC_FALSE); CHKERRXX(ierr);
+
+  double tdirect = fill(world, B, reps);
+  double tstash = fill(world, A, reps);
+  bool ok = check(world, A, reps) && check(world, B, reps);
+
+  if (world.rank() == 0) {
+    printf("\nGA dense matrix fill: %d x %d, %d processes\n\n",
+           (int)grows, (int)gcols, world.size());
+    printf("  %-32s %14s\n","Operation","Max/fill (s)");
+    printf("  %-32s %14.6e\n","one GA call per value",tdirect);
+    printf("  %-32s %14.6e\n","stashed until assembly",tstash);
+    if (tstash > 0.0) printf("\n  Speedup: %8.2f\n",tdirect/tstash);
+    printf("\nValue check %s\n", ok ? "passed" : "failed");
+  }
+
+  ierr = MatDestroy(&A); CHKERRXX(ierr);
+  ierr = MatDestroy(&B); CHKERRXX(ierr);
+  return 0;
+}
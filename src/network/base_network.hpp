@@ -18,10 +18,13 @@
 #ifndef _base_network_h_
 #define _base_network_h_
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <vector>
 #include <map>
+#include <list>
+#include <string>
 #include <boost/smart_ptr/shared_ptr.hpp>
 #include <boost/serialization/singleton.hpp>
 #include <boost/serialization/extended_type_info.hpp>
@@ -40,8 +43,67 @@
 #include "gridpack/environment/environment.hpp"
 #include "gridpack/environment/no_print.hpp"
 
+// Maximum number of mapper index structures stored in a network
+#define MAPPER_CACHE_SIZE 16
+
 namespace gridpack {
 namespace network {
+
+// Orderings that can be applied to local buses after partitioning
+
+enum LocalOrdering{NATURAL_ORDER, BFS_ORDER, RCM_ORDER};
+
+// -------------------------------------------------------------
+// A lightweight view of a contiguous list of local indices. The
+// view does not own the indices and is only valid until the network
+// topology is modified
+// -------------------------------------------------------------
+class NeighborRange {
+public:
+
+  typedef const int* const_iterator;
+
+  /**
+   * Default constructor. Creates an empty range
+   */
+  NeighborRange(void)
+    : p_begin(NULL), p_end(NULL)
+  { }
+
+  /**
+   * Create range from pointers to first element and one past the last
+   * element
+   */
+  NeighborRange(const int *begin, const int *end)
+    : p_begin(begin), p_end(end)
+  { }
+
+  /**
+   * Iterators over indices in range
+   */
+  const_iterator begin(void) const { return p_begin; }
+  const_iterator end(void) const { return p_end; }
+
+  /**
+   * Number of indices in range
+   */
+  int size(void) const { return static_cast<int>(p_end - p_begin); }
+
+  /**
+   * Check if range is empty
+   */
+  bool empty(void) const { return p_begin == p_end; }
+
+  /**
+   * Access individual index in range
+   */
+  int operator[](int i) const { return p_begin[i]; }
+
+private:
+  const int *p_begin;
+  const int *p_end;
+};
+
 /** @cond */
 // -------------------------------------------------------------
 // A simple data class to assemble all bus related elements in
@@ -289,6 +351,9 @@ explicit BaseNetwork(const parallel::Communicator& comm)
   : parallel::Distributed(comm)
 {
   p_refBus = -1;
+  p_adjacencyValid = false;
+  p_topologyVersion = 0;
+  p_mapperGeneration = 0;
   p_busXCBufSize = 0;
   p_branchXCBufSize = 0;
   p_busXCBufType = 0;
@@ -404,6 +469,7 @@ void addBus(int idx)
   bus->p_originalBusIndex = idx;
   bus->p_globalBusIndex = -1;
   p_buses.push_back(*bus);
+  topologyChanged();
 }
 
 /**
@@ -420,6 +486,7 @@ void addBranch(int idx1, int idx2)
   branch->p_globalBusIndex1 = -1;
   branch->p_globalBusIndex2 = -1;
   p_branches.push_back(*branch);
+  topologyChanged();
 }
 
 /**
@@ -633,6 +700,7 @@ bool setLocalBusIndex1(int idx, int b_idx)
     return false;
   } else {
     p_branches[idx].p_localBusIndex1 = b_idx;
+    topologyChanged();
     return true;
   }
 }
@@ -649,6 +717,7 @@ bool setLocalBusIndex2(int idx, int b_idx)
     return false;
   } else {
     p_branches[idx].p_localBusIndex2 = b_idx;
+    topologyChanged();
     return true;
   }
 }
@@ -664,6 +733,7 @@ bool setActiveBus(int idx, bool flag)
   if (idx < 0 || idx >= p_buses.size()) {
     return false;
   } else {
+    if (p_buses[idx].p_activeBus != flag) topologyChanged();
     p_buses[idx].p_activeBus = flag;
     return true;
   }
@@ -696,6 +766,7 @@ bool clearBranchNeighbors(int idx)
     return false;
   } else {
     p_buses[idx].p_branchNeighbors.clear();
+    topologyChanged();
     return true;
   }
 }
@@ -712,6 +783,7 @@ bool addBranchNeighbor(int idx, int br_idx)
     return false;
   } else {
     p_buses[idx].p_branchNeighbors.push_back(br_idx);
+    topologyChanged();
     return true;
   }
 }
@@ -973,24 +1045,61 @@ std::vector<int> getConnectedBuses(int idx) const
     }
     throw gridpack::Exception(buf);
   } else {
-    std::vector<int> branches = p_buses[idx].p_branchNeighbors;
-    int size = branches.size();
-    std::vector<int> ret;
-    int i, j;
-    for (i=0; i<size; i++) {
-      j = branches[i];
-      if (p_branches[j].p_localBusIndex1 != idx) {
-        ret.push_back(p_branches[j].p_localBusIndex1);
-      } else {
-        ret.push_back(p_branches[j].p_localBusIndex2);
-      }
-    }
-    return ret;
+    NeighborRange buses = connectedBuses(idx);
+    return std::vector<int>(buses.begin(), buses.end());
   }
   std::vector<int> null;
   return null;
 }
 
+/**
+ * Return branches connected to bus without copying them. The indices are
+ * stored contiguously for all buses, so this is the preferred way of
+ * looping over neighbors. The range is only valid until the topology of
+ * the network is modified
+ * @param idx local bus index
+ * @return range of local branch indices
+ */
+NeighborRange connectedBranches(int idx) const
+{
+  if (idx<0 || idx >= p_buses.size()) {
+    char buf[256];
+    sprintf(buf,"BaseNetwork::connectedBranches: illegal index: %d size: %d\n",
+           idx, static_cast<int>(p_buses.size()));
+    if (!p_no_print) {
+      printf("%s",buf);
+    }
+    throw gridpack::Exception(buf);
+  }
+  if (!p_adjacencyValid) buildAdjacency();
+  const int *ptr = p_adjBranches.empty() ? NULL : &p_adjBranches[0];
+  return NeighborRange(ptr+p_adjOffsets[idx], ptr+p_adjOffsets[idx+1]);
+}
+
+/**
+ * Return buses connected to central bus via one branch without copying
+ * them. Element i of this range is the bus at the other end of element i
+ * of connectedBranches(idx). The range is only valid until the topology
+ * of the network is modified
+ * @param idx local bus index
+ * @return range of local bus indices
+ */
+NeighborRange connectedBuses(int idx) const
+{
+  if (idx<0 || idx >= p_buses.size()) {
+    char buf[256];
+    sprintf(buf,"BaseNetwork::connectedBuses: illegal index: %d size: %d\n",
+           idx, static_cast<int>(p_buses.size()));
+    if (!p_no_print) {
+      printf("%s",buf);
+    }
+    throw gridpack::Exception(buf);
+  }
+  if (!p_adjacencyValid) buildAdjacency();
+  const int *ptr = p_adjBuses.empty() ? NULL : &p_adjBuses[0];
+  return NeighborRange(ptr+p_adjOffsets[idx], ptr+p_adjOffsets[idx+1]);
+}
+
 
 
 /**
@@ -1227,6 +1336,298 @@ void partition(void)
 
 
 
+/**
+ * Reorder local buses and branches to improve locality. Active buses are
+ * ordered using a breadth-first search or a reverse Cuthill-McKee ordering
+ * of the graph formed by the active buses and the branches between them.
+ * Ghost buses follow the active buses and are grouped by the process that
+ * owns them. Branches are ordered by the new local indices of the buses
+ * at either end. Mappers assign matrix and vector indices in local order,
+ * so this reduces the bandwidth of the locally owned blocks of network
+ * matrices. This must be called after partition and before any exchange
+ * buffers are set up. This is a collective operation
+ * @param ordering ordering to apply to local buses
+ */
+void reorder(LocalOrdering ordering)
+{
+  int nbus = p_buses.size();
+  int nbranch = p_branches.size();
+  int me(this->processor_rank());
+  int i, j;
+
+  if (p_busXCBufSize != 0 || p_branchXCBufSize != 0 || p_busGASet ||
+      p_branchGASet) {
+    char buf[256];
+    sprintf(buf,"BaseNetwork::reorder: network cannot be reordered after"
+        " exchange buffers have been set\n");
+    if (!p_no_print) {
+      printf("%s",buf);
+    }
+    throw gridpack::Exception(buf);
+  }
+  p_busPermutation.resize(nbus);
+  for (i=0; i<nbus; i++) p_busPermutation[i] = i;
+  p_branchPermutation.resize(nbranch);
+  for (i=0; i<nbranch; i++) p_branchPermutation[i] = i;
+  if (ordering == NATURAL_ORDER) return;
+
+  int bw_old, bw_new;
+  long prof_old, prof_new, fill_old, fill_new;
+  localOrderingStatistics(&bw_old, &prof_old, &fill_old);
+
+  // Find owners of ghost buses
+  std::vector<std::pair<int,int> > pairs;
+  std::vector<int> keys;
+  std::vector<int> values;
+  for (i=0; i<nbus; i++) {
+    if (p_buses[i].p_activeBus) {
+      pairs.push_back(std::pair<int,int>(p_buses[i].p_globalBusIndex,me));
+    } else {
+      keys.push_back(p_buses[i].p_globalBusIndex);
+    }
+  }
+  gridpack::hash_map::GlobalIndexHashMap hash_map(communicator());
+  hash_map.addPairs(pairs);
+  hash_map.getValues(keys,values);
+  std::map<int,int> owners;
+  for (i=0; i<values.size(); i++) {
+    owners.insert(std::pair<int,int>(keys[i],values[i]));
+  }
+
+  // Order active buses. Each connected component is started from the
+  // active bus with the lowest degree that has not been visited. For
+  // RCM_ORDER this bus is only the starting point of the search for a
+  // pseudo-peripheral root below; BFS_ORDER uses it as the root
+  std::vector<std::vector<int> > adj;
+  activeBusGraph(adj);
+  std::vector<std::pair<int,int> > starts;
+  for (i=0; i<nbus; i++) {
+    if (p_buses[i].p_activeBus) {
+      starts.push_back(std::pair<int,int>(static_cast<int>(adj[i].size()),i));
+    }
+  }
+  std::sort(starts.begin(), starts.end());
+  if (ordering == RCM_ORDER) {
+    // visit neighbors in order of increasing degree
+    std::vector<std::pair<int,int> > nghbrs;
+    for (i=0; i<nbus; i++) {
+      int nsize = adj[i].size();
+      nghbrs.clear();
+      for (j=0; j<nsize; j++) {
+        nghbrs.push_back(std::pair<int,int>(
+              static_cast<int>(adj[adj[i][j]].size()),adj[i][j]));
+      }
+      std::sort(nghbrs.begin(), nghbrs.end());
+      for (j=0; j<nsize; j++) adj[i][j] = nghbrs[j].second;
+    }
+  }
+  std::vector<int> order;
+  order.reserve(nbus);
+  std::vector<bool> visited(nbus,false);
+  std::vector<int> level;
+  for (i=0; i<starts.size(); i++) {
+    int root = starts[i].second;
+    if (visited[root]) continue;
+    if (ordering == RCM_ORDER) {
+      // Move the root to a pseudo-peripheral bus by repeatedly starting
+      // from the lowest degree bus in the last level of the search
+      int depth = bfsLevels(adj, root, level, visited);
+      while (true) {
+        int next = root;
+        int ndeg = nbus+1;
+        for (j=0; j<level.size(); j++) {
+          if (level[j] == depth && adj[j].size() < ndeg) {
+            next = j;
+            ndeg = adj[j].size();
+          }
+        }
+        if (next == root) break;
+        int ndepth = bfsLevels(adj, next, level, visited);
+        if (ndepth <= depth) break;
+        root = next;
+        depth = ndepth;
+      }
+    }
+    int first = order.size();
+    order.push_back(root);
+    visited[root] = true;
+    while (first < order.size()) {
+      int bus = order[first];
+      first++;
+      int nsize = adj[bus].size();
+      for (j=0; j<nsize; j++) {
+        int nbr = adj[bus][j];
+        if (!visited[nbr]) {
+          visited[nbr] = true;
+          order.push_back(nbr);
+        }
+      }
+    }
+  }
+  if (ordering == RCM_ORDER) {
+    std::reverse(order.begin(), order.end());
+  }
+
+  // Ghost buses are ordered by owner and then by global index
+  std::vector<std::pair<std::pair<int,int>,int> > ghosts;
+  for (i=0; i<nbus; i++) {
+    if (!p_buses[i].p_activeBus) {
+      int owner = -1;
+      std::map<int,int>::iterator it = owners.find(p_buses[i].p_globalBusIndex);
+      if (it != owners.end()) owner = it->second;
+      ghosts.push_back(std::pair<std::pair<int,int>,int>(
+            std::pair<int,int>(owner,p_buses[i].p_globalBusIndex),i));
+    }
+  }
+  std::sort(ghosts.begin(), ghosts.end());
+  for (i=0; i<ghosts.size(); i++) order.push_back(ghosts[i].second);
+  for (i=0; i<nbus; i++) p_busPermutation[order[i]] = i;
+
+  // Active branches come before ghost branches and are ordered by the new
+  // indices of their buses
+  std::vector<std::pair<std::pair<int,int>,std::pair<int,int> > > bkeys;
+  for (i=0; i<nbranch; i++) {
+    int b1 = p_branches[i].p_localBusIndex1;
+    int b2 = p_branches[i].p_localBusIndex2;
+    b1 = (b1 >= 0) ? p_busPermutation[b1] : nbus;
+    b2 = (b2 >= 0) ? p_busPermutation[b2] : nbus;
+    if (b1 > b2) std::swap(b1,b2);
+    int active = p_branches[i].p_activeBranch ? 0 : 1;
+    bkeys.push_back(std::pair<std::pair<int,int>,std::pair<int,int> >(
+          std::pair<int,int>(active,b1),std::pair<int,int>(b2,i)));
+  }
+  std::sort(bkeys.begin(), bkeys.end());
+  for (i=0; i<nbranch; i++) p_branchPermutation[bkeys[i].second.second] = i;
+
+  // Permute buses and branches and update local indices
+  BusDataVector buses;
+  buses.reserve(nbus);
+  for (i=0; i<nbus; i++) buses.push_back(p_buses[order[i]]);
+  p_buses.swap(buses);
+  buses.clear();
+  BranchDataVector branches;
+  branches.reserve(nbranch);
+  for (i=0; i<nbranch; i++) branches.push_back(p_branches[bkeys[i].second.second]);
+  p_branches.swap(branches);
+  branches.clear();
+  for (i=0; i<nbranch; i++) {
+    if (p_branches[i].p_localBusIndex1 >= 0) {
+      p_branches[i].p_localBusIndex1 =
+        p_busPermutation[p_branches[i].p_localBusIndex1];
+    }
+    if (p_branches[i].p_localBusIndex2 >= 0) {
+      p_branches[i].p_localBusIndex2 =
+        p_busPermutation[p_branches[i].p_localBusIndex2];
+    }
+  }
+  for (i=0; i<nbus; i++) {
+    std::vector<int> &nghbrs = p_buses[i].p_branchNeighbors;
+    int nsize = nghbrs.size();
+    for (j=0; j<nsize; j++) nghbrs[j] = p_branchPermutation[nghbrs[j]];
+    std::sort(nghbrs.begin(), nghbrs.end());
+  }
+  if (p_refBus != -1) {
+    p_refBus = p_busPermutation[p_refBus];
+  }
+  topologyChanged();
+  setMap();
+
+  localOrderingStatistics(&bw_new, &prof_new, &fill_new);
+  communicator().max(&bw_old,1);
+  communicator().max(&bw_new,1);
+  communicator().sum(&prof_old,1);
+  communicator().sum(&prof_new,1);
+  communicator().sum(&fill_old,1);
+  communicator().sum(&fill_new,1);
+  if (me == 0 && !p_no_print) {
+    printf("Local %s ordering: bandwidth %d -> %d profile %ld -> %ld"
+        " factor nonzeros %ld -> %ld\n",
+        ordering == RCM_ORDER ? "RCM" : "BFS",
+        bw_old, bw_new, prof_old, prof_new, fill_old, fill_new);
+  }
+}
+
+/**
+ * Return the permutation applied to local buses by the last call to
+ * reorder
+ * @return new local index of each bus, indexed by its index before
+ * reordering. The vector is empty if the network has not been reordered
+ */
+const std::vector<int>& getBusPermutation(void) const
+{
+  return p_busPermutation;
+}
+
+/**
+ * Return the permutation applied to local branches by the last call to
+ * reorder
+ * @return new local index of each branch, indexed by its index before
+ * reordering. The vector is empty if the network has not been reordered
+ */
+const std::vector<int>& getBranchPermutation(void) const
+{
+  return p_branchPermutation;
+}
+
+/**
+ * Evaluate the quality of the current local order for the block of a
+ * network matrix that couples the active buses on this processor. Only
+ * the sparsity pattern is considered and one matrix row is assumed for
+ * each bus
+ * @param bandwidth maximum distance between coupled buses
+ * @param profile number of elements between the first element in each
+ * row and the diagonal
+ * @param fill number of off-diagonal nonzeros in the lower triangular
+ * factor of the block, assuming no pivoting
+ */
+void localOrderingStatistics(int *bandwidth, long *profile, long *fill)
+{
+  int nbus = p_buses.size();
+  int i, j;
+  std::vector<std::vector<int> > adj;
+  activeBusGraph(adj);
+  std::vector<int> pos(nbus,-1);
+  int nactive = 0;
+  for (i=0; i<nbus; i++) {
+    if (p_buses[i].p_activeBus) {
+      pos[i] = nactive;
+      nactive++;
+    }
+  }
+  std::vector<std::vector<int> > rows(nactive);
+  for (i=0; i<nbus; i++) {
+    if (pos[i] < 0) continue;
+    int nsize = adj[i].size();
+    for (j=0; j<nsize; j++) {
+      if (pos[adj[i][j]] < pos[i]) rows[pos[i]].push_back(pos[adj[i][j]]);
+    }
+  }
+  *bandwidth = 0;
+  *profile = 0;
+  *fill = 0;
+  // Rows of the factor are found by walking up the elimination tree from
+  // each nonzero in the corresponding row of the matrix
+  std::vector<int> parent(nactive,-1);
+  std::vector<int> mark(nactive,-1);
+  for (i=0; i<nactive; i++) {
+    int nsize = rows[i].size();
+    int jmin = i;
+    mark[i] = i;
+    for (j=0; j<nsize; j++) {
+      int k = rows[i][j];
+      if (k < jmin) jmin = k;
+      while (k != -1 && mark[k] != i) {
+        (*fill)++;
+        mark[k] = i;
+        if (parent[k] == -1) parent[k] = i;
+        k = parent[k];
+      }
+    }
+    if (i - jmin > *bandwidth) *bandwidth = i - jmin;
+    *profile += static_cast<long>(i - jmin);
+  }
+}
+
 /**
  * Clean all ghost buses and branches from the system. This can be used
  * before repartitioning the network. This operation also removes all exchange
@@ -1351,6 +1752,7 @@ void clean(void)
   if (p_refBus != -1) {
     p_refBus = buses[p_refBus];
   }
+  topologyChanged();
 }
 
 /**
@@ -1358,7 +1760,9 @@ void clean(void)
  * need to be the same as the component classes of the old network. This
  * function can be used to create different types of networks that can be used
  * to solve different problems. The new network is already partitioned so it
- * is not necessary to call the partitioner.
+ * is not necessary to call the partitioner. Data collections in the new network
+ * share storage with the data collections in the calling network and are only
+ * copied for values that are modified by one of the networks.
  * @param new_network a new network of a different type than the calling network
  */
 template <class _new_bus, class _new_branch> void clone(
@@ -1366,7 +1770,7 @@ template <class _new_bus, class _new_branch> void clone(
     <_new_bus,_new_branch> > &new_network)
 {
   new_network->clear();
-  int i, j, nsize, idx, jdx;
+  int i, j, idx, jdx;
   int numBus = numBuses();
   int numBranch = numBranches();
   // Add buses to new network
@@ -1378,11 +1782,10 @@ template <class _new_bus, class _new_branch> void clone(
     *(new_network->getBusData(i)) = *(getBusData(i));
     new_network->setActiveBus(i,getActiveBus(i));
     // set neighbor indices
-    std::vector<int> nghbrs;
-    nghbrs = getConnectedBranches(i);
-    nsize = nghbrs.size();
-    for (j=0; j<nsize; j++) {
-      new_network->addBranchNeighbor(i,nghbrs[j]);
+    NeighborRange nghbrs = connectedBranches(i);
+    NeighborRange::const_iterator it;
+    for (it = nghbrs.begin(); it != nghbrs.end(); it++) {
+      new_network->addBranchNeighbor(i,*it);
     }
   }
   // Set reference bus on new network
@@ -1654,6 +2057,7 @@ void clear(void)
   // Get rid of all buses and branches
   p_buses.clear();
   p_branches.clear();
+  topologyChanged();
 
   //reset all internal parameters to their initial state
   p_refBus = -1;
@@ -2458,6 +2862,138 @@ void setMap(void)
     getOriginalBranchEndpoints(i, &idx1, &idx2);
     p_branchMap.insert(std::pair<std::pair<int,int>,int>(std::pair<int,int>(idx1,idx2),i));
   }
+  buildAdjacency();
+}
+
+/**
+ * Build compressed (CSR) lists of the branches and buses connected to
+ * each local bus. This is called by setMap and is rebuilt automatically
+ * by connectedBranches and connectedBuses if the topology has been
+ * modified since the last call
+ */
+void buildAdjacency(void) const
+{
+  int nbus = p_buses.size();
+  int i, j, k;
+  p_adjOffsets.resize(nbus+1);
+  p_adjOffsets[0] = 0;
+  for (i=0; i<nbus; i++) {
+    p_adjOffsets[i+1] = p_adjOffsets[i]
+      + static_cast<int>(p_buses[i].p_branchNeighbors.size());
+  }
+  p_adjBranches.resize(p_adjOffsets[nbus]);
+  p_adjBuses.resize(p_adjOffsets[nbus]);
+  k = 0;
+  for (i=0; i<nbus; i++) {
+    const std::vector<int> &nghbrs = p_buses[i].p_branchNeighbors;
+    int nsize = nghbrs.size();
+    for (j=0; j<nsize; j++) {
+      int br = nghbrs[j];
+      p_adjBranches[k] = br;
+      if (p_branches[br].p_localBusIndex1 != i) {
+        p_adjBuses[k] = p_branches[br].p_localBusIndex1;
+      } else {
+        p_adjBuses[k] = p_branches[br].p_localBusIndex2;
+      }
+      k++;
+    }
+  }
+  p_adjacencyValid = true;
+}
+
+/**
+ * Return a counter that is incremented whenever buses or branches are
+ * added or removed, the connections between them are modified or the
+ * active status of a bus changes. Structures that are derived from the
+ * topology of the network can compare this value to decide if they are
+ * still valid. The counter is local to this processor
+ * @return topology version
+ */
+unsigned int topologyVersion(void) const
+{
+  return p_topologyVersion;
+}
+
+/**
+ * Create a key for storing mapper index structures in the network. The
+ * key combines the mapper type, the topology version and a hash of the
+ * signature describing the contributions of the network components
+ * @param name name of mapper type
+ * @param sig signature of component contributions
+ * @return key for mapper cache
+ */
+std::string mapperCacheKey(const char *name, const std::vector<int> &sig) const
+{
+  unsigned long hash = 2166136261UL;
+  int i;
+  int nsize = sig.size();
+  for (i=0; i<nsize; i++) {
+    hash = (hash ^ static_cast<unsigned long>(sig[i]))*16777619UL;
+  }
+  char buf[128];
+  sprintf(buf,"%s:%u:%lx",name,p_topologyVersion,hash);
+  return std::string(buf);
+}
+
+/**
+ * Find index structures that were stored in the network by a mapper. The
+ * entry that is found is moved to the front of the cache so that the
+ * least recently used entries are discarded first
+ * @param key key returned by mapperCacheKey
+ * @return stored structure or an empty pointer if none was found
+ */
+boost::shared_ptr<void> getMapperCache(const std::string &key)
+{
+  MapperCacheList::iterator it;
+  for (it = p_mapperCache.begin(); it != p_mapperCache.end(); it++) {
+    if (it->first == key) {
+      p_mapperCache.splice(p_mapperCache.begin(), p_mapperCache, it);
+      return p_mapperCache.front().second;
+    }
+  }
+  return boost::shared_ptr<void>();
+}
+
+/**
+ * Store index structures created by a mapper in the network. Only the
+ * most recently used MAPPER_CACHE_SIZE entries are kept and the cache is
+ * cleared when the topology of the network changes
+ * @param key key returned by mapperCacheKey
+ * @param data structure to store
+ */
+void setMapperCache(const std::string &key, boost::shared_ptr<void> data)
+{
+  MapperCacheList::iterator it;
+  for (it = p_mapperCache.begin(); it != p_mapperCache.end(); it++) {
+    if (it->first == key) {
+      p_mapperCache.erase(it);
+      break;
+    }
+  }
+  p_mapperCache.push_front(std::pair<std::string,
+      boost::shared_ptr<void> >(key, data));
+  while (p_mapperCache.size() > MAPPER_CACHE_SIZE) p_mapperCache.pop_back();
+}
+
+/**
+ * Remove all index structures stored by mappers
+ */
+void clearMapperCache(void)
+{
+  p_mapperCache.clear();
+}
+
+/**
+ * Return a new identifier for index structures built by a mapper. Mappers
+ * are constructed collectively, so the same identifier is returned on all
+ * processors and can be used to check that the structures found in the
+ * cache on each processor were created together
+ * @return mapper generation
+ */
+int nextMapperGeneration(void)
+{
+  p_mapperGeneration++;
+  return p_mapperGeneration;
 }
 
 /**
@@ -2510,6 +3046,29 @@ boost::shared_ptr<gridpack::component::DataCollection> getNetworkData()
   return p_network_data;
 }
 
+/**
+ * Approximate memory used by the data collections on all buses and
+ * branches in the network, summed over all processors. Storage that is
+ * shared with a cloned network is divided between the networks that
+ * share it. This is a collective operation
+ * @return memory footprint in bytes
+ */
+long dataMemoryUsage(void)
+{
+  long ret = 0;
+  int i;
+  int nsize = p_buses.size();
+  for (i=0; i<nsize; i++) {
+    ret += static_cast<long>(p_buses[i].p_data->memoryUsage());
+  }
+  nsize = p_branches.size();
+  for (i=0; i<nsize; i++) {
+    ret += static_cast<long>(p_branches[i].p_data->memoryUsage());
+  }
+  communicator().sum(&ret,1);
+  return ret;
+}
+
 /**
  * Broadcast network data object from one processor to remaining processors on
  * network communicator
@@ -2538,6 +3097,79 @@ private:
   typedef std::vector<  BusData<BusType> > BusDataVector;
   typedef typename BusDataVector::iterator BusIterator;
   typedef boost::shared_ptr< BranchData<BranchType> > BranchDataPtr;
+  typedef std::list<std::pair<std::string, boost::shared_ptr<void> > >
+    MapperCacheList;
+
+/**
+ * Mark structures that are derived from the network topology as out of
+ * date
+ */
+void topologyChanged(void)
+{
+  p_adjacencyValid = false;
+  p_topologyVersion++;
+  p_mapperCache.clear();
+}
+
+/**
+ * Build adjacency lists for the graph formed by active buses and the
+ * branches between them. Lists for ghost buses are empty
+ * @param adj local indices of the active buses connected to each bus
+ */
+void activeBusGraph(std::vector<std::vector<int> > &adj) const
+{
+  int nbus = p_buses.size();
+  int nbranch = p_branches.size();
+  int i;
+  adj.clear();
+  adj.resize(nbus);
+  for (i=0; i<nbranch; i++) {
+    int b1 = p_branches[i].p_localBusIndex1;
+    int b2 = p_branches[i].p_localBusIndex2;
+    if (b1 < 0 || b2 < 0 || b1 == b2) continue;
+    if (p_buses[b1].p_activeBus && p_buses[b2].p_activeBus) {
+      adj[b1].push_back(b2);
+      adj[b2].push_back(b1);
+    }
+  }
+  for (i=0; i<nbus; i++) {
+    std::sort(adj[i].begin(), adj[i].end());
+    adj[i].erase(std::unique(adj[i].begin(), adj[i].end()), adj[i].end());
+  }
+}
+
+/**
+ * Find the breadth-first search level of all buses reachable from a root
+ * bus, ignoring buses that have already been visited
+ * @param adj adjacency lists of buses
+ * @param root local index of root bus
+ * @param level level of each bus, or -1 if the bus was not reached
+ * @param visited buses that are excluded from the search
+ * @return largest level found
+ */
+int bfsLevels(const std::vector<std::vector<int> > &adj, int root,
+    std::vector<int> &level, const std::vector<bool> &visited) const
+{
+  int i;
+  int depth = 0;
+  level.assign(adj.size(),-1);
+  std::vector<int> queue;
+  queue.push_back(root);
+  level[root] = 0;
+  for (i=0; i<queue.size(); i++) {
+    int bus = queue[i];
+    int nsize = adj[bus].size();
+    for (int j=0; j<nsize; j++) {
+      int nbr = adj[bus][j];
+      if (level[nbr] < 0 && !visited[nbr]) {
+        level[nbr] = level[bus]+1;
+        if (level[nbr] > depth) depth = level[nbr];
+        queue.push_back(nbr);
+      }
+    }
+  }
+  return depth;
+}
   typedef std::vector< BranchData<BranchType> > BranchDataVector;
   typedef typename BranchDataVector::iterator BranchIterator;
 
@@ -2610,6 +3242,31 @@ private:
   std::multimap<int,int> p_busMap;
   std::multimap<std::pair<int,int>,int> p_branchMap;
 
+  /**
+   * Compressed adjacency lists. The branches and buses connected to local
+   * bus i are stored in elements p_adjOffsets[i] to p_adjOffsets[i+1]-1
+   * of p_adjBranches and p_adjBuses
+   */
+  mutable std::vector<int> p_adjOffsets;
+  mutable std::vector<int> p_adjBranches;
+  mutable std::vector<int> p_adjBuses;
+  mutable bool p_adjacencyValid;
+
+  /**
+   * Topology version and index structures stored by mappers. The cache is
+   * ordered from the most to the least recently used entry
+   */
+  unsigned int p_topologyVersion;
+  MapperCacheList p_mapperCache;
+  int p_mapperGeneration;
+
+  /**
+   * Permutations applied to local buses and branches by reorder. Element
+   * i is the new local index of the bus or branch with old index i
+   */
+  std::vector<int> p_busPermutation;
+  std::vector<int> p_branchPermutation;
+
   /**
    * Data collection object associated with network as a whole
    */
@@ -0,0 +1,371 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   network_islands.hpp
+ *
+ * @brief  Find the electrical islands of a distributed network, using a
+ * test supplied by the application to decide which branches are in
+ * service, and pick a slack bus for each island
+ *
+ *
+ */
+// -------------------------------------------------------------
+
+#ifndef _network_islands_hpp_
+#define _network_islands_hpp_
+
+#include <map>
+#include <vector>
+#include <mpi.h>
+#include <boost/function.hpp>
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include "gridpack/parallel/communicator.hpp"
+
+namespace gridpack {
+namespace network {
+
+// -------------------------------------------------------------
+//  class NetworkIslands
+// -------------------------------------------------------------
+/**
+ * Connectivity analysis of a partitioned network. Buses connected by
+ * branches that are in service form an island. Islands are labeled by
+ * the smallest global index of their buses, so every process holding
+ * a bus (owned or ghosted) sees the same label.
+ *
+ * The analysis uses a union-find over the buses and branches held by
+ * each process, followed by a union-find over the labels of buses on
+ * the process boundaries, which are exchanged between all processes.
+ * It takes time nearly linear in the number of local buses plus the
+ * number of boundary buses. It relies on each process holding all
+ * branches attached to its buses, as the network does after
+ * partitioning.
+ *
+ * Each island gets the bus with the highest slack score as its slack
+ * bus. Islands that have no bus with a positive score are dead and
+ * cannot be solved.
+ */
+template <class _network>
+class NetworkIslands {
+  public:
+
+  /// Test if branch at local index is in service
+  typedef boost::function<bool (int)> BranchTest;
+
+  /// Slack score of bus at local index (<= 0 if it cannot be a slack bus)
+  typedef boost::function<double (int)> BusScore;
+
+  /**
+   * Constructor
+   * @param network network to analyze
+   */
+  NetworkIslands(boost::shared_ptr<_network> network)
+    : p_network(network), p_nIslands(0), p_nDead(0), p_nDeadBuses(0)
+  {
+  }
+
+  /**
+   * Destructor
+   */
+  ~NetworkIslands(void)
+  {
+  }
+
+  /**
+   * Find islands and their slack buses. This must be called on all
+   * processes in the network communicator
+   * @param closed returns true if branch is in service
+   * @param score returns slack score of bus
+   */
+  void analyze(BranchTest closed, BusScore score)
+  {
+    int nbus = p_network->numBuses();
+    int nbranch = p_network->numBranches();
+    int i;
+
+    // Local union-find. The root of each local set is the bus with the
+    // smallest global index
+    p_global.resize(nbus);
+    p_parent.resize(nbus);
+    for (i=0; i<nbus; i++) {
+      p_global[i] = p_network->getGlobalBusIndex(i);
+      p_parent[i] = i;
+    }
+    int b1, b2;
+    for (i=0; i<nbranch; i++) {
+      if (!closed(i)) continue;
+      p_network->getBranchEndpoints(i,&b1,&b2);
+      p_union(b1,b2);
+    }
+
+    // Buses at the ends of branches that cross process boundaries link
+    // local sets on different processes. Each such bus contributes a
+    // pair (global index of local root, global index of bus)
+    std::vector<int> pairs;
+    for (i=0; i<nbranch; i++) {
+      p_network->getBranchEndpoints(i,&b1,&b2);
+      if (p_network->getActiveBus(b1) && p_network->getActiveBus(b2)) continue;
+      pairs.push_back(p_global[p_find(b1)]);
+      pairs.push_back(p_global[b1]);
+      pairs.push_back(p_global[p_find(b2)]);
+      pairs.push_back(p_global[b2]);
+    }
+    std::vector<int> allPairs;
+    p_allGather(pairs, allPairs, MPI_INT);
+
+    // Union-find over global indices of boundary buses. Every process
+    // builds the same sets
+    std::map<int,int> gparent;
+    int npair = allPairs.size()/2;
+    for (i=0; i<npair; i++) {
+      p_globalUnion(gparent, allPairs[2*i], allPairs[2*i+1]);
+    }
+
+    // Island label of each local bus
+    p_island.resize(nbus);
+    for (i=0; i<nbus; i++) {
+      p_island[i] = p_globalFind(gparent, p_global[p_find(i)]);
+    }
+
+    // Size and best slack candidate of each island, from locally owned
+    // buses
+    std::map<int, IslandData> local;
+    for (i=0; i<nbus; i++) {
+      if (!p_network->getActiveBus(i)) continue;
+      IslandData &data = local[p_island[i]];
+      data.nbus++;
+      p_candidate(data, p_global[i], score(i));
+    }
+    std::vector<int> ibuf;
+    std::vector<double> dbuf;
+    typename std::map<int, IslandData>::iterator it;
+    for (it = local.begin(); it != local.end(); it++) {
+      ibuf.push_back(it->first);
+      ibuf.push_back(it->second.nbus);
+      ibuf.push_back(it->second.slack);
+      dbuf.push_back(it->second.score);
+    }
+    std::vector<int> allInts;
+    std::vector<double> allDoubles;
+    p_allGather(ibuf, allInts, MPI_INT);
+    p_allGather(dbuf, allDoubles, MPI_DOUBLE);
+    p_islands.clear();
+    int nisland = allDoubles.size();
+    for (i=0; i<nisland; i++) {
+      IslandData &data = p_islands[allInts[3*i]];
+      data.nbus += allInts[3*i+1];
+      p_candidate(data, allInts[3*i+2], allDoubles[i]);
+    }
+    p_nIslands = p_islands.size();
+    p_nDead = 0;
+    p_nDeadBuses = 0;
+    for (it = p_islands.begin(); it != p_islands.end(); it++) {
+      if (it->second.slack < 0) {
+        p_nDead++;
+        p_nDeadBuses += it->second.nbus;
+      }
+    }
+    p_parent.clear();
+  }
+
+  /**
+   * Number of islands in the network
+   * @return number of islands
+   */
+  int numIslands(void) const
+  {
+    return p_nIslands;
+  }
+
+  /**
+   * Number of islands that have no slack bus
+   * @return number of dead islands
+   */
+  int numDeadIslands(void) const
+  {
+    return p_nDead;
+  }
+
+  /**
+   * Number of buses in islands that have no slack bus
+   * @return number of buses in dead islands
+   */
+  int numDeadBuses(void) const
+  {
+    return p_nDeadBuses;
+  }
+
+  /**
+   * Island containing bus
+   * @param idx local index of bus
+   * @return label of island (smallest global index of its buses)
+   */
+  int getIsland(int idx) const
+  {
+    return p_island[idx];
+  }
+
+  /**
+   * Number of buses in the island containing bus
+   * @param idx local index of bus
+   * @return number of buses in island
+   */
+  int getIslandSize(int idx) const
+  {
+    return p_data(idx).nbus;
+  }
+
+  /**
+   * Slack bus of the island containing bus
+   * @param idx local index of bus
+   * @return global index of slack bus, or -1 if island is dead
+   */
+  int getSlackBus(int idx) const
+  {
+    return p_data(idx).slack;
+  }
+
+  /**
+   * Check if bus is in an island without a slack bus
+   * @param idx local index of bus
+   * @return true if island is dead
+   */
+  bool isDead(int idx) const
+  {
+    return p_data(idx).slack < 0;
+  }
+
+  /**
+   * Check if bus is the slack bus of its island
+   * @param idx local index of bus
+   * @return true if bus is slack bus
+   */
+  bool isSlack(int idx) const
+  {
+    return p_data(idx).slack == p_global[idx];
+  }
+
+  private:
+
+  /// Size and slack bus of an island
+  struct IslandData {
+    int nbus;
+    int slack;
+    double score;
+    IslandData(void) : nbus(0), slack(-1), score(0.0) {}
+  };
+
+  /// Find root of local set, halving the path on the way
+  int p_find(int idx)
+  {
+    while (p_parent[idx] != idx) {
+      p_parent[idx] = p_parent[p_parent[idx]];
+      idx = p_parent[idx];
+    }
+    return idx;
+  }
+
+  /// Merge the local sets containing two buses
+  void p_union(int idx1, int idx2)
+  {
+    int r1 = p_find(idx1);
+    int r2 = p_find(idx2);
+    if (r1 == r2) return;
+    if (p_global[r1] < p_global[r2]) {
+      p_parent[r2] = r1;
+    } else {
+      p_parent[r1] = r2;
+    }
+  }
+
+  /// Find root of set of global indices
+  static int p_globalFind(std::map<int,int> &parent, int idx)
+  {
+    std::map<int,int>::iterator it = parent.find(idx);
+    if (it == parent.end()) return idx;
+    while (it->second != idx) {
+      std::map<int,int>::iterator up = parent.find(it->second);
+      it->second = up->second;
+      idx = it->second;
+      it = parent.find(idx);
+    }
+    return idx;
+  }
+
+  /// Merge the sets containing two global indices
+  static void p_globalUnion(std::map<int,int> &parent, int idx1, int idx2)
+  {
+    if (parent.find(idx1) == parent.end()) parent[idx1] = idx1;
+    if (parent.find(idx2) == parent.end()) parent[idx2] = idx2;
+    int r1 = p_globalFind(parent, idx1);
+    int r2 = p_globalFind(parent, idx2);
+    if (r1 < r2) {
+      parent[r2] = r1;
+    } else if (r2 < r1) {
+      parent[r1] = r2;
+    }
+  }
+
+  /// Replace slack candidate of island if bus has a higher score
+  static void p_candidate(IslandData &data, int bus, double score)
+  {
+    if (bus < 0 || score <= 0.0) return;
+    if (data.slack < 0 || score > data.score ||
+        (score == data.score && bus < data.slack)) {
+      data.slack = bus;
+      data.score = score;
+    }
+  }
+
+  /// Data for island containing bus
+  const IslandData& p_data(int idx) const
+  {
+    return p_islands.find(p_island[idx])->second;
+  }
+
+  /// Gather vectors from all processes into a single vector
+  template <typename T>
+  void p_allGather(std::vector<T> &local, std::vector<T> &all,
+      MPI_Datatype type)
+  {
+    MPI_Comm comm = static_cast<MPI_Comm>(p_network->communicator());
+    int nproc = p_network->communicator().size();
+    int nlocal = local.size();
+    std::vector<int> sizes(nproc), offsets(nproc);
+    MPI_Allgather(&nlocal,1,MPI_INT,&sizes[0],1,MPI_INT,comm);
+    int total = 0;
+    int p;
+    for (p=0; p<nproc; p++) {
+      offsets[p] = total;
+      total += sizes[p];
+    }
+    all.resize(total);
+    T *sbuf = (nlocal > 0 ? &local[0] : NULL);
+    T *rbuf = (total > 0 ? &all[0] : NULL);
+    MPI_Allgatherv(sbuf,nlocal,type,rbuf,&sizes[0],&offsets[0],type,comm);
+  }
+
+  boost::shared_ptr<_network> p_network;
+
+  // global index, parent in local union-find and island of local buses
+  std::vector<int> p_global;
+  std::vector<int> p_parent;
+  std::vector<int> p_island;
+
+  // data for all islands, indexed by island label
+  std::map<int, IslandData> p_islands;
+
+  int p_nIslands;
+  int p_nDead;
+  int p_nDeadBuses;
+};
+
+}   // namespace network
+}   // namespace gridpack
+
+#endif
@@ -0,0 +1,289 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   node_shared_network.hpp
+ *
+ * @brief
+ * Share the parsed data of a network between all processes on a node.
+ * This is intended for task parallel applications (e.g. contingency
+ * analysis) in which every task communicator holds a complete copy of
+ * the same network. One process on each node reads the network and
+ * writes its topology and data collections into a node-wide shared
+ * memory buffer. The remaining processes build their networks from the
+ * buffer and attach their data collections to the images in it, so
+ * only values that are modified by a task are stored privately.
+ *
+ */
+// -------------------------------------------------------------
+
+#ifndef _node_shared_network_h_
+#define _node_shared_network_h_
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include "gridpack/parallel/communicator.hpp"
+#include "gridpack/parallel/shared_buffer.hpp"
+#include "gridpack/component/data_collection.hpp"
+#include "gridpack/utilities/exception.hpp"
+
+namespace gridpack {
+namespace network {
+
+// -------------------------------------------------------------
+//  class NodeSharedNetwork
+// -------------------------------------------------------------
+template <class _network>
+class NodeSharedNetwork {
+public:
+
+  /**
+   * Divide communicator into groups of processes on the same node. This
+   * must be called on all processes in comm
+   * @param comm communicator containing all tasks (usually world)
+   */
+  NodeSharedNetwork(const gridpack::parallel::Communicator &comm)
+    : p_buffer(comm), p_privateBytes(0)
+  {
+  }
+
+  /**
+   * Default destructor. Networks that were attached to the shared buffer
+   * must be destroyed (or cleared) before this object. This must be
+   * called on all processes in the communicator
+   */
+  ~NodeSharedNetwork(void)
+  {
+  }
+
+  /**
+   * Return true if this process should read the network for its node
+   * @return true if process is the node leader
+   */
+  bool isNodeLeader(void) const
+  {
+    return p_buffer.isNodeLeader();
+  }
+
+  /**
+   * Share network between all processes on the node. On the node leader,
+   * network must contain a partitioned network that was read in the
+   * usual way. On the other processes it must be empty and is built from
+   * the shared copy and then partitioned. On all processes the data
+   * collections are attached to the shared copy. Each network must be
+   * defined on a communicator containing a single process. This must be
+   * called on all processes in the communicator
+   * @param network network that is shared
+   */
+  void share(boost::shared_ptr<_network> network)
+  {
+    if (network->communicator().size() != 1) {
+      char buf[256];
+      sprintf(buf,"NodeSharedNetwork: networks must be on a single process"
+          " (found %d)\n",network->communicator().size());
+      printf("%s",buf);
+      throw gridpack::Exception(buf);
+    }
+    int i;
+    size_t size = 0;
+    if (p_buffer.isNodeLeader()) {
+      p_privateBytes = network->dataMemoryUsage();
+      size = p_layout(network);
+    }
+    p_buffer.allocate(size);
+    if (p_buffer.isNodeLeader()) p_write(network);
+    p_buffer.sync();
+
+    const char *data = p_buffer.data();
+    int nbus, nbranch;
+    memcpy(&nbus, data, sizeof(int));
+    memcpy(&nbranch, data+sizeof(int), sizeof(int));
+    const char *ptr = data + 2*sizeof(int);
+    Header header;
+    if (!p_buffer.isNodeLeader()) {
+      for (i=0; i<nbus; i++) {
+        memcpy(&header, ptr + i*sizeof(Header), sizeof(Header));
+        network->addBus(header.idx1);
+        network->setGlobalBusIndex(i,header.global);
+      }
+      ptr += nbus*sizeof(Header);
+      for (i=0; i<nbranch; i++) {
+        memcpy(&header, ptr + i*sizeof(Header), sizeof(Header));
+        network->addBranch(header.idx1,header.idx2);
+        network->setGlobalBranchIndex(i,header.global);
+      }
+      ptr += nbranch*sizeof(Header);
+      memcpy(&header, ptr, sizeof(Header));
+      network->getNetworkData()->attach(data+header.offset);
+      // Attach data collections before partitioning so that they are
+      // not copied
+      ptr = data + 2*sizeof(int);
+      for (i=0; i<nbus; i++) {
+        memcpy(&header, ptr + i*sizeof(Header), sizeof(Header));
+        network->getBusData(i)->attach(data+header.offset);
+      }
+      ptr += nbus*sizeof(Header);
+      for (i=0; i<nbranch; i++) {
+        memcpy(&header, ptr + i*sizeof(Header), sizeof(Header));
+        network->getBranchData(i)->attach(data+header.offset);
+      }
+      network->partition();
+    } else {
+      for (i=0; i<nbus; i++) {
+        memcpy(&header, ptr + i*sizeof(Header), sizeof(Header));
+        network->getBusData(i)->attach(data+header.offset);
+      }
+      ptr += nbus*sizeof(Header);
+      for (i=0; i<nbranch; i++) {
+        memcpy(&header, ptr + i*sizeof(Header), sizeof(Header));
+        network->getBranchData(i)->attach(data+header.offset);
+      }
+      ptr += nbranch*sizeof(Header);
+      memcpy(&header, ptr, sizeof(Header));
+      network->getNetworkData()->attach(data+header.offset);
+    }
+  }
+
+  /**
+   * Number of bytes in the shared copy of the network on this node
+   * @return size of shared buffer
+   */
+  size_t sharedBytes(void) const
+  {
+    return p_buffer.size();
+  }
+
+  /**
+   * Memory used by the data collections of the network on the node
+   * leader before they were shared. This is the amount of memory that
+   * every process would use without sharing
+   * @return bytes used by unshared data collections (0 on other processes)
+   */
+  long unsharedBytes(void) const
+  {
+    return p_privateBytes;
+  }
+
+  /**
+   * Number of processes on node
+   * @return size of node communicator
+   */
+  int nodeSize(void) const
+  {
+    return p_buffer.nodeSize();
+  }
+
+  /**
+   * Sum a value over all processes on this node
+   * @param value local value
+   * @return sum over node
+   */
+  long nodeSum(long value) const
+  {
+    long ret = 0;
+    MPI_Allreduce(&value,&ret,1,MPI_LONG,MPI_SUM,
+        p_buffer.nodeCommunicator());
+    return ret;
+  }
+
+private:
+
+  /**
+   * Description of a bus, branch or the network data in the shared
+   * buffer. For buses idx1 is the original index, for branches idx1 and
+   * idx2 are the original indices of the end buses
+   */
+  struct Header {
+    int idx1;
+    int idx2;
+    int global;
+    size_t offset;
+  };
+
+  /**
+   * Round offset up so that each data image starts on an 8 byte boundary
+   */
+  static size_t p_align(size_t offset)
+  {
+    return (offset+7)/8*8;
+  }
+
+  /**
+   * Evaluate offsets of data images and total size of shared buffer
+   * @param network network on node leader
+   * @return size of buffer
+   */
+  size_t p_layout(boost::shared_ptr<_network> network)
+  {
+    int i;
+    int nbus = network->numBuses();
+    int nbranch = network->numBranches();
+    size_t offset = p_align(2*sizeof(int)
+        + (nbus+nbranch+1)*sizeof(Header));
+    p_offsets.resize(nbus+nbranch+1);
+    for (i=0; i<nbus; i++) {
+      p_offsets[i] = offset;
+      offset = p_align(offset + network->getBusData(i)->packedSize());
+    }
+    for (i=0; i<nbranch; i++) {
+      p_offsets[nbus+i] = offset;
+      offset = p_align(offset + network->getBranchData(i)->packedSize());
+    }
+    p_offsets[nbus+nbranch] = offset;
+    offset += network->getNetworkData()->packedSize();
+    return offset;
+  }
+
+  /**
+   * Write network into shared buffer on node leader
+   * @param network network on node leader
+   */
+  void p_write(boost::shared_ptr<_network> network)
+  {
+    int i;
+    int nbus = network->numBuses();
+    int nbranch = network->numBranches();
+    char *data = p_buffer.data();
+    memcpy(data, &nbus, sizeof(int));
+    memcpy(data+sizeof(int), &nbranch, sizeof(int));
+    char *ptr = data + 2*sizeof(int);
+    Header header;
+    for (i=0; i<nbus; i++) {
+      header.idx1 = network->getOriginalBusIndex(i);
+      header.idx2 = 0;
+      header.global = network->getGlobalBusIndex(i);
+      header.offset = p_offsets[i];
+      memcpy(ptr, &header, sizeof(Header));
+      ptr += sizeof(Header);
+      network->getBusData(i)->pack(data+header.offset);
+    }
+    for (i=0; i<nbranch; i++) {
+      network->getOriginalBranchEndpoints(i,&header.idx1,&header.idx2);
+      header.global = network->getGlobalBranchIndex(i);
+      header.offset = p_offsets[nbus+i];
+      memcpy(ptr, &header, sizeof(Header));
+      ptr += sizeof(Header);
+      network->getBranchData(i)->pack(data+header.offset);
+    }
+    header.idx1 = 0;
+    header.idx2 = 0;
+    header.global = 0;
+    header.offset = p_offsets[nbus+nbranch];
+    memcpy(ptr, &header, sizeof(Header));
+    network->getNetworkData()->pack(data+header.offset);
+  }
+
+  gridpack::parallel::NodeSharedBuffer p_buffer;
+  std::vector<size_t> p_offsets;
+  long p_privateBytes;
+};
+
+}   // namespace network
+}   // namespace gridpack
+
+#endif
@@ -25,6 +25,7 @@
 
 #include "gridpack/component/base_component.hpp"
 #include "base_network.hpp"
+#include "network_islands.hpp"
 #include "gridpack/environment/environment.hpp"
 
 // -------------------------------------------------------------
@@ -427,6 +428,164 @@ BOOST_AUTO_TEST_CASE ( lattice_partition )
   net.writeGraph("lattice-after.dot");
 }
 
+BOOST_AUTO_TEST_CASE ( lattice_reorder )
+{
+  gridpack::parallel::Communicator world;
+  static const int rows(20), cols(20);
+  BogusLatticeNetwork net(world, rows, cols);
+
+  net.partition();
+
+  int nbus(net.numBuses()), nbranch(net.numBranches());
+  std::vector<int> busidx(nbus), branchidx(nbranch);
+  for (int b = 0; b < nbus; ++b) busidx[b] = net.getGlobalBusIndex(b);
+  for (int b = 0; b < nbranch; ++b) branchidx[b] = net.getGlobalBranchIndex(b);
+
+  int bw_old, bw_new;
+  long prof_old, prof_new, fill_old, fill_new;
+  net.localOrderingStatistics(&bw_old, &prof_old, &fill_old);
+
+  net.reorder(gridpack::network::RCM_ORDER);
+
+  net.localOrderingStatistics(&bw_new, &prof_new, &fill_new);
+  BOOST_CHECK_LE(bw_new, bw_old);
+  BOOST_CHECK_LE(prof_new, prof_old);
+
+  world.max(&bw_old, 1);
+  world.max(&bw_new, 1);
+  world.sum(&prof_old, 1);
+  world.sum(&prof_new, 1);
+  world.sum(&fill_old, 1);
+  world.sum(&fill_new, 1);
+  if (world.rank() == 0) {
+    std::cout << "bandwidth: " << bw_old << " -> " << bw_new
+              << ", profile: " << prof_old << " -> " << prof_new
+              << ", factor nonzeros: " << fill_old << " -> " << fill_new
+              << std::endl;
+  }
+
+  BOOST_REQUIRE_EQUAL(net.numBuses(), nbus);
+  BOOST_REQUIRE_EQUAL(net.numBranches(), nbranch);
+
+  // the permutations move each bus and branch to its new location
+  const std::vector<int> &busperm(net.getBusPermutation());
+  const std::vector<int> &branchperm(net.getBranchPermutation());
+  BOOST_REQUIRE_EQUAL(busperm.size(), nbus);
+  BOOST_REQUIRE_EQUAL(branchperm.size(), nbranch);
+  for (int b = 0; b < nbus; ++b) {
+    BOOST_CHECK_EQUAL(net.getGlobalBusIndex(busperm[b]), busidx[b]);
+  }
+  for (int b = 0; b < nbranch; ++b) {
+    BOOST_CHECK_EQUAL(net.getGlobalBranchIndex(branchperm[b]), branchidx[b]);
+  }
+
+  // active buses come first
+  bool ghost(false);
+  for (int b = 0; b < nbus; ++b) {
+    if (!net.getActiveBus(b)) {
+      ghost = true;
+    } else {
+      BOOST_CHECK(!ghost);
+    }
+  }
+
+  // branch ends, neighbor lists and maps are consistent
+  for (int b = 0; b < nbranch; ++b) {
+    int l1, l2, o1, o2;
+    net.getBranchEndpoints(b, &l1, &l2);
+    net.getOriginalBranchEndpoints(b, &o1, &o2);
+    BOOST_CHECK_EQUAL(net.getOriginalBusIndex(l1), o1);
+    BOOST_CHECK_EQUAL(net.getOriginalBusIndex(l2), o2);
+    std::vector<int> lidx(net.getLocalBranchIndices(o1, o2));
+    BOOST_CHECK(std::find(lidx.begin(), lidx.end(), b) != lidx.end());
+  }
+  for (int b = 0; b < nbus; ++b) {
+    std::vector<int> branches(net.getConnectedBranches(b));
+    for (size_t k = 0; k < branches.size(); ++k) {
+      int l1, l2;
+      net.getBranchEndpoints(branches[k], &l1, &l2);
+      BOOST_CHECK(l1 == b || l2 == b);
+    }
+    std::vector<int> lidx(net.getLocalBusIndices(net.getOriginalBusIndex(b)));
+    BOOST_CHECK(std::find(lidx.begin(), lidx.end(), b) != lidx.end());
+  }
+}
+
+// -------------------------------------------------------------
+// Lattice outages used to test island detection: the branches between
+// columns 9 and 10 are open, splitting the lattice in two, and the
+// last bus is cut off
+// -------------------------------------------------------------
+struct LatticeOutage
+{
+  LatticeOutage(BogusLatticeNetwork *net, int nbus, int cols)
+    : p_net(net), p_nbus(nbus), p_cols(cols)
+  {}
+  bool operator() (int idx) const
+  {
+    int l1, l2;
+    p_net->getBranchEndpoints(idx, &l1, &l2);
+    int g1(p_net->getGlobalBusIndex(l1)), g2(p_net->getGlobalBusIndex(l2));
+    if (g1 == p_nbus-1 || g2 == p_nbus-1) return false;
+    int c1(g1%p_cols), c2(g2%p_cols);
+    return !((c1 == 9 && c2 == 10) || (c1 == 10 && c2 == 9));
+  }
+  BogusLatticeNetwork *p_net;
+  int p_nbus, p_cols;
+};
+
+// bus 0 is the preferred slack bus and bus 115 can also be a slack bus
+struct LatticeSlack
+{
+  LatticeSlack(BogusLatticeNetwork *net)
+    : p_net(net)
+  {}
+  double operator() (int idx) const
+  {
+    int g(p_net->getGlobalBusIndex(idx));
+    if (g == 0) return 2.0;
+    if (g == 115) return 1.0;
+    return 0.0;
+  }
+  BogusLatticeNetwork *p_net;
+};
+
+BOOST_AUTO_TEST_CASE ( lattice_islands )
+{
+  gridpack::parallel::Communicator world;
+  static const int rows(20), cols(20);
+  boost::shared_ptr<BogusLatticeNetwork> 
+    net(new BogusLatticeNetwork(world, rows, cols));
+
+  net->partition();
+
+  gridpack::network::NetworkIslands<BogusLatticeNetwork> islands(net);
+  islands.analyze(LatticeOutage(net.get(), rows*cols, cols),
+                  LatticeSlack(net.get()));
+
+  BOOST_CHECK_EQUAL(islands.numIslands(), 3);
+  BOOST_CHECK_EQUAL(islands.numDeadIslands(), 1);
+  BOOST_CHECK_EQUAL(islands.numDeadBuses(), 1);
+
+  for (int b = 0; b < net->numBuses(); ++b) {
+    int g(net->getGlobalBusIndex(b));
+    if (g == rows*cols-1) {
+      BOOST_CHECK_EQUAL(islands.getIsland(b), g);
+      BOOST_CHECK(islands.isDead(b));
+      BOOST_CHECK_EQUAL(islands.getIslandSize(b), 1);
+    } else if (g%cols < 10) {
+      BOOST_CHECK_EQUAL(islands.getIsland(b), 0);
+      BOOST_CHECK_EQUAL(islands.getSlackBus(b), 0);
+      BOOST_CHECK_EQUAL(islands.getIslandSize(b), rows*cols/2);
+      BOOST_CHECK_EQUAL(islands.isSlack(b), g == 0);
+    } else {
+      BOOST_CHECK_EQUAL(islands.getIsland(b), 10);
+      BOOST_CHECK_EQUAL(islands.getSlackBus(b), 115);
+      BOOST_CHECK_EQUAL(islands.getIslandSize(b), rows*cols/2-1);
+      BOOST_CHECK_EQUAL(islands.isSlack(b), g == 115);
+    }
+  }
+}
 
 BOOST_AUTO_TEST_SUITE_END( )
 
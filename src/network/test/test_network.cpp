@@ -444,6 +444,20 @@ BOOST_AUTO_TEST_CASE( TestNetworkTopology )
           ok = false;
         }
       }
+      // compact neighbor lists should match
+      gridpack::network::NeighborRange brange = network.connectedBranches(i);
+      gridpack::network::NeighborRange nrange = network.connectedBuses(i);
+      if (brange.size() != branches.size() || nrange.size() != buses.size()) {
+        printf("p[%d] incorrect neighbor ranges on bus %d\n",me,i);
+        ok = false;
+      } else {
+        for (j=0; j<n; j++) {
+          if (brange[j] != branches[j] || nrange[j] != buses[j]) {
+            printf("p[%d] incorrect neighbor ranges on bus %d\n",me,i);
+            ok = false;
+          }
+        }
+      }
     }
   }
   oks = (int)ok;
@@ -478,6 +492,11 @@ BOOST_AUTO_TEST_CASE( TestNetworkTopology )
       for (j=0; j<buses.size(); j++) {
         if (buses[j] != buses2[j]) ok = false;
       }
+      gridpack::network::NeighborRange nrange = network2->connectedBuses(i);
+      if (nrange.size() != buses.size()) ok = false;
+      for (j=0; j<nrange.size(); j++) {
+        if (nrange[j] != buses[j]) ok = false;
+      }
     }
     if (network.getReferenceBus() != network2->getReferenceBus()) ok = false;
     n = network2->numBranches();
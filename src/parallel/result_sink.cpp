@@ -0,0 +1,491 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   result_sink.cpp
+ *
+ * @brief
+ * Collect result records from the processes doing a calculation and
+ * write them to indexed files on dedicated writer processes
+ *
+ */
+
+// -------------------------------------------------------------
+
+#include <cstring>
+#include <algorithm>
+#include "gridpack/parallel/result_sink.hpp"
+#include "gridpack/utilities/exception.hpp"
+
+// Tags for messages sent to writers
+#define RESULT_RECORD_TAG 1
+#define RESULT_DONE_TAG 2
+
+// Maximum number of sends that can be pending on a compute process
+#define RESULT_MAX_PENDING 64
+
+// Identifiers at the start and end of result files
+#define RESULT_FILE_MAGIC "GPRS"
+#define RESULT_INDEX_MAGIC "GPRX"
+
+namespace gridpack {
+namespace parallel {
+
+// -------------------------------------------------------------
+//  class ResultRecord
+// -------------------------------------------------------------
+
+/**
+ * Default constructor
+ */
+ResultRecord::ResultRecord(void)
+  : p_id(-1), p_status(0), p_violations(0)
+{
+}
+
+/**
+ * Default destructor
+ */
+ResultRecord::~ResultRecord(void)
+{
+}
+
+/**
+ * Remove all values and set the header of the record
+ * @param id index of calculation (e.g. contingency index)
+ * @param status status of calculation (e.g. 1 if converged)
+ * @param violations application-defined violation flags
+ */
+void ResultRecord::reset(int id, int status, int violations)
+{
+  p_id = id;
+  p_status = status;
+  p_violations = violations;
+  p_values.clear();
+}
+
+/**
+ * Add a value to the record
+ * @param kind application-defined type of value
+ * @param idx1 first index of value
+ * @param idx2 second index of value
+ * @param tag up to 2 character tag
+ * @param value value
+ */
+void ResultRecord::addValue(int kind, int idx1, int idx2,
+    const std::string &tag, double value)
+{
+  ResultValue val;
+  val.kind = kind;
+  val.idx1 = idx1;
+  val.idx2 = idx2;
+  memset(val.tag, '\0', sizeof(val.tag));
+  strncpy(val.tag, tag.c_str(), sizeof(val.tag)-1);
+  val.value = value;
+  p_values.push_back(val);
+}
+
+/**
+ * Header of record
+ * @return id, status or violation flags of record
+ */
+int ResultRecord::id(void) const
+{
+  return p_id;
+}
+
+int ResultRecord::status(void) const
+{
+  return p_status;
+}
+
+int ResultRecord::violations(void) const
+{
+  return p_violations;
+}
+
+/**
+ * Number of values in record
+ * @return number of values
+ */
+int ResultRecord::size(void) const
+{
+  return static_cast<int>(p_values.size());
+}
+
+/**
+ * Return a value
+ * @param idx index of value in record
+ * @return value
+ */
+const ResultValue& ResultRecord::operator[](int idx) const
+{
+  return p_values[idx];
+}
+
+/**
+ * Pack record into a buffer. The buffer holds the id, status, violation
+ * flags and number of values followed by the values
+ * @param buf buffer that is resized to hold the record
+ */
+void ResultRecord::pack(std::vector<char> &buf) const
+{
+  int header[4];
+  header[0] = p_id;
+  header[1] = p_status;
+  header[2] = p_violations;
+  header[3] = static_cast<int>(p_values.size());
+  size_t vsize = p_values.size()*sizeof(ResultValue);
+  buf.resize(sizeof(header)+vsize);
+  memcpy(&buf[0], header, sizeof(header));
+  if (vsize > 0) memcpy(&buf[sizeof(header)], &p_values[0], vsize);
+}
+
+/**
+ * Unpack record from a buffer
+ * @param buf buffer created by pack
+ * @param len length of buffer in bytes
+ * @return false if the buffer does not hold a complete record
+ */
+bool ResultRecord::unpack(const char *buf, int len)
+{
+  int header[4];
+  if (len < static_cast<int>(sizeof(header))) return false;
+  memcpy(header, buf, sizeof(header));
+  size_t vsize = static_cast<size_t>(header[3])*sizeof(ResultValue);
+  if (header[3] < 0 || sizeof(header)+vsize != static_cast<size_t>(len)) {
+    return false;
+  }
+  p_id = header[0];
+  p_status = header[1];
+  p_violations = header[2];
+  p_values.resize(header[3]);
+  if (vsize > 0) memcpy(&p_values[0], buf+sizeof(header), vsize);
+  return true;
+}
+
+// -------------------------------------------------------------
+//  class ResultSink
+// -------------------------------------------------------------
+
+/**
+ * Set aside writer processes and open the output files. This must be
+ * called on all processes in comm
+ * @param comm communicator containing all processes
+ * @param nwriters number of writer processes
+ * @param filename name of output file
+ */
+ResultSink::ResultSink(const Communicator &comm, int nwriters,
+    const std::string &filename)
+  : p_nwriters(nwriters), p_finished(false), p_file(NULL), p_offset(0)
+{
+  int nprocs = comm.size();
+  int me = comm.rank();
+  if (p_nwriters > nprocs-1) p_nwriters = nprocs-1;
+  if (p_nwriters < 1 && nprocs > 1) p_nwriters = 1;
+  p_ncompute = nprocs - p_nwriters;
+  p_writer = (me >= p_ncompute);
+  MPI_Comm_dup(static_cast<MPI_Comm>(comm), &p_comm);
+  p_compute = comm.split(p_writer ? 1 : 0);
+
+  // open output file on writers, or on process 0 if there is only one
+  // process
+  bool open = p_writer || p_nwriters == 0;
+  if (open) {
+    char buf[256];
+    if (p_nwriters > 1) {
+      sprintf(buf,"%s.%d",filename.c_str(),me-p_ncompute);
+      p_filename = buf;
+    } else {
+      p_filename = filename;
+    }
+    p_file = fopen(p_filename.c_str(),"wb");
+    if (p_file == NULL) {
+      sprintf(buf,"ResultSink: unable to open file %s\n",p_filename.c_str());
+      printf("%s",buf);
+      throw gridpack::Exception(buf);
+    }
+    int version = 1;
+    fwrite(RESULT_FILE_MAGIC, 1, 4, p_file);
+    fwrite(&version, sizeof(int), 1, p_file);
+    p_offset = 4 + sizeof(int);
+  }
+}
+
+/**
+ * Default destructor
+ */
+ResultSink::~ResultSink(void)
+{
+  if (p_file != NULL) p_close();
+  MPI_Comm_free(&p_comm);
+}
+
+/**
+ * Return true if this process is a writer
+ * @return true if process should call serve
+ */
+bool ResultSink::isWriter(void) const
+{
+  return p_writer;
+}
+
+/**
+ * Return communicator containing the processes that do the calculation
+ * @return compute communicator
+ */
+Communicator ResultSink::computeCommunicator(void) const
+{
+  return p_compute;
+}
+
+/**
+ * Number of writer processes
+ * @return number of writers (0 if there is only one process)
+ */
+int ResultSink::numWriters(void) const
+{
+  return p_nwriters;
+}
+
+/**
+ * Send a record to its writer. Records are assigned to writers by ID
+ * @param record result record
+ */
+void ResultSink::post(const ResultRecord &record)
+{
+  if (p_writer || p_finished) {
+    char buf[256];
+    sprintf(buf,"ResultSink::post: records can only be posted by compute"
+        " processes before finish is called\n");
+    printf("%s",buf);
+    throw gridpack::Exception(buf);
+  }
+  if (p_nwriters == 0) {
+    // There is only one process, so write the record directly
+    record.pack(p_buf);
+    p_write(&p_buf[0], static_cast<int>(p_buf.size()));
+    return;
+  }
+  p_progress(RESULT_MAX_PENDING-1);
+  p_pending.push_back(PendingSend());
+  PendingSend &send = p_pending.back();
+  record.pack(send.buf);
+  int id = record.id();
+  if (id < 0) id = -id;
+  int dest = p_ncompute + id%p_nwriters;
+  MPI_Isend(&send.buf[0], static_cast<int>(send.buf.size()), MPI_BYTE, dest,
+      RESULT_RECORD_TAG, p_comm, &send.request);
+}
+
+/**
+ * Complete all sends and tell the writers that this process is done
+ */
+void ResultSink::finish(void)
+{
+  if (p_writer || p_finished) return;
+  p_finished = true;
+  if (p_nwriters == 0) {
+    if (p_file != NULL) p_close();
+    return;
+  }
+  int i;
+  for (i=0; i<p_nwriters; i++) {
+    p_pending.push_back(PendingSend());
+    PendingSend &send = p_pending.back();
+    MPI_Isend(NULL, 0, MPI_BYTE, p_ncompute+i, RESULT_DONE_TAG, p_comm,
+        &send.request);
+  }
+  p_progress(0);
+}
+
+/**
+ * Receive and write records until all compute processes have called
+ * finish, then write the index and close the file
+ */
+void ResultSink::serve(void)
+{
+  if (!p_writer) return;
+  int done = 0;
+  int nrecords = 0;
+  std::vector<char> buf;
+  while (done < p_ncompute) {
+    MPI_Status status;
+    int len;
+    MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, p_comm, &status);
+    MPI_Get_count(&status, MPI_BYTE, &len);
+    buf.resize(len > 0 ? len : 1);
+    MPI_Recv(&buf[0], len, MPI_BYTE, status.MPI_SOURCE, status.MPI_TAG,
+        p_comm, MPI_STATUS_IGNORE);
+    if (status.MPI_TAG == RESULT_DONE_TAG) {
+      done++;
+    } else {
+      p_write(&buf[0], len);
+      nrecords++;
+    }
+  }
+  long nbytes = p_offset;
+  p_close();
+  printf("Result writer %d: %d records, %ld bytes written to %s\n",
+      p_compute.rank(),nrecords,nbytes,p_filename.c_str());
+}
+
+/**
+ * Write a packed record to the output file
+ * @param buf packed record
+ * @param len length of record in bytes
+ */
+void ResultSink::p_write(const char *buf, int len)
+{
+  ResultIndexEntry entry;
+  int header[4];
+  memcpy(header, buf, sizeof(header));
+  entry.id = header[0];
+  entry.length = len;
+  entry.offset = p_offset;
+  if (fwrite(buf, 1, len, p_file) != static_cast<size_t>(len)) {
+    char ebuf[256];
+    sprintf(ebuf,"ResultSink: error writing to file %s\n",p_filename.c_str());
+    printf("%s",ebuf);
+    throw gridpack::Exception(ebuf);
+  }
+  p_offset += static_cast<long>(len);
+  p_index.push_back(entry);
+}
+
+/**
+ * Write index and close output file. The index is followed by its
+ * offset, the number of entries and an identifier
+ */
+void ResultSink::p_close(void)
+{
+  long nentries = p_index.size();
+  if (nentries > 0) {
+    fwrite(&p_index[0], sizeof(ResultIndexEntry), nentries, p_file);
+  }
+  fwrite(&p_offset, sizeof(long), 1, p_file);
+  fwrite(&nentries, sizeof(long), 1, p_file);
+  fwrite(RESULT_INDEX_MAGIC, 1, 4, p_file);
+  fclose(p_file);
+  p_file = NULL;
+  p_index.clear();
+}
+
+/**
+ * Release buffers of sends that have completed
+ * @param wait wait until no more than this number of sends are pending
+ */
+void ResultSink::p_progress(int wait)
+{
+  while (!p_pending.empty()) {
+    int flag;
+    if (static_cast<int>(p_pending.size()) > wait) {
+      MPI_Wait(&p_pending.front().request, MPI_STATUS_IGNORE);
+      flag = 1;
+    } else {
+      MPI_Test(&p_pending.front().request, &flag, MPI_STATUS_IGNORE);
+    }
+    if (!flag) break;
+    p_pending.pop_front();
+  }
+}
+
+// -------------------------------------------------------------
+//  class ResultFile
+// -------------------------------------------------------------
+
+/**
+ * Default constructor
+ */
+ResultFile::ResultFile(void)
+  : p_file(NULL)
+{
+}
+
+/**
+ * Default destructor
+ */
+ResultFile::~ResultFile(void)
+{
+  close();
+}
+
+/**
+ * Open file and read index
+ * @param filename name of file
+ * @return false if file could not be opened or is not a result file
+ */
+bool ResultFile::open(const std::string &filename)
+{
+  close();
+  p_file = fopen(filename.c_str(),"rb");
+  if (p_file == NULL) return false;
+  char magic[4];
+  long trailer[2];
+  long tsize = 2*sizeof(long)+4;
+  bool ok = (fread(magic, 1, 4, p_file) == 4 &&
+      strncmp(magic, RESULT_FILE_MAGIC, 4) == 0);
+  ok = ok && fseek(p_file, -tsize, SEEK_END) == 0;
+  ok = ok && fread(trailer, sizeof(long), 2, p_file) == 2;
+  ok = ok && fread(magic, 1, 4, p_file) == 4 &&
+    strncmp(magic, RESULT_INDEX_MAGIC, 4) == 0;
+  ok = ok && trailer[1] >= 0 && fseek(p_file, trailer[0], SEEK_SET) == 0;
+  if (ok && trailer[1] > 0) {
+    std::vector<ResultIndexEntry> index(trailer[1]);
+    ok = fread(&index[0], sizeof(ResultIndexEntry), trailer[1], p_file)
+      == static_cast<size_t>(trailer[1]);
+    long i;
+    for (i=0; ok && i<trailer[1]; i++) {
+      p_index[index[i].id] = index[i];
+    }
+  }
+  if (!ok) close();
+  return ok;
+}
+
+/**
+ * Close file
+ */
+void ResultFile::close(void)
+{
+  if (p_file != NULL) fclose(p_file);
+  p_file = NULL;
+  p_index.clear();
+}
+
+/**
+ * Return the IDs of all records in the file
+ * @return record IDs in increasing order
+ */
+std::vector<int> ResultFile::ids(void) const
+{
+  std::vector<int> ret;
+  std::map<int, ResultIndexEntry>::const_iterator it;
+  for (it = p_index.begin(); it != p_index.end(); ++it) {
+    ret.push_back(it->first);
+  }
+  return ret;
+}
+
+/**
+ * Read a record
+ * @param id ID of record
+ * @param record record read from file
+ * @return false if there is no record with this ID
+ */
+bool ResultFile::read(int id, ResultRecord &record)
+{
+  std::map<int, ResultIndexEntry>::iterator it = p_index.find(id);
+  if (p_file == NULL || it == p_index.end()) return false;
+  std::vector<char> buf(it->second.length);
+  if (fseek(p_file, it->second.offset, SEEK_SET) != 0) return false;
+  if (fread(&buf[0], 1, buf.size(), p_file) != buf.size()) return false;
+  return record.unpack(&buf[0], it->second.length);
+}
+
+}   // namespace parallel
+}   // namespace gridpack
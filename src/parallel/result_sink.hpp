@@ -0,0 +1,304 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   result_sink.hpp
+ *
+ * @brief
+ * A service that collects compact binary result records from the
+ * processes doing a calculation and writes them to a single indexed file.
+ * Records are sent with nonblocking sends to one or more writer processes
+ * that are set aside from the calculation, so output is written while the
+ * calculation continues. If there is only one process, records are
+ * written directly to the file.
+ *
+ */
+
+// -------------------------------------------------------------
+
+#ifndef _result_sink_hpp_
+#define _result_sink_hpp_
+
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include "gridpack/parallel/communicator.hpp"
+
+namespace gridpack {
+namespace parallel {
+
+// -------------------------------------------------------------
+//  struct ResultValue
+// -------------------------------------------------------------
+// A single value in a result record. The meaning of kind is defined by
+// the application. Bus values use idx1 for the bus ID, branch values use
+// idx1 and idx2 for the IDs of the buses at either end of the branch and
+// tag for the circuit ID
+struct ResultValue {
+  int kind;
+  int idx1;
+  int idx2;
+  char tag[4];
+  double value;
+};
+
+// -------------------------------------------------------------
+//  struct ResultIndexEntry
+// -------------------------------------------------------------
+// Location of a record in a result file. The index is written at the
+// end of the file, followed by the offset of the index and the number of
+// entries
+struct ResultIndexEntry {
+  int id;
+  int length;
+  long offset;
+};
+
+// -------------------------------------------------------------
+//  class ResultRecord
+// -------------------------------------------------------------
+class ResultRecord {
+public:
+
+  /**
+   * Default constructor
+   */
+  ResultRecord(void);
+
+  /**
+   * Default destructor
+   */
+  ~ResultRecord(void);
+
+  /**
+   * Remove all values and set the header of the record
+   * @param id index of calculation (e.g. contingency index)
+   * @param status status of calculation (e.g. 1 if converged)
+   * @param violations application-defined violation flags
+   */
+  void reset(int id, int status, int violations);
+
+  /**
+   * Add a value to the record
+   * @param kind application-defined type of value
+   * @param idx1 first index of value
+   * @param idx2 second index of value
+   * @param tag up to 2 character tag
+   * @param value value
+   */
+  void addValue(int kind, int idx1, int idx2, const std::string &tag,
+      double value);
+
+  /**
+   * Header of record
+   * @return id, status or violation flags of record
+   */
+  int id(void) const;
+  int status(void) const;
+  int violations(void) const;
+
+  /**
+   * Number of values in record
+   * @return number of values
+   */
+  int size(void) const;
+
+  /**
+   * Return a value
+   * @param idx index of value in record
+   * @return value
+   */
+  const ResultValue& operator[](int idx) const;
+
+  /**
+   * Pack record into a buffer
+   * @param buf buffer that is resized to hold the record
+   */
+  void pack(std::vector<char> &buf) const;
+
+  /**
+   * Unpack record from a buffer
+   * @param buf buffer created by pack
+   * @param len length of buffer in bytes
+   * @return false if the buffer does not hold a complete record
+   */
+  bool unpack(const char *buf, int len);
+
+private:
+
+  int p_id;
+  int p_status;
+  int p_violations;
+  std::vector<ResultValue> p_values;
+};
+
+// -------------------------------------------------------------
+//  class ResultSink
+// -------------------------------------------------------------
+class ResultSink {
+public:
+
+  /**
+   * Set aside writer processes and open the output files. The last
+   * nwriters processes in comm become writers and should call serve. The
+   * remaining processes should do the calculation on the communicator
+   * returned by computeCommunicator and call post and finish. There is
+   * at least one writer and at least one process is left for the
+   * calculation. If there is only one process, it writes records to the
+   * file as they are posted instead of using a writer. Writer k writes
+   * to filename if there is one writer and to filename.k otherwise. This
+   * must be called on all processes in comm
+   * @param comm communicator containing all processes
+   * @param nwriters number of writer processes
+   * @param filename name of output file
+   */
+  ResultSink(const Communicator &comm, int nwriters,
+      const std::string &filename);
+
+  /**
+   * Default destructor
+   */
+  ~ResultSink(void);
+
+  /**
+   * Return true if this process is a writer
+   * @return true if process should call serve
+   */
+  bool isWriter(void) const;
+
+  /**
+   * Return communicator containing the processes that do the calculation.
+   * On writer processes this contains the writers
+   * @return compute communicator
+   */
+  Communicator computeCommunicator(void) const;
+
+  /**
+   * Number of writer processes
+   * @return number of writers (0 if there is only one process)
+   */
+  int numWriters(void) const;
+
+  /**
+   * Send a record to its writer. This returns once the send has been
+   * started. Only processes in the compute communicator can post records
+   * @param record result record
+   */
+  void post(const ResultRecord &record);
+
+  /**
+   * Complete all sends and tell the writers that this process is done.
+   * This must be called on all processes in the compute communicator
+   */
+  void finish(void);
+
+  /**
+   * Receive and write records until all compute processes have called
+   * finish, then write the index and close the file. This must be called
+   * on all writer processes
+   */
+  void serve(void);
+
+private:
+
+  /**
+   * Write a packed record to the output file
+   * @param buf packed record
+   * @param len length of record in bytes
+   */
+  void p_write(const char *buf, int len);
+
+  /**
+   * Write index and close output file
+   */
+  void p_close(void);
+
+  /**
+   * Release buffers of sends that have completed
+   * @param wait wait until no more than this number of sends are pending
+   */
+  void p_progress(int wait);
+
+  struct PendingSend {
+    std::vector<char> buf;
+    MPI_Request request;
+  };
+
+  MPI_Comm p_comm;
+  Communicator p_compute;
+  int p_nwriters;
+  int p_ncompute;
+  bool p_writer;
+  bool p_finished;
+
+  // output file on writers (or process 0 if there is only one process)
+  FILE *p_file;
+  std::string p_filename;
+  long p_offset;
+  std::vector<ResultIndexEntry> p_index;
+
+  // sends that have been started on compute processes
+  std::deque<PendingSend> p_pending;
+  std::vector<char> p_buf;
+};
+
+// -------------------------------------------------------------
+//  class ResultFile
+// -------------------------------------------------------------
+// Read records from a file written by ResultSink
+class ResultFile {
+public:
+
+  /**
+   * Default constructor
+   */
+  ResultFile(void);
+
+  /**
+   * Default destructor
+   */
+  ~ResultFile(void);
+
+  /**
+   * Open file and read index
+   * @param filename name of file
+   * @return false if file could not be opened or is not a result file
+   */
+  bool open(const std::string &filename);
+
+  /**
+   * Close file
+   */
+  void close(void);
+
+  /**
+   * Return the IDs of all records in the file
+   * @return record IDs in increasing order
+   */
+  std::vector<int> ids(void) const;
+
+  /**
+   * Read a record
+   * @param id ID of record
+   * @param record record read from file
+   * @return false if there is no record with this ID
+   */
+  bool read(int id, ResultRecord &record);
+
+private:
+
+  FILE *p_file;
+  std::map<int, ResultIndexEntry> p_index;
+};
+
+}   // namespace parallel
+}   // namespace gridpack
+
+#endif
@@ -0,0 +1,178 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   shared_buffer.cpp
+ * 
+ * @brief  
+ * A block of memory that is allocated once on each node and can be read
+ * by all processes on the node
+ * 
+ */
+
+// -------------------------------------------------------------
+
+#include <cstdio>
+#include "gridpack/parallel/shared_buffer.hpp"
+#include "gridpack/utilities/exception.hpp"
+
+namespace gridpack {
+namespace parallel {
+
+/**
+ * Divide communicator into groups of processes that share memory.
+ * This must be called on all processes in comm
+ * @param comm communicator containing all processes that use buffer
+ */
+NodeSharedBuffer::NodeSharedBuffer(const Communicator &comm)
+  : p_data(NULL), p_size(0), p_allocated(false)
+{
+  MPI_Comm mpi_comm = static_cast<MPI_Comm>(comm);
+#if MPI_VERSION >= 3
+  MPI_Comm_split_type(mpi_comm, MPI_COMM_TYPE_SHARED, comm.rank(),
+      MPI_INFO_NULL, &p_node);
+#else
+  MPI_Comm_split(mpi_comm, comm.rank(), 0, &p_node);
+#endif
+  MPI_Comm_rank(p_node, &p_nodeRank);
+  MPI_Comm_size(p_node, &p_nodeSize);
+}
+
+/**
+ * Default destructor. Releases buffer. This must be called on all
+ * processes in the communicator
+ */
+NodeSharedBuffer::~NodeSharedBuffer(void)
+{
+  p_free();
+  MPI_Comm_free(&p_node);
+}
+
+/**
+ * Allocate buffer. Only the size on the node leader is used and only
+ * the node leader should write to the buffer. Any previous buffer is
+ * released. This must be called on all processes in the communicator
+ * @param size number of bytes in buffer (ignored on other processes)
+ */
+void NodeSharedBuffer::allocate(size_t size)
+{
+  p_free();
+#if MPI_VERSION >= 3
+  MPI_Aint lsize = p_nodeRank == 0 ? static_cast<MPI_Aint>(size) : 0;
+  int ierr = MPI_Win_allocate_shared(lsize, 1, MPI_INFO_NULL, p_node,
+      &p_data, &p_win);
+  if (ierr != MPI_SUCCESS) {
+    char buf[256];
+    sprintf(buf,"NodeSharedBuffer: unable to allocate %ld bytes\n",
+        static_cast<long>(size));
+    printf("%s",buf);
+    throw gridpack::Exception(buf);
+  }
+  MPI_Aint qsize;
+  int disp;
+  MPI_Win_shared_query(p_win, 0, &qsize, &disp, &p_data);
+  p_size = static_cast<size_t>(qsize);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, p_win);
+#else
+  p_data = new char[size];
+  p_size = size;
+#endif
+  p_allocated = true;
+}
+
+/**
+ * Wait until the node leader has finished writing to the buffer. This
+ * must be called on all processes in the communicator
+ */
+void NodeSharedBuffer::sync(void)
+{
+#if MPI_VERSION >= 3
+  if (p_allocated) MPI_Win_sync(p_win);
+  MPI_Barrier(p_node);
+  if (p_allocated) MPI_Win_sync(p_win);
+#endif
+}
+
+/**
+ * Return pointer to buffer
+ * @return start of buffer (NULL if no buffer is allocated)
+ */
+char* NodeSharedBuffer::data(void)
+{
+  return p_data;
+}
+
+const char* NodeSharedBuffer::data(void) const
+{
+  return p_data;
+}
+
+/**
+ * Return size of buffer
+ * @return number of bytes in buffer
+ */
+size_t NodeSharedBuffer::size(void) const
+{
+  return p_size;
+}
+
+/**
+ * Return true if this process allocates and writes the buffer for its
+ * node
+ * @return true if process has rank 0 on the node
+ */
+bool NodeSharedBuffer::isNodeLeader(void) const
+{
+  return p_nodeRank == 0;
+}
+
+/**
+ * Rank of process on node
+ * @return rank in node communicator
+ */
+int NodeSharedBuffer::nodeRank(void) const
+{
+  return p_nodeRank;
+}
+
+/**
+ * Number of processes on node
+ * @return size of node communicator
+ */
+int NodeSharedBuffer::nodeSize(void) const
+{
+  return p_nodeSize;
+}
+
+/**
+ * Return communicator containing processes on this node
+ * @return node communicator
+ */
+MPI_Comm NodeSharedBuffer::nodeCommunicator(void) const
+{
+  return p_node;
+}
+
+/**
+ * Release buffer
+ */
+void NodeSharedBuffer::p_free(void)
+{
+  if (!p_allocated) return;
+#if MPI_VERSION >= 3
+  MPI_Win_unlock_all(p_win);
+  MPI_Win_free(&p_win);
+#else
+  delete [] p_data;
+#endif
+  p_data = NULL;
+  p_size = 0;
+  p_allocated = false;
+}
+
+}   // namespace parallel
+}   // namespace gridpack
@@ -0,0 +1,123 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   shared_buffer.hpp
+ * 
+ * @brief  
+ * A block of memory that is allocated once on each node and can be read
+ * by all processes on the node. This uses an MPI-3 shared memory window.
+ * If the MPI library does not support MPI-3, each process is treated as
+ * a separate node and gets its own copy of the buffer.
+ * 
+ */
+
+// -------------------------------------------------------------
+
+#ifndef _shared_buffer_hpp_
+#define _shared_buffer_hpp_
+
+#include <cstddef>
+#include <mpi.h>
+#include "gridpack/parallel/communicator.hpp"
+
+namespace gridpack {
+namespace parallel {
+
+// -------------------------------------------------------------
+//  class NodeSharedBuffer
+// -------------------------------------------------------------
+class NodeSharedBuffer {
+public:
+
+  /**
+   * Divide communicator into groups of processes that share memory.
+   * This must be called on all processes in comm
+   * @param comm communicator containing all processes that use buffer
+   */
+  NodeSharedBuffer(const Communicator &comm);
+
+  /**
+   * Default destructor. Releases buffer. This must be called on all
+   * processes in the communicator
+   */
+  ~NodeSharedBuffer(void);
+
+  /**
+   * Allocate buffer. Only the size on the node leader is used and only
+   * the node leader should write to the buffer. Any previous buffer is
+   * released. This must be called on all processes in the communicator
+   * @param size number of bytes in buffer (ignored on other processes)
+   */
+  void allocate(size_t size);
+
+  /**
+   * Wait until the node leader has finished writing to the buffer. This
+   * must be called on all processes in the communicator
+   */
+  void sync(void);
+
+  /**
+   * Return pointer to buffer
+   * @return start of buffer (NULL if no buffer is allocated)
+   */
+  char* data(void);
+  const char* data(void) const;
+
+  /**
+   * Return size of buffer
+   * @return number of bytes in buffer
+   */
+  size_t size(void) const;
+
+  /**
+   * Return true if this process allocates and writes the buffer for its
+   * node
+   * @return true if process has rank 0 on the node
+   */
+  bool isNodeLeader(void) const;
+
+  /**
+   * Rank of process on node
+   * @return rank in node communicator
+   */
+  int nodeRank(void) const;
+
+  /**
+   * Number of processes on node
+   * @return size of node communicator
+   */
+  int nodeSize(void) const;
+
+  /**
+   * Return communicator containing processes on this node
+   * @return node communicator
+   */
+  MPI_Comm nodeCommunicator(void) const;
+
+private:
+
+  /**
+   * Release buffer
+   */
+  void p_free(void);
+
+  MPI_Comm p_node;
+  int p_nodeRank;
+  int p_nodeSize;
+  char *p_data;
+  size_t p_size;
+#if MPI_VERSION >= 3
+  MPI_Win p_win;
+#endif
+  bool p_allocated;
+};
+
+}   // namespace parallel
+}   // namespace gridpack
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   result_test.cpp
+ *
+ * @brief  A simple test of the GridPACK result sink module
+ *
+ *
+ */
+
+// -------------------------------------------------------------
+// -------------------------------------------------------------
+// Battelle Memorial Institute
+// Pacific Northwest Laboratory
+// -------------------------------------------------------------
+
+#include <iostream>
+#include <cstdio>
+#include <ga.h>
+#include "gridpack/parallel/parallel.hpp"
+#include "gridpack/parallel/result_sink.hpp"
+#include "gridpack/environment/environment.hpp"
+
+#define NUM_RECORDS  200
+
+// -------------------------------------------------------------
+//  Main Program
+// -------------------------------------------------------------
+
+int
+main(int argc, char **argv)
+{
+  gridpack::Environment env(argc, argv);
+  // Create an artificial scope so that all objects call their destructors
+  // before GA_Terminate is called
+  if (1) {
+    gridpack::parallel::Communicator world;
+    int me = world.rank();
+    int nproc = world.size();
+    if (me == 0) {
+      printf("Testing ResultSink on %d processors\n\n",nproc);
+    }
+    int nwriters = nproc/4;
+    int i, j;
+    {
+      gridpack::parallel::ResultSink sink(world, nwriters, "results.bin");
+      nwriters = sink.numWriters();
+      if (sink.isWriter()) {
+        sink.serve();
+      } else {
+        // Each compute process posts a block of records. The number of
+        // values in a record depends on its ID
+        gridpack::parallel::Communicator comm = sink.computeCommunicator();
+        int lo = comm.rank()*NUM_RECORDS/comm.size();
+        int hi = (comm.rank()+1)*NUM_RECORDS/comm.size()-1;
+        gridpack::parallel::ResultRecord record;
+        for (i=lo; i<=hi; i++) {
+          record.reset(i, i%2, i%5);
+          for (j=0; j<i%7; j++) {
+            record.addValue(j%2, i, j, "1", static_cast<double>(i+j));
+          }
+          sink.post(record);
+        }
+        sink.finish();
+      }
+    }
+    world.sync();
+
+    // Read back records on process 0
+    int chk = 1;
+    if (me == 0) {
+      int nfound = 0;
+      int nfiles = (nwriters > 1 ? nwriters : 1);
+      int k;
+      for (k=0; k<nfiles; k++) {
+        char buf[128];
+        if (nwriters > 1) {
+          sprintf(buf,"results.bin.%d",k);
+        } else {
+          sprintf(buf,"results.bin");
+        }
+        gridpack::parallel::ResultFile file;
+        if (!file.open(buf)) {
+          printf("Unable to open result file %s\n",buf);
+          chk = 0;
+          continue;
+        }
+        std::vector<int> ids = file.ids();
+        for (i=0; i<static_cast<int>(ids.size()); i++) {
+          gridpack::parallel::ResultRecord record;
+          int id = ids[i];
+          bool ok = file.read(id, record);
+          ok = ok && record.id() == id && record.status() == id%2
+            && record.violations() == id%5 && record.size() == id%7;
+          if (nwriters > 1) ok = ok && id%nwriters == k;
+          for (j=0; ok && j<record.size(); j++) {
+            ok = record[j].kind == j%2 && record[j].idx1 == id
+              && record[j].idx2 == j && std::string(record[j].tag) == "1"
+              && record[j].value == static_cast<double>(id+j);
+          }
+          if (!ok) {
+            printf("Mistake found in record %d of file %s\n",id,buf);
+            chk = 0;
+          }
+          nfound++;
+        }
+      }
+      if (nfound != NUM_RECORDS) {
+        printf("Expected %d records found %d\n",NUM_RECORDS,nfound);
+        chk = 0;
+      }
+      if (chk) {
+        printf("Records OK\n");
+      } else {
+        printf("Error found in records\n");
+      }
+    }
+  }
+  return 0;
+}
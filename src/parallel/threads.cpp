@@ -0,0 +1,63 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   threads.cpp
+ * 
+ * @brief  
+ * Control of thread parallel loops over the local buses and branches on
+ * each process
+ * 
+ */
+
+// -------------------------------------------------------------
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "gridpack/parallel/threads.hpp"
+
+namespace gridpack {
+namespace parallel {
+
+static bool s_threadedLoops = false;
+
+/**
+ * Return the number of threads available to each process
+ * @return number of threads (1 if GridPACK is not built with OpenMP)
+ */
+int numThreads(void)
+{
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+/**
+ * Allow or disallow thread parallel loops over buses and branches
+ * @param flag true if loops in factories and mappers can use threads
+ */
+void setThreadedLoops(bool flag)
+{
+  s_threadedLoops = flag;
+}
+
+/**
+ * Check whether loops over buses and branches should use threads
+ * @return true if threaded loops are enabled and more than one thread
+ * is available
+ */
+bool threadedLoops(void)
+{
+  return s_threadedLoops && numThreads() > 1;
+}
+
+}   // namespace parallel
+}   // namespace gridpack
@@ -0,0 +1,51 @@
+// Emacs Mode Line: -*- Mode:c++;-*-
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   threads.hpp
+ * 
+ * @brief  
+ * Control of thread parallel loops over the local buses and branches on
+ * each process. If GridPACK is built with OpenMP (USE_OPENMP), loops in
+ * the factories and mappers that call component methods can be split
+ * across threads. This is off by default, since it requires that the
+ * component methods called from these loops only modify the component
+ * itself. The number of threads is set with OMP_NUM_THREADS.
+ * 
+ */
+
+// -------------------------------------------------------------
+
+#ifndef _threads_hpp_
+#define _threads_hpp_
+
+namespace gridpack {
+namespace parallel {
+
+/**
+ * Return the number of threads available to each process
+ * @return number of threads (1 if GridPACK is not built with OpenMP)
+ */
+int numThreads(void);
+
+/**
+ * Allow or disallow thread parallel loops over buses and branches
+ * @param flag true if loops in factories and mappers can use threads
+ */
+void setThreadedLoops(bool flag);
+
+/**
+ * Check whether loops over buses and branches should use threads
+ * @return true if threaded loops are enabled and more than one thread
+ * is available
+ */
+bool threadedLoops(void);
+
+}   // namespace parallel
+}   // namespace gridpack
+
+#endif
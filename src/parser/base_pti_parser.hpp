@@ -14,9 +14,11 @@
 #define OLD_MAP
 
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 #ifndef OLD_MAP
 #include <boost/unordered_map.hpp>
 #endif
@@ -32,6 +34,10 @@
 #include "gridpack/network/base_network.hpp"
 #include "gridpack/parser/base_parser.hpp"
 #include "gridpack/parser/hash_distr.hpp"
+#include "gridpack/parallel/index_hash.hpp"
+#include <boost/mpi/collectives.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/string.hpp>
 #include "gridpack/factory/base_factory.hpp"
 #include "parser_classes/gencls.hpp"
 #include "parser_classes/gensal.hpp"
@@ -82,10 +88,27 @@ class BasePTIParser : public BaseParser<_network>
      * @param fileName name of file
      */
     void externalParse(const std::string &fileName)
+    {
+      externalParse(fileName, false);
+    }
+
+    /**
+     * Parse a second file after original network has been distributed.
+     * If parallel is true, .dyr files are read by all processors (see
+     * getDSParallel), otherwise they are read by process 0 and the
+     * parameters are then distributed
+     * @param fileName name of file
+     * @param parallel read .dyr file on all processors
+     */
+    void externalParse(const std::string &fileName, bool parallel)
     {
       std::string ext = getExtension(fileName);
       if (ext == "dyr") {
-        getDSExternal(fileName);
+        if (parallel) {
+          getDSParallel(fileName);
+        } else {
+          getDSExternal(fileName);
+        }
         expandBusModels();
       } else if (ext == "uc") {
         getUCExternal(fileName);
@@ -1003,6 +1026,146 @@ class BasePTIParser : public BaseParser<_network>
       }
     }
 
+    // Compact record from a .dyr file. The text of the record (with the
+    // trailing comment removed) is sent to the processors that own the
+    // device and is only converted to parameters there
+    struct ds_record{
+      int type; // device type (one of DS_GENERATOR, DS_LOAD, etc.)
+      int bus_id; // original index of bus (from bus for branch devices)
+      int bus_id2; // original index of to bus for branch devices
+      std::string id; // device ID
+      std::string text; // comma separated fields of record
+
+      template<class Archive> void serialize(Archive &ar, const unsigned int)
+      {
+        ar & type & bus_id & bus_id2 & id & text;
+      }
+    };
+
+    enum DSDeviceType {DS_GENERATOR, DS_BUS, DS_LOAD, DS_BRANCH};
+
+    /**
+     * This routine reads a .dyr file with parameters for dynamic
+     * simulation on all processors and sends each record directly to the
+     * processors holding the corresponding bus or branch. Each processor
+     * reads a contiguous range of bytes from the file and parses the
+     * records that start in that range. Owners of buses and branches are
+     * found from the original indices of the buses on each processor and
+     * records are routed to them in a single all-to-all exchange. Records
+     * are applied in the same order that they appear in the file. This
+     * assumes that the network has already been partitioned
+     * @param fileName name of .dyr file
+     */
+    void getDSParallel(const std::string & fileName)
+    {
+      int t_ds = p_timer->createCategory("Parser:getDSParallel");
+      p_timer->start(t_ds);
+      const gridpack::parallel::Communicator &comm = p_network->communicator();
+      int me = comm.rank();
+      int nprocs = comm.size();
+
+      // Read records from local part of file
+      std::vector<ds_record> records;
+      int ok = readDSRecords(fileName, records) ? 1 : 0;
+      comm.min(&ok,1);
+      if (!ok) {
+        if (me == 0) {
+          printf("Unable to open dynamic parameter file %s\n",
+              fileName.c_str());
+        }
+        p_timer->stop(t_ds);
+        return;
+      }
+
+      // Find processors that hold each bus and branch referenced by a
+      // record. Ghost copies receive the record as well
+      int nbus = p_network->numBuses();
+      int nbranch = p_network->numBranches();
+      int i, j, idx1, idx2;
+      gridpack::hash_map::GlobalIndexHashMap hashMap(comm);
+      std::vector<std::pair<int,int> > busPairs;
+      std::set<int> localBuses;
+      for (i=0; i<nbus; i++) {
+        idx1 = p_network->getOriginalBusIndex(i);
+        if (localBuses.insert(idx1).second) {
+          busPairs.push_back(std::pair<int,int>(idx1,me));
+        }
+      }
+      hashMap.addPairs(busPairs);
+      std::vector<std::pair<std::pair<int,int>,int> > branchPairs;
+      std::set<std::pair<int,int> > localBranches;
+      for (i=0; i<nbranch; i++) {
+        p_network->getOriginalBranchEndpoints(i,&idx1,&idx2);
+        std::pair<int,int> key(idx1,idx2);
+        if (localBranches.insert(key).second) {
+          branchPairs.push_back(std::pair<std::pair<int,int>,int>(key,me));
+        }
+      }
+      hashMap.addPairs(branchPairs);
+
+      std::set<int> busSet;
+      std::set<std::pair<int,int> > branchSet;
+      int nrec = records.size();
+      for (i=0; i<nrec; i++) {
+        if (records[i].type == DS_BRANCH) {
+          branchSet.insert(std::pair<int,int>(records[i].bus_id,
+                records[i].bus_id2));
+        } else {
+          busSet.insert(records[i].bus_id);
+        }
+      }
+      std::vector<int> busKeys(busSet.begin(), busSet.end());
+      std::vector<int> busOwners;
+      hashMap.getValues(busKeys, busOwners);
+      std::multimap<int,int> busOwnerMap;
+      for (i=0; i<busKeys.size(); i++) {
+        busOwnerMap.insert(std::pair<int,int>(busKeys[i],busOwners[i]));
+      }
+      std::vector<std::pair<int,int> > branchKeys(branchSet.begin(),
+          branchSet.end());
+      std::vector<int> branchOwners;
+      hashMap.getValues(branchKeys, branchOwners);
+      std::multimap<std::pair<int,int>,int> branchOwnerMap;
+      for (i=0; i<branchKeys.size(); i++) {
+        branchOwnerMap.insert(std::pair<std::pair<int,int>,int>(
+              branchKeys[i],branchOwners[i]));
+      }
+
+      // Route records to owners
+      std::vector<std::vector<ds_record> > sendRecords(nprocs);
+      for (i=0; i<nrec; i++) {
+        if (records[i].type == DS_BRANCH) {
+          std::pair<int,int> key(records[i].bus_id,records[i].bus_id2);
+          std::multimap<std::pair<int,int>,int>::iterator it
+            = branchOwnerMap.find(key);
+          while (it != branchOwnerMap.end() && it->first == key) {
+            sendRecords[it->second].push_back(records[i]);
+            it++;
+          }
+        } else {
+          std::multimap<int,int>::iterator it
+            = busOwnerMap.find(records[i].bus_id);
+          while (it != busOwnerMap.end() && it->first == records[i].bus_id) {
+            sendRecords[it->second].push_back(records[i]);
+            it++;
+          }
+        }
+      }
+      records.clear();
+      std::vector<std::vector<ds_record> > recvRecords;
+      boost::mpi::all_to_all(comm.getCommunicator(), sendRecords, recvRecords);
+      sendRecords.clear();
+
+      // Apply records in file order. Processor i read a part of the file
+      // that precedes the part read by processor i+1
+      for (i=0; i<nprocs; i++) {
+        for (j=0; j<recvRecords[i].size(); j++) {
+          applyDSRecord(recvRecords[i][j]);
+        }
+      }
+      p_timer->stop(t_ds);
+    }
+
     struct uc_params{
       int bus_id; // ID of bus that owns generator
       char gen_id[3]; // Generator ID
@@ -1604,6 +1767,241 @@ class BasePTIParser : public BaseParser<_network>
       }
     }
 
+    /**
+     * Read the records in a .dyr file that start in the range of bytes
+     * assigned to this processor. The file is divided into equal byte
+     * ranges and a record belongs to the processor whose range contains
+     * the first non-blank line of the record
+     * @param fileName name of .dyr file
+     * @param records list of records read by this processor
+     * @return false if file could not be opened
+     */
+    bool readDSRecords(const std::string &fileName,
+        std::vector<ds_record> &records)
+    {
+      records.clear();
+      std::ifstream fin(fileName.c_str(), std::ios::in | std::ios::binary);
+      if (!fin.is_open()) return false;
+      fin.seekg(0, std::ios::end);
+      long fsize = static_cast<long>(fin.tellg());
+      int me = p_network->communicator().rank();
+      int nprocs = p_network->communicator().size();
+      long lo = static_cast<long>((static_cast<double>(fsize)*me)/nprocs);
+      long hi = static_cast<long>((static_cast<double>(fsize)*(me+1))/nprocs);
+      if (me == nprocs-1) hi = fsize;
+
+      // Find beginning of first record that starts at or after lo. The
+      // line containing byte lo-1 belongs to the previous range. If it
+      // does not complete a record, the following lines are the remainder
+      // of a record that is read by the previous processor
+      std::string line;
+      long pos = 0;
+      if (lo > 0) {
+        long start = lo-1;
+        char c;
+        while (start > 0) {
+          fin.seekg(start-1);
+          fin.get(c);
+          if (c == '\n') break;
+          start--;
+        }
+        fin.seekg(start);
+        std::getline(fin, line);
+        pos = start + static_cast<long>(line.size()) + 1;
+        bool boundary = (line.find('/') != std::string::npos ||
+            line.find_first_not_of(" \t\r") == std::string::npos);
+        while (!boundary && pos < fsize && std::getline(fin, line)) {
+          pos += static_cast<long>(line.size()) + 1;
+          boundary = (line.find('/') != std::string::npos);
+        }
+      }
+
+      gridpack::utility::StringUtils util;
+      while (pos < hi && std::getline(fin, line)) {
+        pos += static_cast<long>(line.size()) + 1;
+        // Check to see if line is blank
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        std::string record = line;
+        int idx = line.find('/');
+        while (idx == std::string::npos && std::getline(fin, line)) {
+          pos += static_cast<long>(line.size()) + 1;
+          idx = line.find('/');
+          record.append(line);
+        }
+        idx = record.find('/');
+        if (idx != std::string::npos) record.erase(idx,record.length()-idx);
+        std::vector<std::string>  split_line;
+        boost::split(split_line, record, boost::algorithm::is_any_of(","),
+            boost::token_compress_on);
+        if (split_line.size() < 3) continue;
+
+        std::string sval = util.trimQuotes(split_line[1]);
+        util.toUpper(sval);
+        ds_record data;
+        data.bus_id2 = -1;
+        if (onGenerator(sval)) {
+          data.type = DS_GENERATOR;
+          data.bus_id = atoi(split_line[0].c_str());
+          data.id = util.clean2Char(split_line[2]);
+        } else if (onLoad(sval)) {
+          data.type = DS_LOAD;
+          data.bus_id = atoi(split_line[0].c_str());
+          data.id = util.clean2Char(split_line[2]);
+        } else if (onBus(sval)) {
+          data.type = DS_BUS;
+          if (sval == "FRQTPAT") {
+            if (split_line.size() < 4) continue;
+            data.bus_id = atoi(split_line[3].c_str());
+          } else {
+            data.bus_id = atoi(split_line[0].c_str());
+          }
+        } else if (onBranch(sval)) {
+          if (split_line.size() < 4) continue;
+          data.type = DS_BRANCH;
+          data.bus_id = atoi(split_line[0].c_str());
+          data.bus_id2 = atoi(split_line[3].c_str());
+        } else {
+          continue;
+        }
+        data.text = record;
+        records.push_back(data);
+      }
+      fin.close();
+      return true;
+    }
+
+    /**
+     * Store parameters from a .dyr record in the data collection objects
+     * of all local copies of the bus or branch that the record refers to.
+     * Models are handled the same way as in getDSExternal
+     * @param record record read by readDSRecords
+     */
+    void applyDSRecord(const ds_record &record)
+    {
+      std::vector<std::string>  split_line;
+      boost::split(split_line, record.text, boost::algorithm::is_any_of(","),
+          boost::token_compress_on);
+      gridpack::utility::StringUtils util;
+      std::string sval = util.trimQuotes(split_line[1]);
+      util.toUpper(sval);
+      gridpack::component::DataCollection *data;
+      int i, j;
+
+      if (record.type == DS_BRANCH) {
+        std::vector<int> branches =
+          p_network->getLocalBranchIndices(record.bus_id,record.bus_id2);
+        for (i=0; i<branches.size(); i++) {
+          data = p_network->getBranchData(branches[i]).get();
+          if (sval == "DISTR1") {
+            Distr1Parser<branch_relay_params> parser;
+            parser.parse(split_line, data);
+          }
+        }
+        return;
+      }
+
+      std::vector<int> buses = p_network->getLocalBusIndices(record.bus_id);
+      for (i=0; i<buses.size(); i++) {
+        data = p_network->getBusData(buses[i]).get();
+        if (record.type == DS_GENERATOR) {
+          // Identify index of generator to which this data applies
+          int ngen = 0;
+          data->getValue(GENERATOR_NUMBER, &ngen);
+          int g_id = -1;
+          for (j=0; j<ngen; j++) {
+            std::string t_id;
+            data->getValue(GENERATOR_ID,&t_id,j);
+            if (record.id == t_id) {
+              g_id = j;
+              break;
+            }
+          }
+          if (g_id < 0) continue;
+          if (sval == "GENCLS") {
+            GenclsParser<gen_params> parser;
+            parser.parse(split_line, data, g_id);
+          } else if (sval == "GENSAL") {
+            GensalParser<gen_params> parser;
+            parser.parse(split_line, data, g_id);
+          } else if (sval == "GENROU") {
+            GenrouParser<gen_params> parser;
+            parser.parse(split_line, data, g_id);
+          } else if (sval == "GDFORM") {
+            GdformParser<gen_params> parser;
+            parser.parse(split_line, data, g_id);
+          } else if (sval == "WSIEG1") {
+            Wsieg1Parser<gen_params> parser;
+            parser.parse(split_line, data, g_id);
+          } else if (sval == "EXDC1" || sval == "EXDC2") {
+            Exdc1Parser<gen_params> parser;
+            parser.parse(split_line, data, g_id);
+          } else if (sval == "ESST1A") {
+            Esst1aParser<gen_params> parser;
+            parser.parse(split_line, data, g_id);
+          } else if (sval == "ESST4B") {
+            Esst4bParser<gen_params> parser;
+            parser.parse(split_line, data, g_id);
+          } else if (sval == "GGOV1") {
+            Ggov1Parser<gen_params> parser;
+            parser.parse(split_line, data, g_id);
+          } else if (sval == "TGOV1") {
+            Tgov1Parser<gen_params> parser;
+            parser.parse(split_line, data, g_id);
+          } else if (sval == "WSHYGP") {
+            WshygpParser<gen_params> parser;
+            parser.parse(split_line, data, g_id);
+          } else if (sval == "PSSSIM") {
+            PsssimParser<gen_params> parser;
+            parser.parse(split_line, data, g_id);
+          }
+        } else if (record.type == DS_BUS) {
+          if (sval == "LVSHBL") {
+            LvshblParser<bus_relay_params> parser;
+            parser.parse(split_line, data);
+          } else if (sval == "FRQTPAT") {
+            FrqtpatParser<bus_relay_params> parser;
+            parser.parse(split_line, data);
+          }
+        } else if (record.type == DS_LOAD) {
+          // Identify index of load to which this data applies
+          int nload = 0;
+          data->getValue(LOAD_NUMBER, &nload);
+          int l_id = -1;
+          for (j=0; j<nload; j++) {
+            std::string t_id;
+            data->getValue(LOAD_ID,&t_id,j);
+            if (record.id == t_id) {
+              l_id = j;
+              break;
+            }
+          }
+          if (l_id < 0) {
+            printf("No match found for load on bus %d with tag %s\n",
+                record.bus_id,record.id.c_str());
+            continue;
+          }
+          if (sval == "CIM6BL") {
+            Cim6blParser<load_params> parser;
+            parser.parse(split_line, data, l_id);
+          } else if (sval == "IEELBL") {
+            IeelblParser<load_params> parser;
+            parser.parse(split_line, data, l_id);
+          } else if (sval == "USRLOD" && split_line.size() > 3) {
+            std::string sdev;
+            sdev = util.trimQuotes(split_line[3]);
+            if (sdev == "ACMTBLU1") {
+              Acmtblu1Parser<load_params> parser;
+              parser.parse(split_line, data, l_id);
+            } else if (sdev == "CMLDBLU1") {
+              Cmldblu1Parser<load_params> parser;
+              parser.parse(split_line, data, l_id);
+            }
+          }
+        }
+      }
+    }
+
     void find_uc_vector(std::vector<uc_params> *uc_vector)
     {
       std::string          line;
@@ -0,0 +1,501 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+// -------------------------------------------------------------
+/**
+ * @file   memory_parser.hpp
+ *
+ * @brief
+ * Create a network directly from in-memory, column oriented arrays
+ * instead of a network file. Each process supplies an arbitrary share
+ * of the buses, branches and devices. DataCollection objects are built
+ * locally and device records are moved to the process holding their
+ * bus using HashDistribution, so no text I/O is involved and no process
+ * needs to hold the complete model.
+ *
+ * Typical use on every process:
+ *
+ *   MemoryParser<MyNetwork> parser(network);
+ *   parser.setCase(1, 100.0);
+ *   parser.addBuses(buses);
+ *   parser.addBranches(branches);
+ *   parser.addGenerators(generators);
+ *   parser.addLoads(loads);
+ *   parser.ingest();
+ *   network->partition();
+ *
+ * Columns other than the bus numbers may be left empty, in which case
+ * the corresponding field is given a default value (or omitted, for
+ * optional fields). Parallel circuits between the same pair of buses
+ * must be supplied on the same process.
+ */
+// -------------------------------------------------------------
+
+#ifndef _memory_parser_hpp_
+#define _memory_parser_hpp_
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gridpack/parser/base_parser.hpp"
+#include "gridpack/parser/hash_distr.hpp"
+#include "gridpack/utilities/string_utils.hpp"
+
+namespace gridpack {
+namespace parser {
+
+/// Bus records in column format
+struct BusColumns {
+  std::vector<int> number;          // BUS_NUMBER (required)
+  std::vector<int> type;            // BUS_TYPE (default 1)
+  std::vector<std::string> name;    // BUS_NAME
+  std::vector<double> baseKV;       // BUS_BASEKV (default 1.0)
+  std::vector<double> vm;           // BUS_VOLTAGE_MAG (default 1.0)
+  std::vector<double> va;           // BUS_VOLTAGE_ANG (default 0.0)
+  std::vector<double> gl;           // BUS_SHUNT_GL
+  std::vector<double> bl;           // BUS_SHUNT_BL
+  std::vector<int> area;            // BUS_AREA (default 1)
+  std::vector<int> zone;            // BUS_ZONE (default 1)
+};
+
+/// Branch records in column format. Each entry is one circuit
+struct BranchColumns {
+  std::vector<int> from;            // BRANCH_FROMBUS (required)
+  std::vector<int> to;              // BRANCH_TOBUS (required)
+  std::vector<std::string> ckt;     // BRANCH_CKT (default "1 ")
+  std::vector<double> r;            // BRANCH_R
+  std::vector<double> x;            // BRANCH_X
+  std::vector<double> b;            // BRANCH_B
+  std::vector<double> rateA;        // BRANCH_RATING_A
+  std::vector<double> rateB;        // BRANCH_RATING_B
+  std::vector<double> rateC;        // BRANCH_RATING_C
+  std::vector<double> tap;          // BRANCH_TAP (default 0.0, no transformer)
+  std::vector<double> shift;        // BRANCH_SHIFT
+  std::vector<int> status;          // BRANCH_STATUS (default 1)
+};
+
+/// Generator records in column format
+struct GeneratorColumns {
+  std::vector<int> bus;             // GENERATOR_BUSNUMBER (required)
+  std::vector<std::string> id;      // GENERATOR_ID (default "1 ")
+  std::vector<double> pg;           // GENERATOR_PG
+  std::vector<double> qg;           // GENERATOR_QG
+  std::vector<double> qmax;         // GENERATOR_QMAX
+  std::vector<double> qmin;         // GENERATOR_QMIN
+  std::vector<double> vs;           // GENERATOR_VS (default 1.0)
+  std::vector<double> mbase;        // GENERATOR_MBASE (default 100.0)
+  std::vector<double> pmax;         // GENERATOR_PMAX
+  std::vector<double> pmin;         // GENERATOR_PMIN
+  std::vector<int> status;          // GENERATOR_STAT (default 1)
+};
+
+/// Load records in column format
+struct LoadColumns {
+  std::vector<int> bus;             // LOAD_BUSNUMBER (required)
+  std::vector<std::string> id;      // LOAD_ID (default "1 ")
+  std::vector<double> pl;           // LOAD_PL
+  std::vector<double> ql;           // LOAD_QL
+  std::vector<double> ip;           // LOAD_IP
+  std::vector<double> iq;           // LOAD_IQ
+  std::vector<double> yp;           // LOAD_YP
+  std::vector<double> yq;           // LOAD_YQ
+  std::vector<int> status;          // LOAD_STATUS (default 1)
+};
+
+template <class _network>
+class MemoryParser : public BaseParser<_network>
+{
+  public:
+
+    /**
+     * Constructor
+     * @param network network object that will be filled with the
+     * supplied data (must be child of network::BaseNetwork<>)
+     */
+    MemoryParser(boost::shared_ptr<_network> network)
+    {
+      this->setNetwork(network);
+      this->setCaseID(0);
+      this->setCaseSBase(100.0);
+    }
+
+    /**
+     * Destructor
+     */
+    virtual ~MemoryParser()
+    {
+    }
+
+    /**
+     * Set case parameters
+     * @param id case ID
+     * @param sbase system base (MVA)
+     */
+    void setCase(int id, double sbase)
+    {
+      this->setCaseID(id);
+      this->setCaseSBase(sbase);
+    }
+
+    /**
+     * Add buses owned by this process. May be called more than once
+     * @param cols bus data
+     */
+    void addBuses(const BusColumns &cols)
+    {
+      int n = cols.number.size();
+      checkSize("addBuses","type",cols.type.size(),n);
+      checkSize("addBuses","name",cols.name.size(),n);
+      checkSize("addBuses","baseKV",cols.baseKV.size(),n);
+      checkSize("addBuses","vm",cols.vm.size(),n);
+      checkSize("addBuses","va",cols.va.size(),n);
+      checkSize("addBuses","gl",cols.gl.size(),n);
+      checkSize("addBuses","bl",cols.bl.size(),n);
+      checkSize("addBuses","area",cols.area.size(),n);
+      checkSize("addBuses","zone",cols.zone.size(),n);
+      int i;
+      for (i=0; i<n; i++) {
+        boost::shared_ptr<gridpack::component::DataCollection>
+          data(new gridpack::component::DataCollection);
+        int o_idx = cols.number[i];
+        data->addValue(BUS_NUMBER, o_idx);
+        data->addValue(CASE_SBASE, this->p_case_sbase);
+        data->addValue(CASE_ID, this->p_case_id);
+        if (!cols.name.empty()) data->addValue(BUS_NAME, cols.name[i].c_str());
+        data->addValue(BUS_BASEKV, value(cols.baseKV,i,1.0));
+        data->addValue(BUS_TYPE, value(cols.type,i,1));
+        double gl = value(cols.gl,i,0.0);
+        double bl = value(cols.bl,i,0.0);
+        if (gl != 0.0 || bl != 0.0) {
+          data->addValue(BUS_SHUNT_GL, gl);
+          data->addValue(BUS_SHUNT_GL, gl, 0);
+          data->addValue(BUS_SHUNT_BL, bl);
+          data->addValue(BUS_SHUNT_BL, bl, 0);
+          data->addValue(SHUNT_BUSNUMBER, o_idx);
+          data->addValue(SHUNT_NUMBER, 1);
+          data->addValue(SHUNT_ID, "1 ", 0);
+        }
+        data->addValue(BUS_AREA, value(cols.area,i,1));
+        data->addValue(BUS_ZONE, value(cols.zone,i,1));
+        data->addValue(BUS_OWNER, value(cols.area,i,1));
+        data->addValue(BUS_VOLTAGE_MAG, value(cols.vm,i,1.0));
+        data->addValue(BUS_VOLTAGE_ANG, value(cols.va,i,0.0));
+        p_busData.push_back(data);
+      }
+    }
+
+    /**
+     * Add branches owned by this process. Circuits connecting the same
+     * pair of buses are combined into a single branch. May be called
+     * more than once
+     * @param cols branch data
+     */
+    void addBranches(const BranchColumns &cols)
+    {
+      int n = cols.from.size();
+      checkSize("addBranches","to",cols.to.size(),n,true);
+      checkSize("addBranches","ckt",cols.ckt.size(),n);
+      checkSize("addBranches","r",cols.r.size(),n);
+      checkSize("addBranches","x",cols.x.size(),n);
+      checkSize("addBranches","b",cols.b.size(),n);
+      checkSize("addBranches","rateA",cols.rateA.size(),n);
+      checkSize("addBranches","rateB",cols.rateB.size(),n);
+      checkSize("addBranches","rateC",cols.rateC.size(),n);
+      checkSize("addBranches","tap",cols.tap.size(),n);
+      checkSize("addBranches","shift",cols.shift.size(),n);
+      checkSize("addBranches","status",cols.status.size(),n);
+      gridpack::utility::StringUtils util;
+      int i, nelems;
+      for (i=0; i<n; i++) {
+        int o_idx1 = cols.from[i];
+        int o_idx2 = cols.to[i];
+        bool switched = false;
+        int l_idx;
+        std::map<std::pair<int,int>, int>::iterator it;
+        it = p_branchMap.find(std::pair<int,int>(o_idx1,o_idx2));
+        if (it == p_branchMap.end()) {
+          it = p_branchMap.find(std::pair<int,int>(o_idx2,o_idx1));
+          if (it != p_branchMap.end()) switched = true;
+        }
+        if (it != p_branchMap.end()) {
+          l_idx = it->second;
+          p_branchData[l_idx]->getValue(BRANCH_NUM_ELEMENTS,&nelems);
+        } else {
+          boost::shared_ptr<gridpack::component::DataCollection>
+            data(new gridpack::component::DataCollection);
+          l_idx = p_branchData.size();
+          p_branchData.push_back(data);
+          nelems = 0;
+          data->addValue(BRANCH_NUM_ELEMENTS,nelems);
+          data->addValue(BRANCH_INDEX, l_idx);
+          data->addValue(BRANCH_FROMBUS, o_idx1);
+          data->addValue(BRANCH_TOBUS, o_idx2);
+          p_branchMap.insert(std::pair<std::pair<int,int>, int>(
+                std::pair<int,int>(o_idx1,o_idx2),l_idx));
+        }
+        boost::shared_ptr<gridpack::component::DataCollection>
+          data = p_branchData[l_idx];
+        data->addValue(BRANCH_SWITCHED, switched, nelems);
+        std::string tag("1 ");
+        if (!cols.ckt.empty()) {
+          tag = cols.ckt[i];
+          tag = util.clean2Char(tag);
+        }
+        data->addValue(BRANCH_CKT, tag.c_str(), nelems);
+        data->addValue(BRANCH_R, value(cols.r,i,0.0), nelems);
+        data->addValue(BRANCH_X, value(cols.x,i,0.0), nelems);
+        data->addValue(BRANCH_B, value(cols.b,i,0.0), nelems);
+        data->addValue(BRANCH_RATING_A, value(cols.rateA,i,0.0), nelems);
+        data->addValue(BRANCH_RATING_B, value(cols.rateB,i,0.0), nelems);
+        data->addValue(BRANCH_RATING_C, value(cols.rateC,i,0.0), nelems);
+        data->addValue(BRANCH_TAP, value(cols.tap,i,0.0), nelems);
+        data->addValue(BRANCH_SHIFT, value(cols.shift,i,0.0), nelems);
+        data->addValue(BRANCH_SHUNT_ADMTTNC_G1, 0.0, nelems);
+        data->addValue(BRANCH_SHUNT_ADMTTNC_B1, 0.0, nelems);
+        data->addValue(BRANCH_SHUNT_ADMTTNC_G2, 0.0, nelems);
+        data->addValue(BRANCH_SHUNT_ADMTTNC_B2, 0.0, nelems);
+        data->addValue(BRANCH_STATUS, value(cols.status,i,1), nelems);
+        nelems++;
+        data->setValue(BRANCH_NUM_ELEMENTS,nelems);
+      }
+    }
+
+    /**
+     * Add generators. The generators do not need to be supplied on
+     * the process that supplies their bus. May be called more than once
+     * @param cols generator data
+     */
+    void addGenerators(const GeneratorColumns &cols)
+    {
+      int n = cols.bus.size();
+      checkSize("addGenerators","id",cols.id.size(),n);
+      checkSize("addGenerators","pg",cols.pg.size(),n);
+      checkSize("addGenerators","qg",cols.qg.size(),n);
+      checkSize("addGenerators","qmax",cols.qmax.size(),n);
+      checkSize("addGenerators","qmin",cols.qmin.size(),n);
+      checkSize("addGenerators","vs",cols.vs.size(),n);
+      checkSize("addGenerators","mbase",cols.mbase.size(),n);
+      checkSize("addGenerators","pmax",cols.pmax.size(),n);
+      checkSize("addGenerators","pmin",cols.pmin.size(),n);
+      checkSize("addGenerators","status",cols.status.size(),n);
+      int i;
+      for (i=0; i<n; i++) {
+        gen_record rec;
+        rec.bus = cols.bus[i];
+        setTag(rec.id, cols.id, i);
+        rec.pg = value(cols.pg,i,0.0);
+        rec.qg = value(cols.qg,i,0.0);
+        rec.qmax = value(cols.qmax,i,0.0);
+        rec.qmin = value(cols.qmin,i,0.0);
+        rec.vs = value(cols.vs,i,1.0);
+        rec.mbase = value(cols.mbase,i,100.0);
+        rec.pmax = value(cols.pmax,i,0.0);
+        rec.pmin = value(cols.pmin,i,0.0);
+        rec.status = value(cols.status,i,1);
+        p_genKeys.push_back(rec.bus);
+        p_genData.push_back(rec);
+      }
+    }
+
+    /**
+     * Add loads. The loads do not need to be supplied on the process
+     * that supplies their bus. May be called more than once
+     * @param cols load data
+     */
+    void addLoads(const LoadColumns &cols)
+    {
+      int n = cols.bus.size();
+      checkSize("addLoads","id",cols.id.size(),n);
+      checkSize("addLoads","pl",cols.pl.size(),n);
+      checkSize("addLoads","ql",cols.ql.size(),n);
+      checkSize("addLoads","ip",cols.ip.size(),n);
+      checkSize("addLoads","iq",cols.iq.size(),n);
+      checkSize("addLoads","yp",cols.yp.size(),n);
+      checkSize("addLoads","yq",cols.yq.size(),n);
+      checkSize("addLoads","status",cols.status.size(),n);
+      int i;
+      for (i=0; i<n; i++) {
+        load_record rec;
+        rec.bus = cols.bus[i];
+        setTag(rec.id, cols.id, i);
+        rec.pl = value(cols.pl,i,0.0);
+        rec.ql = value(cols.ql,i,0.0);
+        rec.ip = value(cols.ip,i,0.0);
+        rec.iq = value(cols.iq,i,0.0);
+        rec.yp = value(cols.yp,i,0.0);
+        rec.yq = value(cols.yq,i,0.0);
+        rec.status = value(cols.status,i,1);
+        p_loadKeys.push_back(rec.bus);
+        p_loadData.push_back(rec);
+      }
+    }
+
+    /**
+     * Create the network from all data supplied so far. This must be
+     * called on all processes. Afterwards, the network can be
+     * partitioned as if it had been read from a file. The data held by
+     * the parser is released.
+     */
+    void ingest(void)
+    {
+      this->p_timer = gridpack::utility::CoarseTimer::instance();
+      int t_ingest = this->p_timer->createCategory("MemoryParser:ingest");
+      this->p_timer->start(t_ingest);
+      this->p_network_data->addValue(CASE_SBASE, this->p_case_sbase);
+      this->p_network_data->addValue(CASE_ID, this->p_case_id);
+
+      // Add buses and branches supplied on this process to network
+      this->createNetwork(p_busData,p_branchData);
+      p_branchMap.clear();
+
+      // Move device records to the processes holding their buses.
+      // On return, keys contain local bus indices
+      int i, ndev;
+      boost::shared_ptr<gridpack::component::DataCollection> data;
+      {
+        gridpack::hash_distr::HashDistribution<_network,gen_record,gen_record>
+          distr(this->p_network);
+        distr.distributeBusValues(p_genKeys,p_genData);
+      }
+      for (i=0; i<p_genKeys.size(); i++) {
+        const gen_record &rec = p_genData[i];
+        data = this->p_network->getBusData(p_genKeys[i]);
+        if (!data->getValue(GENERATOR_NUMBER,&ndev)) ndev = 0;
+        data->addValue(GENERATOR_BUSNUMBER, rec.bus, ndev);
+        data->addValue(GENERATOR_ID, rec.id, ndev);
+        data->addValue(GENERATOR_PG, rec.pg, ndev);
+        data->addValue(GENERATOR_QG, rec.qg, ndev);
+        data->addValue(GENERATOR_QMAX, rec.qmax, ndev);
+        data->addValue(GENERATOR_QMIN, rec.qmin, ndev);
+        data->addValue(GENERATOR_VS, rec.vs, ndev);
+        data->addValue(GENERATOR_IREG, rec.bus, ndev);
+        data->addValue(GENERATOR_MBASE, rec.mbase, ndev);
+        data->addValue(GENERATOR_STAT, rec.status, ndev);
+        data->addValue(GENERATOR_PMAX, rec.pmax, ndev);
+        data->addValue(GENERATOR_PMIN, rec.pmin, ndev);
+        if (ndev == 0) {
+          data->addValue(GENERATOR_NUMBER, 1);
+        } else {
+          data->setValue(GENERATOR_NUMBER, ndev+1);
+        }
+      }
+      {
+        gridpack::hash_distr::HashDistribution<_network,load_record,load_record>
+          distr(this->p_network);
+        distr.distributeBusValues(p_loadKeys,p_loadData);
+      }
+      for (i=0; i<p_loadKeys.size(); i++) {
+        const load_record &rec = p_loadData[i];
+        data = this->p_network->getBusData(p_loadKeys[i]);
+        if (!data->getValue(LOAD_NUMBER,&ndev)) ndev = 0;
+        data->addValue(LOAD_BUSNUMBER, rec.bus, ndev);
+        data->addValue(LOAD_ID, rec.id, ndev);
+        data->addValue(LOAD_STATUS, rec.status, ndev);
+        if (ndev == 0) {
+          data->addValue(LOAD_PL, rec.pl);
+          data->addValue(LOAD_QL, rec.ql);
+        }
+        data->addValue(LOAD_PL, rec.pl, ndev);
+        data->addValue(LOAD_QL, rec.ql, ndev);
+        data->addValue(LOAD_IP, rec.ip, ndev);
+        data->addValue(LOAD_IQ, rec.iq, ndev);
+        data->addValue(LOAD_YP, rec.yp, ndev);
+        data->addValue(LOAD_YQ, rec.yq, ndev);
+        if (ndev == 0) {
+          data->addValue(LOAD_NUMBER, 1);
+        } else {
+          data->setValue(LOAD_NUMBER, ndev+1);
+        }
+      }
+      p_genKeys.clear();
+      p_genData.clear();
+      p_loadKeys.clear();
+      p_loadData.clear();
+      this->p_timer->stop(t_ingest);
+    }
+
+  private:
+
+    // Fixed size records so that they can be moved by HashDistribution
+    typedef struct {
+      int bus;
+      char id[3];
+      double pg;
+      double qg;
+      double qmax;
+      double qmin;
+      double vs;
+      double mbase;
+      double pmax;
+      double pmin;
+      int status;
+    } gen_record;
+
+    typedef struct {
+      int bus;
+      char id[3];
+      double pl;
+      double ql;
+      double ip;
+      double iq;
+      double yp;
+      double yq;
+      int status;
+    } load_record;
+
+    /**
+     * Check that an optional column is either empty or has the same
+     * length as the key column
+     */
+    void checkSize(const char *method, const char *column, int size,
+        int nkeys, bool required = false)
+    {
+      if ((size == 0 && !required) || size == nkeys) return;
+      char buf[256];
+      sprintf(buf,"MemoryParser::%s: column %s has %d entries, expected %d\n",
+          method,column,size,nkeys);
+      throw gridpack::Exception(buf);
+    }
+
+    /**
+     * Return entry from column or a default if the column is empty
+     */
+    template <typename T>
+    T value(const std::vector<T> &column, int idx, T defval) const
+    {
+      if (column.empty()) return defval;
+      return column[idx];
+    }
+
+    /**
+     * Copy a cleaned two character tag into a record
+     */
+    void setTag(char *tag, const std::vector<std::string> &column, int idx)
+    {
+      std::string str("1 ");
+      if (!column.empty()) {
+        gridpack::utility::StringUtils util;
+        str = column[idx];
+        str = util.clean2Char(str);
+      }
+      strncpy(tag,str.c_str(),2);
+      tag[2] = '\0';
+    }
+
+    std::vector<boost::shared_ptr<gridpack::component::DataCollection> > p_busData;
+    std::vector<boost::shared_ptr<gridpack::component::DataCollection> > p_branchData;
+    std::map<std::pair<int,int>, int> p_branchMap;
+    std::vector<int> p_genKeys;
+    std::vector<gen_record> p_genData;
+    std::vector<int> p_loadKeys;
+    std::vector<load_record> p_loadData;
+};
+
+} /* namespace parser */
+} /* namespace gridpack */
+
+#endif
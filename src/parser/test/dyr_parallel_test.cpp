@@ -0,0 +1,191 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+#include <cstdio>
+#include <vector>
+
+#include <boost/mpi/environment.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/collectives.hpp>
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/included/unit_test.hpp>
+
+#include "mpi.h"
+#include <macdecls.h>
+#include "gridpack/network/base_network.hpp"
+#include "gridpack/parser/memory_parser.hpp"
+#include "gridpack/parser/PTI23_parser.hpp"
+#include "gridpack/environment/environment.hpp"
+
+#define NBUS_PER_PROC 20
+
+class TestBus
+  : public gridpack::component::BaseBusComponent {
+  public:
+
+  TestBus(void) {
+  }
+
+  ~TestBus(void) {
+  }
+};
+
+BOOST_CLASS_EXPORT(TestBus)
+
+class TestBranch
+  : public gridpack::component::BaseBranchComponent {
+  public:
+
+  TestBranch(void) {
+  }
+
+  ~TestBranch(void) {
+  }
+};
+
+BOOST_CLASS_EXPORT(TestBranch)
+
+typedef gridpack::network::BaseNetwork<TestBus, TestBranch> TestNetwork;
+
+/**
+ * Build a partitioned line network. Each bus has one generator and every
+ * other bus has a second generator
+ */
+static void buildNetwork(boost::shared_ptr<TestNetwork> network, int nbus)
+{
+  gridpack::parallel::Communicator world;
+  int me = world.rank();
+  gridpack::parser::BusColumns buses;
+  gridpack::parser::BranchColumns branches;
+  gridpack::parser::GeneratorColumns gens;
+  int i;
+  int lo = me*NBUS_PER_PROC;
+  int hi = lo + NBUS_PER_PROC;
+  for (i=lo; i<hi; i++) {
+    buses.number.push_back(i+1);
+    buses.type.push_back(i == 0 ? 3 : 2);
+    if (i < nbus-1) {
+      branches.from.push_back(i+1);
+      branches.to.push_back(i+2);
+      branches.x.push_back(0.1);
+    }
+    gens.bus.push_back(i+1);
+    gens.id.push_back("1");
+    gens.pg.push_back(1.0);
+    if (i%2 == 0) {
+      gens.bus.push_back(i+1);
+      gens.id.push_back("2");
+      gens.pg.push_back(1.0);
+    }
+  }
+  gridpack::parser::MemoryParser<TestNetwork> parser(network);
+  parser.setCase(1, 100.0);
+  parser.addBuses(buses);
+  parser.addBranches(branches);
+  parser.addGenerators(gens);
+  parser.ingest();
+  network->partition();
+}
+
+/**
+ * Inertia constant assigned to a generator in the test file
+ */
+static double inertia(int bus, int gen)
+{
+  return 1.0 + static_cast<double>(bus) + 0.5*static_cast<double>(gen);
+}
+
+BOOST_AUTO_TEST_SUITE ( TestParallelDyr )
+
+BOOST_AUTO_TEST_CASE( ParallelDyrMatchesSerial )
+{
+  gridpack::parallel::Communicator world;
+  int nprocs = world.size();
+  int nbus = NBUS_PER_PROC*nprocs;
+  const char *filename = "dyr_parallel_test.dyr";
+
+  // Write a .dyr file with blank lines, comments, records that span
+  // several lines and records for buses that do not exist
+  if (world.rank() == 0) {
+    FILE *fp = fopen(filename,"w");
+    int i;
+    for (i=1; i<=nbus; i++) {
+      fprintf(fp,"  %d, 'GENCLS', 1, %f, 0.0 /  generator 1\n",i,inertia(i,1));
+      if ((i-1)%2 == 0) {
+        fprintf(fp,"  %d, 'GENCLS', '2',\n",i);
+        fprintf(fp,"    %f, 0.0\n  /\n",inertia(i,2));
+      }
+      if (i%3 == 0) fprintf(fp,"\n");
+      fprintf(fp,"  %d, 'LVSHBL', 1, 0, 0.8, 1.0 /\n",i);
+      fprintf(fp,"  %d, 'LVSHBL', 2, 0, 0.7, 1.0 /\n",i);
+    }
+    fprintf(fp,"  %d, 'GENCLS', 1, 5.0, 0.0 /\n",10*nbus);
+    fclose(fp);
+  }
+  world.barrier();
+
+  boost::shared_ptr<TestNetwork> network(new TestNetwork(world));
+  buildNetwork(network, nbus);
+  gridpack::parser::PTI23_parser<TestNetwork> parser(network);
+  parser.externalParse(filename, true);
+
+  boost::shared_ptr<TestNetwork> serial(new TestNetwork(world));
+  buildNetwork(serial, nbus);
+  gridpack::parser::PTI23_parser<TestNetwork> sparser(serial);
+  sparser.externalParse(filename, false);
+
+  // Every local copy of every bus receives its parameters once
+  int i, j;
+  int nset = 0;
+  for (i=0; i<network->numBuses(); i++) {
+    boost::shared_ptr<gridpack::component::DataCollection> data
+      = network->getBusData(i);
+    int bus = network->getOriginalBusIndex(i);
+    int ngen;
+    BOOST_REQUIRE(data->getValue(GENERATOR_NUMBER,&ngen));
+    for (j=0; j<ngen; j++) {
+      std::string model;
+      double h;
+      BOOST_CHECK(data->getValue(GENERATOR_MODEL,&model,j));
+      BOOST_CHECK_EQUAL(model, std::string("GENCLS"));
+      BOOST_CHECK(data->getValue(GENERATOR_INERTIA_CONSTANT_H,&h,j));
+      BOOST_CHECK_CLOSE(h, inertia(bus,j+1), 1.0e-8);
+      if (network->getActiveBus(i)) nset++;
+    }
+    int nrelay;
+    BOOST_CHECK(data->getValue(RELAY_NUMBER,&nrelay));
+    BOOST_CHECK_EQUAL(nrelay, 2);
+  }
+  world.sum(&nset,1);
+  BOOST_CHECK_EQUAL(nset, nbus + nbus/2);
+
+  // Result is the same as reading the file on one process
+  BOOST_REQUIRE_EQUAL(network->numBuses(), serial->numBuses());
+  for (i=0; i<network->numBuses(); i++) {
+    BOOST_CHECK_EQUAL(network->getBusData(i)->size(),
+        serial->getBusData(i)->size());
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END( )
+
+bool init_function(void)
+{
+  return true;
+}
+
+int main (int argc, char **argv) {
+
+  gridpack::Environment env(argc, argv);
+  gridpack::parallel::Communicator world;
+
+  if (world.rank() == 0) {
+    printf("Testing parallel .dyr parsing\n");
+  }
+
+  int result = ::boost::unit_test::unit_test_main( &init_function, argc, argv );
+  return result;
+}
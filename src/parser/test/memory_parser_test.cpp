@@ -0,0 +1,180 @@
+/*
+ *     Copyright (c) 2013 Battelle Memorial Institute
+ *     Licensed under modified BSD License. A copy of this license can be found
+ *     in the LICENSE file in the top level directory of this distribution.
+ */
+#include <vector>
+
+#include <boost/mpi/environment.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/collectives.hpp>
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/included/unit_test.hpp>
+
+#include "mpi.h"
+#include <macdecls.h>
+#include "gridpack/network/base_network.hpp"
+#include "gridpack/parser/memory_parser.hpp"
+#include "gridpack/environment/environment.hpp"
+
+#define NBUS_PER_PROC 20
+
+class TestBus
+  : public gridpack::component::BaseBusComponent {
+  public:
+
+  TestBus(void) {
+  }
+
+  ~TestBus(void) {
+  }
+};
+
+BOOST_CLASS_EXPORT(TestBus)
+
+class TestBranch
+  : public gridpack::component::BaseBranchComponent {
+  public:
+
+  TestBranch(void) {
+  }
+
+  ~TestBranch(void) {
+  }
+};
+
+BOOST_CLASS_EXPORT(TestBranch)
+
+typedef gridpack::network::BaseNetwork<TestBus, TestBranch> TestNetwork;
+
+BOOST_AUTO_TEST_SUITE ( TestMemoryParser )
+
+BOOST_AUTO_TEST_CASE( IngestLineNetwork )
+{
+  gridpack::parallel::Communicator world;
+  int me = world.rank();
+  int nprocs = world.size();
+  int nbus = NBUS_PER_PROC*nprocs;
+  boost::shared_ptr<TestNetwork> network(new TestNetwork(world));
+
+  // Each process supplies a contiguous block of a line network. Bus
+  // numbers are not equal to global indices
+  gridpack::parser::BusColumns buses;
+  gridpack::parser::BranchColumns branches;
+  int i;
+  int lo = me*NBUS_PER_PROC;
+  int hi = lo + NBUS_PER_PROC;
+  for (i=lo; i<hi; i++) {
+    buses.number.push_back(2*i+1);
+    buses.type.push_back(i == 0 ? 3 : 1);
+    if (i < nbus-1) {
+      branches.from.push_back(2*i+1);
+      branches.to.push_back(2*i+3);
+      branches.x.push_back(0.1);
+    }
+  }
+  // Add a parallel circuit to the first branch on this process
+  branches.from.push_back(2*lo+3);
+  branches.to.push_back(2*lo+1);
+  branches.x.push_back(0.2);
+  branches.ckt.resize(branches.from.size(),"1");
+  branches.ckt.back() = "2";
+
+  // Generators and loads are supplied by the next process, so they
+  // have to be moved to the process holding their bus
+  gridpack::parser::GeneratorColumns gens;
+  gridpack::parser::LoadColumns loads;
+  int nlo = ((me+1)%nprocs)*NBUS_PER_PROC;
+  gens.bus.push_back(2*nlo+1);
+  gens.pg.push_back(1.0);
+  gens.bus.push_back(2*nlo+1);
+  gens.pg.push_back(2.0);
+  gens.id.push_back("1");
+  gens.id.push_back("2");
+  for (i=nlo; i<nlo+NBUS_PER_PROC; i++) {
+    loads.bus.push_back(2*i+1);
+    loads.pl.push_back(0.5);
+  }
+
+  gridpack::parser::MemoryParser<TestNetwork> parser(network);
+  parser.setCase(1, 100.0);
+  parser.addBuses(buses);
+  parser.addBranches(branches);
+  parser.addGenerators(gens);
+  parser.addLoads(loads);
+  parser.ingest();
+
+  // Buses and branches stay on the process that supplied them
+  BOOST_CHECK_EQUAL(network->numBuses(), NBUS_PER_PROC);
+  int nbranch = network->numBranches();
+  world.sum(&nbranch,1);
+  BOOST_CHECK_EQUAL(nbranch, nbus-1);
+
+  // All devices end up on the bus that they were assigned to
+  int ngen = 0;
+  int nload = 0;
+  double pgen = 0.0;
+  for (i=0; i<network->numBuses(); i++) {
+    boost::shared_ptr<gridpack::component::DataCollection> data
+      = network->getBusData(i);
+    int n;
+    if (data->getValue(GENERATOR_NUMBER,&n)) {
+      BOOST_CHECK_EQUAL(network->getOriginalBusIndex(i), 2*lo+1);
+      BOOST_CHECK_EQUAL(n, 2);
+      int j;
+      for (j=0; j<n; j++) {
+        double pg;
+        data->getValue(GENERATOR_PG,&pg,j);
+        pgen += pg;
+      }
+      ngen += n;
+    }
+    if (data->getValue(LOAD_NUMBER,&n)) {
+      BOOST_CHECK_EQUAL(n, 1);
+      nload += n;
+    }
+  }
+  BOOST_CHECK_EQUAL(ngen, 2);
+  BOOST_CHECK_EQUAL(nload, NBUS_PER_PROC);
+  BOOST_CHECK_CLOSE(pgen, 3.0, 1.0e-12);
+
+  // Parallel circuits are combined into one branch
+  int nmerged = 0;
+  for (i=0; i<network->numBranches(); i++) {
+    int n;
+    network->getBranchData(i)->getValue(BRANCH_NUM_ELEMENTS,&n);
+    if (n == 2) nmerged++;
+  }
+  world.sum(&nmerged,1);
+  BOOST_CHECK_EQUAL(nmerged, nprocs);
+
+  // The ingested network can be partitioned like a parsed one
+  network->partition();
+  int nactive = 0;
+  for (i=0; i<network->numBuses(); i++) {
+    if (network->getActiveBus(i)) nactive++;
+  }
+  world.sum(&nactive,1);
+  BOOST_CHECK_EQUAL(nactive, nbus);
+}
+
+BOOST_AUTO_TEST_SUITE_END( )
+
+bool init_function(void)
+{
+  return true;
+}
+
+int main (int argc, char **argv) {
+
+  gridpack::Environment env(argc, argv);
+  gridpack::parallel::Communicator world;
+
+  if (world.rank() == 0) {
+    printf("Testing in-memory network ingestion\n");
+  }
+
+  int result = ::boost::unit_test::unit_test_main( &init_function, argc, argv );
+  return result;
+}